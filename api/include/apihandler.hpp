@@ -3,9 +3,14 @@
 
 #include <csstats.hpp>
 
+#include <algorithm>
 #include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <queue>
 #include <tuple>
+#include <vector>
 
 #include <client/params.hpp>
 
@@ -105,6 +110,14 @@ public:
 
     void WaitForBlock(PoolHash& _return, const PoolHash& obsolete) override;
 
+    // long-poll variants for the event server, done is called once by the thread storing block,
+    // call is dropped when its owner (connection) expires
+    template <typename T>
+    using Continuation = std::function<void(const T&)>;
+
+    void WaitForBlockAsync(const std::weak_ptr<void>& owner, Continuation<PoolHash> done);
+    void WaitForSmartTransactionAsync(const general::Address& smart_public, const std::weak_ptr<void>& owner, Continuation<api::TransactionId> done);
+
     void SmartMethodParamsGet(SmartMethodParamsGetResult& _return, const general::Address& address, const int64_t id) override;
 
     void TransactionsStateGet(TransactionsStateGetResult& _return, const general::Address& address, const std::vector<int64_t>& v) override;
@@ -156,19 +169,23 @@ public:
     bool isBDLoaded() { return isBDLoaded_; }
     
 private:
-#ifdef USE_DEPRECATED_STATS
-    ::csstats::AllStats stats_;
-#endif // 0
     cs::Executor& executor_;
     cs::DumbCv dumbCv_;
 
     bool isBDLoaded_{ false };
 
+    template <typename T>
+    struct Waiter {
+        std::weak_ptr<void> owner;
+        Continuation<T> done;
+    };
+
     struct smart_trxns_queue {
         cs::SpinLock lock{ATOMIC_FLAG_INIT};
         std::condition_variable_any new_trxn_cv{};
         size_t awaiter_num{0};
         std::deque<csdb::TransactionID> trid_queue{};
+        std::vector<Waiter<api::TransactionId>> waiters{};
     };
 
     struct PendingSmartTransactions {
@@ -191,7 +208,7 @@ private:
 
     BlockChain& blockchain_;
     cs::SolverCore& solver_;
-#ifdef USE_DEPRECATED_STATS // MONITOR_NODE
+#ifdef STATS
     csstats::csstats stats;
 #endif
 
@@ -287,12 +304,14 @@ private:
     std::condition_variable_any newBlockCv_;
     std::mutex dbLock_;
 
+    std::mutex blockWaitersMutex_;
+    std::vector<Waiter<PoolHash>> blockWaiters_;
+
     cs::Sequence maxReadSequence{};
 
 private slots:
     void updateSmartCachesPool(const csdb::Pool& pool);
     void store_block_slot(const csdb::Pool& pool);
-    void collect_all_stats_slot(const csdb::Pool& pool);
     void baseLoaded(const csdb::Pool& pool);
     void maxBlocksCount(cs::Sequence lastBlockNum);
     void onPacketExpired(const cs::TransactionsPacket& packet);
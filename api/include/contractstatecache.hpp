@@ -0,0 +1,106 @@
+#ifndef CONTRACTSTATECACHE_HPP
+#define CONTRACTSTATECACHE_HPP
+
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <csdb/address.hpp>
+
+#include <lib/system/common.hpp>
+
+namespace cs {
+// Contract states limited by memory size, the least recently used ones are evicted first.
+// Keeps the latest stored state of contracts and the states changed by blocks while contracts are executed.
+// Equal states share one copy found by hash.
+class ContractStateCache {
+public:
+    struct Metrics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t bytes = 0;
+        size_t capacity = 0;
+        size_t entries = 0;
+        size_t states = 0;
+    };
+
+    enum class HistoryResult {
+        Found,
+        // the latest state is actual for the sequence
+        Latest,
+        // state was changed after the sequence, but it is not cached
+        Unknown
+    };
+
+    // capacity in bytes, zero disables cache
+    explicit ContractStateCache(size_t capacity);
+
+    std::optional<std::string> latest(const csdb::Address& address);
+    void setLatest(const csdb::Address& address, const std::string& state);
+
+    // stores state read from storage if the cache was not changed after version was taken,
+    // so state read concurrently with its update is never cached
+    void fillLatest(const csdb::Address& address, const std::string& state, uint64_t version);
+    uint64_t version() const;
+
+    // called when contract state is updated in storage
+    void invalidate(const csdb::Address& address);
+
+    // state of the contract changed at block sequence
+    void addHistory(const csdb::Address& address, cs::Sequence sequence, const std::string& state);
+    HistoryResult history(const csdb::Address& address, cs::Sequence sequence, std::string& state);
+    void clearHistory();
+
+    Metrics metrics() const;
+
+private:
+    constexpr static cs::Sequence kLatest = std::numeric_limits<cs::Sequence>::max();
+
+    // approximate memory used by entry besides the state
+    constexpr static size_t kEntryOverhead = 128;
+
+    struct Blob {
+        std::string data;
+        size_t refs = 0;
+    };
+
+    using Key = std::pair<csdb::Address, cs::Sequence>;
+    using Blobs = std::map<cs::Hash, Blob>;
+
+    struct Entry {
+        Blobs::iterator blob;
+        std::list<Key>::iterator usage;
+    };
+
+    using Entries = std::map<cs::Sequence, Entry>;
+
+    void insert(const csdb::Address& address, cs::Sequence sequence, const std::string& state);
+    // erases entry, empty entries of address are left to caller
+    void erase(Entries& entries, Entries::iterator entry);
+    void eraseIfEmpty(std::map<csdb::Address, Entries>::iterator address);
+    void touch(Entry& entry);
+    void evict();
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    size_t bytes_ = 0;
+    size_t historyEntries_ = 0;
+    uint64_t version_ = 0;
+
+    // front is the most recently used
+    std::list<Key> usage_;
+    std::map<csdb::Address, Entries> entries_;
+    Blobs blobs_;
+
+    // the newest evicted history sequence of address
+    std::map<csdb::Address, cs::Sequence> evicted_;
+
+    Metrics metrics_;
+};
+}  // namespace cs
+
+#endif  // CONTRACTSTATECACHE_HPP
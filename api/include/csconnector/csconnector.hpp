@@ -16,6 +16,8 @@
 
 #include <client/params.hpp>
 
+#include <csconnector/eventserver.hpp>
+
 #include <csdb/pool.hpp>
 
 #include <solvercore.hpp>
@@ -53,9 +55,6 @@ public:
     void onReadFromDB(csdb::Pool pool, bool* should_stop) {
         if (!*should_stop) {
             api_handler->updateSmartCachesPool(pool);
-#ifdef MONITOR_NODE
-            api_handler->collect_all_stats_slot(pool);
-#endif
             api_handler->baseLoaded(pool);
         }
     }
@@ -88,11 +87,13 @@ private:
     ::apache::thrift::stdcxx::shared_ptr<::apiexec::APIEXECProcessor> p_apiexec_processor;
 #ifdef BINARY_TCP_API
     ::apache::thrift::server::TThreadedServer server;
+    std::unique_ptr<EventServer> event_server;
     std::thread thread;
     uint16_t server_port;
 #endif
 #ifdef AJAX_IFACE
     ::apache::thrift::server::TThreadedServer ajax_server;
+    std::unique_ptr<EventServer> ajax_event_server;
     std::thread ajax_thread;
     uint16_t ajax_server_port;
 #endif
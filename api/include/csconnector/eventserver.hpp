@@ -0,0 +1,160 @@
+#ifndef EVENTSERVER_HPP
+#define EVENTSERVER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <lib/system/taskruntime.hpp>
+
+namespace csconnector {
+///
+/// Framing and processing of requests of one protocol for EventServer.
+///
+class Codec {
+public:
+    struct Request {
+        std::string method;
+
+        // bytes passed to process or park
+        std::string data;
+
+        // if not empty, it is sent back at once without processing
+        std::string reply;
+    };
+
+    enum class Status : uint8_t {
+        Ready,
+        Incomplete,
+        Malformed
+    };
+
+    // called by any thread once with bytes of reply
+    using Reply = std::function<void(std::string)>;
+
+    virtual ~Codec() = default;
+
+    // extracts the first request of input, called by server thread,
+    // for incomplete request consumed may be set to input size required to complete it, extract is not called before
+    virtual Status extract(std::string_view input, Request& request, size_t& consumed) = 0;
+
+    // returns bytes of reply, called by worker, may throw to close connection
+    virtual std::string process(const Request& request) = 0;
+
+    // parks long-poll request instead of processing it, returns false if request is not long-poll one,
+    // owner expires when the connection is closed, called by server thread
+    virtual bool park(const Request& request, const std::weak_ptr<void>& owner, Reply reply) {
+        (void)request;
+        (void)owner;
+        (void)reply;
+        return false;
+    }
+
+    // returns true if processing of request may wait long, such request is processed at dedicated thread
+    // to not occupy workers, called by server thread
+    virtual bool blocking(const Request& request) const {
+        (void)request;
+        return false;
+    }
+};
+
+///
+/// Non-blocking TCP server: one thread polls all connections, requests are processed by fixed workers pool,
+/// long-poll requests are parked in codec until their reply is ready and do not hold any thread,
+/// blocking requests are processed at dedicated threads, so they do not starve workers.
+/// Every connection has at most one request in processing, next ones wait in its input buffer.
+///
+class EventServer {
+public:
+    struct Settings {
+        uint16_t port = 0;
+        size_t workers = 8;
+        size_t maxConnections = 10000;
+        size_t maxRequestSize = 16 * 1024 * 1024;
+
+        // connection without requests is closed after it, 0 means never
+        std::chrono::milliseconds idleTimeout{0};
+
+        // period of methods latency report to log, 0 means never
+        std::chrono::seconds reportPeriod{60};
+    };
+
+    struct MethodStats {
+        uint64_t calls = 0;
+        uint64_t totalMicroseconds = 0;
+        uint64_t maxMicroseconds = 0;
+    };
+
+    EventServer(std::shared_ptr<Codec> codec, const Settings& settings);
+    ~EventServer();
+
+    EventServer(const EventServer&) = delete;
+    EventServer& operator=(const EventServer&) = delete;
+
+    // binds listening socket, throws std::runtime_error on failure
+    void listen();
+
+    // runs event loop on calling thread until stop
+    void serve();
+    void stop();
+
+    // bound port, valid after listen
+    uint16_t port() const;
+
+    size_t connections() const;
+    uint64_t rejected() const;
+    std::map<std::string, MethodStats> stats() const;
+
+    // methods latency in one line
+    std::string report() const;
+
+private:
+    struct Connection;
+    struct Mailbox;
+
+    using ConnectionPtr = std::shared_ptr<Connection>;
+    using Clock = std::chrono::steady_clock;
+
+    void accept();
+    void read(const ConnectionPtr& connection);
+    void write(const ConnectionPtr& connection);
+    void dispatch(const ConnectionPtr& connection);
+    void complete();
+    void close(const ConnectionPtr& connection);
+    void sweep(Clock::time_point now);
+    void watch(const ConnectionPtr& connection, bool writable);
+    void account(const std::string& method, Clock::duration latency);
+
+    std::shared_ptr<Codec> codec_;
+    const Settings settings_;
+
+    int listener_ = -1;
+    int epoll_ = -1;
+    uint16_t port_ = 0;
+
+    std::atomic<bool> running_ = {false};
+    std::atomic<size_t> connectionsCount_ = {0};
+    std::atomic<uint64_t> rejected_ = {0};
+
+    // connections by descriptor, used by server thread only
+    std::unordered_map<int, ConnectionPtr> connections_;
+
+    // replies of workers and long-polls, may outlive server
+    std::shared_ptr<Mailbox> mailbox_;
+
+    mutable std::mutex statsMutex_;
+    std::map<std::string, MethodStats> stats_;
+
+    cs::TaskRuntime workers_;
+};
+}  // namespace csconnector
+
+#endif  // EVENTSERVER_HPP
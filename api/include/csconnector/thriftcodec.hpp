@@ -0,0 +1,75 @@
+#ifndef THRIFTCODEC_HPP
+#define THRIFTCODEC_HPP
+
+#if defined(_MSC_VER)
+#pragma warning(push, 0)
+#endif
+
+#include <thrift/TProcessor.h>
+#include <thrift/protocol/TProtocol.h>
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#include <csconnector/eventserver.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace csconnector {
+///
+/// Thrift requests of buffered binary or http transports for EventServer.
+///
+class ThriftCodec : public Codec {
+public:
+    enum class Transport : uint8_t {
+        // unframed messages, as TBufferedTransport
+        Buffered,
+
+        // messages in bodies of http POST requests, as THttpServer
+        Http
+    };
+
+    // writes result struct of parked call
+    using ResultWriter = std::function<void(::apache::thrift::protocol::TProtocol*)>;
+
+    // completes parked call, called once by any thread
+    using Completion = std::function<void(ResultWriter)>;
+
+    // reads arguments struct of call and parks it, the call is dropped if owner expires
+    using LongPoll = std::function<void(::apache::thrift::protocol::TProtocol* input, const std::weak_ptr<void>& owner, Completion done)>;
+
+    ThriftCodec(::apache::thrift::stdcxx::shared_ptr<::apache::thrift::TProcessor> processor,
+                ::apache::thrift::stdcxx::shared_ptr<::apache::thrift::protocol::TProtocolFactory> protocolFactory, Transport transport);
+
+    // call of method is parked instead of blocking a worker
+    void addLongPoll(const std::string& method, LongPoll poll);
+
+    // call of method may wait long, it is processed at dedicated thread instead of a worker
+    void addBlocking(const std::string& method);
+
+    Status extract(std::string_view input, Request& request, size_t& consumed) override;
+    std::string process(const Request& request) override;
+    bool park(const Request& request, const std::weak_ptr<void>& owner, Reply reply) override;
+    bool blocking(const Request& request) const override;
+
+private:
+    Status extractMessage(std::string_view input, Request& request, size_t& consumed) const;
+    Status extractHttp(std::string_view input, Request& request, size_t& consumed) const;
+
+    static std::string wrap(Transport transport, std::string message);
+
+    ::apache::thrift::stdcxx::shared_ptr<::apache::thrift::TProcessor> processor_;
+    ::apache::thrift::stdcxx::shared_ptr<::apache::thrift::protocol::TProtocolFactory> protocolFactory_;
+    const Transport transport_;
+
+    std::map<std::string, LongPoll> longPolls_;
+    std::set<std::string> blocking_;
+};
+}  // namespace csconnector
+
+#endif  // THRIFTCODEC_HPP
@@ -4,107 +4,70 @@
 #include <atomic>
 #include <csnode/blockchain.hpp>
 #include <cstdint>
-#include <deque>
+#include <mutex>
 #include <string>
 #include <thread>
-#include <unordered_map>
-#include <vector>
 
-#define NO_STATS_TEST
-#define NO_FAST_UPDATE
-#define LOG_STATS_TO_FILE
+#include <lib/system/signals.hpp>
 
-namespace csstats {
-
-using period_t = std::chrono::seconds::rep;
-
-using Period = period_t;
-using Periods = std::vector<period_t>;
-
-using Count = uint32_t;
-
-using Integral = int32_t;
-using Fraction = int64_t;
-
-struct Amount {
-    Integral integral = 0;
-    Fraction fraction = 0;
-};
-
-using Balance = Amount;
-using Currency = uint8_t;
+#include <statsrollup.hpp>
 
-struct TotalAmount {
-    int64_t integral = 0;
-    int64_t fraction = 0;
-};
+namespace csstats {
 
-using BalancePerCurrency = std::unordered_map<Currency, TotalAmount>;
-using TimeStamp = std::chrono::system_clock::time_point;
-
-struct PeriodStats {
-    period_t periodSec = 0;
-    Count poolsCount = 0;
-    Count transactionsCount = 0;
-    BalancePerCurrency balancePerCurrency;
-    Count smartContractsCount = 0;
-    Count transactionsSmartCount = 0;
-    TimeStamp timeStamp;
-};
+// Statistics are updated by every read, stored and removed block, so getting them never loads blocks.
+// The rollup is saved to checkpoint with sequence and hash of the last counted block, after restart
+// the blocks up to checkpoint are skipped while the blockchain is read.
+class csstats {
+public:
+    enum Options : cs::Sequence {
+        // stored blocks between checkpoints
+        CheckpointInterval = 1000
+    };
 
-using StatsPerPeriod = std::vector<PeriodStats>;
-using StatsCut = std::deque<PeriodStats>;
-using AllStats = std::pair<StatsCut, StatsPerPeriod>;
+    explicit csstats(BlockChain& blockchain);
+    ~csstats();
 
-enum PeriodIndex {
-    Day = 0,
-    Week,
-    Month,
-    Total,
+    // counts blocks skipped because of damaged checkpoint, call when the blockchain is read
+    void run();
 
-    PeriodsCount
-};
-
-#ifdef NO_FAST_UPDATE
-const uint32_t updateTimeSec = 3;
-#else
-const uint32_t updateTimeSec = 30;
-#endif
-const uint32_t secondsPerDay = 24 * 60 * 60;
-const Periods collectionPeriods = {secondsPerDay, secondsPerDay * 7, secondsPerDay * 30, secondsPerDay * 365 * 100};
+    StatsPerPeriod getStats();
 
-class csstats {
-public:
-    csstats(BlockChain& blockchain);
+public slots:
+    void onStartReadingBlocks(cs::Sequence lastBlockSequence);
+    void onReadBlock(const csdb::Pool& pool, bool* shouldStop);
+    void onStoreBlock(const csdb::Pool& pool);
+    void onRemoveBlock(const csdb::Pool& pool);
 
-    StatsPerPeriod getStats();
+private:
+    BlockStats blockStats(const csdb::Pool& pool);
 
-    ~csstats();
+    // call under mutex only
+    void add(const csdb::Pool& pool);
 
-	void run(const ::csstats::AllStats& allStats);
+    bool loadCheckpoint();
+    void saveCheckpoint();
 
-private:
-    std::thread thread;
+    BlockChain& blockchain;
 
     std::mutex mutex;
     using ScopedLock = std::lock_guard<std::mutex>;
-    std::atomic<bool> quit = {false};
 
-    StatsPerPeriod currentStats;
-    StatsCut statsCut;
+    Rollup rollup;
 
-    std::mutex currentStatsMutex;
-    std::chrono::system_clock::time_point lastUpdateTime = std::chrono::system_clock::from_time_t(0);
+    // the last counted block
+    cs::Sequence lastSequence = 0;
+    csdb::PoolHash lastHash;
+    cs::Sequence lastCheckpointSequence = 0;
 
-    BlockChain& blockchain;
+    // blocks up to checkpoint are already counted
+    bool checkpointPending = false;
+    cs::Sequence checkpointSequence = 0;
+    csdb::PoolHash checkpointHash;
 
-    StatsPerPeriod collectStats(const Periods& periods);
-    //AllStats collectAllStats(const Periods& periods);
-
-    template <class F>
-    void matchPeriod(const Periods& periods, period_t period, F func);
-
-    std::map<std::string, Currency> currencies_indexed = {{"CS", (Currency)1}};
+    // blocks before the sequence should be counted again, checkpoint did not fit to blockchain
+    cs::Sequence recountSequence = 0;
+    std::thread recountThread;
+    std::atomic<bool> quit = {false};
 };
 }  // namespace csstats
 
@@ -30,7 +30,9 @@
 
 #include <csdb/currency.hpp>
 
+#include "contractstatecache.hpp"
 #include "executormanager.hpp"
+#include "executorpool.hpp"
 
 class BlockChain;
 
@@ -133,7 +135,8 @@ public:
     void executeByteCodeMultiple(executor::ExecuteByteCodeMultipleResult& _return, const ::general::Address& initiatorAddress, const executor::SmartContractBinary& invokedContract,
         const std::string& method, const std::vector<std::vector<::general::Variant>>& params, const int64_t executionTime, cs::Sequence sequence);
 
-    void getContractMethods(executor::GetContractMethodsResult& _return, const std::vector<::general::ByteCodeObject>& byteCodeObjects);
+    void getContractMethods(executor::GetContractMethodsResult& _return, const std::vector<::general::ByteCodeObject>& byteCodeObjects,
+        ExecutorPool::Lane lane = ExecutorPool::Lane::Getter);
     void getContractVariables(executor::GetContractVariablesResult& _return, const std::vector<::general::ByteCodeObject>& byteCodeObjects, const std::string& contractState);
 
     void compileSourceCode(executor::CompileSourceCodeResult& _return, const std::string& sourceCode);
@@ -200,6 +203,7 @@ public:
 public slots:
     void onBlockStored(const csdb::Pool& pool);
     void onReadBlock(const csdb::Pool& block);
+    void onContractDataUpdated(const csdb::Address& address);
 
     void onExecutorStarted();
     void onExecutorFinished(int code, const std::error_code&);
@@ -232,19 +236,17 @@ private:
     void disconnect();
     void notifyError();
 
-    using OriginExecutor = executor::ContractExecutorConcurrentClient;
-    using BinaryProtocol = apache::thrift::protocol::TBinaryProtocol;
+    // closes connection failed by call and wakes up watcher
+    void notifyError(ExecutorPool::Connection& connection);
 
-    void recreateOriginExecutor();
+    void logPoolMetrics() const;
+    void logStateCacheMetrics() const;
 
 private:
     const BlockChain& blockchain_;
     const cs::SolverCore& solver_;
 
-    ::apache::thrift::stdcxx::shared_ptr<::apache::thrift::transport::TSocket> socket_;
-    ::apache::thrift::stdcxx::shared_ptr<::apache::thrift::transport::TTransport> executorTransport_;
-
-    std::unique_ptr<executor::ContractExecutorConcurrentClient> origExecutor_;
+    ExecutorPool pool_;
     std::unique_ptr<cs::Process> executorProcess_;
 
     general::AccessID lastAccessId_{};
@@ -252,11 +254,9 @@ private:
     std::map<general::AccessID, uint64_t> executeTrxnsTime;
 
     std::map<csdb::Address, csdb::TransactionID> deployTrxns_;
-    std::map<csdb::Address, std::string> lastState_;
-    std::map<csdb::Address, std::unordered_map<cs::Sequence, std::string>> cacheLastStates_;
+    ContractStateCache stateCache_;
     std::map<general::AccessID, std::vector<csdb::Transaction>> innerSendTransactions_;
 
-    std::shared_mutex sharedErrorMutex_;
     std::shared_mutex mutex_;
     std::atomic_size_t execCount_{0};
 
@@ -265,7 +265,6 @@ private:
 
     const int16_t EXECUTOR_VERSION = 4;
 
-    std::mutex callExecutorLock_;
     std::atomic<bool> isWatcherRunning_ = { false };
 
     cs::ExecutorManager manager_;
@@ -0,0 +1,115 @@
+#ifndef EXECUTORPOOL_HPP
+#define EXECUTORPOOL_HPP
+
+#if defined(_MSC_VER)
+#pragma warning(push, 0)
+#endif
+
+#include <ContractExecutor.h>
+
+#include <thrift/transport/TSocket.h>
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cs {
+// Set of executor connections divided into lanes.
+// Every connection serves one call at a time, lanes never borrow connections from each other,
+// so slow api getters can not delay contract executions consensus waits for.
+class ExecutorPool {
+public:
+    using Client = executor::ContractExecutorConcurrentClient;
+
+    enum class Lane : size_t {
+        Consensus,
+        Getter,
+        Count
+    };
+
+    struct Settings {
+        std::string host;
+        uint16_t port = 0;
+        int sendTimeout = 0;
+        int receiveTimeout = 0;
+        std::array<size_t, static_cast<size_t>(Lane::Count)> connections{};
+    };
+
+    // time is measured in milliseconds
+    struct Metrics {
+        uint64_t calls = 0;
+        size_t waiting = 0;
+        size_t maxWaiting = 0;
+        uint64_t totalWaitTime = 0;
+        uint64_t maxWaitTime = 0;
+        uint64_t totalCallTime = 0;
+        uint64_t maxCallTime = 0;
+    };
+
+    class Connection {
+    public:
+        Connection(Connection&& connection) noexcept;
+        Connection& operator=(Connection&&) = delete;
+        ~Connection();
+
+        Client* operator->() const;
+
+        // opens transport if it was closed by previous error
+        bool open();
+        void close();
+
+        // client sets stop flag forever after NOT_OPEN transport error, replace it with new instance
+        void reset();
+
+    private:
+        struct Item;
+
+        Connection(ExecutorPool* pool, Lane lane, Item* item);
+
+        ExecutorPool* pool_;
+        Lane lane_;
+        Item* item_;
+        std::chrono::steady_clock::time_point start_;
+
+        friend class ExecutorPool;
+    };
+
+    explicit ExecutorPool(const Settings& settings);
+    ~ExecutorPool();
+
+    // blocks while all connections of the lane are busy
+    Connection acquire(Lane lane);
+
+    // opens idle connections, returns true if any connection is open
+    bool connect();
+
+    // closes idle connections, busy ones are closed by their owners on error
+    void disconnect();
+
+    bool isConnected() const;
+
+    Metrics metrics(Lane lane) const;
+
+    static const char* laneName(Lane lane);
+
+private:
+    struct LaneData;
+
+    void release(Lane lane, Connection::Item* item, uint64_t callTime);
+
+    template <typename Func>
+    void forEachIdle(Func func);
+
+    std::array<std::unique_ptr<LaneData>, static_cast<size_t>(Lane::Count)> lanes_;
+};
+}  // namespace cs
+
+#endif  // EXECUTORPOOL_HPP
@@ -0,0 +1,113 @@
+#ifndef STATSROLLUP_HPP
+#define STATSROLLUP_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace csstats {
+
+using period_t = std::chrono::seconds::rep;
+
+using Period = period_t;
+using Periods = std::vector<period_t>;
+
+using Count = uint32_t;
+
+using Integral = int32_t;
+using Fraction = int64_t;
+
+struct Amount {
+    Integral integral = 0;
+    Fraction fraction = 0;
+};
+
+using Balance = Amount;
+using Currency = uint8_t;
+
+struct TotalAmount {
+    int64_t integral = 0;
+    int64_t fraction = 0;
+};
+
+using BalancePerCurrency = std::unordered_map<Currency, TotalAmount>;
+using TimeStamp = std::chrono::system_clock::time_point;
+
+struct PeriodStats {
+    period_t periodSec = 0;
+    Count poolsCount = 0;
+    Count transactionsCount = 0;
+    BalancePerCurrency balancePerCurrency;
+    Count smartContractsCount = 0;
+    Count transactionsSmartCount = 0;
+    TimeStamp timeStamp;
+};
+
+using StatsPerPeriod = std::vector<PeriodStats>;
+
+enum PeriodIndex {
+    Day = 0,
+    Week,
+    Month,
+    Total,
+
+    PeriodsCount
+};
+
+const uint32_t secondsPerDay = 24 * 60 * 60;
+const Periods collectionPeriods = {secondsPerDay, secondsPerDay * 7, secondsPerDay * 30, secondsPerDay * 365 * 100};
+
+// adds amount keeping fraction normalized
+void addAmount(TotalAmount& total, int64_t integral, int64_t fraction);
+
+// contribution of one block to statistics
+struct BlockStats {
+    // block time in seconds
+    period_t time = 0;
+    Count transactionsCount = 0;
+    Count smartContractsCount = 0;
+    Count transactionsSmartCount = 0;
+    BalancePerCurrency balancePerCurrency;
+};
+
+// Statistics of blocks summed up into hour buckets, so any period is computed from at most
+// a month of buckets without loading blocks. Buckets older than the longest period are
+// dropped, the whole chain is kept by the total.
+class Rollup {
+public:
+    enum : period_t {
+        BucketSec = 60 * 60
+    };
+
+    void add(const BlockStats& block, period_t now);
+
+    // reverts add() of the same block
+    void remove(const BlockStats& block);
+
+    // periods longer than a month are taken from the total, shorter ones are rounded up to buckets
+    StatsPerPeriod get(const Periods& periods, period_t now) const;
+
+    void clear();
+    void merge(const Rollup& other, period_t now);
+
+    void serialize(std::ostream& os) const;
+    bool deserialize(std::istream& is);
+
+    size_t bucketsCount() const {
+        return buckets_.size();
+    }
+
+private:
+    void prune(period_t now);
+
+    PeriodStats total_;
+
+    // bucket start time to stats of the bucket
+    std::map<period_t, PeriodStats> buckets_;
+};
+}  // namespace csstats
+
+#endif  // STATSROLLUP_HPP
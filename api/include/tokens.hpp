@@ -84,15 +84,33 @@ public:
     };
 
     void updateTokenChaches(const csdb::Address& addr, const std::string& newState, const TokenInvocationData::Params& params);
-    
+
+    // executor is called without data lock
     void refreshTokenState(const csdb::Address& token, const std::string& newState, bool checkBalance = false);
 
+    // refreshes every known token in background, called when the database is loaded
+    void refreshAllTokens();
+
+    // waits for the running refreshes
+    void stop();
+
 private:
     void initiateHolder(Token&, const csdb::Address& token, const csdb::Address& holder, bool increaseTransfers = false);
 
+    // token state is refreshed once no matter how many times it was changed while waiting
+    void scheduleRefresh(const csdb::Address& token);
+    void refreshRoutine();
+
     api::APIHandler* api_;
 
     std::mutex cvMut_;
+    std::condition_variable refreshCv_;
+    std::set<TokenId> pendingRefresh_;
+    std::set<TokenId> runningRefresh_;
+    std::vector<std::thread> refreshThreads_;
+    // tokens of startup refresh which are not refreshed yet
+    std::set<TokenId> loadingTokens_;
+    bool stopRequested_ = false;
 
     struct DeployTask {
         csdb::Address address;
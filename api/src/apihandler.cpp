@@ -37,31 +37,17 @@ APIHandler::APIHandler(BlockChain& blockchain, cs::SolverCore& _solver, cs::Exec
 : executor_(executor)
 , blockchain_(blockchain)
 , solver_(_solver)
-#ifdef USE_DEPRECATED_STATS //MONITOR_NODE
+#ifdef STATS
 , stats(blockchain)
 #endif
 , tm_(this) {
-#ifdef USE_DEPRECATED_STATS //MONITOR_NODE
-    if (static bool firstTime = true; firstTime) {
-        stats_.second.resize(::csstats::collectionPeriods.size());
-        auto nowGlobal = std::chrono::system_clock::now();
-        auto lastTimePoint = nowGlobal - std::chrono::seconds(::csstats::collectionPeriods[::csstats::PeriodIndex::Month]);
-
-        for (auto time = nowGlobal; time > lastTimePoint; time -= std::chrono::seconds(::csstats::updateTimeSec)) {
-            ::csstats::PeriodStats cut;
-            cut.timeStamp = time;
-            stats_.first.push_back(cut);
-        }
-        firstTime = false;
-    }
-#endif
 }
 
 void APIHandler::run() {
     if (!blockchain_.isGood())
         return;
-#ifdef USE_DEPRECATED_STATS //MONITOR_NODE
-    stats.run(stats_);
+#ifdef STATS
+    stats.run();
 #endif
     state_updater_running.test_and_set(std::memory_order_acquire);
 }
@@ -1059,7 +1045,7 @@ void APIHandler::PoolInfoGet(PoolInfoGetResult& _return, const int64_t sequence,
 }
 
 void APIHandler::StatsGet(api::StatsGetResult& _return) {
-#ifdef USE_DEPRECATED_STATS //MONITOR_NODE
+#ifdef STATS
     csstats::StatsPerPeriod stats_inst = this->stats.getStats();
 
     for (auto& s : stats_inst) {
@@ -1122,23 +1108,35 @@ void APIHandler::SmartContractGet(api::SmartContractGetResult& _return, const ge
 
 void APIHandler::store_block_slot(const csdb::Pool& pool) {
     updateSmartCachesPool(pool);
+
+    newBlockCv_.notify_all();
+
+    std::vector<Waiter<PoolHash>> waiters;
+
+    {
+        std::lock_guard lock(blockWaitersMutex_);
+        waiters.swap(blockWaiters_);
+    }
+
+    if (waiters.empty()) {
+        return;
+    }
+
+    const PoolHash hash = fromByteArray(pool.hash().to_binary());
+
+    for (auto& waiter : waiters) {
+        if (!waiter.owner.expired()) {
+            waiter.done(hash);
+        }
+    }
 }
 
 void APIHandler::baseLoaded(const csdb::Pool& pool) {
     if (maxReadSequence && pool.sequence() == maxReadSequence) {
         isBDLoaded_ = true;
 #ifdef TOKENS_CACHE   
-        tm_.loadTokenInfo([&](const TokensMap& tokens, const HoldersMap&) {
-            int count{}, i{};
-            size_t tokenSize = tokens.size();
-            cslog() << "tokens are loading(" << tokenSize << ")...";
-            for (auto& tk : tokens) {
-                if (tokenSize > 100 && !(i++ % (tokenSize / 10)))
-                    cslog() << "loading tokens: " << 10 * (count++) << "%";
-                tm_.refreshTokenState(tk.first, cs::SmartContracts::get_contract_state(get_s_blockchain(), tk.first), true);
-            }
-            cslog() << "tokens loaded!";
-            });
+        // tokens are refreshed by TokensMaster threads, block storing is not blocked by executor
+        tm_.refreshAllTokens();
 #endif
     }
 }
@@ -1159,93 +1157,6 @@ void APIHandler::onTransactionsRejected(const cs::TransactionsPacket& packet) {
     checkTransactionsFlow(packet, cs::DumbCv::Condition::Rejected);
 }
 
-void APIHandler::collect_all_stats_slot(const csdb::Pool& pool) {
-#ifdef USE_DEPRECATED_STATS
-    const ::csstats::Periods periods = ::csstats::collectionPeriods;
-
-    static unsigned int currentCutIndex = 0;
-    static auto startCutTime = stats_.first[currentCutIndex].timeStamp;
-    static auto endCutTime = stats_.first[currentCutIndex + 1].timeStamp;
-
-    auto now = std::chrono::system_clock::now();
-    auto poolTime_t = atoll(pool.user_field(0).value<std::string>().c_str()) / 1000;
-    auto poolTime = std::chrono::system_clock::from_time_t(poolTime_t);
-
-    using Seconds = std::chrono::seconds;
-    Seconds poolAgeSec = std::chrono::duration_cast<Seconds>(now - poolTime);
-
-    if (startCutTime <= poolTime && poolTime < endCutTime) {
-        ::csstats::PeriodStats& periodStats = stats_.first[currentCutIndex];
-        ++periodStats.poolsCount;
-
-        size_t transactionsCount = pool.transactions_count();
-        periodStats.transactionsCount += static_cast<uint32_t>(transactionsCount);
-
-        for (size_t i = 0; i < transactionsCount; ++i) {
-            const auto& transaction = pool.transaction(csdb::TransactionID(pool.sequence(), i));
-
-#ifdef MONITOR_NODE
-            if (is_smart(transaction) || is_smart_state(transaction))
-                ++periodStats.transactionsSmartCount;
-#endif
-
-            if (is_deploy_transaction(transaction)) {
-                ++periodStats.smartContractsCount;
-            }
-
-            Currency currency = 1;
-
-            const auto& amount = transaction.amount();
-
-            periodStats.balancePerCurrency[cs::Byte(currency)].integral += amount.integral();
-            periodStats.balancePerCurrency[cs::Byte(currency)].fraction += amount.fraction();
-        }
-    }
-    else if ((currentCutIndex + 1) < stats_.first.size()) {
-        startCutTime = stats_.first[currentCutIndex].timeStamp;
-        endCutTime = stats_.first[currentCutIndex + 1].timeStamp;
-        ++currentCutIndex;
-    }
-
-    auto period = csstats::Period(poolAgeSec.count());
-    for (size_t periodIndex = 0; periodIndex < periods.size(); ++periodIndex) {
-        if (period < periods[periodIndex]) {
-            csstats::PeriodStats& periodStats = stats_.second[periodIndex];
-            periodStats.poolsCount++;
-
-            size_t transactionsCount = pool.transactions_count();
-            periodStats.transactionsCount += static_cast<uint32_t>(transactionsCount);
-
-            for (size_t i = 0; i < transactionsCount; ++i) {
-                const auto& transaction = pool.transaction(csdb::TransactionID(pool.sequence(), i));
-
-                if (transaction.source() == blockchain_.getGenesisAddress()) {
-                    continue;
-                }
-#ifdef MONITOR_NODE
-                if (is_smart(transaction) || is_smart_state(transaction)) {
-                    ++periodStats.transactionsSmartCount;
-                }
-#endif
-
-                if (is_deploy_transaction(transaction)) {
-                    ++periodStats.smartContractsCount;
-                }
-
-                //Currency currency = currencies_indexed[transaction.currency().to_string()];
-                Currency currency = 1;
-
-                const auto& amount = transaction.amount();
-
-                periodStats.balancePerCurrency[cs::Byte(currency)].integral += amount.integral();
-                periodStats.balancePerCurrency[cs::Byte(currency)].fraction += amount.fraction();
-            }
-        }
-    }
-#else
-    csunused(pool);
-#endif // USE_DEPRECATED_STATS
-}
 //
 
 bool APIHandler::updateSmartCachesTransaction(csdb::Transaction trxn, cs::Sequence sequence) {
@@ -1375,9 +1286,31 @@ bool APIHandler::updateSmartCachesTransaction(csdb::Transaction trxn, cs::Sequen
                 return (*smartLastTrxn)[target_pk];
             }();
 
-            std::unique_lock lock(e.lock);
-            e.trid_queue.push_back(trxn.id().clone());
-            e.new_trxn_cv.notify_all();
+            decltype(e.waiters) waiters;
+            api::TransactionId id;
+
+            {
+                std::unique_lock lock(e.lock);
+                e.trid_queue.push_back(trxn.id().clone());
+
+                // parked long-polls take the transaction as blocked awaiters do
+                if (!e.waiters.empty()) {
+                    waiters.swap(e.waiters);
+                    id = convert_transaction_id(e.trid_queue.front());
+
+                    if (e.awaiter_num == 0) {
+                        e.trid_queue.pop_front();
+                    }
+                }
+
+                e.new_trxn_cv.notify_all();
+            }
+
+            for (auto& waiter : waiters) {
+                if (!waiter.owner.expired()) {
+                    waiter.done(id);
+                }
+            }
         }
 
         {
@@ -1564,6 +1497,38 @@ void APIHandler::WaitForSmartTransaction(api::TransactionId& _return, const gene
     }
 }
 
+void APIHandler::WaitForSmartTransactionAsync(const general::Address& smart_public, const std::weak_ptr<void>& owner, Continuation<api::TransactionId> done) {
+    csdb::Address key = BlockChain::getAddressFromKey(smart_public);
+    auto& entry = [&]() -> decltype(auto) {
+        auto smartLastTrxn = lockedReference(this->smartLastTrxn_);
+        return (*smartLastTrxn)[key];
+    }();
+
+    std::optional<api::TransactionId> ready;
+
+    {
+        std::unique_lock lock(entry.lock);
+
+        if (!entry.trid_queue.empty()) {
+            ready = convert_transaction_id(entry.trid_queue.front());
+
+            if (entry.awaiter_num == 0) {
+                entry.trid_queue.pop_front();
+            }
+        }
+        else {
+            // waiters of closed connections are not kept
+            entry.waiters.erase(std::remove_if(entry.waiters.begin(), entry.waiters.end(), [](const auto& waiter) { return waiter.owner.expired(); }),
+                                entry.waiters.end());
+            entry.waiters.push_back(Waiter<api::TransactionId>{owner, std::move(done)});
+        }
+    }
+
+    if (ready) {
+        done(*ready);
+    }
+}
+
 void APIHandler::SmartContractsAllListGet(SmartContractsListGetResult& _return, const int64_t _offset, const int64_t _limit) {
     auto offset = _offset;
     auto limit = limitPage(_limit);
@@ -1590,6 +1555,14 @@ void api::APIHandler::WaitForBlock(PoolHash& _return, const PoolHash& /* obsolet
     _return = fromByteArray(blockchain_.getLastHash().to_binary());
 }
 
+void api::APIHandler::WaitForBlockAsync(const std::weak_ptr<void>& owner, Continuation<PoolHash> done) {
+    std::lock_guard lock(blockWaitersMutex_);
+
+    blockWaiters_.erase(std::remove_if(blockWaiters_.begin(), blockWaiters_.end(), [](const auto& waiter) { return waiter.owner.expired(); }),
+                        blockWaiters_.end());
+    blockWaiters_.push_back(Waiter<PoolHash>{owner, std::move(done)});
+}
+
 void APIHandler::TransactionsStateGet(TransactionsStateGetResult& _return, const general::Address& address, const std::vector<int64_t>& v) {
     csunused(v);
     csunused(address);
@@ -1943,6 +1916,19 @@ void APIHandler::TransactionsListGet(api::TransactionsGetResult& _return, int64_
     _return.result = false;
     _return.total_trxns_count = static_cast<int32_t>(blockchain_.getTransactionsCount());
 
+    // ordinals index gives the page without walking through previous blocks,
+    // offset is counted from the index own count as it may lag behind the chain
+    BlockChain::Transactions transactions;
+    uint64_t cursor = blockchain_.getIndexedTransactionsCount();
+    cursor -= std::min<uint64_t>(cursor, static_cast<uint64_t>(offset));
+
+    if (blockchain_.getTransactionsPage(transactions, cursor, static_cast<uint64_t>(limit))) {
+        _return.transactions = convertTransactions(transactions);
+        _return.result = !transactions.empty();
+        SetResponseStatus(_return.status, APIRequestStatusType::SUCCESS);
+        return;
+    }
+
     auto tPair = blockchain_.getLastNonEmptyBlock();
     while (limit > 0 && tPair.second) {
         if (tPair.second <= offset) {
@@ -2205,43 +2191,6 @@ void APIHandler::TokensListGet(api::TokensListResult& _return, int64_t offset, i
 }
 
 //////////Wallets
-#ifndef MONITOR_NODE
-typedef std::list<std::pair<const cs::PublicKey*, const cs::WalletsCache::WalletData*>> WCSortedList;
-template <typename T>
-void walletStep(const cs::PublicKey* addr, const cs::WalletsCache::WalletData* wd, const uint64_t num,
-                std::function<const T&(const cs::WalletsCache::WalletData&)> getter, std::function<bool(const T&, const T&)> comparator, WCSortedList& lst) {
-    assert(num > 0);
-
-    const T& val = getter(*wd);
-    if (lst.size() < num || comparator(val, getter(*(lst.back().second)))) {
-        // Guess why I can't use std::upper_bound in here
-        // C++ is not as expressive as I've imagined it to be...
-        auto it = lst.begin();
-        while (it != lst.end() && !comparator(val, getter(*(it->second)))) {/* <-- this looks more like Lisp, doesn't it... */
-            ++it;
-        }
-
-        lst.insert(it, std::make_pair(addr, wd));
-        if (lst.size() > num) {
-            lst.pop_back();
-        }
-    }
-}
-
-template <typename T>
-void iterateOverWallets(std::function<const T&(const cs::WalletsCache::WalletData&)> getter, const uint64_t num, const bool desc, WCSortedList& lst, BlockChain& bc) {
-    using Comparer = std::function<bool(const T&, const T&)>;
-    Comparer comparator = desc ? Comparer(std::greater<T>()) : Comparer(std::less<T>());
-
-    bc.iterateOverWallets([&lst, num, getter, comparator](const cs::PublicKey& addr, const cs::WalletsCache::WalletData& wd) {
-        if (!addr.empty() && wd.balance_ >= csdb::Amount(0)) {
-            walletStep(&addr, &wd, num, getter, comparator, lst);
-        }
-        return true;
-    });
-}
-#endif
-
 void APIHandler::WalletsGet(WalletsGetResult& _return, int64_t _offset, int64_t _limit, int8_t _ordCol, bool _desc) {
     if (!validatePagination(_return, *this, _offset, _limit)) {
         return;
@@ -2249,31 +2198,6 @@ void APIHandler::WalletsGet(WalletsGetResult& _return, int64_t _offset, int64_t
 
     SetResponseStatus(_return.status, APIRequestStatusType::SUCCESS);
 
-#ifndef MONITOR_NODE
-    WCSortedList lst;
-    const uint64_t num = static_cast<uint64_t>(_offset + _limit);
-
-    if (_ordCol == 0) {  // Balance
-        iterateOverWallets<csdb::Amount>([](const cs::WalletsCache::WalletData& wd) -> const csdb::Amount& { return wd.balance_; }, num, _desc, lst, blockchain_);
-    }
-
-    if (lst.size() < static_cast<uint64_t>(_offset)) {
-        return;
-    }
-
-    auto ptr = lst.begin();
-    std::advance(ptr, _offset);
-
-    for (; ptr != lst.end(); ++ptr) {
-        api::WalletInfo wi;
-        const cs::Bytes addr_b((*(ptr->first)).begin(), (*(ptr->first)).end());
-        wi.address = fromByteArray(addr_b);
-        wi.balance.integral = ptr->second->balance_.integral();
-        wi.balance.fraction = static_cast<int64_t>(ptr->second->balance_.fraction());
-
-        _return.wallets.push_back(wi);
-    }
-#else
     const auto& multiWallets = blockchain_.multiWallets();
     auto order = _desc ? cs::MultiWallets::Order::Greater : cs::MultiWallets::Order::Less;
     std::vector<cs::MultiWallets::InternalData> result;
@@ -2282,7 +2206,9 @@ void APIHandler::WalletsGet(WalletsGetResult& _return, int64_t _offset, int64_t
         result = multiWallets.iterate<cs::MultiWallets::ByBalance>(_offset, _limit, order);
     }
     else if (_ordCol == 1) {  // Create time
+#ifdef MONITOR_NODE
         result = multiWallets.iterate<cs::MultiWallets::ByCreateTime>(_offset, _limit, order);
+#endif
     }
     else {  // Transactions count
         result = multiWallets.iterate<cs::MultiWallets::ByTransactionsCount>(_offset, _limit, order);
@@ -2295,14 +2221,15 @@ void APIHandler::WalletsGet(WalletsGetResult& _return, int64_t _offset, int64_t
         wi.balance.integral = data.balance.integral();
         wi.balance.fraction = static_cast<int64_t>(data.balance.fraction());
         wi.transactionsNumber = static_cast<int64_t>(data.transactionsCount);
+#ifdef MONITOR_NODE
         wi.firstTransactionTime = static_cast<int64_t>(data.createTime);
+#endif
 
         _return.wallets.push_back(wi);
     }
 
-#endif
-
-    _return.count = static_cast<int32_t>(blockchain_.getWalletsCountWithBalance());
+    // the same wallets as listed ones
+    _return.count = static_cast<int32_t>(multiWallets.size());
 }
 
 void APIHandler::TrustedGet(TrustedGetResult& _return, int32_t _page) {
@@ -0,0 +1,210 @@
+#include <contractstatecache.hpp>
+
+#include <algorithm>
+
+#include <lib/system/hash.hpp>
+
+cs::ContractStateCache::ContractStateCache(size_t capacity)
+: capacity_(capacity) {
+}
+
+std::optional<std::string> cs::ContractStateCache::latest(const csdb::Address& address) {
+    std::lock_guard lock(mutex_);
+
+    if (auto addressIter = entries_.find(address); addressIter != entries_.end()) {
+        if (auto iter = addressIter->second.find(kLatest); iter != addressIter->second.end()) {
+            ++metrics_.hits;
+            touch(iter->second);
+            return std::make_optional(iter->second.blob->second.data);
+        }
+    }
+
+    ++metrics_.misses;
+    return std::nullopt;
+}
+
+void cs::ContractStateCache::setLatest(const csdb::Address& address, const std::string& state) {
+    std::lock_guard lock(mutex_);
+
+    ++version_;
+    insert(address, kLatest, state);
+}
+
+void cs::ContractStateCache::fillLatest(const csdb::Address& address, const std::string& state, uint64_t version) {
+    std::lock_guard lock(mutex_);
+
+    if (version == version_) {
+        insert(address, kLatest, state);
+    }
+}
+
+uint64_t cs::ContractStateCache::version() const {
+    std::lock_guard lock(mutex_);
+    return version_;
+}
+
+void cs::ContractStateCache::invalidate(const csdb::Address& address) {
+    std::lock_guard lock(mutex_);
+
+    ++version_;
+
+    if (auto addressIter = entries_.find(address); addressIter != entries_.end()) {
+        if (auto iter = addressIter->second.find(kLatest); iter != addressIter->second.end()) {
+            erase(addressIter->second, iter);
+            eraseIfEmpty(addressIter);
+        }
+    }
+}
+
+void cs::ContractStateCache::addHistory(const csdb::Address& address, cs::Sequence sequence, const std::string& state) {
+    std::lock_guard lock(mutex_);
+    insert(address, sequence, state);
+}
+
+cs::ContractStateCache::HistoryResult cs::ContractStateCache::history(const csdb::Address& address, cs::Sequence sequence, std::string& state) {
+    std::lock_guard lock(mutex_);
+
+    // history of address is evicted entirely, so the rest of it is newer than evicted sequence
+    bool isChangedAfter = false;
+
+    if (auto iter = evicted_.find(address); iter != evicted_.end()) {
+        isChangedAfter = iter->second > sequence;
+    }
+
+    if (auto addressIter = entries_.find(address); addressIter != entries_.end()) {
+        auto& items = addressIter->second;
+        auto iter = items.upper_bound(sequence);
+
+        if (iter != items.end() && iter->first != kLatest) {
+            isChangedAfter = true;
+        }
+
+        if (iter != items.begin() && (--iter)->first != kLatest) {
+            ++metrics_.hits;
+            touch(iter->second);
+            state = iter->second.blob->second.data;
+            return HistoryResult::Found;
+        }
+    }
+
+    return isChangedAfter ? HistoryResult::Unknown : HistoryResult::Latest;
+}
+
+void cs::ContractStateCache::clearHistory() {
+    std::lock_guard lock(mutex_);
+
+    evicted_.clear();
+
+    for (auto addressIter = entries_.begin(); historyEntries_ != 0 && addressIter != entries_.end();) {
+        auto& items = addressIter->second;
+
+        while (!items.empty() && items.begin()->first != kLatest) {
+            erase(items, items.begin());
+        }
+
+        eraseIfEmpty(addressIter++);
+    }
+}
+
+cs::ContractStateCache::Metrics cs::ContractStateCache::metrics() const {
+    std::lock_guard lock(mutex_);
+
+    Metrics metrics = metrics_;
+    metrics.bytes = bytes_;
+    metrics.capacity = capacity_;
+    metrics.entries = usage_.size();
+    metrics.states = blobs_.size();
+
+    return metrics;
+}
+
+void cs::ContractStateCache::insert(const csdb::Address& address, cs::Sequence sequence, const std::string& state) {
+    const auto hash = generateHash(state.data(), state.size());
+
+    if (auto addressIter = entries_.find(address); addressIter != entries_.end()) {
+        if (auto iter = addressIter->second.find(sequence); iter != addressIter->second.end()) {
+            if (iter->second.blob->first == hash) {
+                touch(iter->second);
+                return;
+            }
+
+            erase(addressIter->second, iter);
+            eraseIfEmpty(addressIter);
+        }
+    }
+
+    if (state.size() + kEntryOverhead > capacity_) {
+        return;
+    }
+
+    auto [blob, isNew] = blobs_.try_emplace(hash);
+
+    if (isNew) {
+        blob->second.data = state;
+        bytes_ += state.size();
+    }
+
+    ++blob->second.refs;
+    bytes_ += kEntryOverhead;
+
+    usage_.emplace_front(address, sequence);
+    entries_[address].emplace(sequence, Entry{blob, usage_.begin()});
+
+    if (sequence != kLatest) {
+        ++historyEntries_;
+    }
+
+    evict();
+}
+
+void cs::ContractStateCache::erase(Entries& entries, Entries::iterator entry) {
+    auto blob = entry->second.blob;
+
+    if (--blob->second.refs == 0) {
+        bytes_ -= blob->second.data.size();
+        blobs_.erase(blob);
+    }
+
+    if (entry->first != kLatest) {
+        --historyEntries_;
+    }
+
+    bytes_ -= kEntryOverhead;
+    usage_.erase(entry->second.usage);
+    entries.erase(entry);
+}
+
+void cs::ContractStateCache::eraseIfEmpty(std::map<csdb::Address, Entries>::iterator address) {
+    if (address->second.empty()) {
+        entries_.erase(address);
+    }
+}
+
+void cs::ContractStateCache::touch(Entry& entry) {
+    usage_.splice(usage_.begin(), usage_, entry.usage);
+}
+
+void cs::ContractStateCache::evict() {
+    while (bytes_ > capacity_ && !usage_.empty()) {
+        const auto [address, sequence] = usage_.back();
+        auto addressIter = entries_.find(address);
+        auto& items = addressIter->second;
+
+        if (sequence == kLatest) {
+            erase(items, items.find(kLatest));
+            ++metrics_.evictions;
+        }
+        else {
+            // the gap in history would return wrong state, evict the whole history of contract
+            auto& newest = evicted_[address];
+
+            while (!items.empty() && items.begin()->first != kLatest) {
+                newest = std::max(newest, items.begin()->first);
+                ++metrics_.evictions;
+                erase(items, items.begin());
+            }
+        }
+
+        eraseIfEmpty(addressIter);
+    }
+}
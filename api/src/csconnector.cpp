@@ -14,6 +14,7 @@
 #endif  // _MSC_VER
 
 #include "csconnector/csconnector.hpp"
+#include "csconnector/thriftcodec.hpp"
 
 #include <csnode/configholder.hpp>
 #include <csnode/transactionspacket.hpp>
@@ -32,6 +33,79 @@ constexpr const int32_t kContainerLimit = 16 * 1024; // max allowed items in any
 constexpr const bool kStrictRead = false; // use default Thrift value
 constexpr const bool kStrictWrite = true; // use default Thrift value
 
+namespace {
+#ifdef __linux__
+// public and ajax api on event loop, long-polls of blocks and smart transactions are parked in api handler
+std::unique_ptr<EventServer> makeEventServer(const connector::ApiHandlerPtr& handler, shared_ptr<::apache::thrift::TProcessor> processor,
+                                             shared_ptr<TProtocolFactory> protocolFactory, ThriftCodec::Transport transport, uint16_t port,
+                                             int receiveTimeout) {
+    const auto& apiSettings = cs::ConfigHolder::instance().config()->getApiSettings();
+
+    if (!apiSettings.eventServer) {
+        return nullptr;
+    }
+
+    auto codec = std::make_shared<ThriftCodec>(std::move(processor), std::move(protocolFactory), transport);
+
+    codec->addLongPoll("WaitForBlock", [handler](TProtocol* input, const std::weak_ptr<void>& owner, ThriftCodec::Completion done) {
+        api::API_WaitForBlock_args args;
+        args.read(input);
+
+        handler->WaitForBlockAsync(owner, [done = std::move(done)](const api::PoolHash& hash) {
+            done([&hash](TProtocol* output) {
+                api::API_WaitForBlock_result result;
+                result.success = hash;
+                result.__isset.success = true;
+                result.write(output);
+            });
+        });
+    });
+
+    codec->addLongPoll("WaitForSmartTransaction", [handler](TProtocol* input, const std::weak_ptr<void>& owner, ThriftCodec::Completion done) {
+        api::API_WaitForSmartTransaction_args args;
+        args.read(input);
+
+        handler->WaitForSmartTransactionAsync(args.smart_public, owner, [done = std::move(done)](const api::TransactionId& id) {
+            done([&id](TProtocol* output) {
+                api::API_WaitForSmartTransaction_result result;
+                result.success = id;
+                result.__isset.success = true;
+                result.write(output);
+            });
+        });
+    });
+
+    // smart contract transaction waits for its execution in queue
+    codec->addBlocking("TransactionFlow");
+
+    EventServer::Settings settings;
+    settings.port = port;
+    settings.workers = static_cast<size_t>(std::max(apiSettings.serverWorkers, 1));
+    settings.maxConnections = static_cast<size_t>(std::max(apiSettings.serverMaxConnections, 1));
+    settings.idleTimeout = std::chrono::milliseconds(std::max(receiveTimeout, 0));
+
+    return std::make_unique<EventServer>(std::move(codec), settings);
+}
+
+bool listenEventServer(std::unique_ptr<EventServer>& eventServer) {
+    if (!eventServer) {
+        return false;
+    }
+
+    try {
+        eventServer->listen();
+        return true;
+    }
+    catch (const std::exception& e) {
+        cswarning() << "API event server is not started, thread per connection is used: " << e.what();
+    }
+
+    eventServer.reset();
+    return false;
+}
+#endif
+}  // namespace
+
 connector::connector(BlockChain& m_blockchain, cs::SolverCore* solver)
 : executor_(cs::Executor::instance())
 , api_handler(make_shared<api::APIHandler>(m_blockchain, *solver, executor_))
@@ -77,10 +151,18 @@ connector::connector(BlockChain& m_blockchain, cs::SolverCore* solver)
 
 #ifdef BINARY_TCP_API
     server_port = uint16_t(cs::ConfigHolder::instance().config()->getApiSettings().port);
+#ifdef __linux__
+    event_server = makeEventServer(api_handler, p_api_processor, make_shared<TBinaryProtocolFactory>(kStringLimit, kContainerLimit, kStrictRead, kStrictWrite),
+                                   ThriftCodec::Transport::Buffered, server_port, cs::ConfigHolder::instance().config()->getApiSettings().serverReceiveTimeout);
+#endif
 #endif
 
 #ifdef AJAX_IFACE
     ajax_server_port = uint16_t(cs::ConfigHolder::instance().config()->getApiSettings().ajaxPort);
+#ifdef __linux__
+    ajax_event_server = makeEventServer(api_handler, p_api_processor, make_shared<TJSONProtocolFactory>(), ThriftCodec::Transport::Http, ajax_server_port,
+                                        cs::ConfigHolder::instance().config()->getApiSettings().ajaxServerReceiveTimeout);
+#endif
 #endif
 }
 
@@ -88,9 +170,17 @@ void connector::run() {
 
 #ifdef BINARY_TCP_API
     cslog() << "Starting public API on port " << server_port;
+#ifdef __linux__
+    listenEventServer(event_server);
+#endif
     thread = std::thread([this]() {
         try {
-            server.run();
+            if (event_server) {
+                event_server->serve();
+            }
+            else {
+                server.run();
+            }
         }
         catch (...) {
             cserror() << "Oh no! I'm dead :'-(";
@@ -101,9 +191,17 @@ void connector::run() {
 #ifdef AJAX_IFACE
     cslog() << "Starting AJAX server on port " << ajax_server_port;
     ajax_server.setConcurrentClientLimit(AJAX_CONCURRENT_API_CLIENTS);
+#ifdef __linux__
+    listenEventServer(ajax_event_server);
+#endif
     ajax_thread = std::thread([this]() {
         try {
-            ajax_server.run();
+            if (ajax_event_server) {
+                ajax_event_server->serve();
+            }
+            else {
+                ajax_server.run();
+            }
         }
         catch (...) {
             cserror() << "Oh no! I'm dead in AJAX :'-(";
@@ -116,6 +214,9 @@ void connector::run() {
 
 connector::~connector() {
 #ifdef BINARY_TCP_API
+    if (event_server) {
+        event_server->stop();
+    }
     server.stop();
     if (thread.joinable()) {
         thread.join();
@@ -130,6 +231,9 @@ connector::~connector() {
 #endif
 
 #ifdef AJAX_IFACE
+    if (ajax_event_server) {
+        ajax_event_server->stop();
+    }
     ajax_server.stop();
     if (ajax_thread.joinable()) {
         ajax_thread.join();
@@ -1,349 +1,316 @@
 #include "stdafx.h"
 
-#include <algorithm>
 #include <apihandler.hpp>
-#include <cassert>
 #include <client/params.hpp>
-#include <csdb/currency.hpp>
 #include <csstats.hpp>
 
-namespace csstats {
+#include <fstream>
+#include <sstream>
 
-template <class F>
-void csstats::matchPeriod(const Periods& periods, period_t period, F func) {
-    for (size_t i = 0; i < periods.size(); ++i) {
-        if (period < periods[i]) {
-            func(i);
-        }
-    }
-}
+#include <boost/filesystem.hpp>
 
-StatsPerPeriod csstats::collectStats(const Periods& periods) {
-    assert(std::is_sorted(std::begin(periods), std::end(periods), [](const Period& l, const Period& r) { return l < r; }));
+#include <cscrypto/cscrypto.hpp>
 
-    cstrace() << " Collecting stats: started";
+#include <lib/system/logger.hpp>
 
-    auto stats = currentStats;
-    auto startTime = std::chrono::high_resolution_clock::now();
-    auto blockHash = blockchain.getLastHash();
+namespace fs = boost::filesystem;
 
-	static auto lastHash = blockHash;
+namespace {
+const char* kCheckpointPath = "./caches/stats.checkpoint";
+const char* kTemporaryExtension = ".tmp";
 
-    PeriodStats periodStats;
-    periodStats.timeStamp = std::chrono::system_clock::now();
+constexpr uint32_t kMagic = 0x53545343;  // CSTS
+constexpr uint32_t kVersion = 1;
 
-    {
-        auto future_last_hash = blockHash;
+// sizes are limited to protect from reading of garbage
+constexpr uint32_t kMaxHashSize = 1024;
+constexpr uint64_t kMaxDataSize = 64 * 1024 * 1024;
 
-        if (blockHash.is_empty()) {
-            cserror() << "Stats: no bricks in the wall (last hash is empty)";
-        }
+template <typename T>
+void write(std::ostream& os, const T& value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
 
-        while (blockHash != lastHash && !blockHash.is_empty()) {
-            csdb::Pool pool = blockchain.loadBlock(blockHash);
-            periodStats.poolsCount++;
-            std::size_t transactionsCount = pool.transactions_count();
-            periodStats.transactionsCount += static_cast<uint32_t>(transactionsCount);
+template <typename T>
+bool read(std::istream& is, T& value) {
+    return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
 
-            for (std::size_t i = 0; i < transactionsCount; ++i) {
-                const auto& transaction = pool.transaction(csdb::TransactionID(pool.sequence(), i));
-#ifdef MONITOR_NODE
-                if (is_smart(transaction) || is_smart_state(transaction))
-                    ++periodStats.transactionsSmartCount;
-#endif
-                if (is_deploy_transaction(transaction))
-                    ++periodStats.smartContractsCount;
+csstats::period_t now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+}  // namespace
 
-                Currency currency = currencies_indexed[transaction.currency().to_string()];
-                const auto& amount = transaction.amount();
-                periodStats.balancePerCurrency[currency].integral += amount.integral();
-                periodStats.balancePerCurrency[currency].fraction += amount.fraction();
-            }
-            blockHash = pool.previous_hash();
-        }
-        lastHash = future_last_hash;
+namespace csstats {
+
+csstats::csstats(BlockChain& blockchain)
+: blockchain(blockchain) {
+    checkpointPending = loadCheckpoint();
+
+    cs::Connector::connect(&blockchain.startReadingBlocksEvent(), this, &csstats::onStartReadingBlocks);
+    cs::Connector::connect(&blockchain.readBlockEvent(), this, &csstats::onReadBlock);
+    cs::Connector::connect(&blockchain.storeBlockEvent, this, &csstats::onStoreBlock);
+    cs::Connector::connect(&blockchain.removeBlockEvent, this, &csstats::onRemoveBlock);
+}
+
+csstats::~csstats() {
+    cstrace() << "STATS> csstats stop";
+
+    quit = true;
+
+    if (recountThread.joinable()) {
+        recountThread.join();
     }
 
-    // total
-    auto& total = stats[PeriodIndex::Total];
-    total.poolsCount += periodStats.poolsCount;
-    total.transactionsCount += periodStats.transactionsCount;
-    total.smartContractsCount += periodStats.smartContractsCount;
-    total.transactionsSmartCount += periodStats.transactionsSmartCount;
+    ScopedLock lock(mutex);
 
-    for (auto& element : periodStats.balancePerCurrency) {
-        total.balancePerCurrency[element.first].integral += element.second.integral;
-        total.balancePerCurrency[element.first].fraction += element.second.fraction;
+    if (recountSequence == 0 && !checkpointPending && lastSequence != lastCheckpointSequence) {
+        saveCheckpoint();
     }
+}
 
-    for (size_t i = 0; i < periods.size(); ++i) {
-        assert(updateTimeSec != 0);
+void csstats::run() {
+    ScopedLock lock(mutex);
 
-        std::size_t index = (periods[i] / updateTimeSec) - 1;
+    if (recountSequence == 0 || recountThread.joinable()) {
+        return;
+    }
 
-        try {
-            auto& lastPeriodStats = statsCut.at(index);
-            auto& stat = stats.at(i);
+    recountThread = std::thread([this, sequence = recountSequence]() {
+        cslog() << "STATS> counting blocks before #" << WithDelimiters(sequence);
 
-            // remove last stats
-            stat.poolsCount -= lastPeriodStats.poolsCount;
-            stat.smartContractsCount -= lastPeriodStats.smartContractsCount;
-            stat.transactionsCount -= lastPeriodStats.transactionsCount;
-            stat.transactionsSmartCount -= lastPeriodStats.transactionsSmartCount;
+        Rollup recounted;
 
-            for (auto& element : lastPeriodStats.balancePerCurrency) {
-                stat.balancePerCurrency[element.first].integral -= element.second.integral;
-                stat.balancePerCurrency[element.first].fraction -= element.second.fraction;
+        for (cs::Sequence seq = 0; seq < sequence; ++seq) {
+            if (quit) {
+                return;
             }
 
-            // add new stats
-            stat.poolsCount += periodStats.poolsCount;
-            stat.smartContractsCount += periodStats.smartContractsCount;
-            stat.transactionsCount += periodStats.transactionsCount;
-            stat.transactionsSmartCount += periodStats.transactionsSmartCount;
+            const csdb::Pool pool = blockchain.loadBlock(seq);
 
-            for (auto& element : periodStats.balancePerCurrency) {
-                stat.balancePerCurrency[element.first].integral += element.second.integral;
-                stat.balancePerCurrency[element.first].fraction += element.second.fraction;
+            if (pool.is_valid()) {
+                recounted.add(blockStats(pool), now());
             }
         }
-        catch (const std::exception& e) {
-            cslog() << "STATS> " << e.what();
-        }
-    }
 
-    // update cuts
-    statsCut.push_front(periodStats);
-    statsCut.pop_back();
+        ScopedLock lock(mutex);
 
-    auto finishTime = std::chrono::high_resolution_clock::now();
+        rollup.merge(recounted, now());
+        recountSequence = 0;
+        saveCheckpoint();
 
-    using Seconds = std::chrono::seconds;
-    Seconds seconds = std::chrono::duration_cast<Seconds>(finishTime - startTime);
-
-    cstrace() << "STATS> Collecting stats: finished (took " << seconds.count() << "s";
-    cslog() << "STATS> Stats updated";
+        cslog() << "STATS> blocks before #" << WithDelimiters(sequence) << " are counted";
+    });
+}
 
-    return stats;
+StatsPerPeriod csstats::getStats() {
+    ScopedLock lock(mutex);
+    return rollup.get(collectionPeriods, now());
 }
 
-/*AllStats csstats::collectAllStats(const Periods& periods) {
-    assert(std::is_sorted(std::begin(periods), std::end(periods), [](const Period& l, const Period& r) { return l < r; }));
+void csstats::onStartReadingBlocks(cs::Sequence lastBlockSequence) {
+    ScopedLock lock(mutex);
 
-    cstrace() << "STATS>  Collecting All stats: started";
+    if (checkpointPending && checkpointSequence > lastBlockSequence) {
+        cslog() << "STATS> checkpoint of block #" << WithDelimiters(checkpointSequence) << " is ahead of blockchain, count all blocks";
+        checkpointPending = false;
+        rollup.clear();
+    }
+}
 
-    AllStats stats;
-    stats.second.resize(periods.size());
+void csstats::onReadBlock(const csdb::Pool& pool, bool* shouldStop) {
+    if (*shouldStop) {
+        return;
+    }
 
-    auto nowGlobal = std::chrono::system_clock::now();
-    auto lastTimePoint = nowGlobal - std::chrono::seconds(collectionPeriods[PeriodIndex::Month]);
+    ScopedLock lock(mutex);
 
-    for (auto time = nowGlobal; time > lastTimePoint; time -= std::chrono::seconds(updateTimeSec)) {
-        PeriodStats cut;
-        cut.timeStamp = time;
+    if (checkpointPending) {
+        if (pool.sequence() < checkpointSequence) {
+            return;
+        }
 
-        stats.first.push_back(cut);
-    }
+        checkpointPending = false;
 
-    auto startTime = std::chrono::system_clock::now();
-    auto blockHash = blockchain.getLastHash();
-    unsigned int currentCutIndex = 0;
-    auto startCutTime = stats.first[currentCutIndex].timeStamp;
-    auto endCutTime = stats.first[currentCutIndex + 1].timeStamp;
+        if (pool.sequence() == checkpointSequence && pool.hash() == checkpointHash) {
+            lastSequence = pool.sequence();
+            lastHash = pool.hash().clone();
+            lastCheckpointSequence = lastSequence;
+            cslog() << "STATS> restored from checkpoint of block #" << WithDelimiters(lastSequence);
+            return;
+        }
 
-    auto future_lastHash = blockchain.getLastHash();
+        cswarning() << "STATS> checkpoint of block #" << WithDelimiters(checkpointSequence) << " does not fit to blockchain, count all blocks";
+        rollup.clear();
 
-    static bool log_to_console = true;
-    size_t cnt = 0;
-    if (log_to_console) {
-        std::cout << "STATS> analizing blockchain...\n";
+        recountSequence = pool.sequence();
     }
 
-    while (!blockHash.is_empty() && !quit) {
-        const csdb::Pool pool = blockchain.loadBlock(blockHash);
-
-        auto now = std::chrono::system_clock::now();
-        auto poolTime_t = atoll(pool.user_field(0).value<std::string>().c_str()) / 1000;
-        auto poolTime = std::chrono::system_clock::from_time_t(poolTime_t);
-
-        using Seconds = std::chrono::seconds;
-        Seconds poolAgeSec = std::chrono::duration_cast<Seconds>(now - poolTime);
+    add(pool);
+}
 
-        if (startCutTime <= poolTime && poolTime < endCutTime) {
-            PeriodStats& periodStats = stats.first[currentCutIndex];
-            ++periodStats.poolsCount;
+void csstats::onStoreBlock(const csdb::Pool& pool) {
+    ScopedLock lock(mutex);
 
-            size_t transactionsCount = pool.transactions_count();
-            periodStats.transactionsCount += (uint32_t)transactionsCount;
+    if (checkpointPending) {
+        // blockchain was read only partially
+        checkpointPending = false;
+        rollup.clear();
 
-            for (size_t i = 0; i < transactionsCount; ++i) {
-                const auto& transaction = pool.transaction(csdb::TransactionID(pool.hash(), i));
+        recountSequence = pool.sequence();
+    }
 
-#ifdef MONITOR_NODE
-                if (is_smart(transaction) || is_smart_state(transaction))
-                    ++periodStats.transactionsSmartCount;
-#endif
+    if (!lastHash.is_empty() && pool.sequence() <= lastSequence) {
+        return;
+    }
 
-                if (is_deploy_transaction(transaction))
-                    ++periodStats.smartContractsCount;
+    add(pool);
 
-                Currency currency = currencies_indexed[transaction.currency().to_string()];
+    if (recountSequence == 0 && lastSequence >= lastCheckpointSequence + CheckpointInterval) {
+        saveCheckpoint();
+    }
+}
 
-                const auto& amount = transaction.amount();
+void csstats::onRemoveBlock(const csdb::Pool& pool) {
+    ScopedLock lock(mutex);
 
-                periodStats.balancePerCurrency[currency].integral += amount.integral();
-                periodStats.balancePerCurrency[currency].fraction += amount.fraction();
-            }
-        }
-        else if ((currentCutIndex + 1) < stats.first.size()) {
-            startCutTime = stats.first[currentCutIndex].timeStamp;
-            endCutTime = stats.first[currentCutIndex + 1].timeStamp;
+    if (lastHash.is_empty() || pool.sequence() != lastSequence) {
+        return;
+    }
 
-            ++currentCutIndex;
-            continue;
-        }
+    rollup.remove(blockStats(pool));
 
-        matchPeriod(periods, (Period)poolAgeSec.count(), [&](size_t periodIndex) {
-            PeriodStats& periodStats = stats.second[periodIndex];
-            periodStats.poolsCount++;
+    lastSequence = pool.sequence() - 1;
+    lastHash = pool.previous_hash().clone();
 
-            size_t transactionsCount = pool.transactions_count();
-            periodStats.transactionsCount += (uint32_t)transactionsCount;
+    // checkpoint of removed block would not fit to blockchain
+    if (recountSequence == 0 && lastCheckpointSequence > lastSequence) {
+        saveCheckpoint();
+    }
+}
 
-            for (size_t i = 0; i < transactionsCount; ++i) {
-                const auto& transaction = pool.transaction(csdb::TransactionID(pool.hash(), i));
+BlockStats csstats::blockStats(const csdb::Pool& pool) {
+    BlockStats stats;
+    stats.time = static_cast<period_t>(pool.get_time() / 1000);
+    stats.transactionsCount = static_cast<Count>(pool.transactions_count());
 
-                if (transaction.source() == blockchain.getGenesisAddress())
-                    continue;
+    for (const auto& transaction : pool.transactions()) {
+        if (transaction.source() == blockchain.getGenesisAddress()) {
+            continue;
+        }
 #ifdef MONITOR_NODE
-                if (is_smart(transaction) || is_smart_state(transaction))
-                    ++periodStats.transactionsSmartCount;
+        if (is_smart(transaction) || is_smart_state(transaction)) {
+            ++stats.transactionsSmartCount;
+        }
 #endif
-
-                if (is_deploy_transaction(transaction))
-                    ++periodStats.smartContractsCount;
-
-                Currency currency = currencies_indexed[transaction.currency().to_string()];
-
-                const auto& amount = transaction.amount();
-
-                periodStats.balancePerCurrency[currency].integral += amount.integral();
-                periodStats.balancePerCurrency[currency].fraction += amount.fraction();
-            }
-        });
-
-        blockHash = pool.previous_hash();
-
-        ++cnt;
-        if (log_to_console && (cnt % 1000) == 0) {
-            std::cout << '\r' << WithDelimiters(cnt);
+        if (is_deploy_transaction(transaction)) {
+            ++stats.smartContractsCount;
         }
-    }
 
-    if (log_to_console) {
-        std::cout << '\r' << WithDelimiters(cnt) << "... Done\n";
-        log_to_console = false;
+        const auto& amount = transaction.amount();
+        addAmount(stats.balancePerCurrency[Currency(DEFAULT_CURRENCY)], amount.integral(), static_cast<int64_t>(amount.fraction()));
     }
 
-    // lastHash = blockchain.getLastHash();
-    lastHash = future_lastHash;
-
-    auto finishTime = std::chrono::system_clock::now();
-    auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(finishTime - startTime);
-
-    cstrace() << "Collecting All stats: finished (took " << milliseconds.count() << "ms)";
-
     return stats;
-}*/
-
-csstats::csstats(BlockChain& blockchain)
-: blockchain(blockchain) {
-    cstrace() << "STATS> csstats start "
-              << "update interval is " << updateTimeSec << " sec";
 }
 
-void csstats::run(const ::csstats::AllStats& allStats) {
-    csunused(allStats);
-#ifndef STATS
-    csunused(allStats);
-    return;
-#else
-    ScopedLock lock(mutex);
-
-	//lastHash = blockchain.getLastHash();
-
-    thread = std::thread([this, allStats]() {
-        cstrace() << "STATS> csstats thread started";
+void csstats::add(const csdb::Pool& pool) {
+    rollup.add(blockStats(pool), now());
 
-        currentStats = std::move(allStats.second);
-        statsCut = std::move(allStats.first);
-
-        assert(currentStats.size() == collectionPeriods.size());
+    lastSequence = pool.sequence();
+    lastHash = pool.hash().clone();
+}
 
-        for (auto i = 0ull; i < currentStats.size(); ++i)
-            currentStats[i].periodSec = collectionPeriods[i];
+bool csstats::loadCheckpoint() {
+    std::ifstream file(kCheckpointPath, std::ios::binary);
 
-        while (!quit) {
-            using namespace std::chrono_literals;
+    if (!file) {
+        return false;
+    }
 
-            if (!quit) {
-                auto periods = collectionPeriods;
-                periods.pop_back();
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    cs::Sequence sequence = 0;
+    uint32_t hashSize = 0;
 
-                StatsPerPeriod stats = collectStats(periods);
+    if (!read(file, magic) || magic != kMagic || !read(file, version) || version != kVersion || !read(file, sequence) ||
+        !read(file, hashSize) || hashSize > kMaxHashSize) {
+        cswarning() << "STATS> checkpoint is damaged, count all blocks";
+        return false;
+    }
 
-                for (auto& s : stats) {
-                    std::stringstream ss;
-                    ss << "Period " << s.periodSec << " collected ";
-                    ss << s.poolsCount << " pools, " << s.transactionsCount;
-                    ss << " transactions";
+    cs::Bytes hash(hashSize);
+    cs::Hash checksum{};
+    uint64_t size = 0;
 
-                    cstrace() << "STATS> " << ss.str();
-#ifdef LOG_STATS_TO_FILE
-                    cstrace() << "STATS> " << ss.str();
+    if (!file.read(reinterpret_cast<char*>(hash.data()), hashSize) || !read(file, checksum) || !read(file, size) || size > kMaxDataSize) {
+        cswarning() << "STATS> checkpoint is damaged, count all blocks";
+        return false;
+    }
 
-                    ss.str(std::string());
+    std::string data(static_cast<size_t>(size), '\0');
 
-                    ss << "Blockchain size:";
-                    ss << this->blockchain.getSize();
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size())) ||
+        cscrypto::calculateHash(reinterpret_cast<const cs::Byte*>(data.data()), data.size()) != checksum) {
+        cswarning() << "STATS> checkpoint has wrong checksum, count all blocks";
+        return false;
+    }
 
-                    cstrace() << "STATS> " << ss.str();
-#endif
-                    for (auto& t : s.balancePerCurrency) {
-                        cstrace() << "STATS> "
-                                  << "'" << t.first << "' = " << std::to_string(t.second.integral) << "." << std::to_string(t.second.fraction);
-                    }
-                }
-
-                {
-                    ScopedLock lock(currentStatsMutex);
-                    currentStats = std::move(stats);
-                }
-            }
+    std::istringstream stream(data);
 
-            std::this_thread::sleep_for(std::chrono::seconds(updateTimeSec));
-        }
+    if (!rollup.deserialize(stream)) {
+        cswarning() << "STATS> checkpoint is damaged, count all blocks";
+        return false;
+    }
 
-        cstrace() << "STATS> csstats thread stopped";
-    });
+    checkpointSequence = sequence;
+    checkpointHash = csdb::PoolHash::from_binary(std::move(hash));
 
-#endif
+    return true;
 }
 
-csstats::~csstats() {
-    cstrace() << "STATS> csstats stop";
+void csstats::saveCheckpoint() {
+    std::ostringstream stream;
+    rollup.serialize(stream);
 
-    ScopedLock lock(mutex);
+    const std::string data = stream.str();
+    const cs::Bytes hash = lastHash.to_binary();
+    const auto checksum = cscrypto::calculateHash(reinterpret_cast<const cs::Byte*>(data.data()), data.size());
+    const std::string temporaryPath = std::string(kCheckpointPath) + kTemporaryExtension;
 
-    quit = true;
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+        write(file, kMagic);
+        write(file, kVersion);
+        write(file, lastSequence);
+        write(file, static_cast<uint32_t>(hash.size()));
+        file.write(reinterpret_cast<const char*>(hash.data()), static_cast<std::streamsize>(hash.size()));
+        write(file, checksum);
+        write(file, static_cast<uint64_t>(data.size()));
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        file.flush();
+
+        if (!file) {
+            cserror() << "STATS> failed to write " << temporaryPath;
+            file.close();
+            boost::system::error_code code;
+            fs::remove(temporaryPath, code);
+            return;
+        }
+    }
 
-    if (thread.joinable()) {
-        thread.join();
+    // renaming makes torn checkpoint invisible
+    boost::system::error_code code;
+    fs::rename(temporaryPath, kCheckpointPath, code);
+
+    if (code) {
+        cserror() << "STATS> failed to rename " << temporaryPath << ": " << code.message();
+        fs::remove(temporaryPath, code);
+        return;
     }
-}
 
-StatsPerPeriod csstats::getStats() {
-    ScopedLock lock(currentStatsMutex);
-    return currentStats;
+    lastCheckpointSequence = lastSequence;
+    cstrace() << "STATS> checkpoint of block #" << WithDelimiters(lastSequence) << " is saved";
 }
 }  // namespace csstats
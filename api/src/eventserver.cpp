@@ -0,0 +1,581 @@
+#include <csconnector/eventserver.hpp>
+
+#include <lib/system/logger.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace csconnector {
+struct EventServer::Connection {
+    int fd = -1;
+
+    std::string input;
+    std::string output;
+
+    // input size required by incomplete request
+    size_t required = 0;
+    size_t outputOffset = 0;
+
+    // request is processed by worker or parked
+    bool busy = false;
+    bool writable = false;
+
+    std::string method;
+    Clock::time_point started;
+    Clock::time_point lastActivity;
+};
+
+struct EventServer::Mailbox {
+    struct Item {
+        std::weak_ptr<Connection> connection;
+        std::string reply;
+        bool failed = false;
+    };
+
+    std::mutex mutex;
+    std::vector<Item> items;
+    int event = -1;
+
+    void post(std::weak_ptr<Connection> connection, std::string reply, bool failed) {
+        std::lock_guard lock(mutex);
+
+        if (event == -1) {
+            return;
+        }
+
+        items.push_back(Item{std::move(connection), std::move(reply), failed});
+
+#ifdef __linux__
+        const uint64_t value = 1;
+        [[maybe_unused]] auto result = ::write(event, &value, sizeof(value));
+#endif
+    }
+};
+
+EventServer::EventServer(std::shared_ptr<Codec> codec, const Settings& settings)
+: codec_(std::move(codec))
+, settings_(settings)
+, mailbox_(std::make_shared<Mailbox>())
+, workers_(settings.workers) {
+}
+
+EventServer::~EventServer() {
+    stop();
+
+#ifdef __linux__
+    {
+        std::lock_guard lock(mailbox_->mutex);
+
+        if (mailbox_->event != -1) {
+            ::close(mailbox_->event);
+            mailbox_->event = -1;
+        }
+    }
+
+    if (listener_ != -1) {
+        ::close(listener_);
+    }
+
+    if (epoll_ != -1) {
+        ::close(epoll_);
+    }
+#endif
+}
+
+uint16_t EventServer::port() const {
+    return port_;
+}
+
+size_t EventServer::connections() const {
+    return connectionsCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t EventServer::rejected() const {
+    return rejected_.load(std::memory_order_relaxed);
+}
+
+std::map<std::string, EventServer::MethodStats> EventServer::stats() const {
+    std::lock_guard lock(statsMutex_);
+    return stats_;
+}
+
+std::string EventServer::report() const {
+    std::ostringstream os;
+    os << connections() << " connections, " << rejected() << " rejected";
+
+    for (const auto& [method, stats] : this->stats()) {
+        os << ", " << method << ": " << stats.calls << " calls, avg " << (stats.calls ? stats.totalMicroseconds / stats.calls : 0) << " us, max "
+           << stats.maxMicroseconds << " us";
+    }
+
+    return os.str();
+}
+
+void EventServer::account(const std::string& method, Clock::duration latency) {
+    const auto microseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+
+    std::lock_guard lock(statsMutex_);
+    auto& stats = stats_[method];
+
+    ++stats.calls;
+    stats.totalMicroseconds += microseconds;
+    stats.maxMicroseconds = std::max(stats.maxMicroseconds, microseconds);
+}
+
+#ifdef __linux__
+void EventServer::listen() {
+    listener_ = ::socket(AF_INET6, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    bool ipv6 = listener_ != -1;
+
+    if (ipv6) {
+        int off = 0;
+        ::setsockopt(listener_, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+    }
+    else {
+        listener_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    }
+
+    if (listener_ == -1) {
+        throw std::runtime_error(std::string("API server socket: ") + std::strerror(errno));
+    }
+
+    int on = 1;
+    ::setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    int result = 0;
+
+    if (ipv6) {
+        sockaddr_in6 address{};
+        address.sin6_family = AF_INET6;
+        address.sin6_addr = in6addr_any;
+        address.sin6_port = htons(settings_.port);
+        result = ::bind(listener_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    }
+    else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(settings_.port);
+        result = ::bind(listener_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    }
+
+    if (result == -1 || ::listen(listener_, SOMAXCONN) == -1) {
+        throw std::runtime_error("API server could not listen port " + std::to_string(settings_.port) + ": " + std::strerror(errno));
+    }
+
+    sockaddr_storage bound{};
+    socklen_t length = sizeof(bound);
+    ::getsockname(listener_, reinterpret_cast<sockaddr*>(&bound), &length);
+    port_ = ntohs(ipv6 ? reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port : reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+
+    epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+    mailbox_->event = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (epoll_ == -1 || mailbox_->event == -1) {
+        throw std::runtime_error(std::string("API server epoll: ") + std::strerror(errno));
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listener_;
+    ::epoll_ctl(epoll_, EPOLL_CTL_ADD, listener_, &event);
+
+    event.data.fd = mailbox_->event;
+    ::epoll_ctl(epoll_, EPOLL_CTL_ADD, mailbox_->event, &event);
+
+    running_ = true;
+}
+
+void EventServer::serve() {
+    if (listener_ == -1) {
+        listen();
+    }
+
+    constexpr int kEventsCount = 256;
+    epoll_event events[kEventsCount];
+
+    auto lastSweep = Clock::now();
+    auto lastReport = lastSweep;
+
+    while (running_.load()) {
+        const int count = ::epoll_wait(epoll_, events, kEventsCount, 1000);
+
+        if (count == -1 && errno != EINTR) {
+            cserror() << "API server epoll error: " << std::strerror(errno);
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+
+            if (fd == listener_) {
+                accept();
+                continue;
+            }
+
+            if (fd == mailbox_->event) {
+                complete();
+                continue;
+            }
+
+            auto iter = connections_.find(fd);
+
+            if (iter == connections_.end()) {
+                continue;
+            }
+
+            ConnectionPtr connection = iter->second;
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                close(connection);
+                continue;
+            }
+
+            if (events[i].events & EPOLLOUT) {
+                write(connection);
+            }
+
+            if (connection->fd != -1 && (events[i].events & (EPOLLIN | EPOLLRDHUP))) {
+                read(connection);
+            }
+        }
+
+        const auto now = Clock::now();
+
+        if (now - lastSweep >= std::chrono::seconds(1)) {
+            sweep(now);
+            lastSweep = now;
+        }
+
+        if (settings_.reportPeriod.count() != 0 && now - lastReport >= settings_.reportPeriod) {
+            csdebug() << "API server " << settings_.port << "> " << report();
+            lastReport = now;
+        }
+    }
+
+    while (!connections_.empty()) {
+        // close erases map entry, so connection is kept by copy
+        ConnectionPtr connection = connections_.begin()->second;
+        close(connection);
+    }
+}
+
+void EventServer::stop() {
+    running_ = false;
+
+    std::lock_guard lock(mailbox_->mutex);
+
+    if (mailbox_->event != -1) {
+        const uint64_t value = 1;
+        [[maybe_unused]] auto result = ::write(mailbox_->event, &value, sizeof(value));
+    }
+}
+
+void EventServer::accept() {
+    while (true) {
+        const int fd = ::accept4(listener_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (fd == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                cswarning() << "API server accept error: " << std::strerror(errno);
+            }
+
+            return;
+        }
+
+        if (connections_.size() >= settings_.maxConnections) {
+            ::close(fd);
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        int on = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        auto connection = std::make_shared<Connection>();
+        connection->fd = fd;
+        connection->lastActivity = Clock::now();
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+
+        if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) == -1) {
+            ::close(fd);
+            continue;
+        }
+
+        connections_.emplace(fd, std::move(connection));
+        connectionsCount_.store(connections_.size(), std::memory_order_relaxed);
+    }
+}
+
+void EventServer::read(const ConnectionPtr& connection) {
+    char buffer[16 * 1024];
+
+    while (true) {
+        const ssize_t size = ::recv(connection->fd, buffer, sizeof(buffer), 0);
+
+        if (size > 0) {
+            connection->input.append(buffer, static_cast<size_t>(size));
+            connection->lastActivity = Clock::now();
+
+            if (connection->input.size() > settings_.maxRequestSize) {
+                close(connection);
+                return;
+            }
+
+            continue;
+        }
+
+        if (size == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+
+        if (size == -1 && errno == EINTR) {
+            continue;
+        }
+
+        // closed by client, parked request is dropped too
+        close(connection);
+        return;
+    }
+
+    dispatch(connection);
+}
+
+void EventServer::dispatch(const ConnectionPtr& connection) {
+    while (!connection->busy && connection->fd != -1 && !connection->input.empty()) {
+        // big request is not parsed again on every read
+        if (connection->input.size() < connection->required) {
+            return;
+        }
+
+        Codec::Request request;
+        size_t consumed = 0;
+
+        const auto status = codec_->extract(connection->input, request, consumed);
+
+        if (status == Codec::Status::Incomplete) {
+            connection->required = std::max(consumed, connection->input.size() + 1);
+
+            if (connection->required > settings_.maxRequestSize) {
+                close(connection);
+            }
+
+            return;
+        }
+
+        connection->required = 0;
+
+        if (status == Codec::Status::Malformed) {
+            close(connection);
+            return;
+        }
+
+        connection->input.erase(0, consumed);
+
+        if (!request.reply.empty()) {
+            connection->output.append(request.reply);
+            write(connection);
+            continue;
+        }
+
+        connection->busy = true;
+        connection->method = request.method;
+        connection->started = Clock::now();
+
+        std::weak_ptr<Connection> weak = connection;
+        auto mailbox = mailbox_;
+
+        try {
+            if (codec_->park(request, weak, [mailbox, weak](std::string reply) { mailbox->post(weak, std::move(reply), false); })) {
+                return;
+            }
+        }
+        catch (const std::exception& exception) {
+            cswarning() << "API server can not park " << request.method << ": " << exception.what();
+            close(connection);
+            return;
+        }
+
+        const bool blocking = codec_->blocking(request);
+
+        cs::Task task([codec = codec_, mailbox, weak, request = std::move(request)] {
+            if (weak.expired()) {
+                return;
+            }
+
+            std::string reply;
+            bool failed = false;
+
+            try {
+                reply = codec->process(request);
+            }
+            catch (const std::exception& exception) {
+                csdebug() << "API server request " << request.method << " failed: " << exception.what();
+                failed = true;
+            }
+
+            mailbox->post(weak, std::move(reply), failed);
+        });
+
+        if (blocking) {
+            // task is kept if thread is not started
+            auto shared = std::make_shared<cs::Task>(std::move(task));
+
+            try {
+                std::thread([shared] { (*shared)(); }).detach();
+                return;
+            }
+            catch (const std::system_error& error) {
+                cswarning() << "API server can not start thread for " << connection->method << ", worker is used: " << error.what();
+            }
+
+            task = std::move(*shared);
+        }
+
+        workers_.submit(std::move(task));
+    }
+}
+
+void EventServer::complete() {
+    uint64_t value = 0;
+    [[maybe_unused]] auto result = ::read(mailbox_->event, &value, sizeof(value));
+
+    std::vector<Mailbox::Item> items;
+
+    {
+        std::lock_guard lock(mailbox_->mutex);
+        items.swap(mailbox_->items);
+    }
+
+    for (auto& item : items) {
+        ConnectionPtr connection = item.connection.lock();
+
+        if (!connection || connection->fd == -1) {
+            continue;
+        }
+
+        const auto now = Clock::now();
+        account(connection->method, now - connection->started);
+
+        connection->busy = false;
+        connection->lastActivity = now;
+
+        if (item.failed) {
+            close(connection);
+            continue;
+        }
+
+        connection->output.append(item.reply);
+        write(connection);
+        dispatch(connection);
+    }
+}
+
+void EventServer::write(const ConnectionPtr& connection) {
+    while (connection->outputOffset < connection->output.size()) {
+        const ssize_t size = ::send(connection->fd, connection->output.data() + connection->outputOffset, connection->output.size() - connection->outputOffset,
+                                    MSG_NOSIGNAL);
+
+        if (size > 0) {
+            connection->outputOffset += static_cast<size_t>(size);
+            continue;
+        }
+
+        if (size == -1 && errno == EINTR) {
+            continue;
+        }
+
+        if (size == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            watch(connection, true);
+            return;
+        }
+
+        close(connection);
+        return;
+    }
+
+    connection->output.clear();
+    connection->outputOffset = 0;
+
+    watch(connection, false);
+}
+
+void EventServer::watch(const ConnectionPtr& connection, bool writable) {
+    if (connection->writable == writable || connection->fd == -1) {
+        return;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP | (writable ? EPOLLOUT : 0u);
+    event.data.fd = connection->fd;
+
+    ::epoll_ctl(epoll_, EPOLL_CTL_MOD, connection->fd, &event);
+    connection->writable = writable;
+}
+
+void EventServer::close(const ConnectionPtr& connection) {
+    if (connection->fd == -1) {
+        return;
+    }
+
+    const int fd = connection->fd;
+    connection->fd = -1;
+
+    ::epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+
+    // may release the last reference to connection
+    connections_.erase(fd);
+    connectionsCount_.store(connections_.size(), std::memory_order_relaxed);
+}
+
+void EventServer::sweep(Clock::time_point now) {
+    if (settings_.idleTimeout.count() == 0) {
+        return;
+    }
+
+    std::vector<ConnectionPtr> idle;
+
+    for (const auto& [fd, connection] : connections_) {
+        if (!connection->busy && connection->output.empty() && now - connection->lastActivity >= settings_.idleTimeout) {
+            idle.push_back(connection);
+        }
+    }
+
+    for (const auto& connection : idle) {
+        close(connection);
+    }
+}
+#else
+void EventServer::listen() {
+    throw std::runtime_error("API event server is supported on linux only");
+}
+
+void EventServer::serve() {
+    listen();
+}
+
+void EventServer::stop() {
+    running_ = false;
+}
+#endif
+}  // namespace csconnector
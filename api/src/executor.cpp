@@ -1,15 +1,5 @@
 #include <executor.hpp>
 
-#if defined(_MSC_VER)
-#pragma warning(push, 0)
-#endif
-
-#include <thrift/transport/TBufferTransports.h>
-
-#if defined(_MSC_VER)
-#pragma warning(pop)
-#endif
-
 #include "serializer.hpp"
 
 #include <csnode/configholder.hpp>
@@ -35,9 +25,6 @@ cs::ExecutorSettings::Types cs::ExecutorSettings::get() {
 void cs::Executor::executeByteCode(executor::ExecuteByteCodeResult& resp, const std::string& address, const std::string& smart_address,
                                    const std::vector<general::ByteCodeObject>& code, const std::string& state,
                                    std::vector<executor::MethodHeader>& methodHeader, bool isGetter, cs::Sequence sequence) {
-    static std::mutex mutex;
-    std::lock_guard lock(mutex);  // temporary solution
-
     if (!code.empty()) {
         executor::SmartContractBinary smartContractBinary;
         smartContractBinary.contractAddress = smart_address;
@@ -65,125 +52,136 @@ void cs::Executor::executeByteCodeMultiple(executor::ExecuteByteCodeMultipleResu
     const auto accessId = generateAccessId(sequence);
     ++execCount_;
 
+    auto connection = pool_.acquire(ExecutorPool::Lane::Getter);
+    connection.open();
+
     try {
-        std::shared_lock lock(sharedErrorMutex_);
-        origExecutor_->executeByteCodeMultiple(_return, static_cast<general::AccessID>(accessId), initiatorAddress, invokedContract, method, params, executionTime, EXECUTOR_VERSION);
+        connection->executeByteCodeMultiple(_return, static_cast<general::AccessID>(accessId), initiatorAddress, invokedContract, method, params, executionTime, EXECUTOR_VERSION);
     }
     catch (::apache::thrift::transport::TTransportException& x) {
         // sets stop_ flag to true forever, replace with new instance
         if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-            recreateOriginExecutor();
+            connection.reset();
         }
 
         _return.status.code = 1;
         _return.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
     catch (std::exception& x) {
         _return.status.code = 1;
         _return.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
 
     --execCount_;
     deleteAccessId(static_cast<general::AccessID>(accessId));
 }
 
-void cs::Executor::getContractMethods(executor::GetContractMethodsResult& _return, const std::vector<general::ByteCodeObject>& byteCodeObjects) {
+void cs::Executor::getContractMethods(executor::GetContractMethodsResult& _return, const std::vector<general::ByteCodeObject>& byteCodeObjects,
+                                      ExecutorPool::Lane lane) {
+    auto connection = pool_.acquire(lane);
+    connection.open();
+
     try {
-        std::shared_lock lock(sharedErrorMutex_);
-        origExecutor_->getContractMethods(_return, byteCodeObjects, EXECUTOR_VERSION);
+        connection->getContractMethods(_return, byteCodeObjects, EXECUTOR_VERSION);
     }
     catch (const ::apache::thrift::transport::TTransportException& x) {
         // sets stop_ flag to true forever, replace with new instance
         if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-            recreateOriginExecutor();
+            connection.reset();
         }
 
         _return.status.code = 1;
         _return.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
     catch(const std::exception& x ) {
         _return.status.code = 1;
         _return.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
 }
 
 void cs::Executor::getContractVariables(executor::GetContractVariablesResult& _return, const std::vector<general::ByteCodeObject>& byteCodeObjects, const std::string& contractState) {
+    auto connection = pool_.acquire(ExecutorPool::Lane::Getter);
+    connection.open();
+
     try {
-        std::shared_lock lock(sharedErrorMutex_);
-        origExecutor_->getContractVariables(_return, byteCodeObjects, contractState, EXECUTOR_VERSION);
+        connection->getContractVariables(_return, byteCodeObjects, contractState, EXECUTOR_VERSION);
     }
     catch (const ::apache::thrift::transport::TTransportException& x) {
         // sets stop_ flag to true forever, replace with new instance
         if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-            recreateOriginExecutor();
+            connection.reset();
         }
 
         _return.status.code = 1;
         _return.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
     catch(const std::exception& x ) {
         _return.status.code = 1;
         _return.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
 }
 
 void cs::Executor::compileSourceCode(executor::CompileSourceCodeResult& _return, const std::string& sourceCode) {
+    auto connection = pool_.acquire(ExecutorPool::Lane::Getter);
+    connection.open();
+
     try {
-        std::shared_lock slk(sharedErrorMutex_);
-        origExecutor_->compileSourceCode(_return, sourceCode, EXECUTOR_VERSION);
+        connection->compileSourceCode(_return, sourceCode, EXECUTOR_VERSION);
     }
     catch (::apache::thrift::transport::TTransportException& x) {
         // sets stop_ flag to true forever, replace with new instance
         if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-            recreateOriginExecutor();
+            connection.reset();
         }
 
         _return.status.code = 1;
         _return.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
     catch(const std::exception& x ) {
         _return.status.code = 1;
         _return.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
 }
 
 void cs::Executor::getExecutorBuildVersion(executor::ExecutorBuildVersionResult& _return) {
+    auto connection = pool_.acquire(ExecutorPool::Lane::Getter);
+    connection.open();
+
     try {
-        std::shared_lock slk(sharedErrorMutex_);
-        origExecutor_->getExecutorBuildVersion(_return, EXECUTOR_VERSION);
+        connection->getExecutorBuildVersion(_return, EXECUTOR_VERSION);
     }
     catch (::apache::thrift::transport::TTransportException& x) {
         // sets stop_ flag to true forever, replace with new instance
         if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-            recreateOriginExecutor();
+            connection.reset();
         }
 
         _return.status.code = 1;
         _return.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
     catch (const std::exception& x) {
         _return.status.code = 1;
         _return.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
 }
 
@@ -193,7 +191,7 @@ cs::Executor& cs::Executor::instance() {
 }
 
 bool cs::Executor::isConnected() const {
-    return executorTransport_->isOpen();
+    return pool_.isConnected();
 }
 
 void cs::Executor::stop() {
@@ -242,8 +240,7 @@ void cs::Executor::updateDeployTrxns(const csdb::Address& address, const csdb::T
 }
 
 void cs::Executor::setLastState(const csdb::Address& address, const std::string& state) {
-    std::lock_guard lock(mutex_);
-    lastState_[address] = state;
+    stateCache_.setLatest(address, state);
 }
 
 std::optional<std::string> cs::Executor::getState(const csdb::Address& address) {
@@ -253,44 +250,43 @@ std::optional<std::string> cs::Executor::getState(const csdb::Address& address)
         return std::nullopt;
     }
 
+    if (auto cached = stateCache_.latest(absAddress); cached.has_value()) {
+        return cached;
+    }
+
+    const auto version = stateCache_.version();
     std::string state = cs::SmartContracts::get_contract_state(blockchain_, absAddress);
 
     if (state.empty()) {
         return std::nullopt;
     }
 
+    stateCache_.fillLatest(absAddress, state, version);
     return std::make_optional(std::move(state));
 }
 
 void cs::Executor::updateCacheLastStates(const csdb::Address& address, const cs::Sequence& sequence, const std::string& state) {
-    std::lock_guard lock(mutex_);
-
     if (execCount_) {
-        (cacheLastStates_[address])[sequence] = state;
+        stateCache_.addHistory(address, sequence, state);
     }
-    else if (cacheLastStates_.size()) {
-        cacheLastStates_.clear();
+    else {
+        stateCache_.clearHistory();
     }
 }
 
 std::optional<std::string> cs::Executor::getAccessState(const general::AccessID& accessId, const csdb::Address& address) {
-    std::shared_lock lock(mutex_);
-    const auto accessSequence = getSequence(accessId);
-
-    if (const auto unmapStatesIter = cacheLastStates_.find(address); unmapStatesIter != cacheLastStates_.end()) {
-        std::pair<cs::Sequence, std::string> prevSeqState{};
-
-        for (const auto& [currSeq, currState] : unmapStatesIter->second) {
-            if (currSeq > accessSequence) {
-                return prevSeqState.first ? std::make_optional<std::string>(prevSeqState.second) : std::nullopt;
-            }
-
-            prevSeqState = { currSeq, currState };
-        }
+    // unknown access sequence can not be found in history
+    const auto accessSequence = getSequence(accessId).value_or(0);
+    std::string state;
+
+    switch (stateCache_.history(address, accessSequence, state)) {
+        case ContractStateCache::HistoryResult::Found:
+            return std::make_optional(std::move(state));
+        case ContractStateCache::HistoryResult::Unknown:
+            return std::nullopt;
+        default:
+            return getState(address);
     }
-
-    auto lastState = getState(address);
-    return lastState.has_value() ? std::make_optional<std::string>(std::move(lastState).value()) : std::nullopt;
 }
 
 void cs::Executor::addInnerSendTransaction(const general::AccessID& accessId, const csdb::Transaction& transaction) {
@@ -713,6 +709,10 @@ void cs::Executor::onReadBlock(const csdb::Pool& pool) {
     stateUpdate(pool);
 }
 
+void cs::Executor::onContractDataUpdated(const csdb::Address& address) {
+    stateCache_.invalidate(address);
+}
+
 void cs::Executor::onExecutorStarted() {
     if (!isConnected()) {
         connect();
@@ -785,16 +785,27 @@ void cs::Executor::checkExecutorVersion() {
     }
 }
 
+namespace {
+cs::ExecutorPool::Settings makePoolSettings() {
+    const auto& apiData = cs::ConfigHolder::instance().config()->getApiSettings();
+
+    cs::ExecutorPool::Settings settings;
+    settings.host = apiData.executorHost;
+    settings.port = apiData.executorPort;
+    settings.sendTimeout = apiData.executorSendTimeout;
+    settings.receiveTimeout = apiData.executorReceiveTimeout;
+    settings.connections[static_cast<size_t>(cs::ExecutorPool::Lane::Consensus)] = static_cast<size_t>(std::max(apiData.executorConnections, 1));
+    settings.connections[static_cast<size_t>(cs::ExecutorPool::Lane::Getter)] = static_cast<size_t>(std::max(apiData.executorGetterConnections, 1));
+
+    return settings;
+}
+}  // namespace
+
 cs::Executor::Executor(const cs::ExecutorSettings::Types& types)
 : blockchain_(std::get<cs::Reference<const BlockChain>>(types))
 , solver_(std::get<cs::Reference<const cs::SolverCore>>(types))
-, socket_(::apache::thrift::stdcxx::make_shared<::apache::thrift::transport::TSocket>(cs::ConfigHolder::instance().config()->getApiSettings().executorHost,
-                                                                                      cs::ConfigHolder::instance().config()->getApiSettings().executorPort))
-, executorTransport_(new ::apache::thrift::transport::TBufferedTransport(socket_))
-, origExecutor_(std::make_unique<executor::ContractExecutorConcurrentClient>(::apache::thrift::stdcxx::make_shared<apache::thrift::protocol::TBinaryProtocol>(executorTransport_))) {
-    socket_->setSendTimeout(cs::ConfigHolder::instance().config()->getApiSettings().executorSendTimeout);
-    socket_->setRecvTimeout(cs::ConfigHolder::instance().config()->getApiSettings().executorReceiveTimeout);
-
+, pool_(makePoolSettings())
+, stateCache_(static_cast<size_t>(std::max(cs::ConfigHolder::instance().config()->getApiSettings().executorStateCacheSize, 0)) * 1024 * 1024) {
     commitMin_ = cs::ConfigHolder::instance().config()->getApiSettings().executorCommitMin;
     commitMax_ = cs::ConfigHolder::instance().config()->getApiSettings().executorCommitMax;
 
@@ -832,6 +843,9 @@ cs::Executor::Executor(const cs::ExecutorSettings::Types& types)
                 cvErrorConnect_.wait_for(lock, std::chrono::seconds(5), [&] {
                     return !isConnected() || requestStop_;
                 });
+
+                logPoolMetrics();
+                logStateCacheMetrics();
             }
 
             if (requestStop_) {
@@ -920,17 +934,19 @@ std::optional<cs::Executor::OriginExecuteResult> cs::Executor::execute(const std
 
     ++execCount_;
 
+    // getters from api must not delay executions consensus waits for
+    auto connection = pool_.acquire(isGetter ? ExecutorPool::Lane::Getter : ExecutorPool::Lane::Consensus);
+    connection.open();
+
     const auto timeBeg = std::chrono::steady_clock::now();
 
     try {
-        std::shared_lock sharedLock(sharedErrorMutex_);
-        std::lock_guard lock(callExecutorLock_);
-        origExecutor_->executeByteCode(originExecuteRes.resp, static_cast<general::AccessID>(accessId), address, smartContractBinary, methodHeader, EXECUTION_TIME, EXECUTOR_VERSION);
+        connection->executeByteCode(originExecuteRes.resp, static_cast<general::AccessID>(accessId), address, smartContractBinary, methodHeader, EXECUTION_TIME, EXECUTOR_VERSION);
     }
     catch (::apache::thrift::transport::TTransportException& x) {
         // sets stop_ flag to true forever, replace with new instance
         if (x.getType() == ::apache::thrift::transport::TTransportException::NOT_OPEN) {
-            recreateOriginExecutor();
+            connection.reset();
         }
 
         if (x.getType() == ::apache::thrift::transport::TTransportException::TIMED_OUT) {
@@ -941,13 +957,13 @@ std::optional<cs::Executor::OriginExecuteResult> cs::Executor::execute(const std
         }
         originExecuteRes.resp.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
     catch (std::exception& x) {
         originExecuteRes.resp.status.code = cs::error::StdException;
         originExecuteRes.resp.status.message = x.what();
 
-        notifyError();
+        notifyError(connection);
     }
 
     originExecuteRes.timeExecute = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timeBeg).count();
@@ -962,23 +978,11 @@ std::optional<cs::Executor::OriginExecuteResult> cs::Executor::execute(const std
 }
 
 bool cs::Executor::connect() {
-    try {
-        executorTransport_->open();
-    }
-    catch (...) {
-        notifyError();
-    }
-
-    return executorTransport_->isOpen();
+    return pool_.connect();
 }
 
 void cs::Executor::disconnect() {
-    try {
-        executorTransport_->close();
-    }
-    catch (::apache::thrift::transport::TTransportException&) {
-        notifyError();
-    }
+    pool_.disconnect();
 }
 
 void cs::Executor::notifyError() {
@@ -989,8 +993,32 @@ void cs::Executor::notifyError() {
     cvErrorConnect_.notify_one();
 }
 
-void cs::Executor::recreateOriginExecutor() {
-    std::lock_guard lock(sharedErrorMutex_);
-    disconnect();
-    origExecutor_.reset(new executor::ContractExecutorConcurrentClient(::apache::thrift::stdcxx::make_shared<apache::thrift::protocol::TBinaryProtocol>(executorTransport_)));
+void cs::Executor::notifyError(ExecutorPool::Connection& connection) {
+    connection.close();
+    cvErrorConnect_.notify_one();
+}
+
+void cs::Executor::logPoolMetrics() const {
+    for (auto lane : { ExecutorPool::Lane::Consensus, ExecutorPool::Lane::Getter }) {
+        const auto metrics = pool_.metrics(lane);
+
+        if (metrics.calls == 0) {
+            continue;
+        }
+
+        csdebug() << csname() << ExecutorPool::laneName(lane) << " lane: calls " << metrics.calls << ", waiting " << metrics.waiting
+                  << " (max " << metrics.maxWaiting << "), avg wait " << metrics.totalWaitTime / metrics.calls << " ms (max " << metrics.maxWaitTime
+                  << " ms), avg call " << metrics.totalCallTime / metrics.calls << " ms (max " << metrics.maxCallTime << " ms)";
+    }
+}
+
+void cs::Executor::logStateCacheMetrics() const {
+    const auto metrics = stateCache_.metrics();
+
+    if (metrics.hits + metrics.misses == 0) {
+        return;
+    }
+
+    csdebug() << csname() << "state cache: " << metrics.bytes / 1024 << " of " << metrics.capacity / 1024 << " KB, " << metrics.entries << " entries, "
+              << metrics.states << " unique states, hits " << metrics.hits << ", misses " << metrics.misses << ", evictions " << metrics.evictions;
 }
@@ -0,0 +1,231 @@
+#include <executorpool.hpp>
+
+#if defined(_MSC_VER)
+#pragma warning(push, 0)
+#endif
+
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/transport/TBufferTransports.h>
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#include <algorithm>
+
+struct cs::ExecutorPool::Connection::Item {
+    ::apache::thrift::stdcxx::shared_ptr<::apache::thrift::transport::TSocket> socket;
+    ::apache::thrift::stdcxx::shared_ptr<::apache::thrift::transport::TTransport> transport;
+    std::unique_ptr<Client> client;
+    bool busy = false;
+
+    explicit Item(const Settings& settings)
+    : socket(::apache::thrift::stdcxx::make_shared<::apache::thrift::transport::TSocket>(settings.host, settings.port))
+    , transport(new ::apache::thrift::transport::TBufferedTransport(socket)) {
+        socket->setSendTimeout(settings.sendTimeout);
+        socket->setRecvTimeout(settings.receiveTimeout);
+        resetClient();
+    }
+
+    void resetClient() {
+        client = std::make_unique<Client>(::apache::thrift::stdcxx::make_shared<::apache::thrift::protocol::TBinaryProtocol>(transport));
+    }
+
+    bool open() {
+        try {
+            if (!transport->isOpen()) {
+                transport->open();
+            }
+        }
+        catch (...) {
+        }
+
+        return transport->isOpen();
+    }
+
+    void close() {
+        try {
+            transport->close();
+        }
+        catch (...) {
+        }
+    }
+};
+
+struct cs::ExecutorPool::LaneData {
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::unique_ptr<Connection::Item>> items;
+    Metrics metrics;
+};
+
+cs::ExecutorPool::Connection::Connection(ExecutorPool* pool, Lane lane, Item* item)
+: pool_(pool)
+, lane_(lane)
+, item_(item)
+, start_(std::chrono::steady_clock::now()) {
+}
+
+cs::ExecutorPool::Connection::Connection(Connection&& connection) noexcept
+: pool_(connection.pool_)
+, lane_(connection.lane_)
+, item_(connection.item_)
+, start_(connection.start_) {
+    connection.item_ = nullptr;
+}
+
+cs::ExecutorPool::Connection::~Connection() {
+    if (item_ != nullptr) {
+        const auto callTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count();
+        pool_->release(lane_, item_, static_cast<uint64_t>(callTime));
+    }
+}
+
+cs::ExecutorPool::Client* cs::ExecutorPool::Connection::operator->() const {
+    return item_->client.get();
+}
+
+bool cs::ExecutorPool::Connection::open() {
+    return item_->open();
+}
+
+void cs::ExecutorPool::Connection::close() {
+    item_->close();
+}
+
+void cs::ExecutorPool::Connection::reset() {
+    item_->close();
+    item_->resetClient();
+}
+
+cs::ExecutorPool::ExecutorPool(const Settings& settings) {
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        lanes_[i] = std::make_unique<LaneData>();
+
+        // every lane must have at least one connection, otherwise its callers wait forever
+        const auto count = std::max<size_t>(settings.connections[i], 1);
+
+        for (size_t j = 0; j < count; ++j) {
+            lanes_[i]->items.push_back(std::make_unique<Connection::Item>(settings));
+        }
+    }
+}
+
+cs::ExecutorPool::~ExecutorPool() = default;
+
+cs::ExecutorPool::Connection cs::ExecutorPool::acquire(Lane lane) {
+    auto& data = *lanes_[static_cast<size_t>(lane)];
+    const auto timeBeg = std::chrono::steady_clock::now();
+
+    std::unique_lock lock(data.mutex);
+    auto idle = [&data] {
+        return std::find_if(data.items.begin(), data.items.end(), [](const auto& item) { return !item->busy; });
+    };
+
+    auto it = idle();
+
+    if (it == data.items.end()) {
+        ++data.metrics.waiting;
+        data.metrics.maxWaiting = std::max(data.metrics.maxWaiting, data.metrics.waiting);
+
+        data.cv.wait(lock, [&] { return (it = idle()) != data.items.end(); });
+        --data.metrics.waiting;
+    }
+
+    (*it)->busy = true;
+
+    const auto waitTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timeBeg).count());
+    ++data.metrics.calls;
+    data.metrics.totalWaitTime += waitTime;
+    data.metrics.maxWaitTime = std::max(data.metrics.maxWaitTime, waitTime);
+
+    return Connection(this, lane, it->get());
+}
+
+void cs::ExecutorPool::release(Lane lane, Connection::Item* item, uint64_t callTime) {
+    auto& data = *lanes_[static_cast<size_t>(lane)];
+
+    {
+        std::lock_guard lock(data.mutex);
+        item->busy = false;
+
+        data.metrics.totalCallTime += callTime;
+        data.metrics.maxCallTime = std::max(data.metrics.maxCallTime, callTime);
+    }
+
+    data.cv.notify_one();
+}
+
+template <typename Func>
+void cs::ExecutorPool::forEachIdle(Func func) {
+    for (auto& lane : lanes_) {
+        std::vector<Connection::Item*> items;
+
+        {
+            std::lock_guard lock(lane->mutex);
+
+            for (auto& item : lane->items) {
+                if (!item->busy) {
+                    item->busy = true;
+                    items.push_back(item.get());
+                }
+            }
+        }
+
+        // transport operations may take up to socket timeout, do not hold lane lock
+        for (auto item : items) {
+            func(*item);
+        }
+
+        {
+            std::lock_guard lock(lane->mutex);
+
+            for (auto item : items) {
+                item->busy = false;
+            }
+        }
+
+        lane->cv.notify_all();
+    }
+}
+
+bool cs::ExecutorPool::connect() {
+    forEachIdle([](Connection::Item& item) { item.open(); });
+    return isConnected();
+}
+
+void cs::ExecutorPool::disconnect() {
+    forEachIdle([](Connection::Item& item) { item.close(); });
+}
+
+bool cs::ExecutorPool::isConnected() const {
+    for (auto& lane : lanes_) {
+        std::lock_guard lock(lane->mutex);
+
+        for (auto& item : lane->items) {
+            if (item->transport->isOpen()) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+cs::ExecutorPool::Metrics cs::ExecutorPool::metrics(Lane lane) const {
+    auto& data = *lanes_[static_cast<size_t>(lane)];
+
+    std::lock_guard lock(data.mutex);
+    return data.metrics;
+}
+
+const char* cs::ExecutorPool::laneName(Lane lane) {
+    switch (lane) {
+        case Lane::Consensus:
+            return "consensus";
+        case Lane::Getter:
+            return "getter";
+        default:
+            return "unknown";
+    }
+}
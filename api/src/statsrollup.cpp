@@ -0,0 +1,205 @@
+#include <statsrollup.hpp>
+
+#include <ctime>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+#include <csdb/amount.hpp>
+
+namespace {
+constexpr int64_t kMaxFraction = static_cast<int64_t>(csdb::Amount::AMOUNT_MAX_FRACTION);
+
+// buckets of periods up to month are kept
+const csstats::period_t kRetentionSec = csstats::collectionPeriods[csstats::PeriodIndex::Month];
+
+template <typename T>
+void write(std::ostream& os, const T& value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read(std::istream& is, T& value) {
+    return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void add(csstats::PeriodStats& stats, const csstats::BlockStats& block, int sign) {
+    stats.poolsCount += sign;
+    stats.transactionsCount += sign * block.transactionsCount;
+    stats.smartContractsCount += sign * block.smartContractsCount;
+    stats.transactionsSmartCount += sign * block.transactionsSmartCount;
+
+    for (const auto& [currency, amount] : block.balancePerCurrency) {
+        csstats::addAmount(stats.balancePerCurrency[currency], sign * amount.integral, sign * amount.fraction);
+    }
+}
+
+void add(csstats::PeriodStats& stats, const csstats::PeriodStats& other) {
+    stats.poolsCount += other.poolsCount;
+    stats.transactionsCount += other.transactionsCount;
+    stats.smartContractsCount += other.smartContractsCount;
+    stats.transactionsSmartCount += other.transactionsSmartCount;
+
+    for (const auto& [currency, amount] : other.balancePerCurrency) {
+        csstats::addAmount(stats.balancePerCurrency[currency], amount.integral, amount.fraction);
+    }
+}
+
+void serializeStats(std::ostream& os, const csstats::PeriodStats& stats) {
+    write(os, stats.poolsCount);
+    write(os, stats.transactionsCount);
+    write(os, stats.smartContractsCount);
+    write(os, stats.transactionsSmartCount);
+    write(os, static_cast<uint32_t>(stats.balancePerCurrency.size()));
+
+    for (const auto& [currency, amount] : stats.balancePerCurrency) {
+        write(os, currency);
+        write(os, amount.integral);
+        write(os, amount.fraction);
+    }
+}
+
+bool deserializeStats(std::istream& is, csstats::PeriodStats& stats) {
+    uint32_t currencies = 0;
+
+    if (!read(is, stats.poolsCount) || !read(is, stats.transactionsCount) || !read(is, stats.smartContractsCount) ||
+        !read(is, stats.transactionsSmartCount) || !read(is, currencies) || currencies > std::numeric_limits<csstats::Currency>::max() + 1u) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < currencies; ++i) {
+        csstats::Currency currency = 0;
+        csstats::TotalAmount amount;
+
+        if (!read(is, currency) || !read(is, amount.integral) || !read(is, amount.fraction)) {
+            return false;
+        }
+
+        stats.balancePerCurrency[currency] = amount;
+    }
+
+    return true;
+}
+}  // namespace
+
+namespace csstats {
+void addAmount(TotalAmount& total, int64_t integral, int64_t fraction) {
+    total.integral += integral + fraction / kMaxFraction;
+    total.fraction += fraction % kMaxFraction;
+
+    if (total.fraction >= kMaxFraction) {
+        total.fraction -= kMaxFraction;
+        ++total.integral;
+    }
+    else if (total.fraction < 0) {
+        total.fraction += kMaxFraction;
+        --total.integral;
+    }
+}
+
+void Rollup::add(const BlockStats& block, period_t now) {
+    ::add(total_, block, 1);
+
+    const period_t start = block.time - block.time % BucketSec;
+
+    if (start + BucketSec > now - kRetentionSec) {
+        ::add(buckets_[start], block, 1);
+    }
+
+    prune(now);
+}
+
+void Rollup::remove(const BlockStats& block) {
+    ::add(total_, block, -1);
+
+    auto iter = buckets_.find(block.time - block.time % BucketSec);
+
+    if (iter == buckets_.end()) {
+        return;
+    }
+
+    ::add(iter->second, block, -1);
+
+    if (iter->second.poolsCount == 0) {
+        buckets_.erase(iter);
+    }
+}
+
+StatsPerPeriod Rollup::get(const Periods& periods, period_t now) const {
+    StatsPerPeriod result(periods.size());
+
+    for (size_t i = 0; i < periods.size(); ++i) {
+        auto& stats = result[i];
+
+        if (periods[i] > kRetentionSec) {
+            stats = total_;
+        }
+        else {
+            for (auto iter = buckets_.upper_bound(now - periods[i] - BucketSec); iter != buckets_.end(); ++iter) {
+                ::add(stats, iter->second);
+            }
+        }
+
+        stats.periodSec = periods[i];
+        stats.timeStamp = std::chrono::system_clock::from_time_t(static_cast<std::time_t>(now));
+    }
+
+    return result;
+}
+
+void Rollup::clear() {
+    total_ = PeriodStats{};
+    buckets_.clear();
+}
+
+void Rollup::merge(const Rollup& other, period_t now) {
+    ::add(total_, other.total_);
+
+    for (const auto& [start, stats] : other.buckets_) {
+        ::add(buckets_[start], stats);
+    }
+
+    prune(now);
+}
+
+void Rollup::serialize(std::ostream& os) const {
+    serializeStats(os, total_);
+    write(os, static_cast<uint64_t>(buckets_.size()));
+
+    for (const auto& [start, stats] : buckets_) {
+        write(os, start);
+        serializeStats(os, stats);
+    }
+}
+
+bool Rollup::deserialize(std::istream& is) {
+    clear();
+
+    uint64_t count = 0;
+
+    if (!deserializeStats(is, total_) || !read(is, count)) {
+        clear();
+        return false;
+    }
+
+    for (uint64_t i = 0; i < count; ++i) {
+        period_t start = 0;
+        PeriodStats stats;
+
+        if (!read(is, start) || !deserializeStats(is, stats)) {
+            clear();
+            return false;
+        }
+
+        buckets_[start] = std::move(stats);
+    }
+
+    return true;
+}
+
+void Rollup::prune(period_t now) {
+    while (!buckets_.empty() && buckets_.begin()->first + BucketSec <= now - kRetentionSec) {
+        buckets_.erase(buckets_.begin());
+    }
+}
+}  // namespace csstats
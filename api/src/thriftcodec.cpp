@@ -0,0 +1,315 @@
+#include <csconnector/thriftcodec.hpp>
+
+#if defined(_MSC_VER)
+#pragma warning(push, 0)
+#endif
+
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/transport/TTransportException.h>
+#include <thrift/transport/TVirtualTransport.h>
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+
+namespace {
+using ::apache::thrift::TException;
+using ::apache::thrift::protocol::TMessageType;
+using ::apache::thrift::transport::TMemoryBuffer;
+using ::apache::thrift::transport::TTransportException;
+using ::apache::thrift::transport::TVirtualTransport;
+
+constexpr size_t kMaxHttpHeaderSize = 64 * 1024;
+constexpr const char* kCrLf = "\r\n";
+
+::apache::thrift::stdcxx::shared_ptr<TMemoryBuffer> makeInput(std::string_view data) {
+    // buffer observes data, it is not changed by reading
+    return ::apache::thrift::stdcxx::make_shared<TMemoryBuffer>(reinterpret_cast<uint8_t*>(const_cast<char*>(data.data())), static_cast<uint32_t>(data.size()));
+}
+
+// reads message from observed input, remembers input size required by failed read
+class ScanTransport : public TVirtualTransport<ScanTransport> {
+public:
+    explicit ScanTransport(std::string_view data)
+    : data_(data) {
+    }
+
+    uint32_t read(uint8_t* buffer, uint32_t length) {
+        const auto size = static_cast<uint32_t>(std::min<size_t>(length, data_.size() - position_));
+        std::memcpy(buffer, data_.data() + position_, size);
+        position_ += size;
+        return size;
+    }
+
+    uint32_t readAll(uint8_t* buffer, uint32_t length) {
+        if (data_.size() - position_ < length) {
+            required_ = std::max(required_, position_ + length);
+            throw TTransportException(TTransportException::END_OF_FILE, "No more data to read.");
+        }
+
+        return read(buffer, length);
+    }
+
+    size_t position() const {
+        return position_;
+    }
+
+    size_t required() const {
+        return required_;
+    }
+
+private:
+    std::string_view data_;
+    size_t position_ = 0;
+    size_t required_ = 0;
+};
+
+bool equalsNoCase(std::string_view lhs, std::string_view rhs) {
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) {
+        value.remove_prefix(1);
+    }
+
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) {
+        value.remove_suffix(1);
+    }
+
+    return value;
+}
+
+std::string httpDate() {
+    char buffer[64] = {};
+    const std::time_t now = std::time(nullptr);
+    std::tm time{};
+
+#if defined(_MSC_VER)
+    gmtime_s(&time, &now);
+#else
+    gmtime_r(&now, &time);
+#endif
+
+    std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &time);
+    return buffer;
+}
+}  // namespace
+
+namespace csconnector {
+ThriftCodec::ThriftCodec(::apache::thrift::stdcxx::shared_ptr<::apache::thrift::TProcessor> processor,
+                         ::apache::thrift::stdcxx::shared_ptr<::apache::thrift::protocol::TProtocolFactory> protocolFactory, Transport transport)
+: processor_(std::move(processor))
+, protocolFactory_(std::move(protocolFactory))
+, transport_(transport) {
+}
+
+void ThriftCodec::addLongPoll(const std::string& method, LongPoll poll) {
+    longPolls_[method] = std::move(poll);
+}
+
+void ThriftCodec::addBlocking(const std::string& method) {
+    blocking_.insert(method);
+}
+
+Codec::Status ThriftCodec::extract(std::string_view input, Request& request, size_t& consumed) {
+    return transport_ == Transport::Http ? extractHttp(input, request, consumed) : extractMessage(input, request, consumed);
+}
+
+Codec::Status ThriftCodec::extractMessage(std::string_view input, Request& request, size_t& consumed) const {
+    auto buffer = ::apache::thrift::stdcxx::make_shared<ScanTransport>(input);
+    auto protocol = protocolFactory_->getProtocol(buffer);
+
+    std::string name;
+    TMessageType type;
+    int32_t sequenceId = 0;
+
+    // message is skipped to find its end, not complete message throws on reading past the buffer
+    try {
+        protocol->readMessageBegin(name, type, sequenceId);
+        protocol->skip(::apache::thrift::protocol::T_STRUCT);
+        protocol->readMessageEnd();
+    }
+    catch (const TTransportException&) {
+        // long strings of message are not parsed again until they are received
+        consumed = buffer->required();
+        return Status::Incomplete;
+    }
+    catch (const TException&) {
+        return Status::Malformed;
+    }
+
+    consumed = buffer->position();
+
+    request.method = std::move(name);
+    request.data.assign(input.data(), consumed);
+
+    return Status::Ready;
+}
+
+Codec::Status ThriftCodec::extractHttp(std::string_view input, Request& request, size_t& consumed) const {
+    const size_t headerEnd = input.find("\r\n\r\n");
+
+    if (headerEnd == std::string_view::npos) {
+        return input.size() > kMaxHttpHeaderSize ? Status::Malformed : Status::Incomplete;
+    }
+
+    const std::string_view header = input.substr(0, headerEnd);
+    const size_t lineEnd = header.find(kCrLf);
+    const std::string_view requestLine = header.substr(0, lineEnd);
+    const std::string_view method = requestLine.substr(0, requestLine.find(' '));
+
+    // cors preflight of browsers, answered as THttpServer does
+    if (method == "OPTIONS") {
+        std::ostringstream os;
+        os << "HTTP/1.1 200 OK" << kCrLf << "Date: " << httpDate() << kCrLf << "Access-Control-Allow-Origin: *" << kCrLf
+           << "Access-Control-Allow-Methods: POST, OPTIONS" << kCrLf << "Access-Control-Allow-Headers: Content-Type" << kCrLf << kCrLf;
+
+        request.method = "OPTIONS";
+        request.reply = os.str();
+        consumed = headerEnd + 4;
+
+        return Status::Ready;
+    }
+
+    if (method != "POST") {
+        return Status::Malformed;
+    }
+
+    size_t contentLength = 0;
+    bool hasLength = false;
+    size_t position = lineEnd == std::string_view::npos ? header.size() : lineEnd + 2;
+
+    while (position < header.size()) {
+        size_t end = header.find(kCrLf, position);
+
+        if (end == std::string_view::npos) {
+            end = header.size();
+        }
+
+        const std::string_view line = header.substr(position, end - position);
+        const size_t colon = line.find(':');
+
+        if (colon != std::string_view::npos) {
+            const auto name = trim(line.substr(0, colon));
+            const auto value = trim(line.substr(colon + 1));
+
+            if (equalsNoCase(name, "Content-Length")) {
+                try {
+                    contentLength = std::stoull(std::string(value));
+                    hasLength = true;
+                }
+                catch (const std::exception&) {
+                    return Status::Malformed;
+                }
+            }
+            else if (equalsNoCase(name, "Transfer-Encoding") && !equalsNoCase(value, "identity")) {
+                // chunked requests are not sent by api clients
+                return Status::Malformed;
+            }
+        }
+
+        position = end + 2;
+    }
+
+    if (!hasLength) {
+        return Status::Malformed;
+    }
+
+    const size_t bodyStart = headerEnd + 4;
+
+    if (input.size() - bodyStart < contentLength) {
+        consumed = bodyStart + contentLength;
+        return Status::Incomplete;
+    }
+
+    const std::string_view body = input.substr(bodyStart, contentLength);
+
+    auto protocol = protocolFactory_->getProtocol(makeInput(body));
+    std::string name;
+    TMessageType type;
+    int32_t sequenceId = 0;
+
+    try {
+        protocol->readMessageBegin(name, type, sequenceId);
+    }
+    catch (const TException&) {
+        return Status::Malformed;
+    }
+
+    request.method = std::move(name);
+    request.data.assign(body.data(), body.size());
+    consumed = bodyStart + contentLength;
+
+    return Status::Ready;
+}
+
+std::string ThriftCodec::process(const Request& request) {
+    auto input = makeInput(request.data);
+    auto output = ::apache::thrift::stdcxx::make_shared<TMemoryBuffer>();
+
+    processor_->process(protocolFactory_->getProtocol(input), protocolFactory_->getProtocol(output), nullptr);
+
+    return wrap(transport_, output->getBufferAsString());
+}
+
+bool ThriftCodec::park(const Request& request, const std::weak_ptr<void>& owner, Reply reply) {
+    auto iter = longPolls_.find(request.method);
+
+    if (iter == longPolls_.end()) {
+        return false;
+    }
+
+    auto input = makeInput(request.data);
+    auto protocol = protocolFactory_->getProtocol(input);
+
+    std::string name;
+    TMessageType type;
+    int32_t sequenceId = 0;
+
+    protocol->readMessageBegin(name, type, sequenceId);
+
+    iter->second(protocol.get(), owner, [factory = protocolFactory_, transport = transport_, name, sequenceId, reply = std::move(reply)](ResultWriter write) {
+        auto output = ::apache::thrift::stdcxx::make_shared<TMemoryBuffer>();
+        auto outProtocol = factory->getProtocol(output);
+
+        outProtocol->writeMessageBegin(name, ::apache::thrift::protocol::T_REPLY, sequenceId);
+        write(outProtocol.get());
+        outProtocol->writeMessageEnd();
+        outProtocol->getTransport()->writeEnd();
+        outProtocol->getTransport()->flush();
+
+        reply(wrap(transport, output->getBufferAsString()));
+    });
+
+    protocol->readMessageEnd();
+    protocol->getTransport()->readEnd();
+
+    return true;
+}
+
+bool ThriftCodec::blocking(const Request& request) const {
+    return blocking_.count(request.method) > 0;
+}
+
+std::string ThriftCodec::wrap(Transport transport, std::string message) {
+    if (transport != Transport::Http) {
+        return message;
+    }
+
+    std::ostringstream os;
+    os << "HTTP/1.1 200 OK" << kCrLf << "Date: " << httpDate() << kCrLf << "Access-Control-Allow-Origin: *" << kCrLf
+       << "Content-Type: application/x-thrift" << kCrLf << "Content-Length: " << message.size() << kCrLf << "Connection: Keep-Alive" << kCrLf << kCrLf
+       << message;
+
+    return os.str();
+}
+}  // namespace csconnector
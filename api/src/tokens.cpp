@@ -2,7 +2,12 @@
 
 #include <base58.h>
 
+#include <algorithm>
 #include <cctype>
+#include <optional>
+
+#include <csnode/configholder.hpp>
+
 #include "apihandler.hpp"
 #include "tokens.hpp"
 #include "smartcontracts.hpp"
@@ -163,82 +168,231 @@ void executeAndCall(api::APIHandler* p_api, const general::Address& addr, const
         handler(getVariantAs<RetType>(result.results[0].ret_val));
 }
 
+namespace {
+// concurrent refreshes, every one holds executor getter connection while it runs
+constexpr int kMaxRefreshThreads = 4;
+
+// holders balances requested by one executor call
+constexpr size_t kBalancesBatchSize = 1000;
+
+std::string toName(const std::string& value) {
+    return value.substr(0, 255);
+}
+
+std::string toSymbol(const std::string& value) {
+    std::string symbol;
+
+    for (uint32_t i = 0; i < value.size() && i < 4; ++i) {
+        symbol.push_back(static_cast<char>(std::toupper(value[i])));
+    }
+
+    return symbol;
+}
+}  // namespace
+
 void TokensMaster::refreshTokenState(const csdb::Address& token, const std::string& newState, bool checkBalance) {
     bool present = false;
     auto byteCodeObjects = api_->getSmartByteCode(token, present);
     if (!present || byteCodeObjects.empty()) return;
 
+    csdb::Address deployer;
+    std::vector<csdb::Address> holders;
+
+    {
+        std::lock_guard<decltype(dataMut_)> lInt(dataMut_);
+        auto tIt = tokens_.find(token);
+        if (tIt == tokens_.end())
+            return;
+
+        deployer = tIt->second.owner;
+
+        if (checkBalance) {
+            holders.reserve(tIt->second.holders.size());
+            for (auto& h : tIt->second.holders)
+                holders.push_back(h.first);
+        }
+    }
+
     std::string name, symbol, totalSupply;
-    csdb::Address deployer = tokens_[token].owner;
 
     general::Address addr   = std::string((char*)token.public_key().data(), token.public_key().size());
     general::Address dpAddr = std::string((char*)deployer.public_key().data(), deployer.public_key().size());
 
-    executeAndCall<std::string>(api_, dpAddr, addr, byteCodeObjects, newState, "getName", std::vector<general::Variant>(),
-                                [&name](const std::string& newName) { name = newName.substr(0, 255); });
+    // all the getters are called by one executor request
+    const std::vector<std::string> getters = { "getName", "totalSupply", "getSymbol" };
+    std::vector<executor::MethodHeader> methodHeader(getters.size());
 
-    executeAndCall<std::string>(api_, dpAddr, addr, byteCodeObjects, newState, "totalSupply", std::vector<general::Variant>(),
-        [&totalSupply](const std::string& newSupp) { totalSupply = tryExtractAmount(newSupp); });
+    for (size_t i = 0; i < getters.size(); ++i) {
+        methodHeader[i].methodName = getters[i];
+    }
 
-    executeAndCall<std::string>(api_, dpAddr, addr, byteCodeObjects, newState, "getSymbol", std::vector<general::Variant>(),
-        [&symbol](const std::string& newSymb) {
-            symbol.clear();
-            for (uint32_t i = 0; i < newSymb.size(); ++i) {
-                if (i >= 4) break;
-                symbol.push_back((char)std::toupper(newSymb[i]));
-            }
-        });  
+    executor::ExecuteByteCodeResult result;
+    api_->getExecutor().executeByteCode(result, dpAddr, addr, byteCodeObjects, newState, methodHeader, true /*isGetter*/, cs::Executor::kUseLastSequence);
+
+    if (!result.status.code && result.results.size() == getters.size()) {
+        if (!result.results[0].status.code)
+            name = toName(getVariantAs<std::string>(result.results[0].ret_val));
+        if (!result.results[1].status.code)
+            totalSupply = tryExtractAmount(getVariantAs<std::string>(result.results[1].ret_val));
+        if (!result.results[2].status.code)
+            symbol = toSymbol(getVariantAs<std::string>(result.results[2].ret_val));
+    }
+    else {
+        // executor could stop batch at the first failed method, ask one by one
+        executeAndCall<std::string>(api_, dpAddr, addr, byteCodeObjects, newState, "getName", std::vector<general::Variant>(),
+                                    [&name](const std::string& newName) { name = toName(newName); });
 
-    auto& t       = tokens_[token];
-    t.name        = name;
-    t.symbol      = symbol;
-    t.totalSupply = totalSupply;
+        executeAndCall<std::string>(api_, dpAddr, addr, byteCodeObjects, newState, "totalSupply", std::vector<general::Variant>(),
+            [&totalSupply](const std::string& newSupp) { totalSupply = tryExtractAmount(newSupp); });
+
+        executeAndCall<std::string>(api_, dpAddr, addr, byteCodeObjects, newState, "getSymbol", std::vector<general::Variant>(),
+            [&symbol](const std::string& newSymb) { symbol = toSymbol(newSymb); });
+    }
 
     // balance
-    if (checkBalance) {
-        executor::ExecuteByteCodeMultipleResult result;
-        if (byteCodeObjects.empty())
-            return;
+    std::vector<std::optional<std::string>> balances(holders.size());
 
+    if (!holders.empty()) {
         executor::SmartContractBinary smartContractBinary;
         smartContractBinary.contractAddress = addr;
         smartContractBinary.object.byteCodeObjects = byteCodeObjects;
         smartContractBinary.object.instance = newState;
         smartContractBinary.stateCanModify = 0;
 
-        std::vector<csdb::Address> holders;
-        holders.reserve(t.holders.size());
-        for (auto& h : t.holders)
-            holders.push_back(h.first);
-
-        std::vector<std::vector<general::Variant>> holderKeysParams;
-        holderKeysParams.reserve(holders.size());
-        for (auto& h : holders) {
-            general::Variant var;
-            auto key = h.public_key();
-            var.__set_v_string(EncodeBase58(cs::Bytes(key.begin(), key.end())));
-            holderKeysParams.push_back(std::vector<general::Variant>(1, var));
-        }
+        for (size_t begin = 0; begin < holders.size(); begin += kBalancesBatchSize) {
+            const size_t end = std::min(holders.size(), begin + kBalancesBatchSize);
+
+            std::vector<std::vector<general::Variant>> holderKeysParams;
+            holderKeysParams.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i) {
+                general::Variant var;
+                auto key = holders[i].public_key();
+                var.__set_v_string(EncodeBase58(cs::Bytes(key.begin(), key.end())));
+                holderKeysParams.push_back(std::vector<general::Variant>(1, var));
+            }
+
+            executor::ExecuteByteCodeMultipleResult balanceResult;
+            api_->getExecutor().executeByteCodeMultiple(balanceResult, dpAddr, smartContractBinary, "balanceOf", holderKeysParams, 100, cs::Executor::kUseLastSequence);
 
-        api_->getExecutor().executeByteCodeMultiple(result, dpAddr, smartContractBinary, "balanceOf", holderKeysParams, 100, cs::Executor::kUseLastSequence);
-
-        if (!result.status.code && (result.results.size() == holders.size())) {
-            for (uint32_t i = 0; i < holders.size(); ++i) {
-                const auto& res = result.results[i];
-                if (!res.status.code) {
-                    bool zeroBalanceFlg = true;
-                    if (!isZeroAmount(t.holders[holders[i]].balance))
-                        zeroBalanceFlg = false;
-
-                    t.holders[holders[i]].balance = tryExtractAmount(getVariantAs<std::string>(res.ret_val));
-                    if (zeroBalanceFlg && !isZeroAmount(t.holders[holders[i]].balance))
-                        ++t.realHoldersCount;
-                    else if (!zeroBalanceFlg && isZeroAmount(t.holders[holders[i]].balance))
-                        --t.realHoldersCount;
+            if (!balanceResult.status.code && (balanceResult.results.size() == end - begin)) {
+                for (size_t i = begin; i < end; ++i) {
+                    const auto& res = balanceResult.results[i - begin];
+                    if (!res.status.code)
+                        balances[i] = tryExtractAmount(getVariantAs<std::string>(res.ret_val));
                 }
             }
         }
     }
+
+    std::lock_guard<decltype(dataMut_)> lInt(dataMut_);
+    auto tIt = tokens_.find(token);
+    if (tIt == tokens_.end())
+        return;
+
+    auto& t       = tIt->second;
+    t.name        = name;
+    t.symbol      = symbol;
+    t.totalSupply = totalSupply;
+
+    for (size_t i = 0; i < holders.size(); ++i) {
+        auto hIt = t.holders.find(holders[i]);
+        if (!balances[i].has_value() || hIt == t.holders.end())
+            continue;
+
+        const bool zeroBalanceFlg = isZeroAmount(hIt->second.balance);
+        hIt->second.balance = std::move(balances[i]).value();
+
+        if (zeroBalanceFlg && !isZeroAmount(hIt->second.balance))
+            ++t.realHoldersCount;
+        else if (!zeroBalanceFlg && isZeroAmount(hIt->second.balance))
+            --t.realHoldersCount;
+    }
+}
+
+void TokensMaster::refreshAllTokens() {
+    std::vector<TokenId> tokens;
+
+    {
+        std::lock_guard<decltype(dataMut_)> lInt(dataMut_);
+        tokens.reserve(tokens_.size());
+        for (auto& tk : tokens_)
+            tokens.push_back(tk.first);
+    }
+
+    cslog() << "tokens are loading(" << tokens.size() << ")...";
+
+    if (tokens.empty()) {
+        cslog() << "tokens loaded!";
+        return;
+    }
+
+    {
+        std::lock_guard<decltype(cvMut_)> l(cvMut_);
+        loadingTokens_.insert(tokens.begin(), tokens.end());
+    }
+
+    for (auto& token : tokens)
+        scheduleRefresh(token);
+}
+
+void TokensMaster::scheduleRefresh(const csdb::Address& token) {
+    {
+        std::lock_guard<decltype(cvMut_)> l(cvMut_);
+        if (stopRequested_)
+            return;
+
+        pendingRefresh_.insert(token);
+    }
+
+    refreshCv_.notify_one();
+}
+
+void TokensMaster::refreshRoutine() {
+    std::unique_lock<decltype(cvMut_)> l(cvMut_);
+
+    for (;;) {
+        // the same token is never refreshed by two threads at once
+        auto tIt = pendingRefresh_.end();
+        refreshCv_.wait(l, [&] {
+            tIt = std::find_if(pendingRefresh_.begin(), pendingRefresh_.end(), [this](const TokenId& token) { return runningRefresh_.count(token) == 0; });
+            return stopRequested_ || tIt != pendingRefresh_.end();
+        });
+
+        if (stopRequested_)
+            break;
+
+        const TokenId token = *tIt;
+        pendingRefresh_.erase(tIt);
+        runningRefresh_.insert(token);
+
+        l.unlock();
+        refreshTokenState(token, cs::SmartContracts::get_contract_state(api_->get_s_blockchain(), token), true);
+        l.lock();
+
+        runningRefresh_.erase(token);
+
+        // token changed while it was refreshed can be taken by another thread now
+        if (pendingRefresh_.count(token))
+            refreshCv_.notify_one();
+
+        // refreshes of changed tokens are not counted, token scheduled again is loaded by the next refresh
+        if (!pendingRefresh_.count(token) && loadingTokens_.erase(token) != 0 && loadingTokens_.empty())
+            cslog() << "tokens loaded!";
+    }
+}
+
+void TokensMaster::stop() {
+    {
+        std::lock_guard<decltype(cvMut_)> l(cvMut_);
+        stopRequested_ = true;
+    }
+
+    refreshCv_.notify_all();
+
+    for (auto& thread : refreshThreads_) {
+        if (thread.joinable())
+            thread.join();
+    }
 }
 
 /* Call under data lock only */
@@ -253,9 +407,14 @@ void TokensMaster::initiateHolder(Token& token, const csdb::Address& address, co
 
 TokensMaster::TokensMaster(api::APIHandler* api)
 : api_(api) {
+    const int threads = std::clamp(cs::ConfigHolder::instance().config()->getApiSettings().executorGetterConnections, 1, kMaxRefreshThreads);
+
+    for (int i = 0; i < threads; ++i)
+        refreshThreads_.emplace_back(&TokensMaster::refreshRoutine, this);
 }
 
 TokensMaster::~TokensMaster() {
+    stop();
 }
 
 void TokensMaster::updateTokenChaches(const csdb::Address& addr, const std::string& newState, const TokenInvocationData::Params& ps) {
@@ -358,7 +517,7 @@ void TokensMaster::updateTokenChaches(const csdb::Address& addr, const std::stri
         else if (ps.method.empty()) // deploy token
             refreshBalance(tokens_[addr].owner);
 #endif
-        refreshTokenState(addr, cs::SmartContracts::get_contract_state(api_->get_s_blockchain(), addr), true);
+        scheduleRefresh(addr);
     }
 }
 
@@ -435,6 +594,10 @@ TokensMaster::TokensMaster(api::APIHandler*) {
 }
 TokensMaster::~TokensMaster() {
 }
+void TokensMaster::refreshAllTokens() {
+}
+void TokensMaster::stop() {
+}
 void TokensMaster::checkNewDeploy(const csdb::Address&, const csdb::Address&, const api::SmartContractInvocation&) {
 }
 void TokensMaster::checkNewState(const csdb::Address&, const csdb::Address&, const api::SmartContractInvocation&, const std::string&) {
@@ -0,0 +1,135 @@
+#include <framework.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <vector>
+
+#include <lib/system/console.hpp>
+#include <lib/system/random.hpp>
+#include <lib/system/timerwheel.hpp>
+
+// compares timing wheel of CallsQueueScheduler with multiset ordered by time it used before:
+// every round schedules calls, cancels a half of them by tag and expires the rest, like stage timeouts do
+
+using Clock = std::chrono::steady_clock;
+using CallTag = uintptr_t;
+using ProcType = std::function<void()>;
+
+static const size_t kRounds = 100;
+static const uint32_t kMaxDelayMs = 30'000;
+
+static volatile size_t result = 0;
+
+struct Schedule {
+    CallTag tag;
+    Clock::duration delay;
+};
+
+struct Context {
+    CallTag id;
+    Clock::time_point tp;
+    long long dt;
+    ProcType proc;
+
+    bool operator==(const CallTag rhs) const {
+        return id == rhs;
+    }
+};
+
+struct WheelContext {
+    long long dt;
+    ProcType proc;
+};
+
+static std::vector<Schedule> generateSchedules(size_t count) {
+    std::vector<Schedule> schedules;
+    schedules.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        schedules.push_back(Schedule{i + 1, std::chrono::milliseconds(cs::Random::generateValue<uint32_t>(1, kMaxDelayMs))});
+    }
+
+    return schedules;
+}
+
+static void call() {
+    result = result + 1;
+}
+
+static void runMultiset(const std::vector<Schedule>& schedules) {
+    auto compare = [](const Context& lhs, const Context& rhs) { return lhs.tp < rhs.tp; };
+    std::multiset<Context, decltype(compare)> queue(compare);
+
+    for (size_t round = 0; round < kRounds; ++round) {
+        const auto start = Clock::now();
+
+        for (const auto& schedule : schedules) {
+            // scheduler checks the tag is not queued yet
+            if (std::find(queue.cbegin(), queue.cend(), schedule.tag) == queue.cend()) {
+                queue.insert(Context{schedule.tag, start + schedule.delay, 0, &call});
+            }
+        }
+
+        for (size_t i = 0; i < schedules.size(); i += 2) {
+            auto iter = std::find(queue.cbegin(), queue.cend(), schedules[i].tag);
+
+            if (iter != queue.cend()) {
+                queue.erase(iter);
+            }
+        }
+
+        const auto end = start + std::chrono::milliseconds(kMaxDelayMs);
+
+        while (!queue.empty() && queue.cbegin()->tp <= end) {
+            queue.cbegin()->proc();
+            queue.erase(queue.cbegin());
+        }
+    }
+}
+
+static void runTimerWheel(const std::vector<Schedule>& schedules) {
+    auto start = Clock::now();
+    cs::TimerWheel<WheelContext, CallTag> queue(start);
+    std::vector<cs::TimerWheel<WheelContext, CallTag>::Expired> expired;
+
+    for (size_t round = 0; round < kRounds; ++round) {
+        for (const auto& schedule : schedules) {
+            queue.insert(schedule.tag, start + schedule.delay, WheelContext{0, &call});
+        }
+
+        for (size_t i = 0; i < schedules.size(); i += 2) {
+            queue.remove(schedules[i].tag);
+        }
+
+        // time of the wheel is simulated, so every round starts after the previous one
+        start += std::chrono::milliseconds(kMaxDelayMs);
+
+        expired.clear();
+        queue.expire(start, expired);
+
+        for (auto& item : expired) {
+            item.value.proc();
+        }
+    }
+}
+
+static void testSchedules(size_t count) {
+    const auto schedules = generateSchedules(count);
+
+    cs::Console::writeLine("Test multiset scheduling of ", count, " calls, ", kRounds, " rounds");
+    cs::Framework::execute(std::bind(&runMultiset, std::cref(schedules)), std::chrono::seconds(300));
+    cs::Console::writeLine("");
+
+    cs::Console::writeLine("Test timer wheel scheduling of ", count, " calls, ", kRounds, " rounds");
+    cs::Framework::execute(std::bind(&runTimerWheel, std::cref(schedules)), std::chrono::seconds(300));
+    cs::Console::writeLine("");
+}
+
+int main() {
+    for (size_t count : {10, 100, 1'000, 4'000}) {
+        testSchedules(count);
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <framework.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include <csnode/signaturesverifier.hpp>
+
+#include <lib/system/console.hpp>
+#include <lib/system/random.hpp>
+
+static const size_t kItemsCount = 20'000;
+static const size_t kKeysCount = 100;
+static const size_t kMessageSize = 120;
+
+static cs::SignaturesVerifier::Items generateItems() {
+    cscrypto::cryptoInit();
+
+    std::vector<std::pair<cs::PublicKey, cs::PrivateKey>> keys;
+    keys.reserve(kKeysCount);
+
+    for (size_t i = 0; i < kKeysCount; ++i) {
+        cs::PublicKey publicKey;
+        auto privateKey = cs::PrivateKey::generateWithPair(publicKey);
+        keys.emplace_back(publicKey, std::move(privateKey));
+    }
+
+    cs::SignaturesVerifier::Items items;
+    items.reserve(kItemsCount);
+
+    for (size_t i = 0; i < kItemsCount; ++i) {
+        const auto& [publicKey, privateKey] = keys[i % kKeysCount];
+
+        cs::Bytes message(kMessageSize);
+        std::generate(message.begin(), message.end(), [] { return cs::Random::generateValue<cs::Byte>(0, 255); });
+
+        auto signature = cscrypto::generateSignature(privateKey, message.data(), message.size());
+        items.push_back(cs::SignaturesVerifier::Item{signature, publicKey, std::move(message)});
+    }
+
+    return items;
+}
+
+static bool runVerification(const cs::SignaturesVerifier::Items& items, size_t workers) {
+    auto result = cs::SignaturesVerifier::verify(items, workers);
+    return std::all_of(result.begin(), result.end(), [](cs::Byte value) { return value != 0; });
+}
+
+static void testWorkers(const cs::SignaturesVerifier::Items& items, size_t workers) {
+    cs::Console::writeLine("Test batch verification of ", items.size(), " signatures by ", workers, " workers");
+
+    auto start = std::chrono::steady_clock::now();
+    cs::Framework::execute(std::bind(&runVerification, std::cref(items), workers), std::chrono::seconds(100), "Verification failed");
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    const auto perSecond = duration.count() != 0 ? (items.size() * 1'000'000 / static_cast<size_t>(duration.count())) : items.size();
+    cs::Console::writeLine("Verifications per second: ", perSecond);
+    cs::Console::writeLine("");
+}
+
+int main() {
+    const auto items = generateItems();
+    const size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (size_t workers = 1; workers <= cores; workers *= 2) {
+        testWorkers(items, workers);
+    }
+
+    if ((cores & (cores - 1)) != 0) {
+        testWorkers(items, cores);
+    }
+
+    return 0;
+}
@@ -46,6 +46,9 @@ const std::string PARAM_NAME_NODE_TYPE = "node_type";
 const std::string PARAM_NAME_BOOTSTRAP_TYPE = "bootstrap_type";
 const std::string PARAM_NAME_HOSTS_FILENAME = "hosts_filename";
 const std::string PARAM_NAME_USE_IPV6 = "ipv6";
+const std::string PARAM_NAME_BATCHED_IO = "batched_io";
+const std::string PARAM_NAME_ERASURE_CODING = "erasure_coding";
+const std::string PARAM_NAME_ROUND_TRACE_FILE = "round_trace_file";
 const std::string PARAM_NAME_MIN_NEIGHBOURS = "min_neighbours";
 const std::string PARAM_NAME_MAX_NEIGHBOURS = "max_neighbours";
 const std::string PARAM_NAME_RESTRICT_NEIGHBOURS = "restrict_neighbours";
@@ -89,7 +92,13 @@ const std::string PARAM_NAME_EXECUTOR_CHECK_VERSION_DELAY = "executor_check_vers
 const std::string PARAM_NAME_EXECUTOR_MULTI_INSTANCE = "executor_multi_instance";
 const std::string PARAM_NAME_EXECUTOR_VERSION_COMMIT_MIN = "executor_commit_min";
 const std::string PARAM_NAME_EXECUTOR_VERSION_COMMIT_MAX = "executor_commit_max";
+const std::string PARAM_NAME_EXECUTOR_CONNECTIONS = "executor_connections";
+const std::string PARAM_NAME_EXECUTOR_GETTER_CONNECTIONS = "executor_getter_connections";
+const std::string PARAM_NAME_EXECUTOR_STATE_CACHE_SIZE = "executor_state_cache_size";
 const std::string PARAM_NAME_JPS_COMMAND_LINE = "jps_command";
+const std::string PARAM_NAME_EVENT_SERVER = "event_server";
+const std::string PARAM_NAME_SERVER_WORKERS = "server_workers";
+const std::string PARAM_NAME_SERVER_MAX_CONNECTIONS = "server_max_connections";
 
 const std::string PARAM_NAME_EVENTS_CONSENSUS_LIAR = "consensus_liar";
 const std::string PARAM_NAME_EVENTS_CONSENSUS_SILENT = "consensus_silent";
@@ -738,6 +747,9 @@ Config Config::readFromFile(const std::string& fileName) {
         const boost::property_tree::ptree& params = config.get_child(BLOCK_NAME_PARAMS);
 
         result.ipv6_ = !(params.count(PARAM_NAME_USE_IPV6) && params.get<std::string>(PARAM_NAME_USE_IPV6) == "false");
+        result.batchedIO_ = params.count(PARAM_NAME_BATCHED_IO) ? params.get<bool>(PARAM_NAME_BATCHED_IO) : false;
+        result.erasureCoding_ = params.count(PARAM_NAME_ERASURE_CODING) ? params.get<bool>(PARAM_NAME_ERASURE_CODING) : false;
+        result.roundTraceFile_ = params.count(PARAM_NAME_ROUND_TRACE_FILE) ? params.get<std::string>(PARAM_NAME_ROUND_TRACE_FILE) : std::string{};
 
         result.minNeighbours_ = params.count(PARAM_NAME_MIN_NEIGHBOURS) ? params.get<uint32_t>(PARAM_NAME_MIN_NEIGHBOURS) : DEFAULT_MIN_NEIGHBOURS;
         result.maxNeighbours_ = params.count(PARAM_NAME_MAX_NEIGHBOURS) ? params.get<uint32_t>(PARAM_NAME_MAX_NEIGHBOURS) : DEFAULT_MAX_NEIGHBOURS;
@@ -856,6 +868,10 @@ void Config::setLoggerSettings(const boost::property_tree::ptree& config) {
     if (core) {
         settings.add_child("Core", *core);
     }
+    auto async = config.get_child_optional("Async");
+    if (async) {
+        settings.add_child("Async", *async);
+    }
     auto sinks = config.get_child_optional("Sinks");
     if (sinks) {
         for (const auto& val : *sinks) {
@@ -911,6 +927,12 @@ void Config::readApiData(const boost::property_tree::ptree& config) {
     checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_APIEXEC_PORT, apiData_.apiexecPort);
     checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_EXECUTOR_VERSION_COMMIT_MIN, apiData_.executorCommitMin);
     checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_EXECUTOR_VERSION_COMMIT_MAX, apiData_.executorCommitMax);
+    checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_EXECUTOR_CONNECTIONS, apiData_.executorConnections);
+    checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_EXECUTOR_GETTER_CONNECTIONS, apiData_.executorGetterConnections);
+    checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_EXECUTOR_STATE_CACHE_SIZE, apiData_.executorStateCacheSize);
+    checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_EVENT_SERVER, apiData_.eventServer);
+    checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_SERVER_WORKERS, apiData_.serverWorkers);
+    checkAndSaveValue(data, BLOCK_NAME_API, PARAM_NAME_SERVER_MAX_CONNECTIONS, apiData_.serverMaxConnections);
 
     if (data.count(PARAM_NAME_EXECUTOR_IP)) {
         apiData_.executorHost = data.get<std::string>(PARAM_NAME_EXECUTOR_IP);
@@ -1061,7 +1083,13 @@ bool operator==(const ApiData& lhs, const ApiData& rhs) {
            lhs.executorMultiInstance == rhs.executorMultiInstance &&
            lhs.executorCommitMin == rhs.executorCommitMin &&
            lhs.executorCommitMax == rhs.executorCommitMax &&
-           lhs.jpsCmdLine == rhs.jpsCmdLine;
+           lhs.executorConnections == rhs.executorConnections &&
+           lhs.executorGetterConnections == rhs.executorGetterConnections &&
+           lhs.executorStateCacheSize == rhs.executorStateCacheSize &&
+           lhs.jpsCmdLine == rhs.jpsCmdLine &&
+           lhs.eventServer == rhs.eventServer &&
+           lhs.serverWorkers == rhs.serverWorkers &&
+           lhs.serverMaxConnections == rhs.serverMaxConnections;
 }
 
 bool operator!=(const ApiData& lhs, const ApiData& rhs) {
@@ -1119,6 +1147,9 @@ bool operator==(const Config& lhs, const Config& rhs) {
         lhs.outputEp_ == rhs.outputEp_ &&
         lhs.nType_ == rhs.nType_ &&
         lhs.ipv6_ == rhs.ipv6_ &&
+        lhs.batchedIO_ == rhs.batchedIO_ &&
+        lhs.erasureCoding_ == rhs.erasureCoding_ &&
+        lhs.roundTraceFile_ == rhs.roundTraceFile_ &&
         lhs.minNeighbours_ == rhs.minNeighbours_ &&
         lhs.maxNeighbours_ == rhs.maxNeighbours_ &&
         lhs.restrictNeighbours_ == rhs.restrictNeighbours_ &&
@@ -87,7 +87,13 @@ struct ApiData {
     bool executorMultiInstance = false;
     int executorCommitMin = 1506;   // first commit with support of checking
     int executorCommitMax{-1};      // unlimited range on the right
+    int executorConnections = 2;        // connections reserved for consensus contract executions
+    int executorGetterConnections = 2;  // connections for api getters, never used by consensus
+    int executorStateCacheSize = 256;   // megabytes of cached contract states, 0 disables cache
     std::string jpsCmdLine = "jps";
+    bool eventServer = false;           // public and ajax api are served by event loop, not thread per connection
+    int serverWorkers = 8;              // threads processing requests of event server
+    int serverMaxConnections = 10000;   // connections accepted by event server at once
 };
 
 struct ConveyerData {
@@ -193,6 +199,18 @@ public:
     bool useIPv6() const {
         return ipv6_;
     }
+    // recvmmsg/sendmmsg with UDP GSO at Linux, other platforms ignore it
+    bool useBatchedIO() const {
+        return batchedIO_;
+    }
+    // fragmented messages carry repair fragments, all the nodes must support it
+    bool useErasureCoding() const {
+        return erasureCoding_;
+    }
+    // consensus round timeline is dumped to the file, empty if disabled
+    const std::string& getRoundTraceFile() const {
+        return roundTraceFile_;
+    }
     bool hasTwoSockets() const {
         return twoSockets_;
     }
@@ -333,6 +351,9 @@ private:
     NodeVersion minCompatibleVersion_ = NODE_VERSION;
 
     bool ipv6_ = false;
+    bool batchedIO_ = false;
+    bool erasureCoding_ = false;
+    std::string roundTraceFile_;
 
     uint32_t minNeighbours_ = DEFAULT_MIN_NEIGHBOURS;
     uint32_t maxNeighbours_ = DEFAULT_MAX_NEIGHBOURS;
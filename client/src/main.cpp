@@ -11,6 +11,9 @@
 
 #include <csnode/node.hpp>
 #include <csnode/configholder.hpp>
+#include <csnode/roundtrace.hpp>
+
+#include <csdb/database_lmdb.hpp>
 
 #include <lib/system/logger.hpp>
 
@@ -159,6 +162,8 @@ int main(int argc, char* argv[]) {
     const char* argSeed = "seed";
     const char* argDumpKeys = "dumpkeys";
     const char* argSetBCTop = "set-bc-top";
+    const char* argMigrateDB = "migrate-db";
+    const char* argRenderTrace = "render-trace";
     const char* kDeprecatedDBPath = "test_db";
 
     using namespace boost::program_options;
@@ -168,8 +173,10 @@ int main(int argc, char* argv[]) {
         ("recreate-index", "recreate index.db")
         (argSeed, "enter with seed instead of keys")
         (argSetBCTop, po::value<uint64_t>(), "all blocks in blockchain with higher sequence will be removed")
+        (argMigrateDB, "convert BerkeleyDB block store at DB path to lmdb and exit")
         ("disable-auto-shutdown", "node will be prohibited to shutdown in case of fatal errors")
         (argVersion, "show node version")
+        (argRenderTrace, po::value<std::string>(), "print consensus rounds timeline from the round trace file and exit")
         (argDBPath, po::value<std::string>(), "path to DB (default: \"db/\")")
         ("config-file", po::value<std::string>(), "path to configuration file (default: \"config.ini\")")
         ("public-key-file", po::value<std::string>(), "path to public key file (default: \"NodePublic.txt\")")
@@ -219,6 +226,19 @@ int main(int argc, char* argv[]) {
         return EXIT_SUCCESS;
     }
 
+    if (vm.count(argRenderTrace) > 0) {
+        const auto path = vm[argRenderTrace].as<std::string>();
+        const auto events = cs::RoundTrace::load(path);
+
+        if (!events) {
+            cserror() << "Couldn't read round trace file " << path;
+            return EXIT_FAILURE;
+        }
+
+        cs::RoundTrace::render(events.value(), std::cout);
+        return EXIT_SUCCESS;
+    }
+
     // test db directory, exit if user did not rename old kDeprecatedDBPath and expect to use it as default one
     if (vm.count(argDBPath) == 0) {
         // arg is not set, so default dir is not "db_test"
@@ -243,6 +263,19 @@ int main(int argc, char* argv[]) {
         panic();
     }
 
+    if (vm.count(argMigrateDB) > 0) {
+        cslog() << "Migrating blockchain at " << config.getPathToDB() << " to lmdb...";
+
+        auto progress = [](uint64_t count) {
+            if (count % 1000 == 0) {
+                std::cout << '\r' << count << std::flush;
+            }
+        };
+
+        const bool result = csdb::DatabaseLmdb::migrateFromBerkeleyDB(config.getPathToDB(), progress);
+        return result ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     if (vm.count(argSeed) == 0) {
         if (!config.readKeys(vm)) {
             return EXIT_FAILURE;
@@ -1,11 +1,365 @@
 #include <benchmark/benchmark.h>
 
-static void bench(benchmark::State &state)
-{
-  for(auto _ : state)
-  {
-  }
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <csdb/address.hpp>
+#include <csdb/amount.hpp>
+#include <csdb/amount_commission.hpp>
+#include <csdb/currency.hpp>
+#include <csdb/pool.hpp>
+#include <csdb/storage.hpp>
+#include <csdb/transaction.hpp>
+
+#include <cscrypto/cscrypto.hpp>
+
+// All the data is generated, benchmarks do not need any existing blockchain
+namespace {
+constexpr size_t kWalletsCount = 100;
+constexpr size_t kChainLength = 1'000;
+constexpr size_t kChainTransactionsPerPool = 100;
+constexpr size_t kContractsCount = 1'000;
+
+struct Wallet {
+    cs::PublicKey publicKey;
+    cs::PrivateKey privateKey;
+};
+
+const std::vector<Wallet>& wallets() {
+    static const std::vector<Wallet> result = [] {
+        cscrypto::cryptoInit();
+
+        std::vector<Wallet> items;
+        items.reserve(kWalletsCount);
+
+        for (size_t i = 0; i < kWalletsCount; ++i) {
+            cs::PublicKey publicKey;
+            auto privateKey = cs::PrivateKey::generateWithPair(publicKey);
+            items.push_back(Wallet{publicKey, std::move(privateKey)});
+        }
+
+        return items;
+    }();
+
+    return result;
+}
+
+csdb::Address walletAddress(size_t index) {
+    return csdb::Address::from_public_key(wallets()[index % kWalletsCount].publicKey);
+}
+
+csdb::Transaction makeTransaction(size_t index, bool isSigned = false) {
+    const size_t source = index % kWalletsCount;
+    const size_t target = (index * 7 + 1) % kWalletsCount;
+
+    csdb::Transaction transaction(static_cast<int64_t>(index + 1), walletAddress(source), walletAddress(target), csdb::Currency(1),
+                                  csdb::Amount(static_cast<int32_t>(index % 1000), 5), csdb::AmountCommission(0.1), csdb::AmountCommission(0.01), cs::Signature{});
+
+    // every tenth transaction carries user data like contract calls do
+    if (index % 10 == 0) {
+        transaction.add_user_field(1, std::string(200, 'c'));
+    }
+
+    if (isSigned) {
+        const auto bytes = transaction.to_byte_stream_for_sig();
+        transaction.set_signature(cscrypto::generateSignature(wallets()[source].privateKey, bytes.data(), bytes.size()));
+    }
+
+    return transaction;
+}
+
+csdb::Pool makePool(const csdb::PoolHash& previous, cs::Sequence sequence, size_t transactionsCount, bool compose = true) {
+    csdb::Pool pool(previous, sequence);
+    pool.add_user_field(0, std::to_string(1'580'000'000'000ull + sequence));
+
+    for (size_t i = 0; i < transactionsCount; ++i) {
+        pool.add_transaction(makeTransaction(sequence * transactionsCount + i));
+    }
+
+    if (compose) {
+        pool.compose();
+    }
+
+    return pool;
+}
+
+// temporary storage, removed with all the data at exit
+class TemporaryStorage {
+public:
+    TemporaryStorage()
+    : path_(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("csdb_benchmark_%%%%-%%%%-%%%%")) {
+        storage_.open(path_.string());
+    }
+
+    ~TemporaryStorage() {
+        storage_.close();
+
+        boost::system::error_code code;
+        boost::filesystem::remove_all(path_, code);
+    }
+
+    csdb::Storage& storage() {
+        return storage_;
+    }
+
+private:
+    boost::filesystem::path path_;
+    csdb::Storage storage_;
+};
+
+// storage with the chain of kChainLength pools and kContractsCount contract states
+class ChainStorage : public TemporaryStorage {
+public:
+    ChainStorage() {
+        csdb::PoolHash previous;
+
+        for (cs::Sequence sequence = 0; sequence < kChainLength; ++sequence) {
+            auto pool = makePool(previous, sequence, kChainTransactionsPerPool);
+            previous = pool.hash();
+            storage().pool_save(pool);
+        }
+
+        for (size_t i = 0; i < kContractsCount; ++i) {
+            storage().update_contract_data(contract(i), cs::Bytes(4096, static_cast<cs::Byte>(i)));
+        }
+    }
+
+    static csdb::Address contract(size_t index) {
+        const size_t value = index + 1;
+
+        cs::PublicKey key{};
+        std::copy(reinterpret_cast<const cs::Byte*>(&value), reinterpret_cast<const cs::Byte*>(&value) + sizeof(value), key.begin());
+        return csdb::Address::from_public_key(key);
+    }
+
+    static ChainStorage& instance() {
+        static ChainStorage chain;
+        return chain;
+    }
+};
+}  // namespace
+
+static void BM_PoolCompose(benchmark::State& state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto pool = makePool(csdb::PoolHash{}, 1, count, false);
+        state.ResumeTiming();
+
+        pool.compose();
+        bytes += pool.to_binary().size();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_PoolCompose)->RangeMultiplier(10)->Range(10, 10'000);
+
+static void BM_PoolToBinary(benchmark::State& state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto pool = makePool(csdb::PoolHash{}, 1, count);
+
+    for (auto _ : state) {
+        auto binary = pool.to_binary();
+        benchmark::DoNotOptimize(binary.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * pool.to_binary().size()));
+}
+BENCHMARK(BM_PoolToBinary)->RangeMultiplier(10)->Range(10, 10'000);
+
+static void BM_PoolFromBinary(benchmark::State& state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto binary = makePool(csdb::PoolHash{}, 1, count).to_binary();
+
+    for (auto _ : state) {
+        auto pool = csdb::Pool::from_binary(cs::Bytes(binary));
+        benchmark::DoNotOptimize(pool.transactions_count());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * binary.size()));
+}
+BENCHMARK(BM_PoolFromBinary)->RangeMultiplier(10)->Range(10, 10'000);
+
+static void BM_TransactionToBinary(benchmark::State& state) {
+    auto transaction = makeTransaction(static_cast<size_t>(state.range(0)), true);
+
+    for (auto _ : state) {
+        auto binary = transaction.to_binary();
+        benchmark::DoNotOptimize(binary.data());
+    }
+}
+// 0 - transaction with user field, 1 - plain transfer
+BENCHMARK(BM_TransactionToBinary)->Arg(0)->Arg(1);
+
+static void BM_TransactionFromBinary(benchmark::State& state) {
+    const auto binary = makeTransaction(static_cast<size_t>(state.range(0)), true).to_binary();
+
+    for (auto _ : state) {
+        auto transaction = csdb::Transaction::from_binary(binary);
+        benchmark::DoNotOptimize(transaction.is_valid());
+    }
+}
+BENCHMARK(BM_TransactionFromBinary)->Arg(0)->Arg(1);
+
+static void BM_TransactionVerifySignature(benchmark::State& state) {
+    constexpr size_t count = 1'000;
+
+    std::vector<csdb::Transaction> transactions;
+    transactions.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        transactions.push_back(makeTransaction(i, true));
+    }
+
+    size_t index = 0;
+
+    for (auto _ : state) {
+        const auto& transaction = transactions[index++ % count];
+
+        if (!transaction.verify_signature(transaction.source().public_key())) {
+            state.SkipWithError("Signature is not valid");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_TransactionVerifySignature);
+
+static void BM_StoragePoolSave(benchmark::State& state) {
+    const auto count = static_cast<size_t>(state.range(0));
+
+    TemporaryStorage temporary;
+    csdb::PoolHash previous;
+    cs::Sequence sequence = 0;
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto pool = makePool(previous, sequence++, count);
+        previous = pool.hash();
+        bytes += pool.to_binary().size();
+        state.ResumeTiming();
+
+        if (!temporary.storage().pool_save(pool)) {
+            state.SkipWithError(temporary.storage().last_error_message().c_str());
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_StoragePoolSave)->RangeMultiplier(10)->Range(10, 1'000);
+
+static void BM_StorageTransactions(benchmark::State& state) {
+    auto& storage = ChainStorage::instance().storage();
+    const auto limit = static_cast<size_t>(state.range(0));
+    size_t index = 0;
+
+    for (auto _ : state) {
+        auto transactions = storage.transactions(walletAddress(index++), limit);
+        benchmark::DoNotOptimize(transactions.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * limit));
+}
+BENCHMARK(BM_StorageTransactions)->Arg(10)->Arg(100)->Arg(1'000);
+
+// the next page of address transactions, starts deep in the chain
+static void BM_StorageTransactionsOffset(benchmark::State& state) {
+    auto& storage = ChainStorage::instance().storage();
+    const auto limit = static_cast<size_t>(state.range(0));
+
+    const auto address = walletAddress(0);
+    const auto firstPage = storage.transactions(address, 500);
+
+    if (firstPage.empty()) {
+        state.SkipWithError("No transactions in chain");
+        return;
+    }
+
+    const auto offset = firstPage.back().id();
+
+    for (auto _ : state) {
+        auto transactions = storage.transactions(address, limit, offset);
+        benchmark::DoNotOptimize(transactions.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * limit));
+}
+BENCHMARK(BM_StorageTransactionsOffset)->Arg(10)->Arg(100);
+
+static void BM_StorageGetContractData(benchmark::State& state) {
+    auto& storage = ChainStorage::instance().storage();
+    size_t index = 0;
+    cs::Bytes data;
+
+    for (auto _ : state) {
+        if (!storage.get_contract_data(ChainStorage::contract(index++ % kContractsCount), data)) {
+            state.SkipWithError("Contract data is not found");
+            break;
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_StorageGetContractData);
+
+static void BM_AmountSum(benchmark::State& state) {
+    std::vector<csdb::Amount> amounts;
+
+    for (int32_t i = 0; i < 1'000; ++i) {
+        amounts.emplace_back(i, static_cast<uint64_t>(i) * 1'000'000'007ull);
+    }
+
+    for (auto _ : state) {
+        csdb::Amount sum;
+
+        for (const auto& amount : amounts) {
+            sum += amount;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * amounts.size()));
+}
+BENCHMARK(BM_AmountSum);
+
+static void BM_AmountMultiply(benchmark::State& state) {
+    const csdb::Amount amount(12'345, 678'900'000'000'000'000ull);
+    const csdb::Amount factor(0, 10'000'000'000'000'000ull);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(amount * factor);
+        benchmark::DoNotOptimize(amount * 0.001);
+    }
+}
+BENCHMARK(BM_AmountMultiply);
+
+static void BM_AmountCompare(benchmark::State& state) {
+    std::vector<csdb::Amount> amounts;
+
+    for (int32_t i = 0; i < 1'000; ++i) {
+        amounts.emplace_back((i * 7919) % 1'000, static_cast<uint64_t>(i));
+    }
+
+    for (auto _ : state) {
+        auto copy = amounts;
+        std::sort(copy.begin(), copy.end());
+        benchmark::DoNotOptimize(copy.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * amounts.size()));
 }
-BENCHMARK(bench);
+BENCHMARK(BM_AmountCompare);
 
 BENCHMARK_MAIN();
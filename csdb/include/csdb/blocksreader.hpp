@@ -0,0 +1,63 @@
+/**
+ * @file blocksreader.hpp
+ */
+
+#ifndef _CREDITS_CSDB_BLOCKS_READER_H_INCLUDED_
+#define _CREDITS_CSDB_BLOCKS_READER_H_INCLUDED_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <csdb/database.hpp>
+#include <csdb/pool.hpp>
+
+namespace csdb {
+
+/**
+ * @brief Pipelined reader of all stored blocks in sequence order
+ *
+ * Raw blocks are read from database in batches at own thread and decoded (so hashed)
+ * by tasks of cs::TaskRuntime, ordered consumer takes decoded batches while next ones are prepared.
+ */
+class BlocksReader {
+public:
+    enum Options : size_t {
+        BatchSize = 1000,
+        QueueDepth = 4
+    };
+
+    using Batch = std::vector<Pool>;
+
+    explicit BlocksReader(Database::IteratorPtr iterator, size_t batchSize = BatchSize);
+    ~BlocksReader();
+
+    BlocksReader(const BlocksReader&) = delete;
+    BlocksReader& operator=(const BlocksReader&) = delete;
+
+    // returns false if there are no more blocks
+    bool next(Batch& batch);
+
+    // decodes raw blocks in parallel, result is the same as of Pool::from_binary called in order
+    static Batch decode(std::vector<cs::Bytes>& raw);
+
+private:
+    void routine();
+
+    Database::IteratorPtr iterator_;
+    const size_t batchSize_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<Batch> queue_;
+
+    bool stop_ = false;
+    bool finished_ = false;
+};
+
+}  // namespace csdb
+
+#endif  // _CREDITS_CSDB_BLOCKS_READER_H_INCLUDED_
@@ -7,6 +7,7 @@
 #define _CREDITS_CSDB_DATABASE_H_INCLUDED_
 
 #include <client/params.hpp>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -38,6 +39,12 @@ public:
     virtual bool put(const cs::Bytes& key, uint32_t seq_no, const cs::Bytes& value) = 0;
     virtual bool get(const cs::Bytes& key, cs::Bytes* value = nullptr) = 0;
     virtual bool get(const uint32_t seq_no, cs::Bytes* value = nullptr) = 0;
+
+    // gives stored value to reader without copy if driver supports it,
+    // data is valid only inside reader call
+    using Reader = std::function<void(const cs::Byte* data, size_t size)>;
+    virtual bool read(const uint32_t seq_no, const Reader& reader);
+
     virtual bool remove(const cs::Bytes& key) = 0;
     virtual bool seq_no(const cs::Bytes& key, uint32_t* value) = 0; // sequence from block hash
 
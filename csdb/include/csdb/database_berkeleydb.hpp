@@ -7,6 +7,7 @@
 #define _CREDITS_CSDB_DATABASE_BERKELEY_H_INCLUDED_
 
 #include <db_cxx.h>
+#include <functional>
 #include <memory>
 #include <thread>
 
@@ -28,6 +29,9 @@ public:
 public:
     bool open(const std::string& path);
 
+    // iterates all contracts data pairs, stops when func returns false
+    bool forEachContract(const std::function<bool(const cs::Bytes& key, const cs::Bytes& data)>& func);
+
 private:
     bool is_open() const final;
     bool put(const cs::Bytes& key, uint32_t seq_no, const cs::Bytes& value) final;
@@ -0,0 +1,86 @@
+/**
+ * @file database_lmdb.hpp
+ */
+
+#ifndef _CREDITS_CSDB_DATABASE_LMDB_H_INCLUDED_
+#define _CREDITS_CSDB_DATABASE_LMDB_H_INCLUDED_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+#include <lmdb++.h>
+
+#include <csdb/database.hpp>
+
+namespace csdb {
+
+// block store at lmdb environment, blocks are keyed by sequence,
+// hash to sequence and contracts data tables live at the same environment,
+// so block put/remove is one write transaction
+class DatabaseLmdb : public Database {
+public:
+    enum Options : size_t {
+        DefaultMapSize = 1UL * 1024UL * 1024UL * 1024UL,
+        MaxMapIncreaseSize = 8UL * 1024UL * 1024UL * 1024UL
+    };
+
+    // file name of lmdb environment at database directory
+    static constexpr const char* kFileName = "blockchain.mdb";
+
+    DatabaseLmdb();
+    ~DatabaseLmdb() override;
+
+public:
+    bool open(const std::string& path);
+
+    // returns true if lmdb block store exists at path
+    static bool exists(const std::string& path);
+
+    // one-time import of all blocks and contracts data from BerkeleyDB files at path,
+    // lmdb store is created at the same path, callback receives count of imported blocks
+    using MigrateCallback = std::function<void(uint64_t)>;
+    static bool migrateFromBerkeleyDB(const std::string& path, MigrateCallback callback = nullptr);
+
+private:
+    bool is_open() const final;
+    bool put(const cs::Bytes& key, uint32_t seq_no, const cs::Bytes& value) final;
+    bool get(const cs::Bytes& key, cs::Bytes* value) final;
+    bool get(const uint32_t seq_no, cs::Bytes* value) final;
+    bool read(const uint32_t seq_no, const Reader& reader) final;
+    bool remove(const cs::Bytes&) final;
+    bool seq_no(const cs::Bytes& key, uint32_t* value) final;
+    bool write_batch(const ItemList&) final;
+    IteratorPtr new_iterator() final;
+
+    bool updateContractData(const cs::Bytes& key, const cs::Bytes& data) override;
+    bool getContractData(const cs::Bytes& key, cs::Bytes& data) override;
+
+private:
+    class Iterator;
+
+    // runs write transaction, grows map and retries on MDB_MAP_FULL
+    bool write(const std::function<bool(lmdb::txn&)>& func);
+    void increaseMapSize();
+
+    void set_last_error_from_lmdb(const lmdb::error& error);
+
+private:
+    std::unique_ptr<lmdb::env> env_;
+    MDB_dbi blocks_ = 0;
+    MDB_dbi sequences_ = 0;
+    MDB_dbi contracts_ = 0;
+
+    size_t mapSize_ = DefaultMapSize;
+
+    // map resize requires no active transactions in process,
+    // so every transaction holds shared lock while it lasts and resize takes it exclusively
+    mutable std::shared_mutex mapMutex_;
+    std::mutex writeMutex_;
+};
+
+}  // namespace csdb
+
+#endif  // _CREDITS_CSDB_DATABASE_LMDB_H_INCLUDED_
@@ -0,0 +1,120 @@
+/**
+ * @file poolview.hpp
+ */
+
+#ifndef _CREDITS_CSDB_POOL_VIEW_H_INCLUDED_
+#define _CREDITS_CSDB_POOL_VIEW_H_INCLUDED_
+
+#include <memory>
+#include <vector>
+
+#include <csdb/address.hpp>
+#include <csdb/amount.hpp>
+#include <csdb/amount_commission.hpp>
+#include <csdb/currency.hpp>
+#include <csdb/pool.hpp>
+#include <csdb/transaction.hpp>
+#include <csdb/user_field.hpp>
+
+#include <lib/system/common.hpp>
+
+namespace csdb {
+
+/**
+ * @brief Read-only transaction decoded in place from serialized pool
+ *
+ * Fields are decoded on every call, nothing is allocated until \ref to_transaction is called.
+ * View refers to data of \ref PoolView and is valid while any copy of the pool view exists.
+ */
+class TransactionView {
+public:
+    TransactionView() = default;
+
+    bool is_valid() const noexcept {
+        return data_ != nullptr;
+    }
+
+    TransactionID id() const;
+    int64_t innerID() const noexcept;
+    Address source() const;
+    Address target() const;
+    Currency currency() const;
+    Amount amount() const;
+    AmountCommission max_fee() const;
+    AmountCommission counted_fee() const;
+    cs::Signature signature() const;
+
+    // returns invalid user field if there is no field with id
+    UserField user_field(user_field_id_t id) const;
+
+    // serialized transaction, the same as Pool stores
+    const cs::Byte* data() const noexcept {
+        return data_;
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    // full decoding, result is the same as Pool::transaction() of decoded pool
+    Transaction to_transaction() const;
+
+private:
+    TransactionView(const cs::Byte* data, size_t size, cs::Sequence sequence, size_t index);
+
+    // offsets of fields, source and target may be stored as wallet id or public key
+    size_t targetOffset() const noexcept;
+    size_t amountOffset() const noexcept;
+    size_t userFieldsOffset() const noexcept;
+
+    const cs::Byte* data_ = nullptr;
+    size_t size_ = 0;
+    cs::Sequence sequence_ = 0;
+    size_t index_ = 0;
+
+    friend class PoolView;
+};
+
+/**
+ * @brief Read-only pool parsed in place
+ *
+ * Constructor only validates layout of serialized pool and builds offsets table of transactions,
+ * so transaction(i) is O(1) and no transaction object is created until it is requested.
+ * Copies of view share the same data.
+ */
+class PoolView {
+public:
+    PoolView() = default;
+    explicit PoolView(cs::Bytes&& data);
+
+    bool is_valid() const noexcept {
+        return static_cast<bool>(d_);
+    }
+
+    uint8_t version() const noexcept;
+    PoolHash previous_hash() const;
+    cs::Sequence sequence() const noexcept;
+    Amount roundCost() const;
+    UserField user_field(user_field_id_t id) const;
+    uint64_t get_time() const;
+
+    // hash of pool data, calculated on every call
+    PoolHash hash() const;
+
+    size_t transactions_count() const noexcept;
+    TransactionView transaction(size_t index) const;
+    TransactionView transaction(const TransactionID& id) const;
+
+    const cs::Bytes& to_binary() const;
+
+    // full decoding of pool, binary data is copied
+    Pool to_pool() const;
+
+private:
+    struct Data;
+    std::shared_ptr<const Data> d_;
+};
+
+}  // namespace csdb
+
+#endif  // _CREDITS_CSDB_POOL_VIEW_H_INCLUDED_
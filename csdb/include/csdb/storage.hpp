@@ -22,6 +22,7 @@ namespace csdb {
 
 class Pool;
 class PoolHash;
+class PoolView;
 class Address;
 class Wallet;
 class Transaction;
@@ -100,6 +101,7 @@ public:
 
     struct OpenProgress {
         uint64_t poolsProcessed;
+        uint64_t blocksPerSecond;  // average read speed from open start
     };
 
     /**
@@ -201,6 +203,15 @@ public:
      */
     Pool pool_load(const PoolHash& hash) const;
     Pool pool_load(const cs::Sequence sequence) const;
+
+    /**
+     * @brief Loads pool without decoding of transactions
+     * @param[in] sequence Sequence of pool
+     * @return View of pool, invalid if pool is not found or data can not be interpreted as pool
+     *
+     * \sa ::csdb::PoolView
+     */
+    PoolView pool_view(const cs::Sequence sequence) const;
     Pool pool_load_meta(const PoolHash& hash, size_t& cnt) const;
 
     Pool pool_remove_last();
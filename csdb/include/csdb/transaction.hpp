@@ -162,6 +162,7 @@ private:
   friend class ::csdb::priv::obstream;
   friend class ::csdb::priv::ibstream;
   friend class Pool;
+  friend class TransactionView;
 };
 
 }  // namespace csdb
@@ -0,0 +1,131 @@
+#include <csdb/blocksreader.hpp>
+
+#include <algorithm>
+
+#include <lib/system/taskruntime.hpp>
+
+namespace csdb {
+
+BlocksReader::BlocksReader(Database::IteratorPtr iterator, size_t batchSize)
+: iterator_(std::move(iterator))
+, batchSize_(std::max(batchSize, size_t(1))) {
+    thread_ = std::thread(&BlocksReader::routine, this);
+}
+
+BlocksReader::~BlocksReader() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+
+    condition_.notify_all();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // iterator is released at owner thread
+    iterator_.reset();
+}
+
+bool BlocksReader::next(Batch& batch) {
+    std::unique_lock lock(mutex_);
+    condition_.wait(lock, [this] { return !queue_.empty() || finished_; });
+
+    if (queue_.empty()) {
+        return false;
+    }
+
+    batch = std::move(queue_.front());
+    queue_.pop_front();
+
+    lock.unlock();
+    condition_.notify_all();
+
+    return true;
+}
+
+void BlocksReader::routine() {
+    iterator_->seek_to_first();
+
+    while (iterator_->is_valid()) {
+        std::vector<cs::Bytes> raw;
+        raw.reserve(batchSize_);
+
+        while (raw.size() < batchSize_ && iterator_->is_valid()) {
+            raw.push_back(iterator_->value());
+            iterator_->next();
+        }
+
+        Batch batch = decode(raw);
+
+        std::unique_lock lock(mutex_);
+        condition_.wait(lock, [this] { return queue_.size() < QueueDepth || stop_; });
+
+        if (stop_) {
+            break;
+        }
+
+        queue_.push_back(std::move(batch));
+        lock.unlock();
+        condition_.notify_all();
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        finished_ = true;
+    }
+
+    condition_.notify_all();
+}
+
+BlocksReader::Batch BlocksReader::decode(std::vector<cs::Bytes>& raw) {
+    Batch batch(raw.size());
+
+    if (raw.empty()) {
+        return batch;
+    }
+
+    auto decodeRange = [&raw, &batch](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            batch[i] = Pool::from_binary(std::move(raw[i]));
+        }
+    };
+
+    auto& runtime = cs::TaskRuntime::instance();
+    const size_t chunks = std::min(runtime.workersCount() + 1, raw.size());
+    const size_t chunk = (raw.size() + chunks - 1) / chunks;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t remaining = 0;
+
+    // the first chunk is decoded by reader thread while the others are at runtime workers
+    for (size_t begin = chunk; begin < raw.size(); begin += chunk) {
+        const size_t end = std::min(begin + chunk, raw.size());
+
+        {
+            std::lock_guard lock(mutex);
+            ++remaining;
+        }
+
+        runtime.submit([&, begin, end] {
+            decodeRange(begin, end);
+
+            std::lock_guard lock(mutex);
+
+            if (--remaining == 0) {
+                condition.notify_one();
+            }
+        });
+    }
+
+    decodeRange(0, std::min(chunk, raw.size()));
+
+    std::unique_lock lock(mutex);
+    condition.wait(lock, [&remaining] { return remaining == 0; });
+
+    return batch;
+}
+
+}  // namespace csdb
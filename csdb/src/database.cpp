@@ -22,6 +22,17 @@ Database::Database() {
 
 Database::~Database() = default;
 
+bool Database::read(const uint32_t seq_no, const Reader& reader) {
+    cs::Bytes value;
+
+    if (!get(seq_no, &value)) {
+        return false;
+    }
+
+    reader(value.data(), value.size());
+    return true;
+}
+
 Database::Iterator::Iterator() = default;
 
 Database::Iterator::~Iterator() = default;
@@ -578,4 +578,46 @@ bool DatabaseBerkeleyDB::getContractData(const cs::Bytes& key, cs::Bytes& data)
     return true;
 }
 
+bool DatabaseBerkeleyDB::forEachContract(const std::function<bool(const cs::Bytes& key, const cs::Bytes& data)>& func) {
+    if (!db_contracts_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    Dbc* cursorp = nullptr;
+    int status = db_contracts_->cursor(nullptr, &cursorp, 0);
+    if (status) {
+        set_last_error_from_berkeleydb(status);
+        return false;
+    }
+
+    auto g = cs::scopeGuard([&]() {
+        cursorp->close();
+    });
+
+    for (;;) {
+        Dbt_safe db_key;
+        Dbt_safe db_value;
+
+        status = cursorp->get(&db_key, &db_value, DB_NEXT);
+        if (status == DB_NOTFOUND) {
+            break;
+        }
+        if (status) {
+            set_last_error_from_berkeleydb(status);
+            return false;
+        }
+
+        auto keyBegin = static_cast<uint8_t*>(db_key.get_data());
+        auto valueBegin = static_cast<uint8_t*>(db_value.get_data());
+
+        if (!func(cs::Bytes(keyBegin, keyBegin + db_key.get_size()), cs::Bytes(valueBegin, valueBegin + db_value.get_size()))) {
+            return false;
+        }
+    }
+
+    set_last_error();
+    return true;
+}
+
 }  // namespace csdb
@@ -0,0 +1,572 @@
+#include <csdb/database_lmdb.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include <boost/filesystem.hpp>
+
+#include <csdb/database_berkeleydb.hpp>
+#include <csdb/pool.hpp>
+
+#include <lib/system/logger.hpp>
+
+namespace csdb {
+
+namespace {
+const char* kBlocksTable = "blocks";
+const char* kSequencesTable = "sequences";
+const char* kContractsTable = "contracts";
+
+const MDB_dbi kMaxTables = 3;
+
+std::string environmentPath(const std::string& path) {
+    return (boost::filesystem::path(path) / DatabaseLmdb::kFileName).string();
+}
+
+lmdb::val toVal(const cs::Bytes& bytes) {
+    return lmdb::val(bytes.data(), bytes.size());
+}
+
+void assign(const lmdb::val& value, cs::Bytes* result) {
+    auto begin = reinterpret_cast<const cs::Byte*>(value.data());
+    result->assign(begin, begin + value.size());
+}
+
+uint32_t toSequence(const lmdb::val& value) {
+    uint32_t result = std::numeric_limits<uint32_t>::max();
+
+    if (value.size() == sizeof(result)) {
+        std::memcpy(&result, value.data(), sizeof(result));
+    }
+
+    return result;
+}
+}  // namespace
+
+DatabaseLmdb::DatabaseLmdb() = default;
+
+DatabaseLmdb::~DatabaseLmdb() {
+    if (env_) {
+        std::unique_lock lock(mapMutex_);
+        env_->sync(true);
+        env_->close();
+    }
+}
+
+bool DatabaseLmdb::exists(const std::string& path) {
+    return boost::filesystem::exists(environmentPath(path));
+}
+
+bool DatabaseLmdb::open(const std::string& path) {
+    boost::filesystem::path direc(path);
+    if (boost::filesystem::exists(direc)) {
+        if (!boost::filesystem::is_directory(direc)) {
+            set_last_error(InvalidArgument, "%s is not a directory", path.c_str());
+            return false;
+        }
+    }
+    else {
+        if (!boost::filesystem::create_directories(direc)) {
+            set_last_error(IOError, "can not create %s", path.c_str());
+            return false;
+        }
+    }
+
+    try {
+        auto env = std::make_unique<lmdb::env>(lmdb::env::create());
+        env->set_max_dbs(kMaxTables);
+
+        // map can not be less than file, so start from current file size
+        const auto file = environmentPath(path);
+        if (boost::filesystem::exists(file)) {
+            mapSize_ = std::max(mapSize_, static_cast<size_t>(boost::filesystem::file_size(file)) * 2);
+        }
+
+        env->set_mapsize(mapSize_);
+
+        // blocks are written once and may be restored from network,
+        // so durability of the last transactions is traded for write speed like BerkeleyDB DB_TXN_NOSYNC did
+        env->open(file.c_str(), MDB_NOSUBDIR | MDB_NOTLS | MDB_NOSYNC, 0664);
+
+        auto txn = lmdb::txn::begin(*env);
+        blocks_ = lmdb::dbi::open(txn, kBlocksTable, MDB_CREATE | MDB_INTEGERKEY).handle();
+        sequences_ = lmdb::dbi::open(txn, kSequencesTable, MDB_CREATE).handle();
+        contracts_ = lmdb::dbi::open(txn, kContractsTable, MDB_CREATE).handle();
+        txn.commit();
+
+        env_ = std::move(env);
+    }
+    catch (const lmdb::error& error) {
+        set_last_error_from_lmdb(error);
+        return false;
+    }
+
+    set_last_error();
+    return true;
+}
+
+bool DatabaseLmdb::is_open() const {
+    return static_cast<bool>(env_);
+}
+
+void DatabaseLmdb::set_last_error_from_lmdb(const lmdb::error& error) {
+    Error err = UnknownError;
+
+    switch (error.code()) {
+        case MDB_NOTFOUND:
+            err = NotFound;
+            break;
+        case MDB_CORRUPTED:
+        case MDB_PAGE_NOTFOUND:
+            err = Corruption;
+            break;
+        case MDB_INVALID:
+        case MDB_VERSION_MISMATCH:
+            err = NotSupported;
+            break;
+        default:
+            break;
+    }
+
+    set_last_error(err, "LMDB error: %s", error.what());
+}
+
+void DatabaseLmdb::increaseMapSize() {
+    std::unique_lock lock(mapMutex_);
+
+    mapSize_ += std::min(mapSize_, static_cast<size_t>(MaxMapIncreaseSize));
+    env_->set_mapsize(mapSize_);
+
+    cslog() << "DatabaseLmdb> map size increased to " << mapSize_;
+}
+
+bool DatabaseLmdb::write(const std::function<bool(lmdb::txn&)>& func) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    std::lock_guard writeLock(writeMutex_);
+
+    for (;;) {
+        try {
+            bool result = false;
+
+            {
+                std::shared_lock lock(mapMutex_);
+                auto txn = lmdb::txn::begin(*env_);
+
+                result = func(txn);
+
+                if (result) {
+                    txn.commit();
+                }
+                else {
+                    txn.abort();
+                }
+            }
+
+            if (result) {
+                set_last_error();
+            }
+
+            return result;
+        }
+        catch (const lmdb::map_full_error&) {
+            increaseMapSize();
+        }
+        catch (const lmdb::error& error) {
+            set_last_error_from_lmdb(error);
+            return false;
+        }
+    }
+}
+
+bool DatabaseLmdb::put(const cs::Bytes& key, uint32_t seq_no, const cs::Bytes& value) {
+    return write([&](lmdb::txn& txn) {
+        lmdb::val sequence(&seq_no, sizeof(seq_no));
+        lmdb::val data = toVal(value);
+        lmdb::val hash = toVal(key);
+
+        lmdb::dbi_put(txn, blocks_, sequence, data, 0);
+        lmdb::dbi_put(txn, sequences_, hash, sequence, 0);
+
+        return true;
+    });
+}
+
+bool DatabaseLmdb::get(const cs::Bytes& key, cs::Bytes* value) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    try {
+        std::shared_lock lock(mapMutex_);
+        auto txn = lmdb::txn::begin(*env_, nullptr, MDB_RDONLY);
+
+        lmdb::val hash = toVal(key);
+        lmdb::val sequence;
+
+        if (!lmdb::dbi_get(txn, sequences_, hash, sequence)) {
+            set_last_error(NotFound);
+            return false;
+        }
+
+        if (value == nullptr) {
+            set_last_error();
+            return true;
+        }
+
+        // both lookups share one read transaction, data is copied once from the map
+        lmdb::val data;
+
+        if (!lmdb::dbi_get(txn, blocks_, sequence, data)) {
+            set_last_error(NotFound);
+            return false;
+        }
+
+        assign(data, value);
+    }
+    catch (const lmdb::error& error) {
+        set_last_error_from_lmdb(error);
+        return false;
+    }
+
+    set_last_error();
+    return true;
+}
+
+bool DatabaseLmdb::get(const uint32_t seq_no, cs::Bytes* value) {
+    if (value == nullptr) {
+        return false;
+    }
+
+    return read(seq_no, [value](const cs::Byte* data, size_t size) {
+        value->assign(data, data + size);
+    });
+}
+
+bool DatabaseLmdb::read(const uint32_t seq_no, const Reader& reader) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    try {
+        std::shared_lock lock(mapMutex_);
+        auto txn = lmdb::txn::begin(*env_, nullptr, MDB_RDONLY);
+
+        lmdb::val sequence(&seq_no, sizeof(seq_no));
+        lmdb::val data;
+
+        if (!lmdb::dbi_get(txn, blocks_, sequence, data)) {
+            set_last_error(NotFound);
+            return false;
+        }
+
+        // data points to mapped page and is valid until transaction ends
+        reader(reinterpret_cast<const cs::Byte*>(data.data()), data.size());
+    }
+    catch (const lmdb::error& error) {
+        set_last_error_from_lmdb(error);
+        return false;
+    }
+
+    set_last_error();
+    return true;
+}
+
+bool DatabaseLmdb::seq_no(const cs::Bytes& key, uint32_t* value) {
+    if (value == nullptr) {
+        set_last_error(InvalidArgument);
+        return false;
+    }
+
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    try {
+        std::shared_lock lock(mapMutex_);
+        auto txn = lmdb::txn::begin(*env_, nullptr, MDB_RDONLY);
+
+        lmdb::val hash = toVal(key);
+        lmdb::val sequence;
+
+        if (!lmdb::dbi_get(txn, sequences_, hash, sequence)) {
+            set_last_error(NotFound);
+            return false;
+        }
+
+        *value = toSequence(sequence);
+    }
+    catch (const lmdb::error& error) {
+        set_last_error_from_lmdb(error);
+        return false;
+    }
+
+    set_last_error();
+    return true;
+}
+
+bool DatabaseLmdb::remove(const cs::Bytes& key) {
+    return write([&](lmdb::txn& txn) {
+        lmdb::val hash = toVal(key);
+        lmdb::val sequence;
+
+        if (!lmdb::dbi_get(txn, sequences_, hash, sequence)) {
+            set_last_error(NotFound);
+            return false;
+        }
+
+        // value is at transaction page, copy it before del
+        uint32_t seq = toSequence(sequence);
+        lmdb::val sequenceKey(&seq, sizeof(seq));
+
+        lmdb::dbi_del(txn, sequences_, hash, nullptr);
+
+        if (!lmdb::dbi_del(txn, blocks_, sequenceKey, nullptr)) {
+            set_last_error(NotFound);
+            return false;
+        }
+
+        return true;
+    });
+}
+
+bool DatabaseLmdb::write_batch(const ItemList& items) {
+    // items are (key, value) pairs of contracts table
+    return write([&](lmdb::txn& txn) {
+        for (const auto& [key, value] : items) {
+            lmdb::val k = toVal(key);
+            lmdb::val v = toVal(value);
+            lmdb::dbi_put(txn, contracts_, k, v, 0);
+        }
+
+        return true;
+    });
+}
+
+bool DatabaseLmdb::updateContractData(const cs::Bytes& key, const cs::Bytes& data) {
+    return write([&](lmdb::txn& txn) {
+        lmdb::val k = toVal(key);
+        lmdb::val v = toVal(data);
+
+        lmdb::dbi_put(txn, contracts_, k, v, 0);
+        return true;
+    });
+}
+
+bool DatabaseLmdb::getContractData(const cs::Bytes& key, cs::Bytes& data) {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return false;
+    }
+
+    try {
+        std::shared_lock lock(mapMutex_);
+        auto txn = lmdb::txn::begin(*env_, nullptr, MDB_RDONLY);
+
+        lmdb::val k = toVal(key);
+        lmdb::val value;
+
+        if (!lmdb::dbi_get(txn, contracts_, k, value)) {
+            set_last_error(NotFound);
+            return false;
+        }
+
+        assign(value, &data);
+    }
+    catch (const lmdb::error& error) {
+        set_last_error_from_lmdb(error);
+        return false;
+    }
+
+    set_last_error();
+    return true;
+}
+
+// iterates blocks table in sequence order,
+// every step is a short read transaction continued from the last key, so iterator does not
+// hold map lock and writes may grow map while it is alive
+class DatabaseLmdb::Iterator final : public Database::Iterator {
+public:
+    explicit Iterator(DatabaseLmdb& database)
+    : database_(database) {
+    }
+
+    bool is_valid() const final {
+        return valid_;
+    }
+
+    void seek_to_first() final {
+        move(MDB_FIRST);
+    }
+
+    void seek_to_last() final {
+        move(MDB_LAST);
+    }
+
+    void seek(const cs::Bytes&) final {
+        assert(false);
+    }
+
+    void next() final {
+        move(MDB_NEXT);
+    }
+
+    void prev() final {
+        move(MDB_PREV);
+    }
+
+    uint32_t key() const final {
+        return valid_ ? key_ : std::numeric_limits<uint32_t>::max();
+    }
+
+    cs::Bytes value() const final {
+        return valid_ ? value_ : cs::Bytes{};
+    }
+
+private:
+    void move(MDB_cursor_op op) {
+        const bool step = (op == MDB_NEXT || op == MDB_PREV);
+
+        if (step && !valid_) {
+            return;
+        }
+
+        try {
+            std::shared_lock lock(database_.mapMutex_);
+            auto txn = lmdb::txn::begin(*database_.env_, nullptr, MDB_RDONLY);
+            auto cursor = lmdb::cursor::open(txn, database_.blocks_);
+
+            lmdb::val key;
+            lmdb::val value;
+            bool found = false;
+
+            if (step) {
+                // cursor is restored at the last key, or the next one if it was removed meanwhile
+                uint32_t current = key_;
+                key = lmdb::val(&current, sizeof(current));
+                found = cursor.get(key, value, MDB_SET_RANGE);
+
+                if (found && toSequence(key) == key_) {
+                    found = cursor.get(key, value, op);
+                }
+                else if (op == MDB_PREV) {
+                    found = cursor.get(key, value, found ? MDB_PREV : MDB_LAST);
+                }
+            }
+            else {
+                found = cursor.get(key, value, op);
+            }
+
+            valid_ = found;
+
+            if (valid_) {
+                key_ = toSequence(key);
+                assign(value, &value_);
+            }
+        }
+        catch (const lmdb::error& error) {
+            cserror() << "DatabaseLmdb> iterator failed, " << error.what();
+            valid_ = false;
+        }
+    }
+
+    DatabaseLmdb& database_;
+
+    uint32_t key_ = 0;
+    cs::Bytes value_;
+    bool valid_ = false;
+};
+
+DatabaseLmdb::IteratorPtr DatabaseLmdb::new_iterator() {
+    if (!env_) {
+        set_last_error(NotOpen);
+        return nullptr;
+    }
+
+    return std::make_shared<DatabaseLmdb::Iterator>(*this);
+}
+
+bool DatabaseLmdb::migrateFromBerkeleyDB(const std::string& path, MigrateCallback callback) {
+    if (exists(path)) {
+        cserror() << "DatabaseLmdb> lmdb store already exists at " << path;
+        return false;
+    }
+
+    DatabaseBerkeleyDB source;
+    if (!source.open(path)) {
+        cserror() << "DatabaseLmdb> can not open BerkeleyDB at " << path << ", " << source.last_error_message();
+        return false;
+    }
+
+    bool result = false;
+    uint64_t count = 0;
+
+    {
+        DatabaseLmdb target;
+        if (!target.open(path)) {
+            cserror() << "DatabaseLmdb> can not create lmdb store at " << path << ", " << target.last_error_message();
+            return false;
+        }
+
+        Database& from = source;
+        Database& to = target;
+
+        auto iter = from.new_iterator();
+        if (!iter) {
+            return false;
+        }
+
+        result = true;
+
+        for (iter->seek_to_first(); result && iter->is_valid(); iter->next()) {
+            const auto sequence = iter->key();
+            auto value = iter->value();
+
+            auto hash = Pool::hash_from_binary(cs::Bytes(value));
+            if (hash.is_empty()) {
+                cserror() << "DatabaseLmdb> corrupted block " << sequence << " found, migration stopped";
+                result = false;
+            }
+            else if (!to.put(hash.to_binary(), sequence, value)) {
+                cserror() << "DatabaseLmdb> failed to put block " << sequence << ", " << target.last_error_message();
+                result = false;
+            }
+            else if (callback) {
+                callback(++count);
+            }
+            else {
+                ++count;
+            }
+        }
+
+        if (result) {
+            result = source.forEachContract([&to](const cs::Bytes& key, const cs::Bytes& data) {
+                return to.updateContractData(key, data);
+            });
+
+            if (!result) {
+                cserror() << "DatabaseLmdb> failed to migrate contracts data, " << target.last_error_message();
+            }
+        }
+    }
+
+    if (!result) {
+        // partial store must not be opened instead of BerkeleyDB next time
+        boost::system::error_code code;
+        boost::filesystem::remove(environmentPath(path), code);
+        boost::filesystem::remove(environmentPath(path) + "-lock", code);
+        return false;
+    }
+
+    cslog() << "DatabaseLmdb> migrated " << count << " blocks from BerkeleyDB";
+    return true;
+}
+
+}  // namespace csdb
@@ -0,0 +1,466 @@
+#include <csdb/poolview.hpp>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "binary_streams.hpp"
+#include "transaction_p.hpp"
+
+namespace {
+// layout constants of serialized transaction, see Transaction::put()
+constexpr size_t kInnerIdSize = sizeof(uint16_t) + sizeof(uint32_t);
+constexpr uint32_t kSourceIsWalletId = 0x80000000;
+constexpr uint32_t kTargetIsWalletId = 0x40000000;
+constexpr size_t kAmountSize = sizeof(int32_t) + sizeof(uint64_t);
+constexpr size_t kFeeSize = sizeof(uint16_t);
+constexpr size_t kCurrencySize = sizeof(uint8_t);
+constexpr size_t kSignatureSize = cscrypto::kSignatureSize;
+
+// new wallet is stored as address id (size_t) and wallet id, see Pool::NewWalletInfo::put()
+constexpr size_t kNewWalletSize = sizeof(size_t) + sizeof(csdb::internal::WalletId);
+
+// bounds checked reader over serialized pool
+class Reader {
+public:
+    Reader(const cs::Byte* data, size_t size)
+    : data_(data)
+    , size_(size) {
+    }
+
+    template <typename T>
+    bool read(T& value) {
+        if (!has(sizeof(T))) {
+            return false;
+        }
+
+        std::memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    bool skip(size_t size) {
+        if (!has(size)) {
+            return false;
+        }
+
+        pos_ += size;
+        return true;
+    }
+
+    // skips user fields map, see obstream::put(std::map) and UserField::put()
+    bool skipUserFields() {
+        uint8_t count = 0;
+
+        if (!read(count)) {
+            return false;
+        }
+
+        for (uint8_t i = 0; i < count; ++i) {
+            if (!skip(sizeof(csdb::user_field_id_t)) || !skipUserFieldValue()) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool skipUserFieldValue() {
+        csdb::UserField::Type type = csdb::UserField::Unknown;
+
+        if (!read(type)) {
+            return false;
+        }
+
+        switch (type) {
+            case csdb::UserField::Integer:
+                return skip(sizeof(uint64_t));
+
+            case csdb::UserField::String: {
+                uint32_t length = 0;
+                return read(length) && skip(length);
+            }
+
+            case csdb::UserField::Amount:
+                return skip(kAmountSize);
+
+            default:
+                return false;
+        }
+    }
+
+    // skips transaction, see Transaction::put()
+    bool skipTransaction() {
+        uint16_t lo = 0;
+        uint32_t hi = 0;
+
+        if (!read(lo) || !read(hi)) {
+            return false;
+        }
+
+        const size_t sourceSize = (hi & kSourceIsWalletId) ? sizeof(csdb::internal::WalletId) : cscrypto::kPublicKeySize;
+        const size_t targetSize = (hi & kTargetIsWalletId) ? sizeof(csdb::internal::WalletId) : cscrypto::kPublicKeySize;
+
+        return skip(sourceSize + targetSize + kAmountSize + kFeeSize + kCurrencySize) &&
+               skipUserFields() &&
+               skip(kSignatureSize + kFeeSize);
+    }
+
+    bool has(size_t size) const {
+        return size <= size_ - pos_;
+    }
+
+    size_t position() const {
+        return pos_;
+    }
+
+private:
+    const cs::Byte* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+// looks through serialized user fields map for id, returns invalid field if not found
+csdb::UserField findUserField(const cs::Byte* data, size_t size, csdb::user_field_id_t id) {
+    Reader reader(data, size);
+    uint8_t count = 0;
+
+    if (!reader.read(count)) {
+        return csdb::UserField{};
+    }
+
+    for (uint8_t i = 0; i < count; ++i) {
+        csdb::user_field_id_t key = 0;
+
+        if (!reader.read(key)) {
+            break;
+        }
+
+        if (key != id) {
+            if (!reader.skipUserFieldValue()) {
+                break;
+            }
+
+            continue;
+        }
+
+        csdb::UserField field;
+        csdb::priv::ibstream is(data + reader.position(), size - reader.position());
+
+        if (!is.get(field)) {
+            break;
+        }
+
+        return field;
+    }
+
+    return csdb::UserField{};
+}
+
+template <typename T>
+T decode(const cs::Byte* data, size_t size) {
+    T value;
+    csdb::priv::ibstream is(data, size);
+    is.get(value);
+    return value;
+}
+}  // namespace
+
+namespace csdb {
+
+struct PoolView::Data {
+    cs::Bytes bytes;
+    uint8_t version = 0;
+    size_t previousHashOffset = 0;
+    cs::Sequence sequence = 0;
+    size_t userFieldsOffset = 0;
+    size_t roundCostOffset = 0;
+    size_t hashingLength = 0;
+
+    // offsets of transactions begin and the end of the last one
+    std::vector<size_t> offsets;
+
+    bool parse() {
+        Reader reader(bytes.data(), bytes.size());
+
+        uint8_t hashSize = 0;
+        previousHashOffset = sizeof(version);
+
+        if (!reader.read(version) || !reader.read(hashSize) || (hashSize != 0 && hashSize != cscrypto::kHashSize) || !reader.skip(hashSize)) {
+            return false;
+        }
+
+        if (!reader.read(sequence)) {
+            return false;
+        }
+
+        userFieldsOffset = reader.position();
+
+        if (!reader.skipUserFields()) {
+            return false;
+        }
+
+        roundCostOffset = reader.position();
+        uint32_t count = 0;
+
+        if (!reader.skip(kAmountSize) || !reader.read(count)) {
+            return false;
+        }
+
+        offsets.reserve(count + 1);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            offsets.push_back(reader.position());
+
+            if (!reader.skipTransaction()) {
+                return false;
+            }
+        }
+
+        offsets.push_back(reader.position());
+
+        // the rest of hashed data, see Pool::priv::get_hashed_data()
+        uint32_t newWalletsCount = 0;
+        uint8_t numberTrusted = 0;
+        uint64_t realTrusted = 0;
+        uint8_t numberConfirmations = 0;
+        uint64_t confirmationMask = 0;
+
+        if (!reader.read(newWalletsCount) || !reader.skip(static_cast<size_t>(newWalletsCount) * kNewWalletSize)) {
+            return false;
+        }
+
+        if (!reader.read(numberTrusted) || !reader.read(realTrusted) || !reader.skip(static_cast<size_t>(numberTrusted) * cscrypto::kPublicKeySize)) {
+            return false;
+        }
+
+        if (!reader.read(numberConfirmations) || !reader.read(confirmationMask)) {
+            return false;
+        }
+
+#ifdef _MSC_VER
+        const size_t confirmationsCount = static_cast<size_t>(__popcnt64(confirmationMask));
+#else
+        const size_t confirmationsCount = static_cast<size_t>(__builtin_popcountll(confirmationMask));
+#endif
+
+        if (!reader.skip(confirmationsCount * kSignatureSize)) {
+            return false;
+        }
+
+        const size_t hashedSize = reader.position();
+        return reader.read(hashingLength) && hashingLength == hashedSize;
+    }
+};
+
+TransactionView::TransactionView(const cs::Byte* data, size_t size, cs::Sequence sequence, size_t index)
+: data_(data)
+, size_(size)
+, sequence_(sequence)
+, index_(index) {
+}
+
+size_t TransactionView::targetOffset() const noexcept {
+    uint32_t hi = 0;
+    std::memcpy(&hi, data_ + sizeof(uint16_t), sizeof(hi));
+    return kInnerIdSize + ((hi & kSourceIsWalletId) ? sizeof(internal::WalletId) : cscrypto::kPublicKeySize);
+}
+
+size_t TransactionView::amountOffset() const noexcept {
+    uint32_t hi = 0;
+    std::memcpy(&hi, data_ + sizeof(uint16_t), sizeof(hi));
+    return targetOffset() + ((hi & kTargetIsWalletId) ? sizeof(internal::WalletId) : cscrypto::kPublicKeySize);
+}
+
+size_t TransactionView::userFieldsOffset() const noexcept {
+    return amountOffset() + kAmountSize + kFeeSize + kCurrencySize;
+}
+
+TransactionID TransactionView::id() const {
+    return is_valid() ? TransactionID(sequence_, static_cast<cs::Sequence>(index_)) : TransactionID{};
+}
+
+int64_t TransactionView::innerID() const noexcept {
+    if (!is_valid()) {
+        return 0;
+    }
+
+    uint16_t lo = 0;
+    uint32_t hi = 0;
+    std::memcpy(&lo, data_, sizeof(lo));
+    std::memcpy(&hi, data_ + sizeof(lo), sizeof(hi));
+
+    return static_cast<int64_t>((((uint64_t)hi & 0x3fffffff) << 16) | lo);
+}
+
+Address TransactionView::source() const {
+    if (!is_valid()) {
+        return Address{};
+    }
+
+    uint32_t hi = 0;
+    std::memcpy(&hi, data_ + sizeof(uint16_t), sizeof(hi));
+    const auto ptr = data_ + kInnerIdSize;
+
+    if (hi & kSourceIsWalletId) {
+        internal::WalletId id = 0;
+        std::memcpy(&id, ptr, sizeof(id));
+        return Address::from_wallet_id(id);
+    }
+
+    return Address::from_public_key(reinterpret_cast<const char*>(ptr));
+}
+
+Address TransactionView::target() const {
+    if (!is_valid()) {
+        return Address{};
+    }
+
+    uint32_t hi = 0;
+    std::memcpy(&hi, data_ + sizeof(uint16_t), sizeof(hi));
+    const auto ptr = data_ + targetOffset();
+
+    if (hi & kTargetIsWalletId) {
+        internal::WalletId id = 0;
+        std::memcpy(&id, ptr, sizeof(id));
+        return Address::from_wallet_id(id);
+    }
+
+    return Address::from_public_key(reinterpret_cast<const char*>(ptr));
+}
+
+Amount TransactionView::amount() const {
+    return is_valid() ? decode<Amount>(data_ + amountOffset(), kAmountSize) : Amount{};
+}
+
+AmountCommission TransactionView::max_fee() const {
+    return is_valid() ? decode<AmountCommission>(data_ + amountOffset() + kAmountSize, kFeeSize) : AmountCommission{};
+}
+
+Currency TransactionView::currency() const {
+    return is_valid() ? Currency(data_[amountOffset() + kAmountSize + kFeeSize]) : Currency{};
+}
+
+AmountCommission TransactionView::counted_fee() const {
+    return is_valid() ? decode<AmountCommission>(data_ + size_ - kFeeSize, kFeeSize) : AmountCommission{};
+}
+
+cs::Signature TransactionView::signature() const {
+    cs::Signature result{};
+
+    if (is_valid()) {
+        std::memcpy(result.data(), data_ + size_ - kFeeSize - kSignatureSize, kSignatureSize);
+    }
+
+    return result;
+}
+
+UserField TransactionView::user_field(user_field_id_t id) const {
+    if (!is_valid()) {
+        return UserField{};
+    }
+
+    const auto offset = userFieldsOffset();
+    return findUserField(data_ + offset, size_ - offset, id);
+}
+
+Transaction TransactionView::to_transaction() const {
+    if (!is_valid()) {
+        return Transaction{};
+    }
+
+    Transaction result;
+    ::csdb::priv::ibstream is(data_, size_);
+
+    if (!result.get(is)) {
+        return Transaction{};
+    }
+
+    result.d->_update_id(sequence_, static_cast<cs::Sequence>(index_));
+    return result;
+}
+
+PoolView::PoolView(cs::Bytes&& data) {
+    auto d = std::make_shared<Data>();
+    d->bytes = std::move(data);
+
+    if (d->parse()) {
+        d_ = std::move(d);
+    }
+}
+
+uint8_t PoolView::version() const noexcept {
+    return d_ ? d_->version : 0;
+}
+
+PoolHash PoolView::previous_hash() const {
+    if (!d_) {
+        return PoolHash{};
+    }
+
+    PoolHash result;
+    ::csdb::priv::ibstream is(d_->bytes.data() + d_->previousHashOffset, d_->bytes.size() - d_->previousHashOffset);
+    is.get(result);
+
+    return result;
+}
+
+cs::Sequence PoolView::sequence() const noexcept {
+    return d_ ? d_->sequence : 0;
+}
+
+Amount PoolView::roundCost() const {
+    return d_ ? decode<Amount>(d_->bytes.data() + d_->roundCostOffset, kAmountSize) : Amount{};
+}
+
+UserField PoolView::user_field(user_field_id_t id) const {
+    if (!d_) {
+        return UserField{};
+    }
+
+    return findUserField(d_->bytes.data() + d_->userFieldsOffset, d_->roundCostOffset - d_->userFieldsOffset, id);
+}
+
+uint64_t PoolView::get_time() const {
+    return atoll(user_field(0).value<std::string>().c_str());
+}
+
+PoolHash PoolView::hash() const {
+    if (!d_) {
+        return PoolHash{};
+    }
+
+    const auto begin = d_->bytes.data();
+    return PoolHash::calc_from_data(cs::Bytes(begin, begin + d_->hashingLength));
+}
+
+size_t PoolView::transactions_count() const noexcept {
+    return d_ ? d_->offsets.size() - 1 : 0;
+}
+
+TransactionView PoolView::transaction(size_t index) const {
+    if (index >= transactions_count()) {
+        return TransactionView{};
+    }
+
+    const auto begin = d_->offsets[index];
+    return TransactionView(d_->bytes.data() + begin, d_->offsets[index + 1] - begin, d_->sequence, index);
+}
+
+TransactionView PoolView::transaction(const TransactionID& id) const {
+    if (!d_ || !id.is_valid() || id.pool_seq() != d_->sequence) {
+        return TransactionView{};
+    }
+
+    return transaction(static_cast<size_t>(id.index()));
+}
+
+const cs::Bytes& PoolView::to_binary() const {
+    static const cs::Bytes empty;
+    return d_ ? d_->bytes : empty;
+}
+
+Pool PoolView::to_pool() const {
+    return d_ ? Pool::from_binary(cs::Bytes(d_->bytes)) : Pool{};
+}
+
+}  // namespace csdb
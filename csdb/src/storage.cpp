@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <cstdarg>
 #include <deque>
@@ -11,6 +12,7 @@
 #include <stdexcept>
 #include <thread>
 
+#include <boost/filesystem.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
@@ -19,11 +21,14 @@
 #include <lib/system/utils.hpp>
 
 #include <csdb/address.hpp>
+#include <csdb/blocksreader.hpp>
 #include <csdb/database.hpp>
 #include <csdb/database_berkeleydb.hpp>
+#include <csdb/database_lmdb.hpp>
 #include <csdb/internal/shared_data_ptr_implementation.hpp>
 #include <csdb/internal/utils.hpp>
 #include <csdb/pool.hpp>
+#include <csdb/poolview.hpp>
 #include <csdb/wallet.hpp>
 
 #include "binary_streams.hpp"
@@ -248,36 +253,43 @@ bool Storage::priv::rescan(Storage::OpenCallback callback) {
         emit start_reading_event(0);
     }
 
-    Storage::OpenProgress progress{0};
-    for (it->seek_to_first(); it->is_valid(); it->next()) {
-        cs::Bytes v = it->value();
+    Storage::OpenProgress progress{0, 0};
+    const auto startTime = std::chrono::steady_clock::now();
 
-        Pool p = Pool::from_binary(std::move(v));
-        if (!p.is_valid()) {
-            set_last_error(Storage::DataIntegrityError, "Data integrity error: Corrupted pool %d.", count_pool);
-            cserror() << "Please restart node with command : client --set-bc-top " << count_pool - 1;
-            return false;
-        }
-        pools_cache_insert(p.sequence(), p.hash(), p);
+    BlocksReader reader(std::move(it));
+    BlocksReader::Batch batch;
 
-        bool test_failed = false;
-        last_hash = p.hash();
-        count_pool++;
-
-        emit read_block_event(p, &test_failed);
-        if (test_failed) {
-            set_last_error(Storage::DataIntegrityError, "Data integrity error: client reported violation of logic in pool %d", p.sequence());
-            return false;
-        }
+    while (reader.next(batch)) {
+        for (auto& p : batch) {
+            if (!p.is_valid()) {
+                set_last_error(Storage::DataIntegrityError, "Data integrity error: Corrupted pool %d.", count_pool);
+                cserror() << "Please restart node with command : client --set-bc-top " << count_pool - 1;
+                return false;
+            }
+            pools_cache_insert(p.sequence(), p.hash(), p);
 
-        //update_heads_and_tails(heads, tails, p.hash(), p.previous_hash());
-        progress.poolsProcessed++;
+            bool test_failed = false;
+            last_hash = p.hash();
+            count_pool++;
 
-        if (callback != nullptr) {
-            if (callback(progress)) {
-                set_last_error(Storage::UserCancelled);
+            emit read_block_event(p, &test_failed);
+            if (test_failed) {
+                set_last_error(Storage::DataIntegrityError, "Data integrity error: client reported violation of logic in pool %d", p.sequence());
                 return false;
             }
+
+            //update_heads_and_tails(heads, tails, p.hash(), p.previous_hash());
+            progress.poolsProcessed++;
+
+            if (callback != nullptr) {
+                const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+                progress.blocksPerSecond = elapsed > 0 ? progress.poolsProcessed * 1000 / static_cast<uint64_t>(elapsed) : 0;
+
+                if (callback(progress)) {
+                    set_last_error(Storage::UserCancelled);
+                    return false;
+                }
+            }
         }
     }
     emit stop_reading_event();
@@ -464,8 +476,22 @@ bool Storage::open(const ::std::string& path_to_base, OpenCallback callback, cs:
         path = ::csdb::internal::app_data_path() + "/CREDITS";
     }
 
-    auto db{::std::make_shared<::csdb::DatabaseBerkeleyDB>()};
-    db->open(path);
+    std::shared_ptr<Database> db;
+
+    // BerkeleyDB is used only for existing chains which were not migrated yet,
+    // new chains are created at lmdb
+    if (!DatabaseLmdb::exists(path) && boost::filesystem::exists(boost::filesystem::path(path) / "blockchain.db")) {
+        cswarning() << "Storage> BerkeleyDB block store is used, run node with --migrate-db to convert it to lmdb";
+
+        auto bdb = std::make_shared<DatabaseBerkeleyDB>();
+        bdb->open(path);
+        db = bdb;
+    }
+    else {
+        auto lmdb = std::make_shared<DatabaseLmdb>();
+        lmdb->open(path);
+        db = lmdb;
+    }
 
     //d->write_thread = std::thread(&Storage::priv::write_routine, d.get());
 
@@ -639,8 +665,6 @@ Pool Storage::pool_load(const cs::Sequence sequence) const {
     }
 
     Pool res;
-    bool needParseData = true;
-    cs::Bytes data;
 
     const auto &index = d->pools_cache.get<Storage::priv::PoolElement::bySequence>();
     auto it = index.find(sequence);
@@ -656,28 +680,78 @@ Pool Storage::pool_load(const cs::Sequence sequence) const {
         return res;
     }
 
-    if (!d->db->get(static_cast<uint32_t>(sequence), &data)) {
+    // pool keeps its binary representation, so stored data is copied once while it is parsed
+    const bool stored = d->db->read(static_cast<uint32_t>(sequence), [&res](const cs::Byte* data, size_t size) {
+        res = Pool::from_binary(cs::Bytes(data, data + size));
+    });
+
+    if (stored) {
+        d->pools_cache_insert(res.sequence(), res.hash(), res);
+    }
+    else {
+        bool queued = false;
+
         {
-            std::unique_lock<std::mutex> lock2(d->write_lock);
+            std::unique_lock<std::mutex> lock(d->write_lock);
             for (auto& poolToWrite : d->write_queue) {
                 if (poolToWrite.sequence() == sequence) {
                     res = poolToWrite;
-                    needParseData = false;
+                    queued = true;
                     break;
                 }
             }
         }
 
-        if (needParseData && !d->db->get(static_cast<uint32_t>(sequence), &data)) {
+        if (!queued) {
             d->set_last_error(DatabaseError);
             return Pool{};
         }
     }
 
-    if (needParseData) {
-        res = Pool::from_binary(std::move(data));
-        d->pools_cache_insert(res.sequence(), res.hash(), res);
+    if (!res.is_valid()) {
+        d->set_last_error(DataIntegrityError);
     }
+    else {
+        d->set_last_error();
+    }
+
+    return res;
+}
+
+PoolView Storage::pool_view(const cs::Sequence sequence) const {
+    if (!isOpen()) {
+        d->set_last_error(NotOpen);
+        return PoolView{};
+    }
+
+    // decoded pool is already at hand, its binary data is used
+    const auto &index = d->pools_cache.get<Storage::priv::PoolElement::bySequence>();
+    auto it = index.find(sequence);
+    if (it != index.end()) {
+        d->set_last_error();
+        return PoolView((*it).pool.to_binary());
+    }
+
+    cs::Bytes data;
+
+    if (!d->db->get(static_cast<uint32_t>(sequence), &data)) {
+        {
+            std::unique_lock<std::mutex> lock(d->write_lock);
+            for (auto& poolToWrite : d->write_queue) {
+                if (poolToWrite.sequence() == sequence) {
+                    d->set_last_error();
+                    return PoolView(poolToWrite.to_binary());
+                }
+            }
+        }
+
+        if (!d->db->get(static_cast<uint32_t>(sequence), &data)) {
+            d->set_last_error(DatabaseError);
+            return PoolView{};
+        }
+    }
+
+    PoolView res(std::move(data));
 
     if (!res.is_valid()) {
         d->set_last_error(DataIntegrityError);
@@ -910,7 +984,7 @@ Transaction Storage::transaction(const TransactionID& id) const {
         return Transaction{};
     }
 
-    return pool_load(id.pool_seq()).transaction(id);
+    return pool_view(id.pool_seq()).transaction(id).to_transaction();
 }
 
 Transaction Storage::get_last_by_source(Address source) const noexcept {
@@ -1007,8 +1081,9 @@ csdb::PoolHash Storage::pool_hash(cs::Sequence sequence) const {
         }
     }
 
-    res = Pool::from_binary(std::move(data));
-    if (!res.is_valid()) {
+    // only hashed part of block is decoded
+    auto hash = Pool::hash_from_binary(std::move(data));
+    if (hash.is_empty()) {
         d->set_last_error(DataIntegrityError);
         return PoolHash{};
     }
@@ -1016,7 +1091,7 @@ csdb::PoolHash Storage::pool_hash(cs::Sequence sequence) const {
         d->set_last_error();
     }
 
-    return res.hash();
+    return hash;
 }
 
 }  // namespace csdb
@@ -3,6 +3,7 @@
 
 #include <bitset>
 #include <climits>
+#include <cstdint>
 #include <limits>
 
 namespace cs {
@@ -93,7 +94,45 @@ public:
             return 1 + bits_.count();
     }
 
+    // raw state access for persistent snapshots, bits are packed to 64 bit words
+    template <typename Stream>
+    void serialize(Stream& stream) const {
+        stream << greatest_ << isValueSet_;
+
+        for (size_t word = 0; word < kWordsCount; ++word) {
+            uint64_t value = 0;
+
+            for (size_t bit = 0; bit < kWordBits && word * kWordBits + bit < BitSize; ++bit) {
+                if (bits_.test(word * kWordBits + bit)) {
+                    value |= (uint64_t(1) << bit);
+                }
+            }
+
+            stream << value;
+        }
+    }
+
+    template <typename Stream>
+    void deserialize(Stream& stream) {
+        stream >> greatest_ >> isValueSet_;
+        bits_.reset();
+
+        for (size_t word = 0; word < kWordsCount; ++word) {
+            uint64_t value = 0;
+            stream >> value;
+
+            for (size_t bit = 0; bit < kWordBits && word * kWordBits + bit < BitSize; ++bit) {
+                if (value & (uint64_t(1) << bit)) {
+                    bits_.set(word * kWordBits + bit);
+                }
+            }
+        }
+    }
+
 private:
+    static constexpr size_t kWordBits = 64;
+    static constexpr size_t kWordsCount = (BitSize + kWordBits - 1) / kWordBits;
+
     T greatest_;
     uint8_t isValueSet_;
     std::bitset<BitSize> bits_;
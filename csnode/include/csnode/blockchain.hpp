@@ -1,6 +1,7 @@
 #ifndef BLOCKCHAIN_HPP
 #define BLOCKCHAIN_HPP
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <memory>
@@ -34,6 +35,8 @@ class WalletsIds;
 class Fee;
 class TransactionsIndex;
 class TransactionsPacket;
+class WalletsSnapshot;
+class WalletsShards;
 
 /** @brief   The synchronized block signal emits when block is trying to be stored */
 using TryToStoreBlockSignal = cs::Signal<void(const csdb::Pool&, bool*)>;
@@ -44,6 +47,8 @@ using StoreBlockSignal = cs::Signal<void(const csdb::Pool&)>;
 using ChangeBlockSignal = cs::Signal<void(const cs::Sequence)>;
 using RemoveBlockSignal = cs::Signal<void(const csdb::Pool&)>;
 using AlarmSignal = cs::Signal<void(const cs::Sequence)>;
+/** @brief   The contract data signal emits when contract state is written to storage */
+using ContractDataSignal = cs::Signal<void(const csdb::Address&)>;
 using ReadBlockSignal = csdb::ReadBlockSignal;
 using StartReadingBlocksSignal = csdb::BlockReadingStartedSingal;
 }  // namespace cs
@@ -77,6 +82,8 @@ public:
     // utility methods
 
     csdb::Address getAddressByType(const csdb::Address& addr, AddressType type) const;
+    // bulk version of getAddressByType, every unique address is resolved once, result keeps order of addresses
+    std::vector<csdb::Address> getAddressesByType(const std::vector<csdb::Address>& addresses, AddressType type) const;
     bool isEqual(const csdb::Address& laddr, const csdb::Address& raddr) const;
 
     static csdb::Address getAddressFromKey(const std::string&);
@@ -208,6 +215,9 @@ public signals:
     /** @brief Alarm event. Block Isn't correct */
     cs::AlarmSignal alarmBadBlock;
 
+    /** @brief Contract data update event. Raised after the contract state is written to storage */
+    cs::ContractDataSignal contractDataUpdateEvent;
+
     const cs::ReadBlockSignal& readBlockEvent() const;
     const cs::StartReadingBlocksSignal& startReadingBlocksEvent() const;
 
@@ -215,22 +225,31 @@ public slots:
 
     // subscription is placed in SmartContracts constructor
     void onPayableContractReplenish(const csdb::Transaction& starter) {
-        this->walletsCacheUpdater_->invokeReplenishPayableContract(starter, false /*inverse*/);
+        if (isRestoredBySnapshot(lastSequence_)) {
+            return;
+        }
+        updateWallets([&] { walletsCacheUpdater_->invokeReplenishPayableContract(starter, false /*inverse*/); });
     }
     void onContractTimeout(const csdb::Transaction& starter) {
-        this->walletsCacheUpdater_->rollbackExceededTimeoutContract(starter, csdb::Amount(0), false /*inverse*/);
+        if (isRestoredBySnapshot(lastSequence_)) {
+            return;
+        }
+        updateWallets([&] { walletsCacheUpdater_->rollbackExceededTimeoutContract(starter, csdb::Amount(0), false /*inverse*/); });
     }
     void onContractEmittedAccepted(const csdb::Transaction& emitted, const csdb::Transaction& starter) {
-        this->walletsCacheUpdater_->smartSourceTransactionReleased(emitted, starter, false /*inverse*/);
+        if (isRestoredBySnapshot(lastSequence_)) {
+            return;
+        }
+        updateWallets([&] { walletsCacheUpdater_->smartSourceTransactionReleased(emitted, starter, false /*inverse*/); });
     }
     void rollbackPayableContractReplenish(const csdb::Transaction& starter) {
-        this->walletsCacheUpdater_->invokeReplenishPayableContract(starter, true /*inverse*/);
+        updateWallets([&] { walletsCacheUpdater_->invokeReplenishPayableContract(starter, true /*inverse*/); });
     }
     void rollbackContractTimeout(const csdb::Transaction& starter) {
-        this->walletsCacheUpdater_->rollbackExceededTimeoutContract(starter, csdb::Amount(0), true /*inverse*/);
+        updateWallets([&] { walletsCacheUpdater_->rollbackExceededTimeoutContract(starter, csdb::Amount(0), true /*inverse*/); });
     }
     void rollbackContractEmittedAccepted(const csdb::Transaction& emitted, const csdb::Transaction& starter) {
-        this->walletsCacheUpdater_->smartSourceTransactionReleased(emitted, starter, true /*inverse*/);
+        updateWallets([&] { walletsCacheUpdater_->smartSourceTransactionReleased(emitted, starter, true /*inverse*/); });
     }
 
 public:
@@ -239,6 +258,8 @@ public:
 
     csdb::Pool loadBlock(const csdb::PoolHash&) const;
     csdb::Pool loadBlock(const cs::Sequence sequence) const;
+    // serialized block as stored, layout is validated but block is not decoded
+    csdb::PoolView loadBlockView(const cs::Sequence sequence) const;
     csdb::Pool loadBlockMeta(const csdb::PoolHash&, size_t& cnt) const;
     csdb::Transaction loadTransaction(const csdb::TransactionID&) const;
     void iterateOverWallets(const std::function<bool(const cs::PublicKey&, const cs::WalletsCache::WalletData&)>);
@@ -263,6 +284,16 @@ public:
     // wallet transactions: pools cache + db search
     void getTransactions(Transactions& transactions, csdb::Address address, uint64_t offset, uint64_t limit);
 
+    // keyset pagination over transactions ordinals index, transactions are returned newest first,
+    // cursor is exclusive upper bound of ordinals and is updated to continue with the next page,
+    // initial cursor is count of indexed transactions (see getIndexedTransactionsCount()), cursor 0 means no more pages;
+    // returns false if ordinals index is not ready yet
+    bool getTransactionsPage(Transactions& transactions, uint64_t& cursor, uint64_t limit) const;
+    bool getTransactionsPage(Transactions& transactions, const csdb::Address& address, uint64_t& cursor, uint64_t limit) const;
+
+    // count of transactions in ordinals index, may differ from getTransactionsCount() while blocks are indexed
+    uint64_t getIndexedTransactionsCount() const;
+
     void setBlocksToBeRemoved(cs::Sequence number);
 
     void printWalletCaches();
@@ -312,9 +343,20 @@ private:
 
     void onStartReadFromDB(cs::Sequence lastWrittenPoolSeq);
     void onReadFromDB(csdb::Pool block, bool* shouldStop);
+    void onStopReadFromDB();
     bool postInitFromDB();
 
+    // wallets state snapshots, state after block sequence is stored and restored
+    void restoreWalletsSnapshot(cs::Sequence lastWrittenPoolSeq);
+    void saveWalletsSnapshot(cs::Sequence sequence, const csdb::PoolHash& hash);
+
+    // true while reading from DB blocks which wallets state is already restored from snapshot
+    bool isRestoredBySnapshot(cs::Sequence sequence) const {
+        return restoredSequence_ != cs::kWrongSequence && sequence <= restoredSequence_;
+    }
+
     bool updateWalletIds(const csdb::Pool& pool, cs::WalletsCache::Updater& updater);
+    void loadTransactionsPage(Transactions& transactions, const std::vector<csdb::TransactionID>& ids) const;
     bool insertNewWalletId(const csdb::Address& newWallAddress, WalletId newWalletId, cs::WalletsCache::Updater& updater);
 
     void addNewWalletToPool(const csdb::Address& walletAddress, const csdb::Pool::NewWalletInfo::AddressId& addressId, csdb::Pool::NewWallets& newWallets);
@@ -323,7 +365,25 @@ private:
 
     // returns true if new id was inserted
     bool getWalletId(const WalletAddress& address, WalletId& id);
-    bool findWalletData_Unsafe(WalletId id, WalletData& wallData) const;
+
+    // wallets cache is changed by func under cacheMutex_, then changed wallets are published to readers,
+    // while blocks are read from DB they are published once after the last block
+    template <typename Func>
+    void updateWallets(Func func) {
+        std::lock_guard lock(cacheMutex_);
+        func();
+
+        if (!readingFromDb_.load(std::memory_order_relaxed)) {
+            publishWallets();
+        }
+    }
+
+    // copies wallets changed since the previous call to walletsShards_, requires cacheMutex_
+    void publishWallets();
+
+    // readers of wallets use walletsShards_, or wallets cache itself under cacheMutex_ while blocks are read from DB
+    bool applyToWalletData(const cs::PublicKey& key, const std::function<void(const WalletData&)>& func) const;
+    void iterateOverWalletsData(const std::function<bool(const cs::PublicKey&, const WalletData&)>& func) const;
 
     class TransactionsLoader;
 
@@ -343,8 +403,20 @@ private:
     std::unique_ptr<cs::WalletsCache> walletsCacheStorage_;
     std::unique_ptr<cs::WalletsCache::Updater> walletsCacheUpdater_;
     std::unique_ptr<cs::MultiWallets> multiWallets_;
+    std::unique_ptr<cs::WalletsShards> walletsShards_;
+    std::shared_ptr<cs::WalletsSnapshot> walletsSnapshot_;
 
+    // sequence of snapshot wallets state is restored from, kWrongSequence after reading from DB
+    cs::Sequence restoredSequence_ = cs::kWrongSequence;
+    // sequence of the last saved or restored snapshot
+    cs::Sequence lastSnapshotSequence_ = 0;
+
+    // cacheMutex_ serializes writers of wallets cache, readers use walletsShards_ and take it only while blocks are read from DB
     mutable cs::SpinLock cacheMutex_{ATOMIC_FLAG_INIT};
+    mutable cs::SpinLock walletIdsMutex_{ATOMIC_FLAG_INIT};
+
+    // set from the start to the end of reading blocks from DB, walletsShards_ are not published meanwhile
+    std::atomic<bool> readingFromDb_ = {false};
 
     uint64_t total_transactions_count_ = 0;
 
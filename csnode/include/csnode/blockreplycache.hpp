@@ -0,0 +1,72 @@
+#ifndef BLOCKREPLYCACHE_HPP
+#define BLOCKREPLYCACHE_HPP
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+
+#include <csnode/nodecore.hpp>
+
+#include <lib/system/allocators.hpp>
+#include <lib/system/common.hpp>
+#include <lib/system/signals.hpp>
+
+namespace csdb {
+class Pool;
+}  // namespace csdb
+
+namespace cs {
+// LRU of compressed block replies keyed by requested sequences,
+// synchronizing nodes request the same ranges, so replies are compressed once
+class BlockReplyCache {
+public:
+    constexpr static size_t kDefaultMaxCount = 256;
+    constexpr static size_t kDefaultMaxBytes = 64 * 1024 * 1024;
+
+    explicit BlockReplyCache(size_t maxCount = kDefaultMaxCount, size_t maxBytes = kDefaultMaxBytes);
+
+    // moves found reply to the head of LRU
+    std::optional<CompressedRegion> find(const PoolsRequestedSequences& sequences);
+    void insert(const PoolsRequestedSequences& sequences, const CompressedRegion& region);
+
+    // drops replies containing blocks from sequence and above
+    void invalidate(cs::Sequence sequence);
+    void clear();
+
+    size_t size() const;
+    size_t bytes() const;
+
+    size_t hits() const;
+    size_t misses() const;
+
+public slots:
+    void onRemoveBlock(const csdb::Pool& pool);
+
+private:
+    struct Item {
+        PoolsRequestedSequences sequences;
+        cs::Sequence maxSequence;
+        CompressedRegion region;
+    };
+
+    using Items = std::list<Item>;
+
+    void erase(Items::iterator it);
+
+    const size_t maxCount_;
+    const size_t maxBytes_;
+
+    // most recently used are at front
+    Items items_;
+    std::map<PoolsRequestedSequences, Items::iterator> index_;
+    size_t bytes_ = 0;
+
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+
+    mutable std::mutex mutex_;
+};
+}  // namespace cs
+
+#endif  // BLOCKREPLYCACHE_HPP
@@ -147,9 +147,6 @@ public:
     : ValidationPlugin(bv) {
     }
     ErrorType validateBlock(const csdb::Pool&) override;
-
-private:
-    bool checkSignature(const csdb::Transaction&);
 };
 
 class AccountBalanceChecker : public ValidationPlugin
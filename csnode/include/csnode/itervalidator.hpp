@@ -2,6 +2,7 @@
 #define ITER_VALIDATOR_HPP
 
 #include <memory>
+#include <optional>
 #include <set>
 #include <vector>
 
@@ -37,7 +38,8 @@ private:
 
     void checkSignaturesSmartSource(SolverContext&, PacketsVector& smartContractsPackets);
     void checkTransactionsSignatures(SolverContext& context, const Transactions& transactions, Bytes& characteristicMask, PacketsVector& smartsPackets);
-    bool checkTransactionSignature(SolverContext& context, const csdb::Transaction& transaction);
+    // returns nullopt if transaction signature must be verified by source key, otherwise result of smart rules check
+    std::optional<bool> checkSmartSignature(SolverContext& context, const csdb::Transaction& transaction);
 
 	Reject::Reason deployAdditionalCheck(SolverContext& context, size_t trxInd, const csdb::Transaction& transaction);
 
@@ -1,12 +1,14 @@
 #ifndef MULTIWALLETS_HPP
 #define MULTIWALLETS_HPP
 
+#include <iterator>
 #include <mutex>
+#include <vector>
 
 #include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index_container.hpp>
-#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/ranked_index.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 
 #include <csnode/walletscache.hpp>
@@ -39,6 +41,7 @@ public:
         Greater
     };
 
+    // wallets with empty address or negative balance are not listed
     bool contains(const PublicKey& key) const;
     size_t size() const;
 
@@ -49,18 +52,21 @@ public:
     uint64_t createTime(const PublicKey& key) const;
 #endif
 
+    // ranked indexes find page start by offset in O(log n)
     template<Tags tag>
     std::vector<InternalData> iterate(int64_t offset, int64_t limit, Order order = Order::Greater) const {
         cs::Lock lock(mutex_);
         auto& bucket = indexes_.get<tag>();
 
-        if (static_cast<int64_t>(bucket.size()) < offset || limit == 0) {
+        const auto size = static_cast<int64_t>(bucket.size());
+
+        if (offset < 0 || size <= offset || limit <= 0) {
             return {};
         }
 
-        auto capacity = std::min(static_cast<int64_t>(bucket.size()) - offset, limit);
-        return (order == Order::Greater) ? shadowIterate<Order::Greater>(bucket, offset, limit, capacity) :
-                                           shadowIterate<Order::Less>(bucket, offset, limit, capacity);
+        const auto capacity = std::min(size - offset, limit);
+        return (order == Order::Greater) ? copy(bucket.nth(static_cast<size_t>(offset)), capacity) :
+                                           copy(std::make_reverse_iterator(bucket.nth(static_cast<size_t>(size - offset))), capacity);
     }
 
 public slots:
@@ -69,45 +75,29 @@ public slots:
 
 protected:
     InternalData map(const PublicKey& key, const WalletsCache::WalletData& data);
+    static bool isListed(const PublicKey& key, const WalletsCache::WalletData& data);
 
-    template <Order order, typename Bucket>
-    std::vector<InternalData> shadowIterate(Bucket& bucket, int64_t offset, int64_t limit, int64_t capacity) const {
+    template <typename Iterator>
+    static std::vector<InternalData> copy(Iterator begin, int64_t count) {
         std::vector<InternalData> result;
-        result.reserve(static_cast<size_t>(capacity));
-
-        auto [begin, end] = rangeOrder<order>(bucket);
-        std::advance(begin, offset);
+        result.reserve(static_cast<size_t>(count));
 
-        for (; begin != end; ++begin) {
+        for (int64_t i = 0; i < count; ++i, ++begin) {
             result.push_back(*begin);
-
-            if (result.size() == static_cast<size_t>(limit)) {
-                break;
-            }
         }
 
         return result;
     }
 
-    template<Order order, typename Bucket>
-    constexpr auto rangeOrder(Bucket& bucket) const {
-        if constexpr(order == Order::Greater) {
-            return std::make_pair(bucket.begin(), bucket.end());
-        }
-        else {
-            return std::make_pair(bucket.rbegin(), bucket.rend());
-        }
-    }
-
 private:
     using Container = boost::multi_index_container<InternalData,
                         indexed_by<
                             hashed_unique<member<InternalData, PublicKey, &InternalData::key>>,
-                            ordered_non_unique<member<InternalData, csdb::Amount, &InternalData::balance>, std::greater<csdb::Amount>>,
-                            ordered_non_unique<member<InternalData, uint64_t, &InternalData::transactionsCount>, std::greater<uint64_t>>
+                            ranked_non_unique<member<InternalData, csdb::Amount, &InternalData::balance>, std::greater<csdb::Amount>>,
+                            ranked_non_unique<member<InternalData, uint64_t, &InternalData::transactionsCount>, std::greater<uint64_t>>
 #ifdef MONITOR_NODE
                             ,
-                            ordered_non_unique<member<InternalData, uint64_t, &InternalData::createTime>, std::greater<uint64_t>>
+                            ranked_non_unique<member<InternalData, uint64_t, &InternalData::createTime>, std::greater<uint64_t>>
 #endif
                         >
                       >;
@@ -9,6 +9,7 @@
 
 #include <csconnector/csconnector.hpp>
 
+#include <csnode/blockreplycache.hpp>
 #include <csnode/conveyer.hpp>
 #include <csnode/compressor.hpp>
 #include <lib/system/timer.hpp>
@@ -82,12 +83,21 @@ public:
 
     std::string getSenderText(const cs::PublicKey& sender);
 
+    // applies prepared bulk message in processor thread
+    using MessageApply = std::function<void()>;
+
     // incoming requests processing
     void getBigBang(const uint8_t* data, const size_t size, const cs::RoundNumber rNum);
     void getRoundTableSS(const uint8_t* data, const size_t size, const cs::RoundNumber);
     bool verifyPacketSignatures(cs::TransactionsPacket& packet, const cs::PublicKey& sender);
     bool verifyPacketTransactions(cs::TransactionsPacket packet, const cs::PublicKey& sender);
     void getTransactionsPacket(const uint8_t* data, const std::size_t size, const cs::PublicKey& sender);
+
+    // bulk messages are decoded and verified by prepare methods in worker thread, they do not touch node state
+    MessageApply prepareTransactionsPacket(const uint8_t* data, const std::size_t size, const cs::PublicKey& sender);
+    MessageApply preparePacketHashesReply(const uint8_t* data, const std::size_t size, const cs::RoundNumber round, const cs::PublicKey& sender);
+    MessageApply prepareStateReply(const uint8_t* data, const std::size_t size, const cs::RoundNumber rNum, const cs::PublicKey& sender);
+    MessageApply prepareBlockReply(const uint8_t* data, const size_t size);
     void getNodeStopRequest(const cs::RoundNumber round, const uint8_t* data, const std::size_t size);
 
 
@@ -211,7 +221,7 @@ public:
     // smarts consensus additional functions:
 
     // syncro send functions
-    void sendBlockReply(const cs::PoolsBlock& poolsBlock, const cs::PublicKey& target, std::size_t packCounter);
+    void sendBlockReply(const cs::PoolsRequestedSequences& sequences, const cs::PublicKey& target, std::size_t packCounter);
 
     void initCurrentRP();
     void getUtilityMessage(const uint8_t* data, const size_t size);
@@ -328,6 +338,11 @@ private:
 
     void processSync();
 
+    // writes round trace to the configured file, waits for background dump in progress
+    void dumpRoundTrace();
+    // writes round trace by background thread, skipped if the previous one is not finished
+    void dumpRoundTraceAsync();
+
     // transport
     void addToBlackList(const cs::PublicKey& key, bool isMarked);
 
@@ -388,6 +403,7 @@ private:
     bool good_ = true;
 
     std::atomic_bool stopRequested_{ false };
+    std::atomic_flag roundTraceDumping_ = ATOMIC_FLAG_INIT;
     static inline bool autoShutdownEnabled_;
 
     // file names for crypto public/private keys
@@ -417,6 +433,7 @@ private:
     static const uint32_t packetRequestStep_ = 450;
     static const size_t maxPacketRequestSize_ = 1000;
     static const int64_t maxPingSynchroDelay_ = 30000;
+    static const cs::RoundNumber roundTraceDumpPeriod_ = 100;
 
     // serialization/deserialization entities
     cs::IPackStream istream_;
@@ -490,6 +507,7 @@ private:
 
     cs::config::Observer& observer_;
     cs::Compressor compressor_;
+    cs::BlockReplyCache blockReplyCache_;
 
     std::string kLogPrefix_;
 
@@ -13,6 +13,7 @@
 
 #include <lib/system/hash.hpp>
 
+#include <net/erasurecoder.hpp>
 #include <net/packet.hpp>
 
 namespace cs {
@@ -197,10 +198,18 @@ public:
         delete[] packets_;
     }
 
+    // fragmented messages are followed by repair fragments, see ErasureCoder
+    void setErasureCoding(bool enabled) {
+        erasureCoding_ = enabled;
+    }
+
     void init(cs::Byte flags) {
         clear();
         ++id_;
 
+        // repair fragment stores the size of the last data fragment
+        reserved_ = erasureCoding_ ? sizeof(uint16_t) : 0;
+
         newPack();
 
         *ptr_ = flags;
@@ -224,6 +233,7 @@ public:
         clear();
         ++id_;
 
+        reserved_ = 0;
         newPack();
 
         insertBytes(reinterpret_cast<const char*>(pack.data()), static_cast<uint32_t>(pack.size()));
@@ -296,11 +306,23 @@ public:
         return *this;
     }
 
+    // adds repair fragments to erasure coded message, so get packets count after it
     Packet* getPackets() {
         if (!finished_) {
             (packetsEnd_ - 1)->setSize(static_cast<uint32_t>(ptr_ - static_cast<cs::Byte*>((packetsEnd_ - 1)->data())));
 
             if (packetsCount_ > 1) {
+                const bool erasureCoded = reserved_ != 0 && ErasureCoder::isApplicable(packetsCount_);
+
+                // full packets were not filled up to the end
+                for (auto p = packets_; p != packetsEnd_ - 1; ++p) {
+                    p->setSize(Packet::MaxSize - reserved_);
+                }
+
+                if (erasureCoded) {
+                    addRepairPacks();
+                }
+
                 for (auto p = packets_; p != packetsEnd_; ++p) {
                     cs::Byte* data = static_cast<cs::Byte*>(p->data());
 
@@ -310,6 +332,10 @@ public:
                         assert(false);
                     }
 
+                    if (erasureCoded) {
+                        *data |= BaseFlags::ErasureCoded;
+                    }
+
                     *reinterpret_cast<uint16_t*>(data + Offsets::FragmentsNum) = packetsCount_;
                 }
             }
@@ -364,7 +390,7 @@ private:
         new (packetsEnd_) Packet(allocator_->allocateNext(Packet::MaxSize));
 
         ptr_ = static_cast<cs::Byte*>(packetsEnd_->data());
-        end_ = ptr_ + packetsEnd_->size();
+        end_ = ptr_ + packetsEnd_->size() - reserved_;
 
         if (packetsEnd_ != packets_) {
             auto begin = static_cast<cs::Byte*>(packets_->data());
@@ -384,6 +410,43 @@ private:
         ++packetsEnd_;
     }
 
+    // repair packet is the header, the size of the last data packet and the parity of data
+    void addRepairPacks() {
+        const uint32_t dataCount = packetsCount_;
+        const uint32_t headersLength = packets_->getHeadersLength();
+        const uint32_t shardSize = Packet::MaxSize - reserved_ - headersLength;
+        const auto lastSize = static_cast<uint16_t>((packetsEnd_ - 1)->size() - headersLength);
+
+        std::vector<const cs::Byte*> data;
+        data.reserve(dataCount);
+
+        for (auto p = packets_; p != packetsEnd_; ++p) {
+            data.push_back(static_cast<const cs::Byte*>(p->data()) + headersLength);
+        }
+
+        cs::Bytes lastShard(data.back(), data.back() + lastSize);
+        lastShard.resize(shardSize, 0);
+        data.back() = lastShard.data();
+
+        std::vector<cs::Byte*> repair;
+
+        for (uint32_t i = 0; i < ErasureCoder::repairShards(dataCount); ++i) {
+            new (packetsEnd_) Packet(allocator_->allocateNext(Packet::MaxSize));
+
+            auto begin = static_cast<cs::Byte*>(packetsEnd_->data());
+            std::copy(static_cast<const cs::Byte*>(packets_->data()), static_cast<const cs::Byte*>(packets_->data()) + headersLength, begin);
+            *reinterpret_cast<uint16_t*>(begin + static_cast<uint32_t>(Offsets::FragmentId)) = packetsCount_;
+            *reinterpret_cast<uint16_t*>(begin + headersLength) = lastSize;
+
+            repair.push_back(begin + headersLength + sizeof(uint16_t));
+
+            ++packetsCount_;
+            ++packetsEnd_;
+        }
+
+        ErasureCoder::encode(data, repair, shardSize);
+    }
+
     void insertBytes(char const* bytes, uint32_t size) {
         while (size > 0) {
             if (ptr_ == end_) {
@@ -413,6 +476,9 @@ private:
     Packet* packetsEnd_;
     bool finished_ = false;
 
+    bool erasureCoding_ = false;
+    uint32_t reserved_ = 0;
+
     uint64_t id_ = 0;
     cs::PublicKey senderKey_;
 };
@@ -0,0 +1,95 @@
+#ifndef ROUNDTRACE_HPP
+#define ROUNDTRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <lib/system/common.hpp>
+
+namespace cs {
+// Timeline of consensus round stages.
+// Events are recorded from any thread into lock free ring buffer, the oldest ones are overwritten
+class RoundTrace {
+public:
+    enum class Kind : uint8_t {
+        RoundStart,
+        StageOneSent,
+        StageTwoSent,
+        StageThreeSent,
+        StageOneReceived,
+        StageTwoReceived,
+        StageThreeReceived,
+        Validation,
+        BlockFinalize,
+        BlockStore,
+        RoundTableSent,
+        Count
+    };
+
+    constexpr static uint8_t kNoSender = 0xff;
+    constexpr static size_t kCapacity = 1 << 16;
+
+    // time is wall clock in microseconds to compare dumps of different nodes,
+    // duration is in microseconds, zero for instant events
+    struct Event {
+        uint64_t time = 0;
+        cs::RoundNumber round = 0;
+        Kind kind = Kind::RoundStart;
+        uint8_t sender = kNoSender;
+        uint32_t duration = 0;
+    };
+
+    // records event with duration of the scope
+    class Span {
+    public:
+        Span(RoundTrace& trace, Kind kind, uint8_t sender = kNoSender);
+        ~Span();
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        RoundTrace& trace_;
+        Kind kind_;
+        uint8_t sender_;
+        uint64_t time_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    static RoundTrace& instance();
+
+    RoundTrace();
+    ~RoundTrace();
+
+    // events are recorded for the last started round
+    void startRound(cs::RoundNumber round);
+    void record(Kind kind, uint8_t sender = kNoSender, uint32_t duration = 0);
+
+    // recorded events from the oldest one
+    std::vector<Event> events() const;
+
+    bool dump(const std::string& path) const;
+    static std::optional<std::vector<Event>> load(const std::string& path);
+
+    // prints timeline of every round and its slowest confidants
+    static void render(const std::vector<Event>& events, std::ostream& os);
+
+    static const char* kindName(Kind kind);
+
+private:
+    struct Slot;
+
+    void record(uint64_t time, Kind kind, uint8_t sender, uint32_t duration);
+
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> head_;
+    std::atomic<cs::RoundNumber> round_;
+};
+}  // namespace cs
+
+#endif  // ROUNDTRACE_HPP
@@ -0,0 +1,61 @@
+#ifndef SIGNATURES_VERIFIER_HPP
+#define SIGNATURES_VERIFIER_HPP
+
+#include <vector>
+
+#include <lib/system/common.hpp>
+
+namespace csdb {
+class Transaction;
+}
+
+namespace cs {
+// batch verification of signatures,
+// collects (signature, public key, message) tuples and verifies them at thread pool
+class SignaturesVerifier {
+public:
+    struct Item {
+        cs::Signature signature;
+        cs::PublicKey publicKey;
+        cs::Bytes message;
+    };
+
+    using Items = std::vector<Item>;
+
+    enum Options : size_t {
+        // less items are verified at caller thread only
+        MinParallelSize = 32,
+        // items count verified by one task
+        ChunkSize = 16
+    };
+
+    SignaturesVerifier() = default;
+    explicit SignaturesVerifier(size_t reserve);
+
+    void add(const cs::Signature& signature, const cs::PublicKey& publicKey, cs::Bytes message);
+    void add(const csdb::Transaction& transaction, const cs::PublicKey& publicKey);
+
+    size_t size() const {
+        return items_.size();
+    }
+
+    bool empty() const {
+        return items_.empty();
+    }
+
+    void clear() {
+        items_.clear();
+    }
+
+    // returns mask of results in order of addition, 1 - signature is valid, 0 - not valid
+    cs::Bytes verify() const;
+
+    // verifies items by workers count, 0 means hardware concurrency
+    static cs::Bytes verify(const Items& items, size_t workers = 0);
+
+private:
+    Items items_;
+};
+}  // namespace cs
+
+#endif  // SIGNATURES_VERIFIER_HPP
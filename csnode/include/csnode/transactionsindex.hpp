@@ -1,19 +1,21 @@
 #ifndef TRANSACTIONSINDEX_HPP
 #define TRANSACTIONSINDEX_HPP
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <csdb/address.hpp>
 #include <lib/system/common.hpp>
-#include <lib/system/mmappedfile.hpp>
 #include <lmdb.hpp>
 
 class BlockChain;
 
 namespace csdb {
 class Pool;
+class TransactionID;
 } // namespace csdb
 
 namespace cs {
@@ -29,6 +31,22 @@ public:
 
     Sequence getPrevTransBlock(const csdb::Address& _addr, Sequence _curr) const;
 
+    bool isRecreating() const {
+        return recreate_;
+    }
+
+    // ordinals index: every transaction has global ordinal and ordinal in history of each its wallet,
+    // ordinal of the first transaction is 0, so count of transactions is the next ordinal
+    uint64_t getOrdinalsCount() const {
+        return ordinalsCount_.load(std::memory_order_acquire);
+    }
+
+    uint64_t getOrdinalsCount(const csdb::Address& _addr) const;
+
+    // keyset pagination, returns up to _limit ids of transactions with ordinals less than _before, newest first
+    std::vector<csdb::TransactionID> getTransactionIds(uint64_t _before, size_t _limit) const;
+    std::vector<csdb::TransactionID> getTransactionIds(const csdb::Address& _addr, uint64_t _before, size_t _limit) const;
+
 public slots:
     void onStartReadFromDb(Sequence _lastWrittenPoolSeq);
     void onReadFromDb(const csdb::Pool&);
@@ -44,20 +62,32 @@ private:
 
     void updateFromNextBlock(const csdb::Pool&);
     void updateLastIndexed();
-
-    static bool hasToRecreate(const std::string&, cs::Sequence&);
+    bool readLastIndexed();
 
     void setPrevTransBlock(const PublicKey&, cs::Sequence _curr, cs::Sequence _prev);
     void removeLastTransBlock(const PublicKey&, cs::Sequence _curr);
 
+    // change ordinals and last indexed sequence in one transaction
+    void updateOrdinals(const csdb::Pool&);
+    void removeOrdinals(const csdb::Pool&);
+    uint64_t getOrdinalsCount(const PublicKey&) const;
+
     BlockChain& bc_;
     const std::string rootPath_;
     std::unique_ptr<Lmdb> db_;
     Sequence lastIndexedPool_;
-    bool recreate_;
-    MMappedFileWrap<FileSink> lastIndexedFile_;
+
+    // changed by reading from db and by blocks writing, they run at different threads
+    std::atomic<bool> recreate_;
 
     std::map<csdb::Address, cs::Sequence> lapoos_;
+
+    // global ordinals, wallets ordinals and last indexed sequence are tables of one environment
+    std::unique_ptr<Lmdb> ordinalsDb_;
+    std::atomic<uint64_t> ordinalsCount_ = {0};
+
+    // wallets ordinals counts while index is recreated
+    std::map<PublicKey, uint64_t> walletOrdinals_;
 };
 } // namespace cs
 #endif // TRANSACTIONSINDEX_HPP
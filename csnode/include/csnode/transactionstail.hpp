@@ -65,6 +65,16 @@ public:
         return os.str();
     }
 
+    template <typename Stream>
+    void serialize(Stream& stream) const {
+        heap_.serialize(stream);
+    }
+
+    template <typename Stream>
+    void deserialize(Stream& stream) {
+        heap_.deserialize(stream);
+    }
+
 private:
     using Heap = BitHeap<TransactionId, BitSize>;
     Heap heap_;
@@ -1,9 +1,13 @@
 #ifndef WALLETS_CACHE_HPP
 #define WALLETS_CACHE_HPP
 
+#include <atomic>
+#include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <cscrypto/cscrypto.hpp>
@@ -26,6 +30,7 @@ class Transaction;
 
 namespace cs {
 
+class DataStream;
 class WalletsIds;
 
 class WalletsCache {
@@ -65,15 +70,48 @@ public:
 #endif
 
     uint64_t getCount() const {
-        return wallets_.size();
+        return wallets_.size() + (frozen_ ? frozen_->size() : 0) - shadowed_;
     }
 
+    // persistent snapshot support, deserialize() replaces current content only on success
+    void serialize(DataStream& stream) const;
+    bool deserialize(DataStream& stream);
+    void clear();
+
+    class Frozen;
+
+    // state for snapshot written at another thread, frozen wallets are shared with cache
+    // which copies every wallet on its next change, so it costs only wallets changed since the previous one;
+    // returns nullptr while the previous frozen state is still in use
+    std::shared_ptr<const Frozen> freeze();
+
+    // joins wallets changed since freeze with frozen ones after frozen state is released
+    void compact();
+
 private:
+    using Wallets = std::unordered_map<PublicKey, WalletData>;
+
+    const WalletData* find(const PublicKey& key) const;
+    WalletData& get(const PublicKey& key);
+    bool forEach(const std::function<bool(const PublicKey&, const WalletData&)>& func) const;
+
+    // returns false if frozen wallets are in use and force is not set, force copies them
+    bool merge(bool force);
+
     WalletsIds& walletsIds_;
 
     std::list<csdb::TransactionID> smartPayableTransactions_;
     std::map< csdb::Address, std::list<csdb::TransactionID> > canceledSmarts_;
-    std::unordered_map<PublicKey, WalletData> wallets_;
+
+    // all wallets, or only ones changed since freeze while frozen_ is set
+    Wallets wallets_;
+    std::shared_ptr<const Wallets> frozen_;
+
+    // set by frozen state holder when it is destroyed, after it has read frozen_
+    std::shared_ptr<std::atomic<bool>> frozenReleased_;
+
+    // count of wallets_ which are in frozen_ too
+    size_t shadowed_ = 0;
 
 #ifdef MONITOR_NODE
     std::map<PublicKey, TrustedData> trusted_info_;
@@ -109,7 +147,11 @@ public:
 
     PublicKey toPublicKey(const csdb::Address&) const;
 
-    void onStopReadingFromDB() const {
+    // keys of wallets changed since the previous call
+    std::vector<PublicKey> takeModified();
+
+    void onStopReadingFromDB() {
+      data_.merge(true);
       emit updateFromDBFinishedEvent(data_.wallets_);
     }
 
@@ -149,14 +191,34 @@ private:
 #endif
 
     WalletsCache& data_;
+    std::unordered_set<PublicKey> modified_;
 };
 
-inline const WalletsCache::WalletData* WalletsCache::Updater::findWallet(const PublicKey& key) const {
-    auto it = data_.wallets_.find(key);
-    if (it == data_.wallets_.end()) {
-        return nullptr;
+class WalletsCache::Frozen {
+public:
+    ~Frozen() {
+        wallets_.reset();
+        released_->store(true, std::memory_order_release);
     }
-    return &(it->second);
+
+    // writes the same data as WalletsCache::serialize()
+    void serialize(DataStream& stream) const;
+
+private:
+    friend class WalletsCache;
+
+    std::shared_ptr<const Wallets> wallets_;
+    std::shared_ptr<std::atomic<bool>> released_;
+    std::list<csdb::TransactionID> smartPayableTransactions_;
+    std::map<csdb::Address, std::list<csdb::TransactionID>> canceledSmarts_;
+
+#ifdef MONITOR_NODE
+    std::map<PublicKey, TrustedData> trusted_info_;
+#endif
+};
+
+inline const WalletsCache::WalletData* WalletsCache::Updater::findWallet(const PublicKey& key) const {
+    return data_.find(key);
 }
 
 inline const WalletsCache::WalletData* WalletsCache::Updater::findWallet(const csdb::Address& addr) const {
@@ -164,11 +226,12 @@ inline const WalletsCache::WalletData* WalletsCache::Updater::findWallet(const c
 }
 
 inline WalletsCache::WalletData& WalletsCache::Updater::getWalletData(const PublicKey& key) {
-    return data_.wallets_[key];
+    modified_.insert(key);
+    return data_.get(key);
 }
 
 inline WalletsCache::WalletData& WalletsCache::Updater::getWalletData(const csdb::Address& addr) {
-    return data_.wallets_[toPublicKey(addr)];
+    return getWalletData(toPublicKey(addr));
 }
 
 inline double WalletsCache::Updater::load(const csdb::Transaction& t, const BlockChain& bc, bool inverse) {
@@ -3,6 +3,8 @@
 
 #include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -11,9 +13,12 @@
 #include <csdb/address.hpp>
 #include <csdb/internal/types.hpp>
 
+#include <lib/system/common.hpp>
+
 using namespace boost::multi_index;
 
 namespace cs {
+class DataStream;
 
 class WalletsIds {
 public:
@@ -34,6 +39,8 @@ public:
         bool findAnyOrInsertSpecial(const WalletAddress& address, WalletId& id);
 
     private:
+        friend class WalletsIds;
+
         WalletsIds& norm_;
         WalletId nextIdSpecial_;
         static constexpr uint32_t maskSpecial_ = (1u << 31);
@@ -81,6 +88,22 @@ public:
         return *norm_;
     }
 
+    // persistent snapshot support, deserialize() replaces current content only on success
+    void serialize(DataStream& stream) const;
+    bool deserialize(DataStream& stream);
+    void clear();
+
+    // flat copy of ids, it is serialized at another thread as serialize() does
+    struct Content {
+        WalletId nextId = 0;
+        WalletId nextIdSpecial = 0;
+        std::vector<std::pair<cs::PublicKey, WalletId>> wallets;
+
+        void serialize(DataStream& stream) const;
+    };
+
+    Content content() const;
+
 private:
     struct Wallet {
         WalletAddress address; struct byAddress {};
@@ -0,0 +1,60 @@
+#ifndef WALLETS_SHARDS_HPP
+#define WALLETS_SHARDS_HPP
+
+#include <array>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <csnode/walletscache.hpp>
+
+namespace cs {
+// read side copy of wallets cache, wallets are spread over lock-striped shards,
+// so readers never wait for block application and only meet writer for a short copy of changed wallets;
+// writer publishes wallets changed by block when the block is applied completely,
+// locks of several shards are always taken in order of shard index
+class WalletsShards {
+public:
+    using WalletData = WalletsCache::WalletData;
+    using Wallets = std::vector<std::pair<PublicKey, WalletData>>;
+
+    enum : size_t {
+        ShardsCount = 64
+    };
+
+    bool find(const PublicKey& key, WalletData& wallet) const;
+
+    // func is called under shard shared lock, it should be short and must not publish
+    bool apply(const PublicKey& key, const std::function<void(const WalletData&)>& func) const;
+
+    // visits wallets under shared locks of all shards, so they are in state of the same published block,
+    // func must not publish
+    void iterate(const std::function<bool(const PublicKey&, const WalletData&)>& func) const;
+
+    size_t size() const;
+
+    // moves wallets into shards, all touched shards are locked together, so publish is atomic for readers
+    void publish(Wallets&& wallets);
+
+    // replaces all content, used when wallets cache is restored or cleared
+    void reset(WalletsCache& cache);
+
+private:
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<PublicKey, WalletData> wallets;
+    };
+
+    static size_t shardIndex(const PublicKey& key);
+
+    const Shard& shard(const PublicKey& key) const {
+        return shards_[shardIndex(key)];
+    }
+
+    std::array<Shard, ShardsCount> shards_;
+};
+}  // namespace cs
+
+#endif  // WALLETS_SHARDS_HPP
@@ -0,0 +1,62 @@
+#ifndef WALLETS_SNAPSHOT_HPP
+#define WALLETS_SNAPSHOT_HPP
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <csdb/pool.hpp>
+
+#include <lib/system/common.hpp>
+
+namespace cs {
+// on-disk storage of wallets state snapshots,
+// every snapshot is tagged by sequence and hash of the last applied block and protected by checksum
+class WalletsSnapshot {
+public:
+    enum Options : size_t {
+        // blocks between periodic snapshots
+        Interval = 10000,
+        // newest snapshots kept at disk, older one is used if the newest does not fit to chain
+        KeepCount = 2
+    };
+
+    // returns true if snapshot for sequence and hash may be used
+    using AcceptFunc = std::function<bool(cs::Sequence, const csdb::PoolHash&)>;
+
+    explicit WalletsSnapshot(const std::string& path);
+
+    // writes snapshot to temporary file and renames it, so torn snapshot is never visible
+    bool save(cs::Sequence sequence, const csdb::PoolHash& hash, const cs::Bytes& data);
+
+    // looks through snapshots from the newest one, returns data of the first accepted snapshot with valid checksum
+    bool load(const AcceptFunc& accept, cs::Sequence& sequence, cs::Bytes& data) const;
+
+    // removes all snapshots with sequence greater than argument
+    void removeAfter(cs::Sequence sequence);
+
+private:
+    struct Header {
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        cs::Sequence sequence = 0;
+        csdb::PoolHash hash;
+        cs::Hash checksum{};
+        uint64_t size = 0;
+    };
+
+    std::string fileName(cs::Sequence sequence) const;
+
+    // sequences of existing snapshots, newest first
+    std::vector<cs::Sequence> sequences() const;
+
+    bool readHeader(std::istream& stream, Header& header) const;
+    void removeOutdated();
+
+    const std::string path_;
+    mutable std::mutex mutex_;
+};
+}  // namespace cs
+
+#endif  // WALLETS_SNAPSHOT_HPP
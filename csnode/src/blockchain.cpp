@@ -1,9 +1,11 @@
 #include <base58.h>
 #include <csdb/currency.hpp>
+#include <csdb/poolview.hpp>
 #include <lib/system/hash.hpp>
 #include <lib/system/logger.hpp>
 #include <lib/system/utils.hpp>
 #include <limits>
+#include <unordered_map>
 
 #ifdef DBSQL
 #include <dbsql/roundinfo.hpp>
@@ -15,8 +17,11 @@
 #include <csnode/fee.hpp>
 #include <csnode/nodeutils.hpp>
 #include <csnode/node.hpp>
+#include <csnode/roundtrace.hpp>
 #include <csnode/transactionsindex.hpp>
 #include <csnode/transactionsiterator.hpp>
+#include <csnode/walletsshards.hpp>
+#include <csnode/walletssnapshot.hpp>
 #include <solver/smartcontracts.hpp>
 
 #include <boost/filesystem.hpp>
@@ -27,6 +32,7 @@ namespace fs = boost::filesystem;
 
 namespace {
 const char* cachesPath = "./caches";
+const char* snapshotsPath = "./caches/snapshots";
 const char* kLogPrefix = "BLOCKCHAIN: ";
 } // namespace
 
@@ -38,11 +44,13 @@ BlockChain::BlockChain(csdb::Address genesisAddress, csdb::Address startAddress,
 , walletIds_(new WalletsIds)
 , walletsCacheStorage_(new WalletsCache(*walletIds_))
 , multiWallets_(new MultiWallets())
+, walletsShards_(new WalletsShards())
 , cacheMutex_() {
     createCachesPath();
     walletsCacheUpdater_ = walletsCacheStorage_->createUpdater();
     blockHashes_ = std::make_unique<cs::BlockHashes>(cachesPath);
     trxIndex_ = std::make_unique<cs::TransactionsIndex>(*this, cachesPath, recreateIndex);
+    walletsSnapshot_ = std::make_shared<cs::WalletsSnapshot>(snapshotsPath);
 
 }
 
@@ -57,13 +65,12 @@ void BlockChain::subscribeToSignals() {
 
     cs::Connector::connect(&storage_.readingStoppedEvent(), trxIndex_.get(), &TransactionsIndex::onDbReadFinished);
     cs::Connector::connect(&storage_.readingStoppedEvent(), walletsCacheUpdater_.get(), &WalletsCache::Updater::onStopReadingFromDB);
+    cs::Connector::connect(&storage_.readingStoppedEvent(), this, &BlockChain::onStopReadFromDB);
 
-#ifdef MONITOR_NODE
     cs::Connector::connect(&walletsCacheUpdater_->updateFromDBFinishedEvent, multiWallets_.get(), &MultiWallets::onDbReadFinished);
     cs::Connector::connect(&walletsCacheUpdater_->updateFromDBFinishedEvent, [this](const auto&) {
         cs::Connector::connect(&walletsCacheUpdater_->walletUpdateEvent, multiWallets_.get(), &MultiWallets::onWalletCacheUpdated);
         });
-#endif
 }
 
 bool BlockChain::init(const std::string& path, cs::Sequence newBlockchainTop) {
@@ -76,7 +83,7 @@ bool BlockChain::init(const std::string& path, cs::Sequence newBlockchainTop) {
     csdb::Storage::OpenCallback progress = [&](const csdb::Storage::OpenProgress& progress) {
         ++totalLoaded;
         if (progress.poolsProcessed % 1000 == 0) {
-            std::cout << '\r' << WithDelimiters(progress.poolsProcessed) << std::flush;
+            std::cout << '\r' << WithDelimiters(progress.poolsProcessed) << " (" << WithDelimiters(progress.blocksPerSecond) << " blocks/sec)" << std::flush;
         }
         return false;
     };
@@ -92,6 +99,9 @@ bool BlockChain::init(const std::string& path, cs::Sequence newBlockchainTop) {
 
     cslog() << "\rDB is opened, loaded " << WithDelimiters(totalLoaded) << " blocks";
 
+    // new blocks are applied to wallets as usual
+    restoredSequence_ = cs::kWrongSequence;
+
     if (storage_.last_hash().is_empty()) {
         csdebug() << "Last hash is empty...";
         if (storage_.size()) {
@@ -108,6 +118,10 @@ bool BlockChain::init(const std::string& path, cs::Sequence newBlockchainTop) {
 
     good_ = true;
     blocksToBeRemoved_ = totalLoaded - 1; // any amount to remave after start
+
+    if (lastSequence_ >= lastSnapshotSequence_ + cs::WalletsSnapshot::Interval) {
+        saveWalletsSnapshot(lastSequence_, storage_.last_hash());
+    }
     return true;
 }
 
@@ -121,10 +135,111 @@ uint64_t BlockChain::uuid() const {
 }
 
 void BlockChain::onStartReadFromDB(cs::Sequence lastWrittenPoolSeq) {
+    readingFromDb_.store(true, std::memory_order_release);
+
     if (lastWrittenPoolSeq > 0) {
         cslog() << kLogPrefix << "start reading " << WithDelimiters(lastWrittenPoolSeq + 1)
             << " blocks from DB, 0.." << WithDelimiters(lastWrittenPoolSeq);
     }
+
+    restoreWalletsSnapshot(lastWrittenPoolSeq);
+}
+
+void BlockChain::restoreWalletsSnapshot(cs::Sequence lastWrittenPoolSeq) {
+    // index is recreated from wallets state of every block, so it requires full replay
+    if (trxIndex_->isRecreating()) {
+        cslog() << kLogPrefix << "transactions index is being recreated, wallets snapshot is not used";
+        return;
+    }
+
+    auto accept = [this, lastWrittenPoolSeq](cs::Sequence sequence, const csdb::PoolHash& hash) {
+        return sequence <= lastWrittenPoolSeq && storage_.pool_hash(sequence) == hash;
+    };
+
+    cs::Sequence sequence = 0;
+    cs::Bytes data;
+
+    if (!walletsSnapshot_->load(accept, sequence, data)) {
+        return;
+    }
+
+    cs::DataStream stream(data.data(), data.size());
+    bool isRestored = walletIds_->deserialize(stream) && walletsCacheStorage_->deserialize(stream);
+
+    uint64_t transactionsCount = 0;
+    NonEmptyBlockData lastNonEmptyBlock;
+    std::map<cs::Sequence, NonEmptyBlockData> previousNonEmpty;
+    size_t size = 0;
+
+    stream >> transactionsCount >> lastNonEmptyBlock.poolSeq >> lastNonEmptyBlock.transCount >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        cs::Sequence blockSequence = 0;
+        NonEmptyBlockData blockData;
+        stream >> blockSequence >> blockData.poolSeq >> blockData.transCount;
+        previousNonEmpty.emplace(blockSequence, blockData);
+    }
+
+    if (!isRestored || !stream.isValid()) {
+        cswarning() << kLogPrefix << "failed to restore wallets snapshot of block #" << WithDelimiters(sequence) << ", full replay is required";
+        walletIds_->clear();
+        walletsCacheStorage_->clear();
+        walletsShards_->reset(*walletsCacheStorage_);
+        return;
+    }
+
+    walletsShards_->reset(*walletsCacheStorage_);
+
+    total_transactions_count_ = transactionsCount;
+    lastNonEmptyBlock_ = lastNonEmptyBlock;
+    previousNonEmpty_ = std::move(previousNonEmpty);
+
+    restoredSequence_ = sequence;
+    lastSnapshotSequence_ = sequence;
+
+    cslog() << kLogPrefix << "wallets state is restored from snapshot of block #" << WithDelimiters(sequence)
+            << ", " << WithDelimiters(walletsCacheStorage_->getCount()) << " wallets";
+}
+
+void BlockChain::saveWalletsSnapshot(cs::Sequence sequence, const csdb::PoolHash& hash) {
+    if (hash.is_empty()) {
+        return;
+    }
+
+    // wallets are frozen in place and shared until they change, the rest is copied flat,
+    // so the state is serialized and written by background thread
+    auto wallets = walletsCacheStorage_->freeze();
+
+    if (!wallets) {
+        // the previous snapshot is still being written, it is taken at the next block
+        return;
+    }
+
+    auto ids = walletIds_->content();
+    std::vector<std::pair<cs::Sequence, NonEmptyBlockData>> previousNonEmpty(previousNonEmpty_.begin(), previousNonEmpty_.end());
+
+    lastSnapshotSequence_ = sequence;
+
+    cs::Concurrent::runBlocking(cs::RunPolicy::ThreadPolicy, [snapshot = walletsSnapshot_, sequence, hash = hash.clone(), wallets = std::move(wallets), ids = std::move(ids),
+                         transactionsCount = total_transactions_count_, lastNonEmptyBlock = lastNonEmptyBlock_,
+                         previousNonEmpty = std::move(previousNonEmpty)]() mutable {
+        cs::Bytes data;
+        cs::DataStream stream(data);
+
+        ids.serialize(stream);
+        wallets->serialize(stream);
+
+        stream << transactionsCount << lastNonEmptyBlock.poolSeq << lastNonEmptyBlock.transCount << previousNonEmpty.size();
+
+        for (const auto& [blockSequence, blockData] : previousNonEmpty) {
+            stream << blockSequence << blockData.poolSeq << blockData.transCount;
+        }
+
+        // cache joins frozen wallets with changed ones after they are released
+        wallets.reset();
+
+        snapshot->save(sequence, hash, data);
+    });
 }
 
 void BlockChain::onReadFromDB(csdb::Pool block, bool* shouldStop) {
@@ -136,7 +251,10 @@ void BlockChain::onReadFromDB(csdb::Pool block, bool* shouldStop) {
         csdebug() << kLogPrefix << "UUID = " << uuid_;
     }
 
-    if (!updateWalletIds(block, *walletsCacheUpdater_.get())) {
+    // wallets state of the block is already restored from snapshot
+    const bool isRestored = isRestoredBySnapshot(blockSeq);
+
+    if (!isRestored && !updateWalletIds(block, *walletsCacheUpdater_.get())) {
         cserror() << kLogPrefix << "updateWalletIds() failed on block #" << block.sequence();
         *shouldStop = true;
     }
@@ -152,8 +270,11 @@ void BlockChain::onReadFromDB(csdb::Pool block, bool* shouldStop) {
                     t.set_time(block_time);
                 }
             }
-            updateNonEmptyBlocks(block);
-            walletsCacheUpdater_->loadNextBlock(block, block.confidants(), *this);
+
+            if (!isRestored) {
+                updateNonEmptyBlocks(block);
+                updateWallets([&] { walletsCacheUpdater_->loadNextBlock(block, block.confidants(), *this); });
+            }
         }
     }
 }
@@ -260,8 +381,7 @@ void BlockChain::writeGenesisBlock() {
 }
 
 void BlockChain::iterateOverWallets(const std::function<bool(const cs::PublicKey&, const cs::WalletsCache::WalletData&)> func) {
-    std::lock_guard lock(cacheMutex_);
-    walletsCacheStorage_->iterateOverWallets(func);
+    iterateOverWalletsData(func);
 }
 
 #ifdef MONITOR_NODE
@@ -271,11 +391,8 @@ void BlockChain::iterateOverWriters(const std::function<bool(const cs::PublicKey
 }
 
 void BlockChain::applyToWallet(const csdb::Address& addr, const std::function<void(const cs::WalletsCache::WalletData&)> func) {
-    std::lock_guard lock(cacheMutex_);
     auto pub = getAddressByType(addr, BlockChain::AddressType::PublicKey);
-    auto wd = walletsCacheUpdater_->findWallet(pub.public_key());
-
-    func(*wd);
+    applyToWalletData(pub.public_key(), func);
 }
 #endif
 
@@ -312,6 +429,21 @@ csdb::Pool BlockChain::loadBlock(const cs::Sequence sequence) const {
     return storage_.pool_load(sequence);
 }
 
+csdb::PoolView BlockChain::loadBlockView(const cs::Sequence sequence) const {
+    std::lock_guard lock(dbLock_);
+
+    if (deferredBlock_.is_valid() && deferredBlock_.sequence() == sequence) {
+        auto pool = deferredBlock_.clone();
+        uint32_t size = 0;
+        const auto data = reinterpret_cast<const cs::Byte*>(pool.to_byte_stream(size));
+        return csdb::PoolView(cs::Bytes(data, data + size));
+    }
+    if (sequence > getLastSeq()) {
+        return csdb::PoolView{};
+    }
+    return storage_.pool_view(sequence);
+}
+
 csdb::Pool BlockChain::loadBlockMeta(const csdb::PoolHash& ph, size_t& cnt) const {
     std::lock_guard lock(dbLock_);
 
@@ -331,8 +463,10 @@ csdb::Transaction BlockChain::loadTransaction(const csdb::TransactionID& transId
         transaction.set_time(deferredBlock_.get_time());
     }
     else {
-        transaction = storage_.transaction(transId);
-        transaction.set_time(storage_.pool_load(transId.pool_seq()).get_time());
+        // only requested transaction is decoded
+        const auto view = storage_.pool_view(transId.pool_seq());
+        transaction = view.transaction(transId).to_transaction();
+        transaction.set_time(view.get_time());
     }
 
     return transaction;
@@ -398,7 +532,7 @@ void BlockChain::removeLastBlock() {
 
         // such operations are only possible on valid pool:
         total_transactions_count_ -= pool.transactions().size();
-        walletsCacheUpdater_->loadNextBlock(pool, pool.confidants(), *this, true);
+        updateWallets([&] { walletsCacheUpdater_->loadNextBlock(pool, pool.confidants(), *this, true); });
         // remove wallets exposed by the block
         removeWalletsInPoolFromCache(pool);
         // signal all subscribers, transaction index is still consistent up to removed block!
@@ -416,12 +550,71 @@ void BlockChain::removeLastBlock() {
     }
     --lastSequence_;
 
+    // snapshots of removed block are not valid any more, older one or replay is used on restart
+    walletsSnapshot_->removeAfter(lastSequence_);
+    if (lastSnapshotSequence_ > lastSequence_) {
+        lastSnapshotSequence_ = lastSequence_;
+    }
+
     csmeta(csdebug) << kLogPrefix << "done";
 }
 
 void BlockChain::updateLastTransactions(const std::vector<std::pair<cs::PublicKey, csdb::TransactionID>>& updates) {
-    std::lock_guard l(cacheMutex_);
-    walletsCacheUpdater_->updateLastTransactions(updates);
+    updateWallets([&] { walletsCacheUpdater_->updateLastTransactions(updates); });
+}
+
+void BlockChain::publishWallets() {
+    const auto keys = walletsCacheUpdater_->takeModified();
+
+    if (keys.empty()) {
+        return;
+    }
+
+    // copies are made before shards are locked, so readers wait only for moves
+    cs::WalletsShards::Wallets wallets;
+    wallets.reserve(keys.size());
+
+    for (const auto& key : keys) {
+        if (auto wallet = walletsCacheUpdater_->findWallet(key)) {
+            wallets.emplace_back(key, *wallet);
+        }
+    }
+
+    walletsShards_->publish(std::move(wallets));
+}
+
+void BlockChain::onStopReadFromDB() {
+    std::lock_guard lock(cacheMutex_);
+
+    // wallets changed by all read blocks are published at once
+    publishWallets();
+    readingFromDb_.store(false, std::memory_order_release);
+}
+
+bool BlockChain::applyToWalletData(const cs::PublicKey& key, const std::function<void(const WalletData&)>& func) const {
+    if (!readingFromDb_.load(std::memory_order_acquire)) {
+        return walletsShards_->apply(key, func);
+    }
+
+    std::lock_guard lock(cacheMutex_);
+    auto wallet = walletsCacheUpdater_->findWallet(key);
+
+    if (!wallet) {
+        return false;
+    }
+
+    func(*wallet);
+    return true;
+}
+
+void BlockChain::iterateOverWalletsData(const std::function<bool(const cs::PublicKey&, const WalletData&)>& func) const {
+    if (!readingFromDb_.load(std::memory_order_acquire)) {
+        walletsShards_->iterate(func);
+        return;
+    }
+
+    std::lock_guard lock(cacheMutex_);
+    walletsCacheStorage_->iterateOverWallets(func);
 }
 
 csdb::Address BlockChain::getAddressFromKey(const std::string& key) {
@@ -438,7 +631,7 @@ csdb::Address BlockChain::getAddressFromKey(const std::string& key) {
 
 void BlockChain::removeWalletsInPoolFromCache(const csdb::Pool& pool) {
     try {
-        std::lock_guard lock(cacheMutex_);
+        std::lock_guard lock(walletIdsMutex_);
         const csdb::Pool::NewWallets& newWallets = pool.newWallets();
 
         for (const auto& newWall : newWallets) {
@@ -482,6 +675,8 @@ void BlockChain::logBlockInfo(csdb::Pool& pool) {
 }
 
 bool BlockChain::finalizeBlock(csdb::Pool& pool, bool isTrusted, cs::PublicKeys lastConfidants) {
+    cs::RoundTrace::Span span(cs::RoundTrace::instance(), cs::RoundTrace::Kind::BlockFinalize);
+
     if (!pool.compose()) {
         csmeta(cserror) << kLogPrefix << "Couldn't compose block: " << pool.sequence();
         return false;
@@ -554,6 +749,16 @@ bool BlockChain::finalizeBlock(csdb::Pool& pool, bool isTrusted, cs::PublicKeys
     }
     // pool signatures check: end
 
+    // state of wallets is complete for previous block here, including contracts events raised after it was stored
+    if (currentSequence > 0 && currentSequence - 1 >= lastSnapshotSequence_ + cs::WalletsSnapshot::Interval) {
+        cs::ScopedLock lock(cacheMutex_, walletIdsMutex_);
+        saveWalletsSnapshot(currentSequence - 1, pool.previous_hash());
+    }
+    else {
+        std::lock_guard lock(cacheMutex_);
+        walletsCacheStorage_->compact();
+    }
+
     trxIndex_->update(pool);
     updateNonEmptyBlocks(pool);
 
@@ -597,8 +802,6 @@ cs::Sequence BlockChain::getSequenceByHash(const csdb::PoolHash& hash) const {
 }
 
 uint64_t BlockChain::getWalletsCountWithBalance() {
-    std::lock_guard lock(cacheMutex_);
-
     uint64_t count = 0;
     auto proc = [&](const cs::PublicKey&, const WalletData& wallet) {
         constexpr csdb::Amount zero_balance(0);
@@ -607,11 +810,19 @@ uint64_t BlockChain::getWalletsCountWithBalance() {
         }
         return true;
     };
-    walletsCacheStorage_->iterateOverWallets(proc);
+    iterateOverWalletsData(proc);
     return count;
 }
 
 void BlockChain::getTransactions(Transactions& transactions, csdb::Address address, uint64_t offset, uint64_t limit) {
+    if (!trxIndex_->isRecreating()) {
+        const uint64_t count = trxIndex_->getOrdinalsCount(address);
+        uint64_t cursor = count - std::min(count, offset);
+
+        getTransactionsPage(transactions, address, cursor, limit);
+        return;
+    }
+
     for (auto trIt = cs::TransactionsIterator(*this, address); trIt.isValid(); trIt.next()) {
         if (offset > 0) {
             --offset;
@@ -626,9 +837,56 @@ void BlockChain::getTransactions(Transactions& transactions, csdb::Address addre
     }
 }
 
+uint64_t BlockChain::getIndexedTransactionsCount() const {
+    return trxIndex_->getOrdinalsCount();
+}
+
+bool BlockChain::getTransactionsPage(Transactions& transactions, uint64_t& cursor, uint64_t limit) const {
+    if (trxIndex_->isRecreating()) {
+        return false;
+    }
+
+    cursor = std::min(cursor, trxIndex_->getOrdinalsCount());
+    loadTransactionsPage(transactions, trxIndex_->getTransactionIds(cursor, limit));
+    cursor -= std::min<uint64_t>(cursor, limit);
+
+    return true;
+}
+
+bool BlockChain::getTransactionsPage(Transactions& transactions, const csdb::Address& address, uint64_t& cursor, uint64_t limit) const {
+    if (trxIndex_->isRecreating()) {
+        return false;
+    }
+
+    cursor = std::min(cursor, trxIndex_->getOrdinalsCount(address));
+    loadTransactionsPage(transactions, trxIndex_->getTransactionIds(address, cursor, limit));
+    cursor -= std::min<uint64_t>(cursor, limit);
+
+    return true;
+}
+
+void BlockChain::loadTransactionsPage(Transactions& transactions, const std::vector<csdb::TransactionID>& ids) const {
+    csdb::Pool pool;
+
+    // ids of one page are mostly from the same blocks
+    for (const auto& id : ids) {
+        if (!pool.is_valid() || pool.sequence() != id.pool_seq()) {
+            pool = loadBlock(id.pool_seq());
+        }
+
+        if (!pool.is_valid() || id.index() >= pool.transactions_count()) {
+            csmeta(cserror) << kLogPrefix << "Transactions ordinals index is inconsistent at " << id.to_string();
+            continue;
+        }
+
+        transactions.push_back(pool.transaction(id));
+        transactions.back().set_time(pool.get_time());
+    }
+}
+
 bool BlockChain::updateWalletIds(const csdb::Pool& pool, WalletsCache::Updater& proc) {
     try {
-        std::lock_guard lock(cacheMutex_);
+        std::lock_guard lock(walletIdsMutex_);
 
         const csdb::Pool::NewWallets& newWallets = pool.newWallets();
         for (const auto& newWall : newWallets) {
@@ -754,8 +1012,16 @@ bool BlockChain::getTransaction(const csdb::Address& addr, const int64_t& innerI
 }
 
 bool BlockChain::updateContractData(const csdb::Address& abs_addr, const cs::Bytes& data) const {
-    cs::Lock lock(dbLock_);
-    return storage_.update_contract_data(abs_addr, data);
+    bool result = false;
+
+    {
+        cs::Lock lock(dbLock_);
+        result = storage_.update_contract_data(abs_addr, data);
+    }
+
+    // state may be changed even if update failed
+    emit contractDataUpdateEvent(abs_addr);
+    return result;
 }
 
 bool BlockChain::getContractData(const csdb::Address& abs_addr, cs::Bytes& data) const {
@@ -780,11 +1046,9 @@ bool BlockChain::updateFromNextBlock(const csdb::Pool& nextPool) {
     }
 
     try {
-        std::lock_guard lock(cacheMutex_);
-
         // currently block stores own round confidants, not next round:
         const auto& currentRoundConfidants = nextPool.confidants();
-        walletsCacheUpdater_->loadNextBlock(nextPool, currentRoundConfidants, *this);
+        updateWallets([&] { walletsCacheUpdater_->loadNextBlock(nextPool, currentRoundConfidants, *this); });
         if (!blockHashes_->onNextBlock(nextPool)) {
             cslog() << kLogPrefix << "Error writing DB structure";
         }
@@ -806,13 +1070,15 @@ bool BlockChain::findWalletData(const csdb::Address& address, WalletData& wallDa
         return findWalletData(address.wallet_id(), wallData);
     }
 
-    std::lock_guard lock(cacheMutex_);
+    {
+        std::lock_guard lock(walletIdsMutex_);
 
-    if (!walletIds_->normal().find(address, id)) {
-        return false;
+        if (!walletIds_->normal().find(address, id)) {
+            return false;
+        }
     }
 
-    return findWalletData_Unsafe(id, wallData);
+    return applyToWalletData(address.public_key(), [&wallData](const WalletData& wallet) { wallData = wallet; });
 }
 
 bool BlockChain::findWalletData(const csdb::Address& address, WalletData& wallData) const {
@@ -820,31 +1086,12 @@ bool BlockChain::findWalletData(const csdb::Address& address, WalletData& wallDa
         return findWalletData(address.wallet_id(), wallData);
     }
 
-    std::lock_guard lock(cacheMutex_);
-
-    const WalletData* wallDataPtr = walletsCacheUpdater_->findWallet(address.public_key());
-    if (wallDataPtr) {
-        wallData = *wallDataPtr;
-        return true;
-    }
-    return false;
+    return applyToWalletData(address.public_key(), [&wallData](const WalletData& wallet) { wallData = wallet; });
 }
 
 bool BlockChain::findWalletData(WalletId id, WalletData& wallData) const {
-    std::lock_guard lock(cacheMutex_);
-    return findWalletData_Unsafe(id, wallData);
-}
-
-bool BlockChain::findWalletData_Unsafe(WalletId id, WalletData& wallData) const {
     auto pubKey = getAddressByType(csdb::Address::from_wallet_id(id), AddressType::PublicKey);
-    const WalletData* wallDataPtr = walletsCacheUpdater_->findWallet(pubKey.public_key());
-
-    if (wallDataPtr) {
-        wallData = *wallDataPtr;
-        return true;
-    }
-
-    return false;
+    return applyToWalletData(pubKey.public_key(), [&wallData](const WalletData& wallet) { wallData = wallet; });
 }
 
 bool BlockChain::findWalletId(const WalletAddress& address, WalletId& id) const {
@@ -853,7 +1100,7 @@ bool BlockChain::findWalletId(const WalletAddress& address, WalletId& id) const
         return true;
     }
     else if (address.is_public_key()) {
-        std::lock_guard lock(cacheMutex_);
+        std::lock_guard lock(walletIdsMutex_);
         return walletIds_->normal().find(address, id);
     }
 
@@ -867,7 +1114,7 @@ bool BlockChain::getWalletId(const WalletAddress& address, WalletId& id) {
         return false;
     }
     else if (address.is_public_key()) {
-        std::lock_guard lock(cacheMutex_);
+        std::lock_guard lock(walletIdsMutex_);
         return walletIds_->normal().get(address, id);
     }
 
@@ -876,6 +1123,8 @@ bool BlockChain::getWalletId(const WalletAddress& address, WalletId& id) {
 }
 
 bool BlockChain::findAddrByWalletId(const WalletId id, csdb::Address& addr) const {
+    std::lock_guard lock(walletIdsMutex_);
+
     if (!walletIds_->normal().findaddr(id, addr)) {
         return false;
     }
@@ -1120,6 +1369,8 @@ bool BlockChain::deferredBlockExchange(cs::RoundPackage& rPackage, const csdb::P
 }
 
 bool BlockChain::storeBlock(csdb::Pool& pool, bool bySync) {
+    cs::RoundTrace::Span span(cs::RoundTrace::instance(), cs::RoundTrace::Kind::BlockStore);
+
     const auto lastSequence = getLastSeq();
     const auto poolSequence = pool.sequence();
     csdebug() << csfunc() << "last #" << lastSequence << ", pool #" << poolSequence;
@@ -1378,6 +1629,31 @@ csdb::Address BlockChain::getAddressByType(const csdb::Address& addr, AddressTyp
     return addr_res;
 }
 
+std::vector<csdb::Address> BlockChain::getAddressesByType(const std::vector<csdb::Address>& addresses, AddressType type) const {
+    std::vector<csdb::Address> result;
+    result.reserve(addresses.size());
+
+    std::unordered_map<csdb::Address, csdb::Address> resolved;
+
+    for (const auto& addr : addresses) {
+        // nothing to resolve
+        if (type == AddressType::PublicKey && addr.is_public_key()) {
+            result.push_back(addr);
+            continue;
+        }
+
+        auto iter = resolved.find(addr);
+
+        if (iter == resolved.end()) {
+            iter = resolved.emplace(addr, getAddressByType(addr, type)).first;
+        }
+
+        result.push_back(iter->second);
+    }
+
+    return result;
+}
+
 bool BlockChain::isEqual(const csdb::Address& laddr, const csdb::Address& raddr) const {
     if (getAddressByType(laddr, AddressType::PublicKey) == getAddressByType(raddr, AddressType::PublicKey)) {
         return true;
@@ -1387,16 +1663,14 @@ bool BlockChain::isEqual(const csdb::Address& laddr, const csdb::Address& raddr)
 }
 
 uint32_t BlockChain::getTransactionsCount(const csdb::Address& addr) {
-    std::lock_guard lock(cacheMutex_);
-
     auto pubKey = getAddressByType(addr, AddressType::PublicKey);
-    const WalletData* wallDataPtr = walletsCacheUpdater_->findWallet(pubKey.public_key());
+    uint32_t result = 0;
 
-    if (!wallDataPtr) {
-        return 0;
-    }
+    applyToWalletData(pubKey.public_key(), [&result](const WalletData& wallet) {
+        result = static_cast<uint32_t>(wallet.transNum_);
+    });
 
-    return static_cast<uint32_t>(wallDataPtr->transNum_);
+    return result;
 }
 
 //uint64_t BlockChain::initUuid() const {
@@ -1419,16 +1693,14 @@ uint32_t BlockChain::getTransactionsCount(const csdb::Address& addr) {
 //}
 
 csdb::TransactionID BlockChain::getLastTransaction(const csdb::Address& addr) const {
-    std::lock_guard lock(cacheMutex_);
-
     auto pubKey = getAddressByType(addr, AddressType::PublicKey);
-    const WalletData* wallDataPtr = walletsCacheUpdater_->findWallet(pubKey.public_key());
+    csdb::TransactionID result;
 
-    if (!wallDataPtr) {
-        return csdb::TransactionID();
-    }
+    applyToWalletData(pubKey.public_key(), [&result](const WalletData& wallet) {
+        result = wallet.lastTransaction_;
+    });
 
-    return wallDataPtr->lastTransaction_;
+    return result;
 }
 
 cs::Sequence BlockChain::getPreviousPoolSeq(const csdb::Address& addr, cs::Sequence ps) const {
@@ -0,0 +1,98 @@
+#include <csnode/blockreplycache.hpp>
+
+#include <algorithm>
+
+#include <csdb/pool.hpp>
+
+namespace cs {
+BlockReplyCache::BlockReplyCache(size_t maxCount, size_t maxBytes)
+: maxCount_(maxCount)
+, maxBytes_(maxBytes) {
+}
+
+std::optional<CompressedRegion> BlockReplyCache::find(const PoolsRequestedSequences& sequences) {
+    std::lock_guard lock(mutex_);
+
+    auto it = index_.find(sequences);
+
+    if (it == index_.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+
+    ++hits_;
+    items_.splice(items_.begin(), items_, it->second);
+
+    return it->second->region;
+}
+
+void BlockReplyCache::insert(const PoolsRequestedSequences& sequences, const CompressedRegion& region) {
+    if (sequences.empty() || region.size() > maxBytes_) {
+        return;
+    }
+
+    std::lock_guard lock(mutex_);
+
+    if (auto it = index_.find(sequences); it != index_.end()) {
+        erase(it->second);
+    }
+
+    items_.push_front(Item{sequences, *std::max_element(sequences.begin(), sequences.end()), region});
+    index_.emplace(sequences, items_.begin());
+    bytes_ += region.size();
+
+    while (items_.size() > maxCount_ || bytes_ > maxBytes_) {
+        erase(std::prev(items_.end()));
+    }
+}
+
+void BlockReplyCache::invalidate(cs::Sequence sequence) {
+    std::lock_guard lock(mutex_);
+
+    for (auto it = items_.begin(); it != items_.end();) {
+        auto current = it++;
+
+        if (current->maxSequence >= sequence) {
+            erase(current);
+        }
+    }
+}
+
+void BlockReplyCache::clear() {
+    std::lock_guard lock(mutex_);
+
+    items_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
+
+size_t BlockReplyCache::size() const {
+    std::lock_guard lock(mutex_);
+    return items_.size();
+}
+
+size_t BlockReplyCache::bytes() const {
+    std::lock_guard lock(mutex_);
+    return bytes_;
+}
+
+size_t BlockReplyCache::hits() const {
+    std::lock_guard lock(mutex_);
+    return hits_;
+}
+
+size_t BlockReplyCache::misses() const {
+    std::lock_guard lock(mutex_);
+    return misses_;
+}
+
+void BlockReplyCache::onRemoveBlock(const csdb::Pool& pool) {
+    invalidate(pool.sequence());
+}
+
+void BlockReplyCache::erase(Items::iterator it) {
+    bytes_ -= it->region.size();
+    index_.erase(it->sequences);
+    items_.erase(it);
+}
+}  // namespace cs
@@ -10,6 +10,7 @@
 #include <lib/system/common.hpp>
 #include <csnode/walletsstate.hpp>
 #include <csnode/walletscache.hpp>
+#include <csnode/signaturesverifier.hpp>
 #include <csdb/amount_commission.hpp>
 #include <csdb/pool.hpp>
 #include <cscrypto/cscrypto.hpp>
@@ -224,22 +225,27 @@ ValidationPlugin::ErrorType BlockSignaturesValidator::validateBlock(const csdb::
     return ErrorType::error;
   }
 
-  size_t checkingSignature = 0;
   auto signedData = cscrypto::calculateHash(block.to_binary().data(), block.hashingLength());
+  cs::Bytes message(signedData.begin(), signedData.end());
+
+  size_t checkingSignature = 0;
+  SignaturesVerifier verifier(signatures.size());
+
   for (size_t i = 0; i < confidants.size(); ++i) {
     if (realTrustedMask & (1ull << i)) {
-      if (!cscrypto::verifySignature(signatures[checkingSignature],
-                                     confidants[i],
-                                     signedData.data(),
-                                     cscrypto::kHashSize)) {
-        cserror() << kLogPrefix << "block " << block.sequence()
-                  << " has invalid signatures";
-        return ErrorType::error;
-      }
+      verifier.add(signatures[checkingSignature], confidants[i], message);
       ++checkingSignature;
     }
   }
 
+  const auto verified = verifier.verify();
+
+  if (std::find(verified.begin(), verified.end(), 0) != verified.end()) {
+    cserror() << kLogPrefix << "block " << block.sequence()
+              << " has invalid signatures";
+    return ErrorType::error;
+  }
+
   return ErrorType::noError;
 }
 
@@ -414,7 +420,15 @@ ValidationPlugin::ErrorType BalanceOnlyChecker::validateBlock(const csdb::Pool&
 ValidationPlugin::ErrorType TransactionsChecker::validateBlock(const csdb::Pool& block) {
   const auto& trxs = block.transactions();
   std::set<csdb::Address> newStates;
-  for (const auto& t : trxs) {
+  std::vector<size_t> indexes;
+  std::vector<csdb::Address> sources;
+
+  indexes.reserve(trxs.size());
+  sources.reserve(trxs.size());
+
+  for (size_t i = 0; i < trxs.size(); ++i) {
+    const auto& t = trxs[i];
+
     if (SmartContracts::is_new_state(t)) {
       // already checked by another plugin
       newStates.insert(t.source());
@@ -426,7 +440,23 @@ ValidationPlugin::ErrorType TransactionsChecker::validateBlock(const csdb::Pool&
       continue;
     }
 
-    if (!checkSignature(t)) {
+    indexes.push_back(i);
+    sources.push_back(t.source());
+  }
+
+  // resolve all wallet ids before verification
+  const auto keys = getBlockChain().getAddressesByType(sources, BlockChain::AddressType::PublicKey);
+  SignaturesVerifier verifier(indexes.size());
+
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    verifier.add(trxs[indexes[i]], keys[i].public_key());
+  }
+
+  const auto verified = verifier.verify();
+
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    if (!verified[i]) {
+      const auto& t = trxs[indexes[i]];
       cserror() << kLogPrefix << " in pool " << block.sequence()
                 << " transaction from " << t.source().to_string()
                 << ", with innerID " << t.innerID()
@@ -434,17 +464,8 @@ ValidationPlugin::ErrorType TransactionsChecker::validateBlock(const csdb::Pool&
       return ErrorType::error;
     }
   }
-  return ErrorType::noError;
-}
 
-bool TransactionsChecker::checkSignature(const csdb::Transaction& t) {
-  if (t.source().is_wallet_id()) {
-    const auto& bc = getBlockChain();
-    auto pub = bc.getAddressByType(t.source(), BlockChain::AddressType::PublicKey);
-    return t.verify_signature(pub.public_key());
-  } else {
-    return t.verify_signature(t.source().public_key());
-  }
+  return ErrorType::noError;
 }
 
 //
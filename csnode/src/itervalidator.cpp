@@ -4,6 +4,8 @@
 
 #include <csdb/amount_commission.hpp>
 #include <csnode/fee.hpp>
+#include <csnode/roundtrace.hpp>
+#include <csnode/signaturesverifier.hpp>
 #include <csnode/walletsstate.hpp>
 #include <smartcontracts.hpp>
 #include <solvercontext.hpp>
@@ -21,6 +23,8 @@ IterValidator::IterValidator(WalletsState& wallets) {
 }
 
 Characteristic IterValidator::formCharacteristic(SolverContext& context, Transactions& transactions, PacketsVector& smartsPackets) {
+    RoundTrace::Span span(RoundTrace::instance(), RoundTrace::Kind::Validation);
+
     cs::Characteristic characteristic;
     characteristic.mask.resize(transactions.size(), Reject::Reason::None);
 
@@ -176,19 +180,52 @@ Reject::Reason IterValidator::deployAdditionalCheck(SolverContext& context, size
 
 void IterValidator::checkTransactionsSignatures(SolverContext& context, const Transactions& transactions, cs::Bytes& characteristicMask, PacketsVector& smartsPackets) {
     checkSignaturesSmartSource(context, smartsPackets);
-    size_t transactionsCount = transactions.size();
-    size_t maskSize = characteristicMask.size();
+    const size_t count = std::min(transactions.size(), characteristicMask.size());
+
+    // signatures checked by rules without crypto are set at once, others go to batch
+    std::vector<size_t> indexes;
+    std::vector<csdb::Address> sources;
+    indexes.reserve(count);
+    sources.reserve(count);
+
+    cs::Bytes correctSignatures(count, 0);
+
+    for (size_t i = 0; i < count; ++i) {
+        auto checked = checkSmartSignature(context, transactions[i]);
+
+        if (checked.has_value()) {
+            correctSignatures[i] = checked.value() ? 1 : 0;
+        }
+        else {
+            indexes.push_back(i);
+            sources.push_back(transactions[i].source());
+        }
+    }
+
+    // resolve all wallet ids before verification
+    const auto keys = context.blockchain().getAddressesByType(sources, BlockChain::AddressType::PublicKey);
+
+    SignaturesVerifier verifier(indexes.size());
+
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        verifier.add(transactions[indexes[i]], keys[i].public_key());
+    }
+
+    const auto verified = verifier.verify();
+
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        correctSignatures[indexes[i]] = verified[i];
+    }
+
     size_t rejectedCounter = 0;
-    for (size_t i = 0; i < transactionsCount; ++i) {
-        if (i < maskSize) {
-            bool correctSignature = checkTransactionSignature(context, transactions[i]);
-            if (!correctSignature) {
-                characteristicMask[i] = Reject::Reason::WrongSignature;
-                rejectedCounter++;
-                cslog() << kLogPrefix << "transaction[" << i << "] rejected, incorrect signature.";
-                if (SmartContracts::is_new_state(transactions[i])) {
-                    pTransval_->saveNewState(context.smart_contracts().absolute_address(transactions[i].source()), i, Reject::Reason::WrongSignature);
-                }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!correctSignatures[i]) {
+            characteristicMask[i] = Reject::Reason::WrongSignature;
+            rejectedCounter++;
+            cslog() << kLogPrefix << "transaction[" << i << "] rejected, incorrect signature.";
+            if (SmartContracts::is_new_state(transactions[i])) {
+                pTransval_->saveNewState(context.smart_contracts().absolute_address(transactions[i].source()), i, Reject::Reason::WrongSignature);
             }
         }
     }
@@ -197,7 +234,7 @@ void IterValidator::checkTransactionsSignatures(SolverContext& context, const Tr
     }
 }
 
-bool IterValidator::checkTransactionSignature(SolverContext& context, const csdb::Transaction& transaction) {
+std::optional<bool> IterValidator::checkSmartSignature(SolverContext& context, const csdb::Transaction& transaction) {
     csdb::Address src = transaction.source();
     // TODO: is_known_smart_contract() does not recognize not yet deployed contract, so all transactions emitted in constructor
     // currently will be rejected
@@ -207,11 +244,8 @@ bool IterValidator::checkTransactionSignature(SolverContext& context, const csdb
         smartSourceTransaction = context.smart_contracts().is_known_smart_contract(transaction.source());
     }
     if (!SmartContracts::is_new_state(transaction) && !smartSourceTransaction) {
-        if (src.is_wallet_id()) {
-            auto pub = context.blockchain().getAddressByType(src, BlockChain::AddressType::PublicKey);
-            return transaction.verify_signature(pub.public_key());
-        }
-        return transaction.verify_signature(src.public_key());
+        // ordinary signature, must be verified by source public key
+        return std::nullopt;
     }
     else {
         // special rule for new_state transactions
@@ -39,25 +39,36 @@ void cs::MultiWallets::onDbReadFinished(const std::unordered_map<cs::PublicKey,
     cs::Lock lock(mutex_);
 
     for (const auto& [key, value] : data) {
-        auto mapped = map(key, value);
-        indexes_.insert(std::move(mapped));
+        if (isListed(key, value)) {
+            indexes_.insert(map(key, value));
+        }
     }
 }
 
 void cs::MultiWallets::onWalletCacheUpdated(const cs::PublicKey& key, const cs::WalletsCache::WalletData& data) {
+    const bool listed = isListed(key, data);
     auto mapped = map(key, data);
 
     cs::Lock lock(mutex_);
     auto& byKey = indexes_.get<Tags::ByPublicKey>();
 
     if (auto iter = byKey.find(key); iter != byKey.end()) {
-        byKey.replace(iter, mapped);
+        if (listed) {
+            byKey.replace(iter, mapped);
+        }
+        else {
+            byKey.erase(iter);
+        }
     }
-    else {
+    else if (listed) {
         indexes_.insert(mapped);
     }
 }
 
+bool cs::MultiWallets::isListed(const cs::PublicKey& key, const cs::WalletsCache::WalletData& data) {
+    return !key.empty() && data.balance_ >= csdb::Amount(0);
+}
+
 cs::MultiWallets::InternalData cs::MultiWallets::map(const cs::PublicKey& key, const cs::WalletsCache::WalletData& data) {
     InternalData mapped { key, data.balance_, data.transNum_
 #ifdef MONITOR_NODE
@@ -2,6 +2,7 @@
 #include <csignal>
 #include <numeric>
 #include <sstream>
+#include <thread>
 #include <numeric>
 
 #include <solver/consensus.hpp>
@@ -19,7 +20,11 @@
 #include <csnode/roundpackage.hpp>
 #include <csnode/configholder.hpp>
 #include <csnode/eventreport.hpp>
+#include <csnode/roundtrace.hpp>
 
+#include <csdb/poolview.hpp>
+
+#include <lib/system/concurrent.hpp>
 #include <lib/system/logger.hpp>
 #include <lib/system/progressbar.hpp>
 #include <lib/system/signals.hpp>
@@ -50,6 +55,7 @@ Node::Node(cs::config::Observer& observer)
 , blockValidator_(std::make_unique<cs::BlockValidator>(*this))
 , observer_(observer) {
     autoShutdownEnabled_ = cs::ConfigHolder::instance().config()->autoShutdownEnabled();
+    ostream_.setErasureCoding(cs::ConfigHolder::instance().config()->useErasureCoding());
 
     solver_ = new cs::SolverCore(this, genesisAddress_, startAddress_);
 
@@ -82,10 +88,12 @@ Node::Node(cs::config::Observer& observer)
     cs::Connector::connect(&blockChain_.readBlockEvent(), &executor, &cs::Executor::onReadBlock);
     cs::Connector::connect(&blockChain_.storeBlockEvent, &stat_, &cs::RoundStat::onStoreBlock);
     cs::Connector::connect(&blockChain_.storeBlockEvent, &executor, &cs::Executor::onBlockStored);
+    cs::Connector::connect(&blockChain_.contractDataUpdateEvent, &executor, &cs::Executor::onContractDataUpdated);
     cs::Connector::connect(&transport_->pingReceived, this, &Node::onPingReceived);
     cs::Connector::connect(&transport_->pingReceived, &stat_, &cs::RoundStat::onPingReceived);
     cs::Connector::connect(&blockChain_.alarmBadBlock, this, &Node::sendBlockAlarmSignal);
     cs::Connector::connect(&blockChain_.tryToStoreBlockEvent, this, &Node::deepBlockValidation);
+    cs::Connector::connect(&blockChain_.removeBlockEvent, &blockReplyCache_, &cs::BlockReplyCache::onRemoveBlock);
 
     setupNextMessageBehaviour();
 
@@ -195,10 +203,41 @@ void Node::stop() {
     cs::Executor::instance().stop();
     cswarning() << "[EXECUTOR IS SIGNALED TO STOP]";
 
+    dumpRoundTrace();
+
     observer_.stop();
     cswarning() << "[CONFIG OBSERVER STOPPED]";
 }
 
+namespace {
+void writeRoundTrace(const std::string& path) {
+    if (!path.empty() && !cs::RoundTrace::instance().dump(path)) {
+        cswarning() << "NODE> Can not dump round trace to " << path;
+    }
+}
+}  // namespace
+
+void Node::dumpRoundTrace() {
+    while (roundTraceDumping_.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    writeRoundTrace(cs::ConfigHolder::instance().config()->getRoundTraceFile());
+    roundTraceDumping_.clear(std::memory_order_release);
+}
+
+void Node::dumpRoundTraceAsync() {
+    if (roundTraceDumping_.test_and_set(std::memory_order_acquire)) {
+        return;
+    }
+
+    // file is written out of round processing at dedicated thread to not occupy runtime workers, events are read lock free
+    cs::Concurrent::runBlocking(cs::RunPolicy::ThreadPolicy, [this, path = cs::ConfigHolder::instance().config()->getRoundTraceFile()] {
+        writeRoundTrace(path);
+        roundTraceDumping_.clear(std::memory_order_release);
+    });
+}
+
 void Node::initCurrentRP() {
     cs::RoundPackage rp;
     if (getBlockChain().getLastSeq() == 0) {
@@ -576,23 +615,34 @@ bool Node::verifyPacketTransactions(cs::TransactionsPacket packet, const cs::Pub
 }
 
 void Node::getTransactionsPacket(const uint8_t* data, const std::size_t size, const cs::PublicKey& sender) {
-    istream_.init(data, size);
+    if (auto apply = prepareTransactionsPacket(data, size, sender)) {
+        apply();
+    }
+}
+
+Node::MessageApply Node::prepareTransactionsPacket(const uint8_t* data, const std::size_t size, const cs::PublicKey& sender) {
+    cs::IPackStream stream;
+    stream.init(data, size);
 
     cs::TransactionsPacket packet;
-    istream_ >> packet;
+    stream >> packet;
 
     if (packet.hash().isEmpty()) {
         cswarning() << "Received transaction packet hash is empty";
-        return;
-    }
-    
-    if (verifyPacketSignatures(packet, sender) && verifyPacketTransactions(packet, sender)) {
-        processTransactionsPacket(std::move(packet));
+        return MessageApply();
     }
-    else {
-        addToBlackList(sender, true);
-    }
-    cs::Bytes toHash = packet.toBinary(cs::TransactionsPacket::Serialization::Transactions);
+
+    // signatures check is the heaviest part, transactions are validated against current wallets state
+    const bool isSigned = verifyPacketSignatures(packet, sender);
+
+    return [this, packet = std::move(packet), sender, isSigned]() mutable {
+        if (isSigned && verifyPacketTransactions(packet, sender)) {
+            processTransactionsPacket(std::move(packet));
+        }
+        else {
+            addToBlackList(sender, true);
+        }
+    };
 }
 
 void Node::getNodeStopRequest(const cs::RoundNumber round, const uint8_t* data, const std::size_t size) {
@@ -710,24 +760,33 @@ void Node::getPacketHashesRequest(const uint8_t* data, const std::size_t size, c
 }
 
 void Node::getPacketHashesReply(const uint8_t* data, const std::size_t size, const cs::RoundNumber round, const cs::PublicKey& sender) {
-    if (cs::Conveyer::instance().isSyncCompleted(round)) {
-        csdebug() << "NODE> sync packets have already finished in round " << round;
-        return;
+    if (auto apply = preparePacketHashesReply(data, size, round, sender)) {
+        apply();
     }
+}
 
-    istream_.init(data, size);
+Node::MessageApply Node::preparePacketHashesReply(const uint8_t* data, const std::size_t size, const cs::RoundNumber round, const cs::PublicKey& sender) {
+    cs::IPackStream stream;
+    stream.init(data, size);
 
     cs::PacketsVector packets;
-    istream_ >> packets;
+    stream >> packets;
 
     if (packets.empty()) {
         csmeta(cserror) << "Packet hashes reply, bad packets parsing";
-        return;
+        return MessageApply();
     }
 
-    csdebug() << "NODE> Get reply with " << packets.size() <<  " packet hashes from sender " << cs::Utils::byteStreamToHex(sender);
+    return [this, packets = std::move(packets), round, sender]() mutable {
+        if (cs::Conveyer::instance().isSyncCompleted(round)) {
+            csdebug() << "NODE> sync packets have already finished in round " << round;
+            return;
+        }
+
+        csdebug() << "NODE> Get reply with " << packets.size() <<  " packet hashes from sender " << cs::Utils::byteStreamToHex(sender);
 
-    processPacketsReply(std::move(packets), round);
+        processPacketsReply(std::move(packets), round);
+    };
 }
 
 
@@ -1245,19 +1304,23 @@ void Node::sendStateReply(const cs::PublicKey& respondent, const csdb::Address&
 }
 
 void Node::getStateReply(const uint8_t* data, const std::size_t size, const cs::RoundNumber rNum, const cs::PublicKey& sender) {
-    istream_.init(data, size);
+    if (auto apply = prepareStateReply(data, size, rNum, sender)) {
+        apply();
+    }
+}
+
+Node::MessageApply Node::prepareStateReply(const uint8_t* data, const std::size_t size, const cs::RoundNumber rNum, const cs::PublicKey& sender) {
+    cs::IPackStream stream;
+    stream.init(data, size);
+
     cs::PublicKey key;
     cs::Bytes contract_data;
     cs::Signature signature;
-    istream_ >> key >> contract_data >> signature;
-    csdb::Address abs_addr = csdb::Address::from_public_key(key);
-    
-    csmeta(csdebug) << cs::SmartContracts::to_base58(blockChain_, abs_addr) << " from "
-        << cs::Utils::byteStreamToHex(sender.data(), sender.size());
+    stream >> key >> contract_data >> signature;
 
-    if (!istream_.good() || !istream_.end()) {
+    if (!stream.good() || !stream.end()) {
         cserror() << "NODE> Bad State packet format";
-        return;
+        return MessageApply();
     }
 
     cs::Bytes signed_data;
@@ -1265,11 +1328,18 @@ void Node::getStateReply(const uint8_t* data, const std::size_t size, const cs::
     signed_stream << rNum << key << contract_data;
     if (!cscrypto::verifySignature(signature, sender, signed_data.data(), signed_data.size())) {
         csdebug() << "NODE> State Signature is incorrect";
-        return;
+        return MessageApply();
     }
 
-    /*Place here the function call with (state)*/
-    solver_->smart_contracts().net_update_contract_state(abs_addr, contract_data);
+    return [this, key, contract_data = std::move(contract_data), sender] {
+        csdb::Address abs_addr = csdb::Address::from_public_key(key);
+
+        csdebug() << "NODE> Get state reply of " << cs::SmartContracts::to_base58(blockChain_, abs_addr) << " from "
+            << cs::Utils::byteStreamToHex(sender.data(), sender.size());
+
+        /*Place here the function call with (state)*/
+        solver_->smart_contracts().net_update_contract_state(abs_addr, contract_data);
+    };
 }
 
 cs::ConfidantsKeys Node::retriveSmartConfidants(const cs::Sequence startSmartRoundNumber) const {
@@ -1359,76 +1429,92 @@ void Node::getBlockRequest(const uint8_t* data, const size_t size, const cs::Pub
         return;
     }
 
-    const bool isOneBlockReply = poolSynchronizer_->isOneBlockReply();
-    const std::size_t reserveSize = isOneBlockReply ? 1 : sequences.size();
-
-    cs::PoolsBlock poolsBlock;
-    poolsBlock.reserve(reserveSize);
-
-    auto sendReply = [&] {
-        sendBlockReply(poolsBlock, sender, packetNum);
-        poolsBlock.clear();
-    };
-
-    for (auto& sequence : sequences) {
-        csdb::Pool pool = blockChain_.loadBlock(sequence);
-
-        if (pool.is_valid()) {
-            poolsBlock.push_back(std::move(pool));
-
-            if (isOneBlockReply) {
-                sendReply();
-            }
-        }
-        else {
-            csmeta(cslog) << "unable to load block " << sequence << " from blockchain";
+    if (poolSynchronizer_->isOneBlockReply()) {
+        for (const auto sequence : sequences) {
+            sendBlockReply(cs::PoolsRequestedSequences{sequence}, sender, packetNum);
         }
     }
-
-    if (!isOneBlockReply) {
-        sendReply();
+    else {
+        sendBlockReply(sequences, sender, packetNum);
     }
+
+    csdebug() << "NODE> Block replies cache: " << blockReplyCache_.hits() << " hit(s), " << blockReplyCache_.misses() << " miss(es), "
+              << blockReplyCache_.size() << " item(s) of " << blockReplyCache_.bytes() << " bytes";
 }
 
 void Node::getBlockReply(const uint8_t* data, const size_t size) {
-    if (!poolSynchronizer_->isSyncroStarted()) {
-        csdebug() << "NODE> Get block reply> Pool sync has already finished";
-        return;
+    if (auto apply = prepareBlockReply(data, size)) {
+        apply();
     }
+}
 
-    csdebug() << "NODE> Get Block Reply";
-
-    istream_.init(data, size);
+Node::MessageApply Node::prepareBlockReply(const uint8_t* data, const size_t size) {
+    cs::IPackStream stream;
+    stream.init(data, size);
 
     CompressedRegion region;
-    istream_ >> region;
+    stream >> region;
 
     size_t packetNumber = 0;
-    istream_ >> packetNumber;
+    stream >> packetNumber;
 
-    cs::PoolsBlock poolsBlock = compressor_.decompress<cs::PoolsBlock>(region);
+    // node compressor belongs to processor thread
+    cs::Compressor compressor;
+    cs::PoolsBlock poolsBlock = compressor.decompress<cs::PoolsBlock>(region);
 
     if (poolsBlock.empty()) {
         cserror() << "NODE> Get block reply> No pools found";
-        return;
+        return MessageApply();
     }
 
-    poolSynchronizer_->getBlockReply(std::move(poolsBlock), packetNumber);
+    return [this, poolsBlock = std::move(poolsBlock), packetNumber]() mutable {
+        if (!poolSynchronizer_->isSyncroStarted()) {
+            csdebug() << "NODE> Get block reply> Pool sync has already finished";
+            return;
+        }
+
+        csdebug() << "NODE> Get Block Reply";
+
+        poolSynchronizer_->getBlockReply(std::move(poolsBlock), packetNumber);
+    };
 }
 
-void Node::sendBlockReply(const cs::PoolsBlock& poolsBlock, const cs::PublicKey& target, std::size_t packetNum) {
-    for (const auto& pool : poolsBlock) {
-        csdebug() << "NODE> Send block reply. Sequence: " << pool.sequence();
-    }
+void Node::sendBlockReply(const cs::PoolsRequestedSequences& sequences, const cs::PublicKey& target, std::size_t packetNum) {
+    auto region = blockReplyCache_.find(sequences);
+
+    if (!region.has_value()) {
+        // stored binary is the same as serialized csdb::Pool, so it is framed as is without decoding
+        std::vector<cs::Bytes> blocks;
+        blocks.reserve(sequences.size());
+
+        for (const auto sequence : sequences) {
+            csdb::PoolView view = blockChain_.loadBlockView(sequence);
+
+            if (view.is_valid()) {
+                blocks.push_back(view.to_binary());
+            }
+            else {
+                csmeta(cslog) << "unable to load block " << sequence << " from blockchain";
+            }
+        }
+
+        if (blocks.empty()) {
+            return;
+        }
+
+        region = compressor_.compress(blocks);
 
-    csdebug() << "Node> Sending blocks with signatures:";
+        // the last block may be replaced yet, removed blocks invalidate cache by signal
+        const bool isComplete = blocks.size() == sequences.size();
+        const bool isStored = *std::max_element(sequences.begin(), sequences.end()) < blockChain_.getLastSeq();
 
-    for (const auto& it : poolsBlock) {
-        csdebug() << "#" << it.sequence() << " signs = " << it.signatures().size();
+        if (isComplete && isStored) {
+            blockReplyCache_.insert(sequences, region.value());
+        }
     }
 
-    auto region = compressor_.compress(poolsBlock);
-    sendDirect(target, MsgTypes::RequestedBlock, cs::Conveyer::instance().currentRoundNumber(), region, packetNum);
+    csdebug() << "NODE> Send block reply. Sequences: " << sequences.front() << " - " << sequences.back() << ", count " << sequences.size();
+    sendDirect(target, MsgTypes::RequestedBlock, cs::Conveyer::instance().currentRoundNumber(), region.value(), packetNum);
 }
 
 void Node::becomeWriter() {
@@ -1598,7 +1684,8 @@ void Node::sendBlockRequest(const ConnectionPtr target, const cs::PoolsRequested
     ostream_ << sequences;
     ostream_ << packetNum;
 
-    transport_->deliverDirect(ostream_.getPackets(), ostream_.getPacketsCount(), target);
+    auto packets = ostream_.getPackets();
+    transport_->deliverDirect(packets, ostream_.getPacketsCount(), target);
 
     ostream_.clear();
 }
@@ -1843,7 +1930,8 @@ void Node::sendToNeighbour(const ConnectionPtr target, const MsgTypes msgType, c
     csdetails() << "NODE> Sending Direct data: packets count: " << ostream_.getPacketsCount() << ", last packet size: " << ostream_.getCurrentSize() << ", out: " << target->out
         << ", in: " << target->in << ", specialOut: " << target->specialOut << ", msgType: " << Packet::messageTypeToString(msgType);
 
-    transport_->deliverDirect(ostream_.getPackets(), ostream_.getPacketsCount(), target);
+    auto packets = ostream_.getPackets();
+    transport_->deliverDirect(packets, ostream_.getPacketsCount(), target);
     ostream_.clear();
 }
 
@@ -1896,7 +1984,8 @@ uint32_t Node::sendToList(const std::vector<cs::PublicKey>& listMembers, const c
     csdebug() << "NODE> Sending to confidants list, size: " << ostream_.getCurrentSize() << ", round: " << round
                 << ", msgType: " << Packet::messageTypeToString(msgType);
 
-    const auto result = transport_->deliverConfidants(ostream_.getPackets(), ostream_.getPacketsCount(), listMembers, static_cast<int>(listExeption));
+    auto packets = ostream_.getPackets();
+    const auto result = transport_->deliverConfidants(packets, ostream_.getPacketsCount(), listMembers, static_cast<int>(listExeption));
     ostream_.clear();
 
     if (!result.second.empty()) {
@@ -1953,7 +2042,8 @@ void Node::sendToBroadcastImpl(const MsgTypes& msgType, const cs::RoundNumber ro
 
     csdebug() << "NODE> Sending broadcast data: size: " << ostream_.getCurrentSize() << ", round: " << round
                 << ", msgType: " << Packet::messageTypeToString(msgType);
-    transport_->deliverBroadcast(ostream_.getPackets(), ostream_.getPacketsCount());
+    auto packets = ostream_.getPackets();
+    transport_->deliverBroadcast(packets, ostream_.getPacketsCount());
     ostream_.clear();
 }
 
@@ -1963,6 +2053,8 @@ void Node::sendStageOne(const cs::StageOne& stageOneInfo) {
         return;
     }
 
+    cs::RoundTrace::Span span(cs::RoundTrace::instance(), cs::RoundTrace::Kind::StageOneSent);
+
     csmeta(csdebug) << "Round: " << cs::Conveyer::instance().currentRoundNumber() << "." << cs::numeric_cast<int>(subRound_)
         << cs::StageOne::toString(stageOneInfo);
 
@@ -2061,6 +2153,7 @@ void Node::sendStageTwo(cs::StageTwo& stageTwoInfo) {
         return;
     }
 
+    cs::RoundTrace::Span span(cs::RoundTrace::instance(), cs::RoundTrace::Kind::StageTwoSent);
     sendToConfidants(MsgTypes::SecondStage, cs::Conveyer::instance().currentRoundNumber(), subRound_, stageTwoInfo.signature, stageTwoInfo.message);
 
     // cash our stage two
@@ -2134,6 +2227,8 @@ void Node::sendStageThree(cs::StageThree& stageThreeInfo) {
         return;
     }
 
+    cs::RoundTrace::Span span(cs::RoundTrace::instance(), cs::RoundTrace::Kind::StageThreeSent);
+
     // TODO: think how to improve this code
     sendToConfidants(MsgTypes::ThirdStage, cs::Conveyer::instance().currentRoundNumber(), subRound_, stageThreeInfo.signature, stageThreeInfo.message);
 
@@ -2720,7 +2815,11 @@ void Node::sendRoundTable(cs::RoundPackage& rPackage) {
     table.hashes = rPackage.roundTable().hashes;
     roundPackageCache_.push_back(rPackage);
     clearRPCache(rPackage.roundTable().round);
-    sendRoundPackageToAll(rPackage);
+
+    {
+        cs::RoundTrace::Span span(cs::RoundTrace::instance(), cs::RoundTrace::Kind::RoundTableSent);
+        sendRoundPackageToAll(rPackage);
+    }
 
     csdebug() << "Round " << rPackage.roundTable().round << ", Confidants count " << rPackage.roundTable().confidants.size();
     csdebug() << "Hashes count: " << rPackage.roundTable().hashes.size();
@@ -3468,6 +3567,13 @@ void Node::onRoundStart(const cs::RoundTable& roundTable, bool updateRound) {
     }
 
     updateBlackListCounter();
+
+    cs::RoundTrace::instance().startRound(roundTable.round);
+
+    if (roundTable.round % roundTraceDumpPeriod_ == 0) {
+        dumpRoundTraceAsync();
+    }
+
     // TODO: think how to improve this code.
     stageOneMessage_.clear();
     stageOneMessage_.resize(roundTable.confidants.size());
@@ -0,0 +1,270 @@
+#include <csnode/roundtrace.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <ostream>
+
+namespace {
+const std::array<char, 8> kDumpMagic = {'C', 'S', 'R', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t kDumpVersion = 1;
+
+uint64_t now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+template <typename T>
+void write(std::ostream& os, const T& value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read(std::istream& is, T& value) {
+    return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+double toMs(uint64_t microseconds) {
+    return static_cast<double>(microseconds) / 1000.0;
+}
+}  // namespace
+
+// sequence is odd while the slot is written, and 2 * (index + 1) when the event of index is ready
+struct cs::RoundTrace::Slot {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> time{0};
+    std::atomic<uint64_t> round{0};
+    std::atomic<uint64_t> data{0};
+};
+
+cs::RoundTrace::Span::Span(RoundTrace& trace, Kind kind, uint8_t sender)
+: trace_(trace)
+, kind_(kind)
+, sender_(sender)
+, time_(now())
+, start_(std::chrono::steady_clock::now()) {
+}
+
+cs::RoundTrace::Span::~Span() {
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count();
+    trace_.record(time_, kind_, sender_, static_cast<uint32_t>(std::min<int64_t>(duration, std::numeric_limits<uint32_t>::max())));
+}
+
+cs::RoundTrace& cs::RoundTrace::instance() {
+    static RoundTrace trace;
+    return trace;
+}
+
+cs::RoundTrace::RoundTrace()
+: slots_(std::make_unique<Slot[]>(kCapacity))
+, head_(0)
+, round_(0) {
+}
+
+cs::RoundTrace::~RoundTrace() = default;
+
+void cs::RoundTrace::startRound(cs::RoundNumber round) {
+    round_.store(round, std::memory_order_relaxed);
+    record(Kind::RoundStart);
+}
+
+void cs::RoundTrace::record(Kind kind, uint8_t sender, uint32_t duration) {
+    record(now(), kind, sender, duration);
+}
+
+void cs::RoundTrace::record(uint64_t time, Kind kind, uint8_t sender, uint32_t duration) {
+    const uint64_t index = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[index % kCapacity];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.time.store(time, std::memory_order_relaxed);
+    slot.round.store(round_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    slot.data.store(static_cast<uint64_t>(kind) | (static_cast<uint64_t>(sender) << 8) | (static_cast<uint64_t>(duration) << 32), std::memory_order_relaxed);
+
+    slot.sequence.store(2 * (index + 1), std::memory_order_release);
+}
+
+std::vector<cs::RoundTrace::Event> cs::RoundTrace::events() const {
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t begin = head > kCapacity ? head - kCapacity : 0;
+
+    std::vector<Event> result;
+    result.reserve(static_cast<size_t>(head - begin));
+
+    for (uint64_t index = begin; index < head; ++index) {
+        const Slot& slot = slots_[index % kCapacity];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        // not written yet or already overwritten
+        if (sequence != 2 * (index + 1)) {
+            continue;
+        }
+
+        Event event;
+        event.time = slot.time.load(std::memory_order_relaxed);
+        event.round = slot.round.load(std::memory_order_relaxed);
+
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        event.kind = static_cast<Kind>(data & 0xff);
+        event.sender = static_cast<uint8_t>((data >> 8) & 0xff);
+        event.duration = static_cast<uint32_t>(data >> 32);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+            result.push_back(event);
+        }
+    }
+
+    return result;
+}
+
+bool cs::RoundTrace::dump(const std::string& path) const {
+    const auto items = events();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    if (!file) {
+        return false;
+    }
+
+    file.write(kDumpMagic.data(), kDumpMagic.size());
+    write(file, kDumpVersion);
+    write(file, static_cast<uint64_t>(items.size()));
+
+    for (const auto& event : items) {
+        write(file, event.time);
+        write(file, static_cast<uint64_t>(event.round));
+        write(file, static_cast<uint8_t>(event.kind));
+        write(file, event.sender);
+        write(file, uint16_t(0));
+        write(file, event.duration);
+    }
+
+    return static_cast<bool>(file);
+}
+
+std::optional<std::vector<cs::RoundTrace::Event>> cs::RoundTrace::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::array<char, kDumpMagic.size()> magic{};
+    uint32_t version = 0;
+    uint64_t count = 0;
+
+    if (!file.read(magic.data(), magic.size()) || magic != kDumpMagic || !read(file, version) || version != kDumpVersion || !read(file, count)) {
+        return std::nullopt;
+    }
+
+    std::vector<Event> result;
+    result.reserve(static_cast<size_t>(std::min<uint64_t>(count, kCapacity)));
+
+    for (uint64_t i = 0; i < count; ++i) {
+        Event event;
+        uint64_t round = 0;
+        uint8_t kind = 0;
+        uint16_t reserved = 0;
+
+        if (!read(file, event.time) || !read(file, round) || !read(file, kind) || !read(file, event.sender) || !read(file, reserved) || !read(file, event.duration)) {
+            return std::nullopt;
+        }
+
+        if (kind >= static_cast<uint8_t>(Kind::Count)) {
+            return std::nullopt;
+        }
+
+        event.round = static_cast<cs::RoundNumber>(round);
+        event.kind = static_cast<Kind>(kind);
+        result.push_back(event);
+    }
+
+    return result;
+}
+
+void cs::RoundTrace::render(const std::vector<Event>& events, std::ostream& os) {
+    std::map<cs::RoundNumber, std::vector<Event>> rounds;
+
+    for (const auto& event : events) {
+        rounds[event.round].push_back(event);
+    }
+
+    const auto flags = os.flags();
+    os << std::fixed << std::setprecision(3);
+
+    for (auto& [round, items] : rounds) {
+        std::stable_sort(items.begin(), items.end(), [](const Event& lhs, const Event& rhs) { return lhs.time < rhs.time; });
+
+        auto startIter = std::find_if(items.begin(), items.end(), [](const Event& event) { return event.kind == Kind::RoundStart; });
+        const uint64_t start = startIter != items.end() ? startIter->time : items.front().time;
+
+        os << "Round " << round << " at " << static_cast<double>(start) / 1'000'000.0 << '\n';
+
+        // the latest stage of every kind and the longest phase show what makes round slow
+        std::map<Kind, const Event*> latest;
+        const Event* longest = nullptr;
+
+        for (const auto& event : items) {
+            const double offset = event.time >= start ? toMs(event.time - start) : -toMs(start - event.time);
+
+            os << "  " << std::setw(10) << offset << " ms  " << std::left << std::setw(22) << kindName(event.kind) << std::right;
+
+            if (event.sender != kNoSender) {
+                os << " [" << static_cast<int>(event.sender) << "]";
+            }
+
+            if (event.duration != 0) {
+                os << "  " << toMs(event.duration) << " ms";
+            }
+
+            os << '\n';
+
+            if (event.sender != kNoSender) {
+                latest[event.kind] = &event;
+            }
+
+            if (event.duration != 0 && (longest == nullptr || event.duration > longest->duration)) {
+                longest = &event;
+            }
+        }
+
+        for (const auto& [kind, event] : latest) {
+            os << "  latest " << kindName(kind) << ": [" << static_cast<int>(event->sender) << "] at " << toMs(event->time - std::min(event->time, start)) << " ms\n";
+        }
+
+        if (longest != nullptr) {
+            os << "  longest " << kindName(longest->kind) << ": " << toMs(longest->duration) << " ms\n";
+        }
+    }
+
+    os.flags(flags);
+}
+
+const char* cs::RoundTrace::kindName(Kind kind) {
+    switch (kind) {
+        case Kind::RoundStart:
+            return "round start";
+        case Kind::StageOneSent:
+            return "stage-1 sent";
+        case Kind::StageTwoSent:
+            return "stage-2 sent";
+        case Kind::StageThreeSent:
+            return "stage-3 sent";
+        case Kind::StageOneReceived:
+            return "stage-1 received";
+        case Kind::StageTwoReceived:
+            return "stage-2 received";
+        case Kind::StageThreeReceived:
+            return "stage-3 received";
+        case Kind::Validation:
+            return "validation";
+        case Kind::BlockFinalize:
+            return "block finalize";
+        case Kind::BlockStore:
+            return "block store";
+        case Kind::RoundTableSent:
+            return "round table sent";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,119 @@
+#include <csnode/signaturesverifier.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <csdb/transaction.hpp>
+
+#include <lib/system/concurrent.hpp>
+
+namespace {
+// shared between caller and pool tasks, pool task may start after caller finished all chunks
+struct BatchState {
+    const cs::SignaturesVerifier::Items& items;
+    cs::Bytes& result;
+
+    const size_t chunks;
+    std::atomic<size_t> nextChunk{0};
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t completedChunks = 0;
+
+    BatchState(const cs::SignaturesVerifier::Items& it, cs::Bytes& res, size_t count)
+    : items(it)
+    , result(res)
+    , chunks(count) {
+    }
+
+    void verifyChunk(size_t chunk) {
+        const size_t begin = chunk * cs::SignaturesVerifier::ChunkSize;
+        const size_t end = std::min(begin + cs::SignaturesVerifier::ChunkSize, items.size());
+
+        for (size_t i = begin; i < end; ++i) {
+            const auto& item = items[i];
+            result[i] = cscrypto::verifySignature(item.signature, item.publicKey, item.message.data(), item.message.size()) ? 1 : 0;
+        }
+    }
+
+    void process() {
+        size_t processed = 0;
+
+        for (size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed); chunk < chunks; chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) {
+            verifyChunk(chunk);
+            ++processed;
+        }
+
+        if (processed == 0) {
+            return;
+        }
+
+        {
+            cs::Lock lock(mutex);
+            completedChunks += processed;
+        }
+
+        condition.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock lock(mutex);
+        condition.wait(lock, [this] { return completedChunks == chunks; });
+    }
+};
+}  // namespace
+
+namespace cs {
+SignaturesVerifier::SignaturesVerifier(size_t reserve) {
+    items_.reserve(reserve);
+}
+
+void SignaturesVerifier::add(const cs::Signature& signature, const cs::PublicKey& publicKey, cs::Bytes message) {
+    items_.push_back(Item{signature, publicKey, std::move(message)});
+}
+
+void SignaturesVerifier::add(const csdb::Transaction& transaction, const cs::PublicKey& publicKey) {
+    add(transaction.signature(), publicKey, transaction.to_byte_stream_for_sig());
+}
+
+cs::Bytes SignaturesVerifier::verify() const {
+    return verify(items_);
+}
+
+cs::Bytes SignaturesVerifier::verify(const Items& items, size_t workers) {
+    cs::Bytes result(items.size(), 0);
+
+    if (items.empty()) {
+        return result;
+    }
+
+    if (workers == 0) {
+        workers = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    const size_t chunks = (items.size() + ChunkSize - 1) / ChunkSize;
+    auto state = std::make_shared<BatchState>(items, result, chunks);
+
+    if (items.size() < MinParallelSize || workers == 1) {
+        state->process();
+        return result;
+    }
+
+    // caller thread works too, so pool gets one task less,
+    // and if pool is busy caller verifies all chunks by itself
+    const size_t tasks = std::min(workers, chunks) - 1;
+
+    for (size_t i = 0; i < tasks; ++i) {
+        cs::Concurrent::run([state] { state->process(); });
+    }
+
+    state->process();
+    state->wait();
+
+    return result;
+}
+}  // namespace cs
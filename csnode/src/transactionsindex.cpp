@@ -1,6 +1,8 @@
 #include <transactionsindex.hpp>
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
 #include <set>
 #include <vector>
 
@@ -15,7 +17,18 @@
 
 namespace {
 constexpr const char* kDbPath = "/indexdb";
-constexpr const char* kLastIndexedPath =  "/last_indexed";
+constexpr const char* kOrdinalsDbPath = "/ordinalsdb";
+
+// tables of ordinals db
+constexpr const char* kOrdinalsTable = "ordinals";
+constexpr const char* kWalletOrdinalsTable = "wallet_ordinals";
+constexpr const char* kStateTable = "state";
+constexpr size_t kOrdinalsTablesCount = 3;
+
+constexpr const char* kLastIndexedKey = "last_indexed";
+
+// file of previous versions, last indexed sequence was not written together with index
+constexpr const char* kLegacyLastIndexedPath = "/last_indexed";
 
 auto getTrxIndexKey(const cs::PublicKey& _pubKey, cs::Sequence _seq) {
     cs::Bytes ret(_pubKey.begin(), _pubKey.end());
@@ -25,6 +38,85 @@ auto getTrxIndexKey(const cs::PublicKey& _pubKey, cs::Sequence _seq) {
     std::copy(ptr, ptr + sizeof(_seq), ret.begin() + _pubKey.size());
     return ret;
 }
+
+// ordinals are stored in big endian, so lmdb keeps keys sorted in numeric order
+void writeBigEndian(uint64_t _value, uint8_t* _ptr) {
+    for (size_t i = sizeof(_value); i > 0; --i) {
+        _ptr[i - 1] = static_cast<uint8_t>(_value & 0xFF);
+        _value >>= 8;
+    }
+}
+
+uint64_t readBigEndian(const uint8_t* _ptr) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < sizeof(result); ++i) {
+        result = (result << 8) | _ptr[i];
+    }
+    return result;
+}
+
+cs::Bytes getOrdinalKey(uint64_t _ordinal) {
+    cs::Bytes ret(sizeof(_ordinal));
+    writeBigEndian(_ordinal, ret.data());
+    return ret;
+}
+
+cs::Bytes getWalletOrdinalKey(const cs::PublicKey& _pubKey, uint64_t _ordinal) {
+    cs::Bytes ret(_pubKey.begin(), _pubKey.end());
+    ret.resize(ret.size() + sizeof(_ordinal));
+    writeBigEndian(_ordinal, ret.data() + _pubKey.size());
+    return ret;
+}
+
+cs::Bytes getTransactionIdValue(const csdb::TransactionID& _id) {
+    cs::Bytes ret(sizeof(uint64_t) * 2);
+    writeBigEndian(_id.pool_seq(), ret.data());
+    writeBigEndian(_id.index(), ret.data() + sizeof(uint64_t));
+    return ret;
+}
+
+csdb::TransactionID readTransactionIdValue(const lmdb::val& _value) {
+    if (_value.size() != sizeof(uint64_t) * 2) {
+        return csdb::TransactionID();
+    }
+
+    auto ptr = reinterpret_cast<const uint8_t*>(_value.data());
+    return csdb::TransactionID(readBigEndian(ptr), readBigEndian(ptr + sizeof(uint64_t)));
+}
+
+// ordinal of transaction is taken from the tail of key
+uint64_t readOrdinal(const lmdb::val& _key) {
+    return readBigEndian(reinterpret_cast<const uint8_t*>(_key.data()) + _key.size() - sizeof(uint64_t));
+}
+
+using OrdinalsBatch = std::vector<std::pair<cs::Bytes, cs::Bytes>>;
+
+void putRange(lmdb::txn& _txn, const char* _table, const OrdinalsBatch& _batch) {
+    auto dbi = lmdb::dbi::open(_txn, _table);
+
+    for (const auto& [k, v] : _batch) {
+        lmdb::val key(k.data(), k.size());
+        lmdb::val value(v.data(), v.size());
+        dbi.put(_txn, key, value);
+    }
+}
+
+void removeRange(lmdb::txn& _txn, const char* _table, const std::vector<cs::Bytes>& _keys) {
+    auto dbi = lmdb::dbi::open(_txn, _table);
+
+    for (const auto& k : _keys) {
+        dbi.del(_txn, lmdb::val(k.data(), k.size()));
+    }
+}
+
+void putLastIndexed(lmdb::txn& _txn, cs::Sequence _sequence) {
+    auto dbi = lmdb::dbi::open(_txn, kStateTable);
+    auto value = getOrdinalKey(_sequence);
+
+    lmdb::val key(kLastIndexedKey, std::strlen(kLastIndexedKey));
+    lmdb::val data(value.data(), value.size());
+    dbi.put(_txn, key, data);
+}
 } // namespace
 
 namespace cs {
@@ -33,9 +125,17 @@ TransactionsIndex::TransactionsIndex(BlockChain& _bc, const std::string& _path,
     : bc_(_bc),
       rootPath_(_path),
       db_(std::make_unique<Lmdb>(_path + kDbPath)),
-      recreate_(_recreate ? true : hasToRecreate(_path + kLastIndexedPath, lastIndexedPool_)),
-      lastIndexedFile_(_path + kLastIndexedPath, sizeof(cs::Sequence)) {
+      lastIndexedPool_(kWrongSequence),
+      recreate_(_recreate),
+      ordinalsDb_(std::make_unique<Lmdb>(_path + kOrdinalsDbPath)) {
+    boost::system::error_code error;
+    boost::filesystem::remove(_path + kLegacyLastIndexedPath, error);
+
     init();
+
+    if (!readLastIndexed()) {
+        recreate_ = true;
+    }
 }
 
 void TransactionsIndex::onStartReadFromDb(Sequence _lastWrittenPoolSeq) {
@@ -59,6 +159,7 @@ void TransactionsIndex::onDbReadFinished() {
     if (recreate_) {
         recreate_ = false;
         lapoos_.clear();
+        walletOrdinals_.clear();
         cslog() << "Recreated index 0 -> " << lastIndexedPool_
                 << ". Continue to keep it actual from new blocks.";
     }
@@ -97,8 +198,8 @@ void TransactionsIndex::onRemoveBlock(const csdb::Pool& _pool) {
         lbd(t.source(), lastIndexedPool_);
         lbd(t.target(), lastIndexedPool_);
     }
-    --lastIndexedPool_;
-    updateLastIndexed();
+
+    removeOrdinals(_pool);
 
     if (updates.size()) {
         bc_.updateLastTransactions(updates);
@@ -118,6 +219,10 @@ void TransactionsIndex::close() {
     if (db_->isOpen()) {
       db_->close();
     }
+
+    if (ordinalsDb_->isOpen()) {
+        ordinalsDb_->close();
+    }
 }
 
 void TransactionsIndex::updateFromNextBlock(const csdb::Pool& _pool) {
@@ -150,7 +255,7 @@ void TransactionsIndex::updateFromNextBlock(const csdb::Pool& _pool) {
                           << _pool.sequence() << ", prev pool num is " << lapoo
                           << ". For public key: "
                           << EncodeBase58(key.public_key().data(), key.public_key().data() + key.public_key().size())
-                          << ", recreate status is " << recreate_;
+                          << ", recreate status is " << recreate_.load();
             }
         }
     };
@@ -160,8 +265,7 @@ void TransactionsIndex::updateFromNextBlock(const csdb::Pool& _pool) {
         lbd(tr.target());
     }
 
-    lastIndexedPool_ = _pool.sequence();
-    updateLastIndexed();
+    updateOrdinals(_pool);
 }
 
 void TransactionsIndex::setPrevTransBlock(const PublicKey& _pubKey, cs::Sequence _curr, cs::Sequence _prev) {
@@ -180,28 +284,193 @@ Sequence TransactionsIndex::getPrevTransBlock(const csdb::Address& _addr, Sequen
     return db_->value<Sequence>(key);
 }
 
-inline bool TransactionsIndex::hasToRecreate(const std::string& _lastIndFilePath,
-                                             cs::Sequence& _lastIndexedPool) {
-    boost::filesystem::path p(_lastIndFilePath);
-    if (!boost::filesystem::is_regular_file(p)) {
-        return true;
+uint64_t TransactionsIndex::getOrdinalsCount(const csdb::Address& _addr) const {
+    return getOrdinalsCount(bc_.getAddressByType(_addr, BlockChain::AddressType::PublicKey).public_key());
+}
+
+uint64_t TransactionsIndex::getOrdinalsCount(const PublicKey& _pubKey) const {
+    if (recreate_) {
+        auto it = walletOrdinals_.find(_pubKey);
+        return it != walletOrdinals_.end() ? it->second : 0;
     }
-    MMappedFileWrap<FileSource> f(_lastIndFilePath, sizeof(cs::Sequence), false);
-    if (!f.isOpen()) {
-        return true;
+
+    uint64_t count = 0;
+    auto key = getWalletOrdinalKey(_pubKey, std::numeric_limits<uint64_t>::max());
+
+    ordinalsDb_->iterate(reinterpret_cast<const char*>(key.data()), key.size(), false,
+                         [&_pubKey, &count](const lmdb::val& _key, const lmdb::val&) {
+        if (_key.size() == _pubKey.size() + sizeof(uint64_t) &&
+            std::equal(_pubKey.begin(), _pubKey.end(), reinterpret_cast<const uint8_t*>(_key.data()))) {
+            count = readOrdinal(_key) + 1;
+        }
+        return false;
+    }, kWalletOrdinalsTable);
+
+    return count;
+}
+
+std::vector<csdb::TransactionID> TransactionsIndex::getTransactionIds(uint64_t _before, size_t _limit) const {
+    std::vector<csdb::TransactionID> result;
+
+    if (_before == 0 || _limit == 0) {
+        return result;
+    }
+
+    result.reserve(_limit);
+    auto key = getOrdinalKey(_before - 1);
+
+    ordinalsDb_->iterate(reinterpret_cast<const char*>(key.data()), key.size(), false,
+                         [&result, _limit](const lmdb::val&, const lmdb::val& _value) {
+        result.push_back(readTransactionIdValue(_value));
+        return result.size() < _limit;
+    }, kOrdinalsTable);
+
+    return result;
+}
+
+std::vector<csdb::TransactionID> TransactionsIndex::getTransactionIds(const csdb::Address& _addr, uint64_t _before, size_t _limit) const {
+    std::vector<csdb::TransactionID> result;
+
+    if (_before == 0 || _limit == 0) {
+        return result;
     }
-    _lastIndexedPool = *(f.data<const cs::Sequence>());
-    if (_lastIndexedPool == kWrongSequence) {
+
+    result.reserve(_limit);
+
+    const auto pubKey = bc_.getAddressByType(_addr, BlockChain::AddressType::PublicKey).public_key();
+    auto key = getWalletOrdinalKey(pubKey, _before - 1);
+
+    ordinalsDb_->iterate(reinterpret_cast<const char*>(key.data()), key.size(), false,
+                         [&result, &pubKey, _limit](const lmdb::val& _key, const lmdb::val& _value) {
+        if (_key.size() != pubKey.size() + sizeof(uint64_t) ||
+            !std::equal(pubKey.begin(), pubKey.end(), reinterpret_cast<const uint8_t*>(_key.data()))) {
+            return false;
+        }
+
+        result.push_back(readTransactionIdValue(_value));
+        return result.size() < _limit;
+    }, kWalletOrdinalsTable);
+
+    return result;
+}
+
+void TransactionsIndex::updateOrdinals(const csdb::Pool& _pool) {
+    const auto& transactions = _pool.transactions();
+
+    OrdinalsBatch ordinals;
+    OrdinalsBatch walletOrdinals;
+    std::map<PublicKey, uint64_t> counts;
+
+    ordinals.reserve(transactions.size());
+    walletOrdinals.reserve(transactions.size() * 2);
+
+    uint64_t ordinal = ordinalsCount_.load(std::memory_order_relaxed);
+
+    auto addWalletOrdinal = [&](const PublicKey& _pubKey, const cs::Bytes& _value) {
+        auto it = counts.find(_pubKey);
+
+        if (it == counts.end()) {
+            it = counts.emplace(_pubKey, getOrdinalsCount(_pubKey)).first;
+        }
+
+        walletOrdinals.emplace_back(getWalletOrdinalKey(_pubKey, it->second++), _value);
+    };
+
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        auto value = getTransactionIdValue(csdb::TransactionID(_pool.sequence(), i));
+        ordinals.emplace_back(getOrdinalKey(ordinal++), value);
+
+        const auto source = bc_.getAddressByType(transactions[i].source(), BlockChain::AddressType::PublicKey).public_key();
+        const auto target = bc_.getAddressByType(transactions[i].target(), BlockChain::AddressType::PublicKey).public_key();
+
+        addWalletOrdinal(source, value);
+
+        if (target != source) {
+            addWalletOrdinal(target, value);
+        }
+    }
+
+    ordinalsDb_->update([&ordinals, &walletOrdinals, &_pool](lmdb::txn& _txn) {
+        putRange(_txn, kOrdinalsTable, ordinals);
+        putRange(_txn, kWalletOrdinalsTable, walletOrdinals);
+        putLastIndexed(_txn, _pool.sequence());
         return true;
+    });
+
+    lastIndexedPool_ = _pool.sequence();
+
+    if (recreate_) {
+        for (const auto& [key, count] : counts) {
+            walletOrdinals_[key] = count;
+        }
     }
-    return false;
+
+    ordinalsCount_.store(ordinal, std::memory_order_release);
 }
 
-inline void TransactionsIndex::updateLastIndexed() {
-    auto ptr = lastIndexedFile_.data<cs::Sequence>();
-    if (ptr) {
-        *ptr = lastIndexedPool_;
+void TransactionsIndex::removeOrdinals(const csdb::Pool& _pool) {
+    const auto& transactions = _pool.transactions();
+    std::map<PublicKey, uint64_t> counts;
+    std::vector<cs::Bytes> ordinals;
+    std::vector<cs::Bytes> walletOrdinals;
+
+    for (const auto& transaction : transactions) {
+        const auto source = bc_.getAddressByType(transaction.source(), BlockChain::AddressType::PublicKey).public_key();
+        const auto target = bc_.getAddressByType(transaction.target(), BlockChain::AddressType::PublicKey).public_key();
+
+        ++counts[source];
+
+        if (target != source) {
+            ++counts[target];
+        }
+    }
+
+    for (const auto& [key, count] : counts) {
+        const uint64_t total = getOrdinalsCount(key);
+
+        for (uint64_t ordinal = total - std::min(total, count); ordinal < total; ++ordinal) {
+            walletOrdinals.push_back(getWalletOrdinalKey(key, ordinal));
+        }
+
+        if (recreate_) {
+            walletOrdinals_[key] = total - std::min(total, count);
+        }
+    }
+
+    uint64_t total = ordinalsCount_.load(std::memory_order_relaxed);
+    const uint64_t removed = std::min<uint64_t>(total, transactions.size());
+
+    for (uint64_t ordinal = total - removed; ordinal < total; ++ordinal) {
+        ordinals.push_back(getOrdinalKey(ordinal));
+    }
+
+    ordinalsCount_.store(total - removed, std::memory_order_release);
+    --lastIndexedPool_;
+
+    ordinalsDb_->update([&ordinals, &walletOrdinals, this](lmdb::txn& _txn) {
+        removeRange(_txn, kOrdinalsTable, ordinals);
+        removeRange(_txn, kWalletOrdinalsTable, walletOrdinals);
+        putLastIndexed(_txn, lastIndexedPool_);
+        return true;
+    });
+}
+
+bool TransactionsIndex::readLastIndexed() {
+    auto value = ordinalsDb_->value<cs::Bytes>(kLastIndexedKey, std::strlen(kLastIndexedKey), kStateTable);
+
+    if (value.size() != sizeof(uint64_t)) {
+        return false;
     }
+
+    lastIndexedPool_ = readBigEndian(value.data());
+    return lastIndexedPool_ != kWrongSequence;
+}
+
+void TransactionsIndex::updateLastIndexed() {
+    ordinalsDb_->update([this](lmdb::txn& _txn) {
+        putLastIndexed(_txn, lastIndexedPool_);
+        return true;
+    });
 }
 
 void TransactionsIndex::onDbFailed(const LmdbException& e) {
@@ -210,9 +479,33 @@ void TransactionsIndex::onDbFailed(const LmdbException& e) {
 
 inline void TransactionsIndex::init() {
     Connector::connect(&db_->failed, this, &TransactionsIndex::onDbFailed);
+    Connector::connect(&ordinalsDb_->failed, this, &TransactionsIndex::onDbFailed);
 
     db_->setMapSize(cs::Lmdb::Default1GbMapSize);
     db_->open();
+
+    ordinalsDb_->setMaxDbs(kOrdinalsTablesCount);
+    ordinalsDb_->setMapSize(cs::Lmdb::Default1GbMapSize);
+    ordinalsDb_->open();
+
+    // tables are created once, so they could be opened by readers
+    ordinalsDb_->update([](lmdb::txn& _txn) {
+        for (auto table : {kOrdinalsTable, kWalletOrdinalsTable, kStateTable}) {
+            lmdb::dbi::open(_txn, table, MDB_CREATE);
+        }
+        return true;
+    });
+
+    uint64_t count = 0;
+    auto key = getOrdinalKey(std::numeric_limits<uint64_t>::max());
+
+    ordinalsDb_->iterate(reinterpret_cast<const char*>(key.data()), key.size(), false,
+                         [&count](const lmdb::val& _key, const lmdb::val&) {
+        count = readOrdinal(_key) + 1;
+        return false;
+    }, kOrdinalsTable);
+
+    ordinalsCount_.store(count, std::memory_order_release);
 }
 
 inline void TransactionsIndex::reset() {
@@ -221,5 +514,14 @@ inline void TransactionsIndex::reset() {
     db_.reset(nullptr);
     csdb::internal::path_remove(rootPath_ + kDbPath);
     db_ = std::make_unique<Lmdb>(rootPath_ + kDbPath);
+
+    Connector::disconnect(&ordinalsDb_->failed, this, &TransactionsIndex::onDbFailed);
+    ordinalsDb_->close();
+    ordinalsDb_.reset(nullptr);
+    csdb::internal::path_remove(rootPath_ + kOrdinalsDbPath);
+    ordinalsDb_ = std::make_unique<Lmdb>(rootPath_ + kOrdinalsDbPath);
+
+    walletOrdinals_.clear();
+    ordinalsCount_.store(0, std::memory_order_release);
 }
 } // namespace cs
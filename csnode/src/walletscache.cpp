@@ -2,6 +2,7 @@
 
 #include <blockchain.hpp>
 #include <csdb/amount_commission.hpp>
+#include <csnode/datastream.hpp>
 #include <csnode/walletscache.hpp>
 #include <csnode/walletsids.hpp>
 #include <lib/system/logger.hpp>
@@ -22,6 +23,102 @@ inline int32_t getRealTrustedNum(const std::vector<uint8_t>& realTrusted) {
 }
 
 const char* kLogPrefix = "WalletsCache: ";
+
+enum AddressKind : uint8_t {
+    PublicKeyAddress,
+    WalletIdAddress
+};
+
+void serializeId(cs::DataStream& stream, const csdb::TransactionID& id) {
+    stream << id.pool_seq() << id.index();
+}
+
+csdb::TransactionID deserializeId(cs::DataStream& stream) {
+    cs::Sequence sequence = cs::kWrongSequence;
+    cs::Sequence index = cs::kWrongSequence;
+    stream >> sequence >> index;
+    return csdb::TransactionID(sequence, index);
+}
+
+void serializeAddress(cs::DataStream& stream, const csdb::Address& address) {
+    if (address.is_wallet_id()) {
+        stream << uint8_t(WalletIdAddress) << address.wallet_id();
+    }
+    else {
+        stream << uint8_t(PublicKeyAddress) << address.public_key();
+    }
+}
+
+csdb::Address deserializeAddress(cs::DataStream& stream) {
+    uint8_t kind = 0;
+    stream >> kind;
+
+    if (kind == WalletIdAddress) {
+        csdb::Address::WalletId id = 0;
+        stream >> id;
+        return csdb::Address::from_wallet_id(id);
+    }
+
+    cs::PublicKey key;
+    stream >> key;
+    return csdb::Address::from_public_key(key);
+}
+
+void serializeIds(cs::DataStream& stream, const std::list<csdb::TransactionID>& ids) {
+    stream << ids.size();
+
+    for (const auto& id : ids) {
+        serializeId(stream, id);
+    }
+}
+
+std::list<csdb::TransactionID> deserializeIds(cs::DataStream& stream) {
+    std::list<csdb::TransactionID> ids;
+    size_t size = 0;
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        ids.push_back(deserializeId(stream));
+    }
+
+    return ids;
+}
+
+void serializeWallet(cs::DataStream& stream, const cs::PublicKey& key, const cs::WalletsCache::WalletData& wallet) {
+    stream << key << wallet.balance_ << wallet.delegated_ << wallet.delegats_.size();
+
+    for (const auto& [delegate, amount] : wallet.delegats_) {
+        stream << delegate << amount;
+    }
+
+    wallet.trxTail_.serialize(stream);
+    stream << wallet.transNum_;
+    serializeId(stream, wallet.lastTransaction_);
+#ifdef MONITOR_NODE
+    stream << wallet.createTime_;
+#endif
+}
+
+void serializeSmarts(cs::DataStream& stream, const std::list<csdb::TransactionID>& smartPayableTransactions,
+                     const std::map<csdb::Address, std::list<csdb::TransactionID>>& canceledSmarts) {
+    serializeIds(stream, smartPayableTransactions);
+    stream << canceledSmarts.size();
+
+    for (const auto& [address, ids] : canceledSmarts) {
+        serializeAddress(stream, address);
+        serializeIds(stream, ids);
+    }
+}
+
+#ifdef MONITOR_NODE
+void serializeTrusted(cs::DataStream& stream, const std::map<cs::PublicKey, cs::WalletsCache::TrustedData>& trustedInfo) {
+    stream << trustedInfo.size();
+
+    for (const auto& [key, info] : trustedInfo) {
+        stream << key << info.times << info.times_trusted << info.totalFee;
+    }
+}
+#endif
 }  // namespace
 
 namespace cs {
@@ -109,13 +206,9 @@ void WalletsCache::Updater::invokeReplenishPayableContract(const csdb::Transacti
             sourceWallData.balance_ -= csdb::Amount(transaction.counted_fee().to_double());
             sourceWallData.balance_ += csdb::Amount(transaction.max_fee().to_double());
         }
-#ifdef MONITOR_NODE
         emit walletUpdateEvent(toPublicKey(transaction.source()), sourceWallData);
-#endif
     }
-#ifdef MONITOR_NODE
     emit walletUpdateEvent(toPublicKey(transaction.target()), wallData);
-#endif
 }
 
 void WalletsCache::Updater::smartSourceTransactionReleased(const csdb::Transaction& smartSourceTrx,
@@ -134,10 +227,8 @@ void WalletsCache::Updater::smartSourceTransactionReleased(const csdb::Transacti
         smartWallData.balance_ -= countedFee;
         initWallData.balance_ += countedFee;
     }
-#ifdef MONITOR_NODE
     emit walletUpdateEvent(toPublicKey(smartSourceTrx.source()), smartWallData);
     emit walletUpdateEvent(toPublicKey(initTrx.source()), initWallData);
-#endif
 }
 
 void WalletsCache::Updater::rollbackExceededTimeoutContract(const csdb::Transaction& transaction,
@@ -185,17 +276,15 @@ void WalletsCache::Updater::rollbackExceededTimeoutContract(const csdb::Transact
             }
         }
     }
-#ifdef MONITOR_NODE
     emit walletUpdateEvent(toPublicKey(transaction.source()), wallData);
-#endif
 }
 
 #ifdef MONITOR_NODE
 bool WalletsCache::Updater::setWalletTime(const PublicKey& address, const uint64_t& p_timeStamp) {
-    auto it = data_.wallets_.find(address);
-    if (it != data_.wallets_.end()) {
-        it->second.createTime_ = p_timeStamp;
-        emit walletUpdateEvent(it->first, it->second);
+    if (data_.find(address) != nullptr) {
+        auto& wallet = getWalletData(address);
+        wallet.createTime_ = p_timeStamp;
+        emit walletUpdateEvent(address, wallet);
         return true;
     }
     return false;
@@ -241,9 +330,7 @@ void WalletsCache::Updater::fundConfidantsWalletsWithFee(const csdb::Amount& tot
             if (numPayedTrusted == (realTrustedNumber - 1)) {
                 feeToEachConfidant = totalFee - payedFee;
             }
-#ifdef MONITOR_NODE
             emit walletUpdateEvent(confidants[i], walletData);
-#endif
         }
     }
 }
@@ -285,9 +372,7 @@ void WalletsCache::Updater::fundConfidantsWalletsWithExecFee(const csdb::Transac
             if (numPayedTrusted == (realTrustedNumber - 1)) {
                 feeToEachConfidant = transaction.user_field(trx_uf::new_state::Fee).value<csdb::Amount>() - payedFee;
             }
-#ifdef MONITOR_NODE
             emit walletUpdateEvent(confidants[i], walletData);
-#endif
         }
     }
 }
@@ -387,9 +472,7 @@ double WalletsCache::Updater::loadTrxForSource(const csdb::Transaction& tr,
         else {
 		    --wallData_s.transNum_;
         }
-#ifdef MONITOR_NODE
         emit walletUpdateEvent(toPublicKey(tr.source()), wallData_s);
-#endif
     }
     else {
         if (!inverse) {
@@ -482,9 +565,7 @@ double WalletsCache::Updater::loadTrxForSource(const csdb::Transaction& tr,
         wallData_s.trxTail_.erase(tr.innerID());
     }
 
-#ifdef MONITOR_NODE
     emit walletUpdateEvent(toPublicKey(wallAddress), wallData);
-#endif
     return tr.counted_fee().to_double();
 }
 
@@ -564,10 +645,8 @@ void WalletsCache::Updater::checkSmartWaitingForMoney(const csdb::Transaction& i
 
             auto& wallData = getWalletData(initTransaction.target());
             wallData.balance_ -= initTransaction.amount();
-#ifdef MONITOR_NODE
             emit walletUpdateEvent(toPublicKey(initTransaction.source()), wallDataIniter);
             emit walletUpdateEvent(toPublicKey(initTransaction.target()), wallData);
-#endif
         }
     }
 
@@ -580,10 +659,8 @@ void WalletsCache::Updater::checkSmartWaitingForMoney(const csdb::Transaction& i
 
         auto& wallData = getWalletData(initTransaction.target());
         wallData.balance_ += initTransaction.amount();
-#ifdef MONITOR_NODE
         emit walletUpdateEvent(toPublicKey(initTransaction.source()), wallDataIniter);
         emit walletUpdateEvent(toPublicKey(initTransaction.target()), wallData);
-#endif
     }
 }
 
@@ -633,29 +710,134 @@ void WalletsCache::Updater::loadTrxForTarget(const csdb::Transaction& tr, bool i
         if (!inverse) ++wallData.transNum_;
         else --wallData.transNum_;
     }
-#ifdef MONITOR_NODE
     emit walletUpdateEvent(toPublicKey(tr.target()), wallData);
-#endif
 }
 
 void WalletsCache::Updater::updateLastTransactions(const std::vector<std::pair<PublicKey, csdb::TransactionID>>& updates) {
     for (const auto& u : updates) {
-        auto it = data_.wallets_.find(u.first);
-        if (it != data_.wallets_.end()) {
-            it->second.lastTransaction_ = u.second;
-#ifdef MONITOR_NODE
-            emit walletUpdateEvent(it->first, it->second);
-#endif
+        if (data_.find(u.first) != nullptr) {
+            auto& wallet = getWalletData(u.first);
+            wallet.lastTransaction_ = u.second;
+            emit walletUpdateEvent(u.first, wallet);
         }
     }
 }
 
+std::vector<PublicKey> WalletsCache::Updater::takeModified() {
+    std::vector<PublicKey> result(modified_.begin(), modified_.end());
+    modified_.clear();
+    return result;
+}
+
 void WalletsCache::iterateOverWallets(const std::function<bool(const PublicKey&, const WalletData&)> func) {
-    for (const auto& wallet : wallets_) {
-        if (!func(wallet.first, wallet.second)) {
-            break;
+    forEach(func);
+}
+
+const WalletsCache::WalletData* WalletsCache::find(const PublicKey& key) const {
+    if (auto it = wallets_.find(key); it != wallets_.end()) {
+        return &it->second;
+    }
+
+    if (frozen_) {
+        if (auto it = frozen_->find(key); it != frozen_->end()) {
+            return &it->second;
+        }
+    }
+
+    return nullptr;
+}
+
+WalletsCache::WalletData& WalletsCache::get(const PublicKey& key) {
+    if (auto it = wallets_.find(key); it != wallets_.end()) {
+        return it->second;
+    }
+
+    if (frozen_) {
+        if (auto it = frozen_->find(key); it != frozen_->end()) {
+            ++shadowed_;
+            return wallets_.emplace(key, it->second).first->second;
         }
     }
+
+    return wallets_[key];
+}
+
+bool WalletsCache::forEach(const std::function<bool(const PublicKey&, const WalletData&)>& func) const {
+    for (const auto& [key, wallet] : wallets_) {
+        if (!func(key, wallet)) {
+            return false;
+        }
+    }
+
+    if (frozen_) {
+        for (const auto& [key, wallet] : *frozen_) {
+            if (shadowed_ != 0 && wallets_.count(key) != 0) {
+                continue;
+            }
+
+            if (!func(key, wallet)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+std::shared_ptr<const WalletsCache::Frozen> WalletsCache::freeze() {
+    if (!merge(false)) {
+        return nullptr;
+    }
+
+    // nodes are moved, so references to wallets stay valid
+    frozen_ = std::make_shared<const Wallets>(std::move(wallets_));
+    frozenReleased_ = std::make_shared<std::atomic<bool>>(false);
+    wallets_.clear();
+    shadowed_ = 0;
+
+    auto frozen = std::make_shared<Frozen>();
+    frozen->wallets_ = frozen_;
+    frozen->released_ = frozenReleased_;
+    frozen->smartPayableTransactions_ = smartPayableTransactions_;
+    frozen->canceledSmarts_ = canceledSmarts_;
+#ifdef MONITOR_NODE
+    frozen->trusted_info_ = trusted_info_;
+#endif
+
+    return frozen;
+}
+
+void WalletsCache::compact() {
+    merge(false);
+}
+
+bool WalletsCache::merge(bool force) {
+    if (!frozen_) {
+        return true;
+    }
+
+    // acquire pairs with release of the holder, so its reads of frozen wallets are finished
+    const bool released = frozenReleased_->load(std::memory_order_acquire);
+
+    if (!released && !force) {
+        return false;
+    }
+
+    Wallets wallets = released ? std::move(*std::const_pointer_cast<Wallets>(frozen_)) : *frozen_;
+    frozen_.reset();
+    frozenReleased_.reset();
+
+    // changed wallets replace frozen ones by nodes, so references to them stay valid
+    while (!wallets_.empty()) {
+        auto node = wallets_.extract(wallets_.begin());
+        wallets.erase(node.key());
+        wallets.insert(std::move(node));
+    }
+
+    wallets_ = std::move(wallets);
+    shadowed_ = 0;
+
+    return true;
 }
 
 #ifdef MONITOR_NODE
@@ -667,4 +849,115 @@ void WalletsCache::iterateOverWriters(const std::function<bool(const PublicKey&,
     }
 }
 #endif
+
+void WalletsCache::serialize(DataStream& stream) const {
+    stream << static_cast<size_t>(getCount());
+
+    forEach([&stream](const PublicKey& key, const WalletData& wallet) {
+        serializeWallet(stream, key, wallet);
+        return true;
+    });
+
+    serializeSmarts(stream, smartPayableTransactions_, canceledSmarts_);
+
+#ifdef MONITOR_NODE
+    serializeTrusted(stream, trusted_info_);
+#endif
+}
+
+void WalletsCache::Frozen::serialize(DataStream& stream) const {
+    stream << wallets_->size();
+
+    for (const auto& [key, wallet] : *wallets_) {
+        serializeWallet(stream, key, wallet);
+    }
+
+    serializeSmarts(stream, smartPayableTransactions_, canceledSmarts_);
+
+#ifdef MONITOR_NODE
+    serializeTrusted(stream, trusted_info_);
+#endif
+}
+
+bool WalletsCache::deserialize(DataStream& stream) {
+    size_t size = 0;
+    stream >> size;
+
+    std::unordered_map<PublicKey, WalletData> wallets;
+    wallets.reserve(size);
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        PublicKey key;
+        stream >> key;
+
+        auto& wallet = wallets[key];
+        size_t delegatsCount = 0;
+        stream >> wallet.balance_ >> wallet.delegated_ >> delegatsCount;
+
+        for (size_t j = 0; j < delegatsCount && stream.isValid(); ++j) {
+            PublicKey delegate;
+            csdb::Amount amount;
+            stream >> delegate >> amount;
+            wallet.delegats_.emplace(delegate, amount);
+        }
+
+        wallet.trxTail_.deserialize(stream);
+        stream >> wallet.transNum_;
+        wallet.lastTransaction_ = deserializeId(stream);
+#ifdef MONITOR_NODE
+        stream >> wallet.createTime_;
+#endif
+    }
+
+    auto smartPayableTransactions = deserializeIds(stream);
+
+    decltype(canceledSmarts_) canceledSmarts;
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        auto address = deserializeAddress(stream);
+        canceledSmarts.emplace(address, deserializeIds(stream));
+    }
+
+#ifdef MONITOR_NODE
+    decltype(trusted_info_) trustedInfo;
+    stream >> size;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        PublicKey key;
+        TrustedData info;
+        stream >> key >> info.times >> info.times_trusted >> info.totalFee;
+        trustedInfo.emplace(key, info);
+    }
+#endif
+
+    if (!stream.isValid()) {
+        cserror() << kLogPrefix << "snapshot data is corrupted";
+        return false;
+    }
+
+    wallets_ = std::move(wallets);
+    frozen_.reset();
+    frozenReleased_.reset();
+    shadowed_ = 0;
+    smartPayableTransactions_ = std::move(smartPayableTransactions);
+    canceledSmarts_ = std::move(canceledSmarts);
+#ifdef MONITOR_NODE
+    trusted_info_ = std::move(trustedInfo);
+#endif
+
+    return true;
+}
+
+void WalletsCache::clear() {
+    wallets_.clear();
+    frozen_.reset();
+    frozenReleased_.reset();
+    shadowed_ = 0;
+    smartPayableTransactions_.clear();
+    canceledSmarts_.clear();
+#ifdef MONITOR_NODE
+    trusted_info_.clear();
+#endif
+}
 }  // namespace cs
@@ -1,4 +1,5 @@
 #include <csnode/walletsids.hpp>
+#include <csnode/datastream.hpp>
 #include <lib/system/logger.hpp>
 #include <lib/system/utils.hpp>
 #include <limits>
@@ -176,4 +177,67 @@ bool WalletsIds::Special::findAnyOrInsertSpecial(const WalletAddress& address, W
     return false;
 }
 
+void WalletsIds::serialize(DataStream& stream) const {
+    content().serialize(stream);
+}
+
+WalletsIds::Content WalletsIds::content() const {
+    Content result;
+    result.nextId = nextId_;
+    result.nextIdSpecial = special_->nextIdSpecial_;
+    result.wallets.reserve(data_.size());
+
+    for (const auto& wallet : data_) {
+        result.wallets.emplace_back(wallet.address.public_key(), wallet.id);
+    }
+
+    return result;
+}
+
+void WalletsIds::Content::serialize(DataStream& stream) const {
+    stream << nextId << nextIdSpecial << wallets.size();
+
+    for (const auto& [key, id] : wallets) {
+        stream << key << id;
+    }
+}
+
+bool WalletsIds::deserialize(DataStream& stream) {
+    WalletId nextId = 0;
+    WalletId nextIdSpecial = 0;
+    size_t size = 0;
+
+    stream >> nextId >> nextIdSpecial >> size;
+
+    Data data;
+
+    for (size_t i = 0; i < size && stream.isValid(); ++i) {
+        cs::PublicKey key;
+        WalletId id = 0;
+
+        stream >> key >> id;
+
+        if (!data.insert({csdb::Address::from_public_key(key), id}).second) {
+            cserror() << "WalletsIds: duplicated wallet in snapshot";
+            return false;
+        }
+    }
+
+    if (!stream.isValid()) {
+        return false;
+    }
+
+    data_ = std::move(data);
+    nextId_ = nextId;
+    special_->nextIdSpecial_ = nextIdSpecial;
+
+    return true;
+}
+
+void WalletsIds::clear() {
+    data_.clear();
+    nextId_ = 0;
+    special_->nextIdSpecial_ = Special::makeSpecial(0);
+}
+
 }  // namespace cs
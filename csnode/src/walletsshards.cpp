@@ -0,0 +1,101 @@
+#include <csnode/walletsshards.hpp>
+
+#include <mutex>
+
+namespace cs {
+bool WalletsShards::find(const PublicKey& key, WalletData& wallet) const {
+    return apply(key, [&wallet](const WalletData& data) { wallet = data; });
+}
+
+bool WalletsShards::apply(const PublicKey& key, const std::function<void(const WalletData&)>& func) const {
+    const auto& item = shard(key);
+    std::shared_lock lock(item.mutex);
+
+    auto it = item.wallets.find(key);
+
+    if (it == item.wallets.end()) {
+        return false;
+    }
+
+    func(it->second);
+    return true;
+}
+
+void WalletsShards::iterate(const std::function<bool(const PublicKey&, const WalletData&)>& func) const {
+    std::array<std::shared_lock<std::shared_mutex>, ShardsCount> locks;
+
+    for (size_t i = 0; i < ShardsCount; ++i) {
+        locks[i] = std::shared_lock(shards_[i].mutex);
+    }
+
+    for (const auto& item : shards_) {
+        for (const auto& [key, wallet] : item.wallets) {
+            if (!func(key, wallet)) {
+                return;
+            }
+        }
+    }
+}
+
+size_t WalletsShards::size() const {
+    std::array<std::shared_lock<std::shared_mutex>, ShardsCount> locks;
+    size_t result = 0;
+
+    for (size_t i = 0; i < ShardsCount; ++i) {
+        locks[i] = std::shared_lock(shards_[i].mutex);
+        result += shards_[i].wallets.size();
+    }
+
+    return result;
+}
+
+void WalletsShards::publish(Wallets&& wallets) {
+    std::array<std::vector<size_t>, ShardsCount> indexes;
+
+    for (size_t i = 0; i < wallets.size(); ++i) {
+        indexes[shardIndex(wallets[i].first)].push_back(i);
+    }
+
+    // all touched shards are locked before the first move, so readers see the whole block or nothing of it
+    std::array<std::unique_lock<std::shared_mutex>, ShardsCount> locks;
+
+    for (size_t i = 0; i < ShardsCount; ++i) {
+        if (!indexes[i].empty()) {
+            locks[i] = std::unique_lock(shards_[i].mutex);
+        }
+    }
+
+    for (size_t i = 0; i < ShardsCount; ++i) {
+        auto& item = shards_[i];
+
+        for (auto index : indexes[i]) {
+            auto& [key, wallet] = wallets[index];
+            item.wallets[key] = std::move(wallet);
+        }
+    }
+}
+
+void WalletsShards::reset(WalletsCache& cache) {
+    std::array<std::unordered_map<PublicKey, WalletData>, ShardsCount> content;
+
+    cache.iterateOverWallets([&content](const PublicKey& key, const WalletData& wallet) {
+        content[shardIndex(key)].emplace(key, wallet);
+        return true;
+    });
+
+    std::array<std::unique_lock<std::shared_mutex>, ShardsCount> locks;
+
+    for (size_t i = 0; i < ShardsCount; ++i) {
+        locks[i] = std::unique_lock(shards_[i].mutex);
+    }
+
+    for (size_t i = 0; i < ShardsCount; ++i) {
+        shards_[i].wallets.swap(content[i]);
+    }
+}
+
+size_t WalletsShards::shardIndex(const PublicKey& key) {
+    // std::hash of public key takes leading bytes, shard is selected by the last one to not correlate with buckets
+    return key.back() % ShardsCount;
+}
+}  // namespace cs
@@ -0,0 +1,204 @@
+#include <csnode/walletssnapshot.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include <csnode/datastream.hpp>
+
+#include <lib/system/logger.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+const char* kLogPrefix = "WalletsSnapshot: ";
+const char* kPrefix = "wallets_";
+const char* kExtension = ".snapshot";
+const char* kTemporaryExtension = ".tmp";
+
+constexpr uint32_t kMagic = 0x53574353;  // CSWS
+constexpr uint32_t kVersion = 1;
+
+// header is limited to protect from reading of garbage size
+constexpr uint64_t kMaxHeaderSize = 1024;
+}  // namespace
+
+namespace cs {
+WalletsSnapshot::WalletsSnapshot(const std::string& path)
+: path_(path) {
+    boost::system::error_code code;
+
+    if (!fs::is_directory(path_, code)) {
+        fs::create_directories(path_, code);
+    }
+
+    // remove leftovers of interrupted saving
+    for (fs::directory_iterator it(path_, code), end; !code && it != end; it.increment(code)) {
+        if (it->path().extension() == kTemporaryExtension) {
+            fs::remove(it->path(), code);
+        }
+    }
+}
+
+bool WalletsSnapshot::save(cs::Sequence sequence, const csdb::PoolHash& hash, const cs::Bytes& data) {
+    std::lock_guard lock(mutex_);
+
+    cs::Bytes header;
+    cs::DataStream stream(header);
+
+    const auto checksum = cscrypto::calculateHash(data.data(), data.size());
+    stream << kMagic << kVersion << sequence << hash << checksum << static_cast<uint64_t>(data.size());
+
+    const std::string name = fileName(sequence);
+    const std::string temporaryName = name + kTemporaryExtension;
+
+    {
+        std::ofstream file(temporaryName, std::ios::binary | std::ios::trunc);
+
+        if (!file) {
+            cserror() << kLogPrefix << "can not create " << temporaryName;
+            return false;
+        }
+
+        const uint64_t headerSize = header.size();
+        file.write(reinterpret_cast<const char*>(&headerSize), sizeof(headerSize));
+        file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        file.flush();
+
+        if (!file) {
+            cserror() << kLogPrefix << "failed to write " << temporaryName;
+            file.close();
+            boost::system::error_code code;
+            fs::remove(temporaryName, code);
+            return false;
+        }
+    }
+
+    boost::system::error_code code;
+    fs::rename(temporaryName, name, code);
+
+    if (code) {
+        cserror() << kLogPrefix << "failed to rename " << temporaryName << ": " << code.message();
+        fs::remove(temporaryName, code);
+        return false;
+    }
+
+    removeOutdated();
+
+    csdebug() << kLogPrefix << "snapshot of block #" << WithDelimiters(sequence) << " is saved, " << WithDelimiters(data.size()) << " bytes";
+    return true;
+}
+
+bool WalletsSnapshot::load(const AcceptFunc& accept, cs::Sequence& sequence, cs::Bytes& data) const {
+    std::lock_guard lock(mutex_);
+
+    for (auto seq : sequences()) {
+        std::ifstream file(fileName(seq), std::ios::binary);
+        Header header;
+
+        if (!file || !readHeader(file, header) || header.sequence != seq) {
+            cswarning() << kLogPrefix << "snapshot of block #" << WithDelimiters(seq) << " is damaged, skip it";
+            continue;
+        }
+
+        if (!accept(header.sequence, header.hash)) {
+            csdebug() << kLogPrefix << "snapshot of block #" << WithDelimiters(seq) << " does not fit to blockchain, skip it";
+            continue;
+        }
+
+        cs::Bytes bytes(header.size);
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+        if (!file || cscrypto::calculateHash(bytes.data(), bytes.size()) != header.checksum) {
+            cswarning() << kLogPrefix << "snapshot of block #" << WithDelimiters(seq) << " has wrong checksum, skip it";
+            continue;
+        }
+
+        sequence = header.sequence;
+        data = std::move(bytes);
+        return true;
+    }
+
+    return false;
+}
+
+void WalletsSnapshot::removeAfter(cs::Sequence sequence) {
+    std::lock_guard lock(mutex_);
+
+    for (auto seq : sequences()) {
+        if (seq <= sequence) {
+            break;
+        }
+
+        boost::system::error_code code;
+        fs::remove(fileName(seq), code);
+        csdebug() << kLogPrefix << "snapshot of block #" << WithDelimiters(seq) << " is removed";
+    }
+}
+
+std::string WalletsSnapshot::fileName(cs::Sequence sequence) const {
+    return (fs::path(path_) / (kPrefix + std::to_string(sequence) + kExtension)).string();
+}
+
+std::vector<cs::Sequence> WalletsSnapshot::sequences() const {
+    std::vector<cs::Sequence> result;
+    boost::system::error_code code;
+
+    for (fs::directory_iterator it(path_, code), end; !code && it != end; it.increment(code)) {
+        const auto& path = it->path();
+
+        if (path.extension() != kExtension) {
+            continue;
+        }
+
+        const std::string stem = path.stem().string();
+
+        if (stem.compare(0, std::strlen(kPrefix), kPrefix) != 0) {
+            continue;
+        }
+
+        try {
+            result.push_back(std::stoull(stem.substr(std::strlen(kPrefix))));
+        }
+        catch (const std::exception&) {
+            continue;
+        }
+    }
+
+    std::sort(result.begin(), result.end(), std::greater<cs::Sequence>());
+    return result;
+}
+
+bool WalletsSnapshot::readHeader(std::istream& stream, Header& header) const {
+    uint64_t headerSize = 0;
+    stream.read(reinterpret_cast<char*>(&headerSize), sizeof(headerSize));
+
+    if (!stream || headerSize > kMaxHeaderSize) {
+        return false;
+    }
+
+    cs::Bytes bytes(headerSize);
+    stream.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    if (!stream) {
+        return false;
+    }
+
+    cs::DataStream headerStream(bytes.data(), bytes.size());
+    headerStream >> header.magic >> header.version >> header.sequence >> header.hash >> header.checksum >> header.size;
+
+    return headerStream.isValid() && header.magic == kMagic && header.version == kVersion;
+}
+
+void WalletsSnapshot::removeOutdated() {
+    const auto existing = sequences();
+
+    for (size_t i = KeepCount; i < existing.size(); ++i) {
+        boost::system::error_code code;
+        fs::remove(fileName(existing[i]), code);
+    }
+}
+}  // namespace cs
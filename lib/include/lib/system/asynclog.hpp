@@ -0,0 +1,323 @@
+#ifndef ASYNCLOG_HPP
+#define ASYNCLOG_HPP
+
+#include <boost/log/core/record.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/log/utility/setup/settings.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Asynchronous backend of cs* logging macros.
+ *
+ * The calling thread only opens Boost.Log record (so filters and attributes work as before) and captures message
+ * arguments to its own buffer, formatting and sinks I/O are done by the flusher thread.
+ *
+ * Configuration ini example:
+ * [Async]
+ * Enabled=true
+ * BufferSize=1024
+ * Overflow=block
+ * RateLimit=0
+ */
+
+namespace logger {
+enum class OverflowPolicy : uint8_t {
+    // drops records which do not fit thread buffer
+    Drop,
+
+    // waits for the flusher
+    Block
+};
+
+struct AsyncSettings {
+    bool enabled = true;
+
+    // records of one thread waiting for the flusher
+    size_t bufferSize = 1024;
+    OverflowPolicy overflow = OverflowPolicy::Block;
+
+    // records per second of one call site, 0 means no limit
+    size_t rateLimit = 0;
+
+    std::chrono::milliseconds flushInterval{10};
+
+    static AsyncSettings read(const boost::log::settings& settings);
+};
+
+namespace detail {
+template <typename T>
+constexpr bool isStateManipulator() {
+    return std::is_same_v<T, decltype(std::setfill('0'))> || std::is_same_v<T, decltype(std::setprecision(0))> ||
+           std::is_same_v<T, decltype(std::setbase(0))>;
+}
+
+// values which can be safely copied and printed by the flusher
+template <typename T>
+constexpr bool isDeferred() {
+    if constexpr (std::is_pointer_v<T>) {
+        // pointed objects may be gone, but manipulators and addresses are fine
+        return std::is_function_v<std::remove_pointer_t<T>> || std::is_void_v<std::remove_pointer_t<T>>;
+    }
+    else {
+        return std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_same_v<T, decltype(std::setw(0))> || isStateManipulator<T>();
+    }
+}
+
+// captured argument of log message
+class Argument {
+public:
+    enum : size_t {
+        InlineSize = 16
+    };
+
+    template <typename T>
+    static Argument value(const T& value) {
+        static_assert(sizeof(T) <= InlineSize && std::is_trivially_copyable_v<T>, "Argument is not deferred");
+
+        Argument argument;
+        new (argument.storage_) T(value);
+        argument.print_ = [](std::ostream& os, const Argument& arg) { os << *std::launder(reinterpret_cast<const T*>(arg.storage_)); };
+
+        return argument;
+    }
+
+    static Argument text(std::string_view text) {
+        Argument argument;
+        argument.text_.assign(text.data(), text.size());
+        argument.print_ = [](std::ostream& os, const Argument& arg) { os << arg.text_; };
+
+        return argument;
+    }
+
+    void print(std::ostream& os) const {
+        print_(os, *this);
+    }
+
+private:
+    using Print = void (*)(std::ostream&, const Argument&);
+
+    Print print_ = nullptr;
+    alignas(std::max_align_t) unsigned char storage_[InlineSize] = {};
+    std::string text_;
+};
+
+struct Entry {
+    boost::log::record record;
+    std::vector<Argument> arguments;
+    uint64_t sequence = 0;
+    uint32_t suppressed = 0;
+};
+
+// single producer single consumer ring of one thread records
+class ThreadBuffer {
+public:
+    explicit ThreadBuffer(size_t capacity);
+
+    // producer side
+    Entry* reserve();
+    void publish();
+
+    // consumer side
+    size_t available() const;
+    Entry& front(size_t offset);
+    void release();
+
+    void retire();
+    bool isRetired() const;
+
+private:
+    std::vector<Entry> entries_;
+    const uint64_t mask_;
+
+    alignas(64) std::atomic<uint64_t> head_ = {0};
+    alignas(64) std::atomic<uint64_t> tail_ = {0};
+    std::atomic<bool> retired_ = {false};
+};
+}  // namespace detail
+
+class AsyncLog {
+public:
+    struct Metrics {
+        uint64_t records = 0;
+        uint64_t dropped = 0;
+        uint64_t suppressed = 0;
+        uint64_t blocked = 0;
+    };
+
+    static AsyncLog& instance();
+
+    AsyncLog() = default;
+    ~AsyncLog();
+
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    // starts the flusher if settings enable it, otherwise records are written by calling threads
+    void start(const AsyncSettings& settings);
+
+    // writes all captured records and stops the flusher
+    void stop();
+
+    // waits until records captured before the call are written to sinks
+    void flush();
+
+    bool isRunning() const;
+    Metrics metrics() const;
+
+    // rate limiter, returns false if record should be suppressed,
+    // suppressed gets count of previously suppressed records of the call site
+    bool admit(const char* file, int line, uint32_t& suppressed);
+
+    // returns entry of calling thread buffer or nullptr if record should be written at once
+    detail::Entry* acquire(bool& dropped);
+
+    // publishes entry acquired by calling thread
+    void publish();
+
+    // formats message of record and passes it to sinks
+    static void write(boost::log::record& record, const std::vector<detail::Argument>& arguments, uint32_t suppressed);
+
+private:
+    struct Site {
+        std::atomic<int64_t> window = {0};
+        std::atomic<uint32_t> count = {0};
+        std::atomic<uint32_t> suppressed = {0};
+    };
+
+    enum : size_t {
+        SitesCount = 4096
+    };
+
+    void flusherRoutine();
+    size_t drain();
+    void wake();
+
+    detail::ThreadBuffer& threadBuffer();
+
+    std::atomic<bool> running_ = {false};
+    std::atomic<size_t> active_ = {0};
+    std::thread flusher_;
+
+    std::atomic<size_t> bufferSize_ = {AsyncSettings().bufferSize};
+    std::atomic<OverflowPolicy> overflow_ = {AsyncSettings().overflow};
+    std::atomic<size_t> rateLimit_ = {0};
+    std::chrono::milliseconds flushInterval_ = AsyncSettings().flushInterval;
+
+    std::mutex buffersMutex_;
+    std::vector<std::shared_ptr<detail::ThreadBuffer>> buffers_;
+    std::atomic<uint64_t> generation_ = {1};
+
+    std::mutex wakeMutex_;
+    std::condition_variable wakeVariable_;
+    std::condition_variable flushedVariable_;
+    std::atomic<bool> sleeping_ = {false};
+
+    std::atomic<uint64_t> sequence_ = {0};
+    std::atomic<uint64_t> published_ = {0};
+    std::atomic<uint64_t> written_ = {0};
+
+    std::atomic<uint64_t> records_ = {0};
+    std::atomic<uint64_t> dropped_ = {0};
+    std::atomic<uint64_t> suppressed_ = {0};
+    std::atomic<uint64_t> blocked_ = {0};
+
+    std::array<Site, SitesCount> sites_;
+
+    struct Item {
+        uint64_t sequence;
+        detail::ThreadBuffer* buffer;
+        detail::Entry* entry;
+    };
+
+    // used by flusher only
+    std::vector<Item> batch_;
+};
+
+///
+/// Log record of one macro call, arguments streamed to it are captured and formatted later by the flusher.
+/// Usage: for (Record record(...); record; record.commit()) record << ...;
+///
+class Record {
+public:
+    template <typename Logger>
+    Record(Logger& logger, boost::log::trivial::severity_level level, const char* file, int line)
+    : record_(logger.open_record(boost::log::keywords::severity = level))
+    , level_(level) {
+        if (record_) {
+            open(file, line);
+        }
+    }
+
+    ~Record();
+
+    Record(const Record&) = delete;
+    Record& operator=(const Record&) = delete;
+
+    explicit operator bool() const {
+        return arguments_ != nullptr;
+    }
+
+    void commit();
+
+    template <typename T>
+    Record& operator<<(const T& value) {
+        if constexpr (detail::isDeferred<T>()) {
+            arguments_->push_back(detail::Argument::value(value));
+
+            if constexpr (detail::isStateManipulator<T>()) {
+                format() << value;
+            }
+        }
+        else if constexpr (std::is_convertible_v<const T&, const char*>) {
+            const char* text = value;
+            arguments_->push_back(detail::Argument::text(text ? std::string_view(text) : std::string_view("(null)")));
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            arguments_->push_back(detail::Argument::text(value));
+        }
+        else {
+            // formatted at once by the stream which keeps flags of previous manipulators
+            auto& stream = format();
+            stream.str(std::string());
+            stream << value;
+            arguments_->push_back(detail::Argument::text(stream.str()));
+        }
+
+        return *this;
+    }
+
+    Record& operator<<(std::ostream& (*manipulator)(std::ostream&));
+    Record& operator<<(std::ios_base& (*manipulator)(std::ios_base&));
+
+private:
+    void open(const char* file, int line);
+    std::ostringstream& format();
+
+    boost::log::record record_;
+    boost::log::trivial::severity_level level_;
+
+    detail::Entry* entry_ = nullptr;
+    std::vector<detail::Argument>* arguments_ = nullptr;
+    std::vector<detail::Argument> local_;
+    std::ostringstream* format_ = nullptr;
+    uint32_t suppressed_ = 0;
+};
+}  // namespace logger
+
+#endif  // ASYNCLOG_HPP
@@ -2,12 +2,12 @@
 #define CONCURRENT_HPP
 
 #include <assert.h>
+#include <atomic>
 #include <condition_variable>
 #include <functional>
-#include <future>
-#include <list>
 #include <memory>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <unordered_set>
 
@@ -16,9 +16,7 @@
 #include <lib/system/logger.hpp>
 #include <lib/system/signals.hpp>
 #include <lib/system/structures.hpp>
-
-#include <boost/asio/post.hpp>
-#include <boost/asio/thread_pool.hpp>
+#include <lib/system/taskruntime.hpp>
 
 namespace cs {
 enum class RunPolicy : cs::Byte {
@@ -37,21 +35,6 @@ enum class WatcherState : cs::Byte {
     Compeleted
 };
 
-// aliasing
-using Threads = boost::asio::thread_pool;
-
-// returns instance of boost thread pool
-class ThreadPool {
-public:
-    ThreadPool() = delete;
-    ~ThreadPool() = default;
-
-    static Threads& instance() noexcept {
-        static Threads threadPool(std::thread::hardware_concurrency());
-        return threadPool;
-    }
-};
-
 template <typename T>
 class FutureWatcher;
 class Concurrent;
@@ -70,11 +53,11 @@ private:
     }
 
     template <typename Func>
-    static void execute(Func&& function) {
-        auto& threadPool = ThreadPool::instance();
-        boost::asio::post(threadPool, std::forward<Func>(function));
+    static void execute(Func&& function, TaskPriority priority = TaskPriority::Normal) {
+        TaskRuntime::instance().submit(std::forward<Func>(function), priority);
     }
 
+    // dedicated thread for long living loops, they should not occupy runtime workers
     template <typename Func>
     static void run(Func&& function) {
         try {
@@ -94,10 +77,6 @@ private:
     friend class Concurrent;
 };
 
-// future entity
-template <typename T>
-using Future = std::future<T>;
-
 template <typename Result>
 class FutureBase : public std::enable_shared_from_this<FutureBase<Result>> {
     friend class Concurrent;
@@ -106,41 +85,22 @@ public:
     using Id = uint64_t;
 
 protected:
-    FutureBase() {
-        ++producedId;
-
-        id_ = producedId;
-        state_ = WatcherState::Idle;
+    FutureBase()
+    : state_(WatcherState::Idle)
+    , id_(++producedId) {
         policy_ = RunPolicy::ThreadPolicy;
     }
 
-    FutureBase(FutureBase&) = delete;
-    ~FutureBase() = default;
-
-    explicit FutureBase(const RunPolicy policy, Future<Result>&& future)
+    explicit FutureBase(const RunPolicy policy)
     : FutureBase() {
-        future_ = std::move(future);
         policy_ = policy;
+        state_ = WatcherState::Running;
     }
 
-    FutureBase(FutureBase&& watcher) noexcept
-    : future_(std::move(watcher.future_))
-    , policy_(watcher.policy_)
-    , state_(watcher.state_)
-    , id_(watcher.id_) {
-    }
-
-    FutureBase& operator=(FutureBase&& watcher) noexcept {
-        if (state_ == WatcherState::Running) {
-            cserror() << csname() << "Trying to use operator= in watcher running state";
-        }
-
-        future_ = std::move(watcher.future_);
-        policy_ = watcher.policy_;
-        id_ = watcher.id_;
-
-        return *this;
-    }
+    // watcher is referenced by its running task, so it is never moved
+    FutureBase(const FutureBase&) = delete;
+    FutureBase& operator=(const FutureBase&) = delete;
+    ~FutureBase() = default;
 
 public:
     // returns current watcher state, if watcher never watched runnable entity
@@ -156,16 +116,14 @@ public:
 protected:
     using CompletedSignal = cs::Signal<void(Id)>;
 
-    Future<Result> future_;
     RunPolicy policy_;
-    WatcherState state_ = WatcherState::Idle;
+    std::atomic<WatcherState> state_;
     Id id_;
 
-    inline static Id producedId = 0;
+    inline static std::atomic<Id> producedId = 0;
     constexpr static std::chrono::milliseconds kAwaiterTime{10};
 
     void setCompletedState() {
-        future_ = Future<Result>();
         state_ = WatcherState::Compeleted;
 
         emit completed(id_);
@@ -191,57 +149,45 @@ protected signals:
     CompletedSignal completed;
 };
 
-// object to get future result from concurrent
+// object to get result from concurrent
 // and generate signal when finished
 template <typename Result>
 class FutureWatcher : public FutureBase<Result> {
+    friend class Concurrent;
+
 public:
     using FinishSignal = cs::Signal<void(const Result&)>;
     using FailedSignal = cs::Signal<void()>;
 
-    explicit FutureWatcher(RunPolicy policy, Future<Result>&& future)
-    : FutureBase<Result>(policy, std::move(future)) {
-        watch();
+    explicit FutureWatcher(RunPolicy policy)
+    : FutureBase<Result>(policy) {
     }
 
     FutureWatcher() = default;
     ~FutureWatcher() = default;
-    FutureWatcher(FutureWatcher&&) = default;
-
-    FutureWatcher& operator=(FutureWatcher&& watcher) {
-        FutureBase<Result>::operator=(std::move(watcher));
-
-        watch();
-        return *this;
-    }
 
 protected:
     using Super = FutureBase<Result>;
 
-    void watch() {
-        auto closure = [=] {
-            try {
-                Result result = Super::future_.get();
-
-                auto lambda = [this, res = std::move(result)]() {
-                    Super::await(finished);
-                    emit finished(std::move(res));
-
-                    Super::setCompletedState();
-                };
+    // called by runtime task, signal call keeps watcher alive until it is emitted
+    template <typename Func>
+    void execute(Func&& func) {
+        try {
+            auto signal = [this, self = Super::shared_from_this(), result = func()] {
+                Super::await(finished);
+                emit finished(result);
 
-                Super::callSignal(std::bind(std::move(lambda)));
-            }
-            catch (std::exception& e) {
-                Super::await(failed);
+                Super::setCompletedState();
+            };
 
-                cserror() << "Concurrent execution with " << typeid(Result).name() << " failed, " << e.what();
-                emit failed();
-            }
-        };
+            Super::callSignal(std::move(signal));
+        }
+        catch (std::exception& e) {
+            Super::await(failed);
 
-        Super::state_ = WatcherState::Running;
-        Worker::run(std::move(closure));
+            cserror() << "Concurrent execution with " << typeid(Result).name() << " failed, " << e.what();
+            emit failed();
+        }
     }
 
 public signals:
@@ -251,53 +197,42 @@ public signals:
 
 template <>
 class FutureWatcher<void> : public FutureBase<void> {
+    friend class Concurrent;
+
 public:
     using FinishSignal = cs::Signal<void()>;
     using FailedSignal = cs::Signal<void()>;
 
-    explicit FutureWatcher(RunPolicy policy, Future<void>&& future)
-    : FutureBase<void>(policy, std::move(future)) {
-        watch();
+    explicit FutureWatcher(RunPolicy policy)
+    : FutureBase<void>(policy) {
     }
 
     FutureWatcher() = default;
     ~FutureWatcher() = default;
-    FutureWatcher(FutureWatcher&& watcher) = default;
-
-    FutureWatcher& operator=(FutureWatcher&& watcher) noexcept {
-        FutureBase<void>::operator=(std::move(watcher));
-
-        watch();
-        return *this;
-    }
 
 protected:
     using Super = FutureBase<void>;
 
-    void watch() {
-        auto closure = [=] {
-            try {
-                Super::future_.get();
-
-                auto signal = [=] {
-                    Super::await(finished);
-                    emit finished();
+    template <typename Func>
+    void execute(Func&& func) {
+        try {
+            func();
 
-                    Super::setCompletedState();
-                };
+            auto signal = [this, self = Super::shared_from_this()] {
+                Super::await(finished);
+                emit finished();
 
-                Super::callSignal(std::move(signal));
-            }
-            catch (std::exception& e) {
-                Super::await(failed);
+                Super::setCompletedState();
+            };
 
-                cserror() << "Concurrent execution with void result failed, " << e.what();
-                emit failed();
-            }
-        };
+            Super::callSignal(std::move(signal));
+        }
+        catch (std::exception& e) {
+            Super::await(failed);
 
-        Super::state_ = WatcherState::Running;
-        Worker::run(std::move(closure));
+            cserror() << "Concurrent execution with void result failed, " << e.what();
+            emit failed();
+        }
     }
 
 public signals:
@@ -310,56 +245,39 @@ template <typename T>
 using FutureWatcherPtr = std::shared_ptr<FutureWatcher<T>>;
 
 class Concurrent {
-    template<typename T>
-    using Executions = std::list<T>;
-
 public:
-    // runs function in another thread, returns future watcher
+    // runs function at task runtime, returns future watcher
     // than generates finished signal by run policy
-    // you should not store watcher, it does by run method, just use finished/failed signal to subscribe
+    // you should not store watcher, running task does it, just use finished/failed signal to subscribe;
+    // function must not block, see runBlocking
     template <typename Func, typename... Args>
     static FutureWatcherPtr<std::invoke_result_t<std::decay_t<Func>, std::decay_t<Args>...>> run(RunPolicy policy, Func&& function, Args&&... args) {
-        using ReturnType = std::invoke_result_t<std::decay_t<Func>, std::decay_t<Args>...>;
-        using WatcherType = FutureWatcher<ReturnType>;
-
-        // running executions
-        static Executions<FutureWatcherPtr<ReturnType>> executions;
-        using ExecutionsIterator = typename decltype(executions)::iterator;
-
-        // run async and store it at executions
-        auto watcher = std::make_shared<WatcherType>(policy, std::async(std::launch::async, std::forward<Func>(function), std::forward<Args>(args)...));
-
-        {
-            cs::Lock lock(executionsMutex_);
-            executions.push_back(watcher);
-        }
-
-        // watcher will be removed after lambda called
-        cs::Connector::connect(&watcher->completed, [storage = watcher->shared_from_this()](typename FutureWatcher<ReturnType>::Id id) {
-            ExecutionsIterator iter;
-
-            {
-                cs::Lock lock(executionsMutex_);
-                iter = std::find_if(executions.begin(), executions.end(), [=](const auto& watcher) {
-                    return (watcher->id() == id) && (watcher->state() == WatcherState::Compeleted);
-                });
-            }
-
-            if (iter != executions.end()) {
-                cs::Lock lock(executionsMutex_);
-                executions.erase(iter);
-            }
-        });
+        auto [watcher, task] = watch(policy, std::forward<Func>(function), std::forward<Args>(args)...);
+        Worker::execute(std::move(task));
+        return watcher;
+    }
 
+    // the same as run, but function is called at dedicated thread,
+    // it is for functions which block, like executor calls, to not occupy runtime workers
+    template <typename Func, typename... Args>
+    static FutureWatcherPtr<std::invoke_result_t<std::decay_t<Func>, std::decay_t<Args>...>> runBlocking(RunPolicy policy, Func&& function, Args&&... args) {
+        auto [watcher, task] = watch(policy, std::forward<Func>(function), std::forward<Args>(args)...);
+        Worker::run(std::move(task));
         return watcher;
     }
 
-    // runs function entity in thread pool
+    // runs function entity at task runtime
     template <typename Func>
     static void run(Func&& function) {
         Worker::execute(std::forward<Func>(function));
     }
 
+    // runs function entity at task runtime with priority
+    template <typename Func>
+    static void run(Func&& function, cs::TaskPriority priority) {
+        Worker::execute(std::forward<Func>(function), priority);
+    }
+
     // runs function entity by concurrent policy
     template <typename Func>
     static void run(Func&& function, cs::ConcurrentPolicy policy) {
@@ -371,16 +289,19 @@ public:
         }
     }
 
-    // runs non-binded function in thread pool
+    // runs non-binded function at task runtime
     template <typename Func, typename... Args>
     static void run(Func&& func, Args&&... args) {
         Concurrent::run(std::bind(std::forward<Func>(func), std::forward<Args>(args)...));
     }
 
-    // calls std::function after ms time in another thread
+    // calls std::function after ms time by run policy, time is waited by runtime timer
     static void runAfter(const std::chrono::milliseconds& ms, cs::RunPolicy policy, std::function<void()> callBack) {
         auto timePoint = std::chrono::steady_clock::now() + ms;
-        Worker::run(std::bind(&Concurrent::runAfterHelper, timePoint, policy, std::move(callBack)));
+
+        TaskRuntime::instance().submitAt(timePoint, [policy, callBack = std::move(callBack)]() mutable {
+            Worker::execute(policy, std::move(callBack));
+        });
     }
 
     template <typename Func>
@@ -388,13 +309,29 @@ public:
         Worker::execute(policy, std::forward<Func>(function));
     }
 
-private:
-    static void runAfterHelper(const std::chrono::steady_clock::time_point& timePoint, cs::RunPolicy policy, std::function<void()> callBack) {
-        std::this_thread::sleep_until(timePoint);
-        Worker::execute(policy, std::move(callBack));
+    // queue depth, steals and executed tasks of runtime
+    static TaskRuntime::Metrics metrics() {
+        return TaskRuntime::instance().metrics();
     }
 
-    inline static std::mutex executionsMutex_;
+private:
+    // returns watcher and task which calls function and delivers its result to watcher
+    template <typename Func, typename... Args>
+    static auto watch(RunPolicy policy, Func&& function, Args&&... args) {
+        using ReturnType = std::invoke_result_t<std::decay_t<Func>, std::decay_t<Args>...>;
+        using WatcherType = FutureWatcher<ReturnType>;
+
+        auto watcher = std::make_shared<WatcherType>(policy);
+
+        auto task = [watcher, function = std::forward<Func>(function),
+                     arguments = std::tuple<std::decay_t<Args>...>(std::forward<Args>(args)...)]() mutable {
+            watcher->execute([&] {
+                return std::apply(std::move(function), std::move(arguments));
+            });
+        };
+
+        return std::make_pair(std::move(watcher), std::move(task));
+    }
 };
 
 template <typename T>
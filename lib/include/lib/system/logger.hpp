@@ -10,6 +10,8 @@
 
 #include <sstream>
 
+#include <lib/system/asynclog.hpp>
+
 /*
  * \brief Just a syntax shugar over Boost::Log v2.
  * So you can use all the power of boost \link https://www.boost.org/doc/libs/1_67_0/libs/log/doc/html/index.html
@@ -25,6 +27,8 @@
  * Configuration ini example:
  * [Core]
  * Filter="%Severity% >= info"
+ *
+ * Messages are formatted and written to sinks by background flusher, see asynclog.hpp for [Async] settings.
  */
 
 namespace logging = boost::log;
@@ -56,17 +60,15 @@ BOOST_LOG_INLINE_GLOBAL_LOGGER_CTOR_ARGS(File, logging::sources::severity_channe
 BOOST_LOG_INLINE_GLOBAL_LOGGER_CTOR_ARGS(EventLogger, logging::sources::severity_channel_logger_mt<logging::trivial::severity_level>, (logging::keywords::channel = "Event"))
 }  // namespace logger
 
-#define LOG_SEV(level, ...)               \
-    if (!logger::useLogger<__VA_ARGS__>()) \
-        ;                                  \
-    else                                   \
-        BOOST_LOG_SEV(logger::getLogger<__VA_ARGS__>(), logger::severity_level::level)
-
-#define cstrace(...)                       \
-    if (!logger::useLogger<__VA_ARGS__>()) \
-        ;                                  \
-    else                                   \
-        BOOST_LOG_SEV(logger::getLogger<__VA_ARGS__>(), logger::severity_level::trace) << __FILE__ << ":" << __func__ << ":" << __LINE__ << " "
+#define LOG_SEV(level, ...)                                                                                                    \
+    if (!logger::useLogger<__VA_ARGS__>())                                                                                     \
+        ;                                                                                                                      \
+    else                                                                                                                       \
+        for (logger::Record csLogRecord(logger::getLogger<__VA_ARGS__>(), logger::severity_level::level, __FILE__, __LINE__); \
+             csLogRecord; csLogRecord.commit())                                                                               \
+            csLogRecord
+
+#define cstrace(...) LOG_SEV(trace, __VA_ARGS__) << __FILE__ << ":" << __func__ << ":" << __LINE__ << " "
 
 // set Filter="%Severity% >= trace" in config to view this level messages:
 #define csdetails(...) LOG_SEV(trace, __VA_ARGS__)
@@ -3,6 +3,7 @@
 #define QUEUES_HPP
 #include <atomic>
 #include <cstdint>
+#include <memory>
 #include <thread>
 
 #include "cache.hpp"
@@ -99,4 +100,156 @@ private:
     __cacheline_aligned std::atomic<Element*> writingBarrier_ = {elements};
 };
 
+/* SPSCRing is a fixed capacity ring of preallocated elements for one writer and
+   one reader. Elements are used in place: writer fills back() and calls push(),
+   reader uses front() and calls pop(). Elements are not destroyed on pop, so
+   resources kept by them may be reused by writer */
+template <typename T, std::size_t Capacity>
+class SPSCRing {
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SPSCRing()
+    : elements_(new T[Capacity]) {
+    }
+
+    SPSCRing(const SPSCRing&) = delete;
+    SPSCRing& operator=(const SPSCRing&) = delete;
+
+    // returns nullptr if ring is full, offset allows writer to fill several elements
+    // before pushing them, element at offset becomes back() after offset pushes
+    T* back(std::size_t offset = 0) {
+        const auto head = head_.load(std::memory_order_relaxed) + offset;
+
+        if (head - tail_.load(std::memory_order_acquire) >= Capacity) {
+            return nullptr;
+        }
+
+        return &elements_[head & kMask];
+    }
+
+    void push() {
+        head_.fetch_add(1, std::memory_order_release);
+    }
+
+    // returns nullptr if ring is empty
+    T* front() {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        return &elements_[tail & kMask];
+    }
+
+    void pop() {
+        tail_.fetch_add(1, std::memory_order_release);
+    }
+
+    std::size_t size() const {
+        const auto tail = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_acquire) - tail;
+    }
+
+    static constexpr std::size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1;
+
+    std::unique_ptr<T[]> elements_;
+
+    __cacheline_aligned std::atomic<std::size_t> head_ = {0};
+    __cacheline_aligned std::atomic<std::size_t> tail_ = {0};
+};
+
+/* MPSCRing is a fixed capacity ring of preallocated elements for many writers and
+   one reader. Writer claims a slot and fills it in tryPush(), slot becomes visible
+   to reader only when it is filled. Reader uses front() in place and calls pop() */
+template <typename T, std::size_t Capacity>
+class MPSCRing {
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    struct Slot {
+        __cacheline_aligned std::atomic<std::size_t> sequence;
+        T element;
+    };
+
+public:
+    MPSCRing()
+    : slots_(new Slot[Capacity]) {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCRing(const MPSCRing&) = delete;
+    MPSCRing& operator=(const MPSCRing&) = delete;
+
+    // fill is called as fill(T&) for claimed slot, returns false if ring is full
+    template <typename Func>
+    bool tryPush(Func&& fill) {
+        auto pos = head_.load(std::memory_order_relaxed);
+
+        while (true) {
+            Slot& slot = slots_[pos & kMask];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(slot.element);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // returns nullptr if ring is empty or the next slot is not filled yet
+    T* front() {
+        Slot& slot = slots_[tail_ & kMask];
+
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            return nullptr;
+        }
+
+        return &slot.element;
+    }
+
+    void pop() {
+        slots_[tail_ & kMask].sequence.store(tail_ + Capacity, std::memory_order_release);
+        ++tail_;
+        popped_.store(tail_, std::memory_order_release);
+    }
+
+    std::size_t size() const {
+        const auto popped = popped_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_acquire) - popped;
+    }
+
+    static constexpr std::size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1;
+
+    std::unique_ptr<Slot[]> slots_;
+
+    __cacheline_aligned std::atomic<std::size_t> head_ = {0};
+
+    // tail_ is owned by reader, popped_ publishes it for size()
+    __cacheline_aligned std::size_t tail_ = 0;
+    std::atomic<std::size_t> popped_ = {0};
+};
+
 #endif  // QUEUES_HPP
@@ -1,10 +1,20 @@
 /* Send blaming letters to @yrtimd */
 #ifndef STRUCTURES_HPP
 #define STRUCTURES_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include "allocators.hpp"
 #include "cache.hpp"
@@ -281,6 +291,13 @@ public:
         return newComer.data;
     }
 
+    // unlike tryStore() does not add the key
+    ArgType* find(const KeyType& key) {
+        Element** myBucket;
+        auto foundElement = getElt(key, &myBucket);
+        return foundElement ? &foundElement->data : nullptr;
+    }
+
     auto begin() {
         return buffer_.begin();
     }
@@ -324,11 +341,23 @@ private:
     Element** buckets_;
 };
 
+// Bounded MPSC queue of calls for the single consumer thread, calls are run in FIFO order.
+// Callables up to CallSize bytes are constructed in preallocated cells, so a typical insert does not allocate.
+// If ring is full calls go to overflow list, the following calls go there too until consumer drains it to keep the order.
 class CallsQueue {
 public:
-    struct Call {
-        __cacheline_aligned std::atomic<Call*> next;
-        std::function<void()> func;
+    enum : size_t {
+        DefaultCapacity = 4096,
+        CallSize = 96,
+        MaxProducers = 64
+    };
+
+    // calls inserted by one producer thread, producers above MaxProducers share the last record,
+    // record of exited thread is kept until another thread reuses it, then its counts go to the shared one
+    struct ProducerStats {
+        std::thread::id thread;
+        uint64_t calls = 0;
+        uint64_t overflows = 0;
     };
 
     static CallsQueue& instance() {
@@ -336,54 +365,376 @@ public:
         return inst;
     }
 
-    // Called from a single thread
+    explicit CallsQueue(size_t capacity = DefaultCapacity);
+    ~CallsQueue();
+
+    CallsQueue(const CallsQueue&) = delete;
+    CallsQueue& operator=(const CallsQueue&) = delete;
+
+    // Called from a single thread, runs calls inserted before the call
     inline void callAll();
-    inline void insert(std::function<void()>);
+
+    template <typename Func>
+    void insert(Func&& func);
+
+    // approximate count of waiting calls
+    size_t size() const;
+
+    std::vector<ProducerStats> producers() const;
 
 private:
-    CallsQueue() {
+    struct Operations {
+        void (*invoke)(void*);
+        void (*destroy)(void*);
+    };
+
+    template <typename Func>
+    struct InlineOperations {
+        static void invoke(void* storage) {
+            (*static_cast<Func*>(storage))();
+        }
+
+        static void destroy(void* storage) {
+            static_cast<Func*>(storage)->~Func();
+        }
+
+        constexpr static Operations operations{&invoke, &destroy};
+    };
+
+    // storage keeps pointer to allocated callable
+    template <typename Func>
+    struct HeapOperations {
+        static void invoke(void* storage) {
+            (**static_cast<Func**>(storage))();
+        }
+
+        static void destroy(void* storage) {
+            delete *static_cast<Func**>(storage);
+        }
+
+        constexpr static Operations operations{&invoke, &destroy};
+    };
+
+    struct Call {
+        const Operations* operations = nullptr;
+        alignas(std::max_align_t) unsigned char storage[CallSize];
+
+        template <bool Inlined, typename Func>
+        void construct(Func&& func) {
+            using Type = std::decay_t<Func>;
+
+            if constexpr (Inlined) {
+                new (storage) Type(std::forward<Func>(func));
+                operations = &InlineOperations<Type>::operations;
+            }
+            else {
+                *reinterpret_cast<Type**>(storage) = new Type(std::forward<Func>(func));
+                operations = &HeapOperations<Type>::operations;
+            }
+        }
+
+        // destroys callable even if it throws
+        void run() {
+            struct Guard {
+                Call* call;
+
+                ~Guard() {
+                    call->operations->destroy(call->storage);
+                    call->operations = nullptr;
+                }
+            } guard{this};
+
+            operations->invoke(storage);
+        }
+    };
+
+    struct Cell {
+        __cacheline_aligned std::atomic<size_t> sequence;
+        Call call;
+    };
+
+    struct Producer {
+        std::atomic<bool> registered = {false};
+        // claimed by living thread
+        std::atomic<bool> active = {false};
+        std::atomic<std::thread::id> thread = {std::thread::id()};
+        std::atomic<uint64_t> calls = {0};
+        std::atomic<uint64_t> overflows = {0};
+    };
+
+    using Producers = std::array<Producer, MaxProducers>;
+
+    // record of current thread, released when thread exits or inserts to another queue,
+    // records are shared with slots to survive the queue
+    struct ProducerSlot {
+        std::weak_ptr<Producers> producers;
+        Producer* producer = nullptr;
+        uint64_t owner = 0;
+
+        ~ProducerSlot() {
+            release();
+        }
+
+        void release() {
+            if (auto records = producers.lock(); records && producer != &records->back()) {
+                producer->active.store(false, std::memory_order_release);
+            }
+
+            producers.reset();
+            producer = nullptr;
+            owner = 0;
+        }
+    };
+
+    template <typename Func>
+    constexpr static bool fitsCell() {
+        using Type = std::decay_t<Func>;
+        return sizeof(Type) <= CallSize && alignof(Type) <= alignof(std::max_align_t) && std::is_nothrow_destructible_v<Type>;
     }
-    __cacheline_aligned std::atomic<Call*> head_ = {nullptr};
+
+    Producer& producer();
+
+    // runs published calls of ring up to position, returns false if some call is not published yet
+    inline bool runRing(size_t end);
+    inline void runOverflow();
+
+    inline static std::atomic<uint64_t> producedId_ = {0};
+    const uint64_t id_ = ++producedId_;
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    __cacheline_aligned std::atomic<size_t> enqueuePosition_ = {0};
+
+    // written by consumer only
+    __cacheline_aligned std::atomic<size_t> dequeuePosition_ = {0};
+
+    // calls of full ring in insertion order, every call is allocated
+    __cacheline_aligned std::atomic<bool> overflowed_ = {false};
+    mutable std::mutex overflowMutex_;
+    std::vector<Call> overflow_;
+    std::vector<Call> overflowCalls_;
+
+    std::shared_ptr<Producers> producers_ = std::make_shared<Producers>();
 };
 
+inline CallsQueue::CallsQueue(size_t capacity)
+: mask_([capacity] {
+    size_t size = 2;
+
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    return size - 1;
+}())
+, cells_(new Cell[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+inline CallsQueue::~CallsQueue() {
+    for (size_t i = 0; i <= mask_; ++i) {
+        if (cells_[i].call.operations) {
+            cells_[i].call.operations->destroy(cells_[i].call.storage);
+        }
+    }
+
+    for (auto& call : overflow_) {
+        call.operations->destroy(call.storage);
+    }
+}
+
 inline void CallsQueue::callAll() {
-    Call* startHead = head_.load(std::memory_order_relaxed);
+    if (!runRing(enqueuePosition_.load(std::memory_order_acquire))) {
+        return;
+    }
 
-    if (!startHead) {
+    if (!overflowed_.load(std::memory_order_acquire)) {
         return;
     }
 
-    Call* newHead = startHead;
-    head_.compare_exchange_strong(newHead, nullptr, std::memory_order_relaxed, std::memory_order_relaxed);
-    Call* elt = startHead;
+    // calls of ring inserted before overflow go first, overflow waits for next time if any of them is not published
+    if (runRing(enqueuePosition_.load(std::memory_order_acquire))) {
+        runOverflow();
+    }
+}
+
+inline bool CallsQueue::runRing(size_t end) {
+    size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+
+    while (position != end) {
+        Cell& cell = cells_[position & mask_];
+
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+            // position is taken by producer, but call is not constructed yet
+            return false;
+        }
+
+        dequeuePosition_.store(position + 1, std::memory_order_relaxed);
+
+        struct Release {
+            Cell& cell;
+            size_t sequence;
+
+            ~Release() {
+                cell.sequence.store(sequence, std::memory_order_release);
+            }
+        } release{cell, position + mask_ + 1};
+
+        cell.call.run();
+        ++position;
+    }
+
+    return true;
+}
+
+inline void CallsQueue::runOverflow() {
+    {
+        std::lock_guard lock(overflowMutex_);
+        overflowCalls_.swap(overflow_);
+        overflowed_.store(false, std::memory_order_release);
+    }
+
+    size_t index = 0;
+
+    try {
+        for (; index < overflowCalls_.size(); ++index) {
+            overflowCalls_[index].run();
+        }
+    }
+    catch (...) {
+        for (++index; index < overflowCalls_.size(); ++index) {
+            overflowCalls_[index].operations->destroy(overflowCalls_[index].storage);
+        }
+
+        overflowCalls_.clear();
+        throw;
+    }
 
-    do {
-        elt->func();
-        Call* rem = elt;
-        elt = rem->next.load(std::memory_order_relaxed);
-        delete rem;
-    } while (elt);
+    overflowCalls_.clear();
+}
 
-    if (newHead != startHead) {
-        do {
-            Call* next = newHead->next.load(std::memory_order_relaxed);
-            if (next == startHead)
+template <typename Func>
+void CallsQueue::insert(Func&& func) {
+    Producer& stats = producer();
+    stats.calls.fetch_add(1, std::memory_order_relaxed);
+
+    if (!overflowed_.load(std::memory_order_acquire)) {
+        size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+
+        while (true) {
+            Cell& cell = cells_[position & mask_];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+            if (difference == 0) {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    try {
+                        cell.call.construct<fitsCell<Func>()>(std::forward<Func>(func));
+                    }
+                    catch (...) {
+                        // taken position must be published anyway, consumer waits for it
+                        cell.call.construct<true>([] {});
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        throw;
+                    }
+
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return;
+                }
+            }
+            else if (difference < 0) {
+                // ring is full
                 break;
-            newHead = next;
-        } while (true);
+            }
+            else {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    stats.overflows.fetch_add(1, std::memory_order_relaxed);
+
+    Call call;
+    call.construct<false>(std::forward<Func>(func));
+
+    std::lock_guard lock(overflowMutex_);
+    overflow_.push_back(call);
+    overflowed_.store(true, std::memory_order_release);
+}
+
+inline size_t CallsQueue::size() const {
+    const size_t dequeued = dequeuePosition_.load(std::memory_order_relaxed);
+    const size_t enqueued = enqueuePosition_.load(std::memory_order_relaxed);
+    size_t result = enqueued - std::min(enqueued, dequeued);
+
+    if (overflowed_.load(std::memory_order_relaxed)) {
+        std::lock_guard lock(overflowMutex_);
+        result += overflow_.size();
+    }
+
+    return result;
+}
+
+inline CallsQueue::Producer& CallsQueue::producer() {
+    thread_local ProducerSlot slot;
+
+    if (slot.owner == id_) {
+        return *slot.producer;
+    }
+
+    slot.release();
+
+    Producers& records = *producers_;
+    Producer& shared = records.back();
+    Producer* result = &shared;
+
+    for (size_t i = 0; i < MaxProducers - 1; ++i) {
+        bool active = false;
+
+        if (records[i].active.compare_exchange_strong(active, true, std::memory_order_acquire)) {
+            result = &records[i];
+            break;
+        }
+    }
+
+    if (result == &shared) {
+        // shared record of other threads has empty id
+        shared.registered.store(true, std::memory_order_release);
+    }
+    else {
+        if (result->registered.load(std::memory_order_acquire)) {
+            // record of exited thread, its counts are kept by the shared one
+            shared.calls.fetch_add(result->calls.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            shared.overflows.fetch_add(result->overflows.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            shared.registered.store(true, std::memory_order_release);
+        }
 
-        newHead->next.store(nullptr, std::memory_order_relaxed);
+        result->thread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        result->registered.store(true, std::memory_order_release);
     }
+
+    slot.producers = producers_;
+    slot.producer = result;
+    slot.owner = id_;
+
+    return *result;
 }
 
-inline void CallsQueue::insert(std::function<void()> f) {
-    Call* newElt = new Call;
-    newElt->func = f;
+inline std::vector<CallsQueue::ProducerStats> CallsQueue::producers() const {
+    std::vector<ProducerStats> result;
+
+    for (const auto& item : *producers_) {
+        if (!item.registered.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        result.push_back(ProducerStats{item.thread.load(std::memory_order_relaxed), item.calls.load(std::memory_order_relaxed), item.overflows.load(std::memory_order_relaxed)});
+    }
 
-    Call* head = head_.load(std::memory_order_relaxed);
-    do {
-        newElt->next.store(head, std::memory_order_relaxed);
-    } while (!head_.compare_exchange_weak(head, newElt, std::memory_order_acquire, std::memory_order_relaxed));
+    return result;
 }
 
 template <size_t Length>
@@ -0,0 +1,158 @@
+#ifndef TASKRUNTIME_HPP
+#define TASKRUNTIME_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <lib/system/common.hpp>
+#include <lib/system/timerwheel.hpp>
+
+namespace cs {
+enum class TaskPriority : cs::Byte {
+    High,
+    Normal,
+    Low
+};
+
+// move only type erased callable, unlike std::function it accepts move only lambdas
+class Task {
+public:
+    Task() = default;
+
+    template <typename Func, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, Task>>>
+    Task(Func&& func)
+    : callable_(std::make_unique<Callable<std::decay_t<Func>>>(std::forward<Func>(func))) {
+    }
+
+    Task(Task&&) noexcept = default;
+    Task& operator=(Task&&) noexcept = default;
+
+    explicit operator bool() const noexcept {
+        return static_cast<bool>(callable_);
+    }
+
+    void operator()() {
+        callable_->call();
+    }
+
+private:
+    struct Base {
+        virtual ~Base() = default;
+        virtual void call() = 0;
+    };
+
+    template <typename Func>
+    struct Callable : Base {
+        template <typename F>
+        explicit Callable(F&& f)
+        : func(std::forward<F>(f)) {
+        }
+
+        void call() override {
+            func();
+        }
+
+        Func func;
+    };
+
+    std::unique_ptr<Base> callable_;
+};
+
+///
+/// Work stealing task runtime, every worker thread owns deques of tasks per priority.
+/// Tasks submitted by worker are pushed to its own deque and taken back in LIFO order,
+/// idle workers steal the oldest tasks from others, tasks of other threads are placed to shared queue.
+/// Delayed tasks wait in timer wheel of separate timer thread.
+/// Workers are shared by timers, signatures verification and message lanes, so tasks must not block:
+/// executor calls, blocking I/O and waits run on dedicated threads (Concurrent::runBlocking, ConcurrentPolicy::Thread).
+///
+class TaskRuntime {
+public:
+    struct Metrics {
+        size_t workers = 0;
+
+        // tasks waiting for worker
+        size_t queued = 0;
+
+        // tasks waiting for their time
+        size_t delayed = 0;
+
+        uint64_t executed = 0;
+        uint64_t steals = 0;
+    };
+
+    explicit TaskRuntime(size_t workers = std::thread::hardware_concurrency());
+    ~TaskRuntime();
+
+    TaskRuntime(const TaskRuntime&) = delete;
+    TaskRuntime& operator=(const TaskRuntime&) = delete;
+
+    static TaskRuntime& instance();
+
+    void submit(Task task, TaskPriority priority = TaskPriority::Normal);
+    void submitAt(std::chrono::steady_clock::time_point timePoint, Task task, TaskPriority priority = TaskPriority::High);
+
+    // true if called from worker of this runtime
+    bool isWorkerThread() const;
+
+    size_t workersCount() const;
+    Metrics metrics() const;
+
+private:
+    constexpr static size_t kPriorities = 3;
+
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::array<std::deque<Task>, kPriorities> tasks;
+        std::atomic<size_t> size = {0};
+    };
+
+    struct Delayed {
+        Task task;
+        TaskPriority priority = TaskPriority::High;
+    };
+
+    void workerRoutine(size_t index);
+    void timerRoutine();
+
+    Task findTask(size_t index);
+    Task popLocal(size_t index, size_t priority);
+    Task popShared(size_t priority);
+    Task steal(size_t index, size_t priority);
+
+    void execute(Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    Queue shared_;
+
+    std::vector<std::thread> workers_;
+    std::atomic<bool> stop_ = {false};
+
+    // all not taken tasks
+    std::atomic<size_t> pending_ = {0};
+    std::atomic<size_t> sleeping_ = {0};
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCondition_;
+
+    std::atomic<uint64_t> executed_ = {0};
+    std::atomic<uint64_t> steals_ = {0};
+
+    TimerWheel<Delayed, uint64_t> delayed_;
+    uint64_t delayedId_ = 0;
+    std::atomic<size_t> delayedSize_ = {0};
+    std::mutex timerMutex_;
+    std::condition_variable timerCondition_;
+    std::thread timer_;
+};
+}  // namespace cs
+
+#endif  // TASKRUNTIME_HPP
@@ -0,0 +1,546 @@
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace cs {
+// Hierarchical timing wheel with millisecond ticks. The first level covers 256 ticks, every next
+// level has 64 slots of the whole previous level, entries are moved to lower levels when their slot is reached.
+// Insert and remove by key are O(1), entries live in a pool and are indexed by open addressing table,
+// so no memory is allocated after containers are grown.
+template <typename T, typename Key = uintptr_t>
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Expired {
+        Key key;
+        T value;
+    };
+
+    explicit TimerWheel(Clock::time_point start = Clock::now())
+    : start_(start) {
+        clear();
+    }
+
+    // returns false if key is already scheduled
+    bool insert(Key key, Clock::time_point time, T value) {
+        if (find(key) != kNil) {
+            return false;
+        }
+
+        const uint32_t index = allocate();
+        Node& node = nodes_[index];
+        node.key = key;
+        node.tick = ceilTick(time);
+        node.value = std::move(value);
+
+        if (node.tick <= current_) {
+            link(index, kDueSlot);
+        }
+        else {
+            place(index);
+        }
+
+        addIndex(index);
+        ++size_;
+
+        return true;
+    }
+
+    bool remove(Key key) {
+        const uint32_t position = findPosition(key);
+
+        if (position == kNil) {
+            return false;
+        }
+
+        const uint32_t index = keys_[position];
+        keys_[position] = kDeleted;
+        ++deleted_;
+
+        unlink(index);
+        release(index);
+        --size_;
+
+        return true;
+    }
+
+    bool contains(Key key) const {
+        return find(key) != kNil;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    void clear() {
+        nodes_.clear();
+        free_ = kNil;
+        size_ = 0;
+        deleted_ = 0;
+
+        heads_.fill(kNil);
+        tails_.fill(kNil);
+        occupied_.fill(0);
+
+        keys_.assign(std::max<size_t>(keys_.size(), kMinIndexSize), kEmpty);
+    }
+
+    // the earliest time when expire() may return something, entries of higher levels are checked
+    // at the time of their move to lower level
+    std::optional<Clock::time_point> nextExpiry() const {
+        if (size_ == 0) {
+            return std::nullopt;
+        }
+
+        if (heads_[kDueSlot] != kNil) {
+            return timeOf(current_);
+        }
+
+        uint64_t result = std::numeric_limits<uint64_t>::max();
+
+        const uint64_t blockStart = current_ & ~uint64_t(kFirstMask);
+        const uint32_t position = static_cast<uint32_t>(current_ & kFirstMask);
+
+        if (uint32_t slot = findOccupied(position + 1, kFirstSlots); slot != kNil) {
+            result = blockStart + slot;
+        }
+        else if (uint32_t slot = findOccupied(0, position + 1); slot != kNil) {
+            result = blockStart + kFirstSlots + slot;
+        }
+
+        result = std::min(result, upperLevelsTick());
+
+        return timeOf(result);
+    }
+
+    // moves entries expired up to time to out in order of expiration, out is not cleared
+    void expire(Clock::time_point time, std::vector<Expired>& out) {
+        collect(kDueSlot, out);
+
+        const uint64_t target = floorTick(time);
+
+        if (size_ == 0) {
+            current_ = std::max(current_, target);
+            return;
+        }
+
+        while (current_ < target) {
+            const uint64_t blockEnd = (current_ | kFirstMask) + 1;
+            const uint32_t slot = findOccupied(static_cast<uint32_t>(current_ & kFirstMask) + 1, kFirstSlots);
+
+            uint64_t next = blockEnd;
+
+            if (slot != kNil) {
+                next = (current_ & ~uint64_t(kFirstMask)) + slot;
+            }
+            else if (isFirstLevelEmpty()) {
+                // blocks with empty slots are skipped up to the next move down
+                next = std::max(blockEnd, upperLevelsTick());
+            }
+
+            current_ = std::min(next, target);
+
+            if ((current_ & kFirstMask) == 0) {
+                cascade();
+            }
+
+            collect(static_cast<uint32_t>(current_ & kFirstMask), out);
+
+            if (size_ == 0) {
+                current_ = target;
+            }
+        }
+    }
+
+private:
+    constexpr static uint32_t kNil = std::numeric_limits<uint32_t>::max();
+    constexpr static uint32_t kEmpty = kNil;
+    constexpr static uint32_t kDeleted = kNil - 1;
+    constexpr static size_t kMinIndexSize = 64;
+
+    constexpr static uint32_t kFirstBits = 8;
+    constexpr static uint32_t kFirstSlots = 1u << kFirstBits;
+    constexpr static uint64_t kFirstMask = kFirstSlots - 1;
+    constexpr static uint32_t kLevelBits = 6;
+    constexpr static uint32_t kLevelSlots = 1u << kLevelBits;
+    constexpr static uint64_t kLevelMask = kLevelSlots - 1;
+    constexpr static uint32_t kLevels = 5;
+
+    // the longest delay kept without moving to the top level again, about 49 days
+    constexpr static uint64_t kMaxDelta = uint64_t(1) << (kFirstBits + kLevelBits * (kLevels - 1));
+
+    constexpr static uint32_t kFirstWords = kFirstSlots / 64;
+    constexpr static uint32_t kSlots = kFirstSlots + kLevelSlots * (kLevels - 1);
+
+    // entries scheduled at passed time
+    constexpr static uint32_t kDueSlot = kSlots;
+
+    struct Node {
+        Key key{};
+        uint64_t tick = 0;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t slot = kNil;
+        T value{};
+    };
+
+    static uint32_t levelShift(uint32_t level) {
+        return kFirstBits + kLevelBits * (level - 1);
+    }
+
+    static uint32_t countTrailingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<uint32_t>(__builtin_ctzll(value));
+#else
+        uint32_t count = 0;
+
+        while ((value & 1) == 0) {
+            value >>= 1;
+            ++count;
+        }
+
+        return count;
+#endif
+    }
+
+    static uint64_t mix(Key key) {
+        uint64_t value = static_cast<uint64_t>(key);
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    uint64_t ceilTick(Clock::time_point time) const {
+        if (time <= start_) {
+            return 0;
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(time - start_).count();
+        return static_cast<uint64_t>((elapsed + 999'999) / 1'000'000);
+    }
+
+    uint64_t floorTick(Clock::time_point time) const {
+        if (time <= start_) {
+            return 0;
+        }
+
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(time - start_).count());
+    }
+
+    Clock::time_point timeOf(uint64_t tick) const {
+        return start_ + std::chrono::milliseconds(tick);
+    }
+
+    // the earliest tick when entries of upper levels are moved down
+    uint64_t upperLevelsTick() const {
+        uint64_t result = std::numeric_limits<uint64_t>::max();
+
+        for (uint32_t level = 1; level < kLevels; ++level) {
+            const uint64_t bits = occupied_[kFirstWords + level - 1];
+
+            if (bits == 0) {
+                continue;
+            }
+
+            // slot of the current block is already moved down
+            const uint32_t shift = levelShift(level);
+            const uint64_t block = (current_ >> shift) + 1;
+            const uint32_t rotation = static_cast<uint32_t>(block & kLevelMask);
+            const uint64_t rotated = rotation == 0 ? bits : (bits >> rotation) | (bits << (kLevelSlots - rotation));
+
+            result = std::min(result, (block + countTrailingZeros(rotated)) << shift);
+        }
+
+        return result;
+    }
+
+    bool isFirstLevelEmpty() const {
+        for (uint32_t word = 0; word < kFirstWords; ++word) {
+            if (occupied_[word] != 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // the first occupied slot of the first level in [from, to)
+    uint32_t findOccupied(uint32_t from, uint32_t to) const {
+        while (from < to) {
+            const uint32_t word = from / 64;
+            uint64_t bits = occupied_[word] >> (from % 64);
+
+            if (bits != 0) {
+                const uint32_t slot = from + countTrailingZeros(bits);
+                return slot < to ? slot : kNil;
+            }
+
+            from = (word + 1) * 64;
+        }
+
+        return kNil;
+    }
+
+    void place(uint32_t index) {
+        const uint64_t tick = nodes_[index].tick;
+
+        if (tick < current_) {
+            link(index, kDueSlot);
+            return;
+        }
+
+        const uint64_t delta = tick - current_;
+
+        if (delta < kFirstSlots) {
+            link(index, static_cast<uint32_t>(tick & kFirstMask));
+            return;
+        }
+
+        for (uint32_t level = 1; level < kLevels; ++level) {
+            if (delta < (uint64_t(1) << levelShift(level + 1))) {
+                link(index, kFirstSlots + (level - 1) * kLevelSlots + static_cast<uint32_t>((tick >> levelShift(level)) & kLevelMask));
+                return;
+            }
+        }
+
+        // too far, placed at the longest delay and moved to the top level again when reached
+        const uint64_t limit = current_ + kMaxDelta - 1;
+        link(index, kFirstSlots + (kLevels - 2) * kLevelSlots + static_cast<uint32_t>((limit >> levelShift(kLevels - 1)) & kLevelMask));
+    }
+
+    // moves entries of upper levels reached by current tick down
+    void cascade() {
+        uint32_t top = 1;
+
+        while (top + 1 < kLevels && (current_ & ((uint64_t(1) << levelShift(top + 1)) - 1)) == 0) {
+            ++top;
+        }
+
+        for (uint32_t level = top; level >= 1; --level) {
+            const uint32_t slot = kFirstSlots + (level - 1) * kLevelSlots + static_cast<uint32_t>((current_ >> levelShift(level)) & kLevelMask);
+            uint32_t index = heads_[slot];
+
+            clearSlot(slot);
+
+            while (index != kNil) {
+                const uint32_t next = nodes_[index].next;
+                place(index);
+                index = next;
+            }
+        }
+    }
+
+    void collect(uint32_t slot, std::vector<Expired>& out) {
+        uint32_t index = heads_[slot];
+
+        if (index == kNil) {
+            return;
+        }
+
+        clearSlot(slot);
+
+        while (index != kNil) {
+            Node& node = nodes_[index];
+            const uint32_t next = node.next;
+
+            out.push_back(Expired{node.key, std::move(node.value)});
+
+            removeIndex(node.key);
+            release(index);
+            --size_;
+
+            index = next;
+        }
+    }
+
+    void link(uint32_t index, uint32_t slot) {
+        Node& node = nodes_[index];
+        node.slot = slot;
+        node.next = kNil;
+        node.prev = tails_[slot];
+
+        if (tails_[slot] != kNil) {
+            nodes_[tails_[slot]].next = index;
+        }
+        else {
+            heads_[slot] = index;
+            setOccupied(slot, true);
+        }
+
+        tails_[slot] = index;
+    }
+
+    void unlink(uint32_t index) {
+        Node& node = nodes_[index];
+
+        if (node.prev != kNil) {
+            nodes_[node.prev].next = node.next;
+        }
+        else {
+            heads_[node.slot] = node.next;
+        }
+
+        if (node.next != kNil) {
+            nodes_[node.next].prev = node.prev;
+        }
+        else {
+            tails_[node.slot] = node.prev;
+        }
+
+        if (heads_[node.slot] == kNil) {
+            setOccupied(node.slot, false);
+        }
+    }
+
+    void clearSlot(uint32_t slot) {
+        heads_[slot] = kNil;
+        tails_[slot] = kNil;
+        setOccupied(slot, false);
+    }
+
+    void setOccupied(uint32_t slot, bool value) {
+        if (slot == kDueSlot) {
+            return;
+        }
+
+        // one word for every upper level
+        const uint32_t word = slot < kFirstSlots ? slot / 64 : kFirstWords + (slot - kFirstSlots) / kLevelSlots;
+        const uint64_t bit = uint64_t(1) << (slot < kFirstSlots ? slot % 64 : (slot - kFirstSlots) % kLevelSlots);
+
+        if (value) {
+            occupied_[word] |= bit;
+        }
+        else {
+            occupied_[word] &= ~bit;
+        }
+    }
+
+    uint32_t allocate() {
+        if (free_ != kNil) {
+            const uint32_t index = free_;
+            free_ = nodes_[index].next;
+            return index;
+        }
+
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    void release(uint32_t index) {
+        Node& node = nodes_[index];
+        node.value = T{};
+        node.slot = kNil;
+        node.prev = kNil;
+        node.next = free_;
+        free_ = index;
+    }
+
+    uint32_t findPosition(Key key) const {
+        const size_t mask = keys_.size() - 1;
+
+        for (size_t position = mix(key) & mask;; position = (position + 1) & mask) {
+            const uint32_t index = keys_[position];
+
+            if (index == kEmpty) {
+                return kNil;
+            }
+
+            if (index != kDeleted && nodes_[index].key == key) {
+                return static_cast<uint32_t>(position);
+            }
+        }
+    }
+
+    uint32_t find(Key key) const {
+        const uint32_t position = findPosition(key);
+        return position == kNil ? kNil : keys_[position];
+    }
+
+    void addIndex(uint32_t index) {
+        if ((size_ + deleted_ + 1) * 2 > keys_.size()) {
+            rehash();
+        }
+
+        const size_t mask = keys_.size() - 1;
+        size_t position = mix(nodes_[index].key) & mask;
+
+        while (keys_[position] != kEmpty && keys_[position] != kDeleted) {
+            position = (position + 1) & mask;
+        }
+
+        if (keys_[position] == kDeleted) {
+            --deleted_;
+        }
+
+        keys_[position] = index;
+    }
+
+    void removeIndex(Key key) {
+        const uint32_t position = findPosition(key);
+
+        if (position != kNil) {
+            keys_[position] = kDeleted;
+            ++deleted_;
+        }
+    }
+
+    void rehash() {
+        size_t capacity = kMinIndexSize;
+
+        while (capacity < (size_ + 1) * 4) {
+            capacity *= 2;
+        }
+
+        std::vector<uint32_t> keys(capacity, kEmpty);
+        const size_t mask = capacity - 1;
+
+        for (uint32_t index : keys_) {
+            if (index == kEmpty || index == kDeleted) {
+                continue;
+            }
+
+            size_t position = mix(nodes_[index].key) & mask;
+
+            while (keys[position] != kEmpty) {
+                position = (position + 1) & mask;
+            }
+
+            keys[position] = index;
+        }
+
+        keys_ = std::move(keys);
+        deleted_ = 0;
+    }
+
+    Clock::time_point start_;
+
+    // all the entries up to the tick are expired
+    uint64_t current_ = 0;
+
+    std::vector<Node> nodes_;
+    uint32_t free_ = kNil;
+    size_t size_ = 0;
+
+    std::array<uint32_t, kSlots + 1> heads_;
+    std::array<uint32_t, kSlots + 1> tails_;
+    std::array<uint64_t, kFirstWords + kLevels - 1> occupied_;
+
+    // positions of nodes by key, open addressing with linear probing
+    std::vector<uint32_t> keys_;
+    size_t deleted_ = 0;
+};
+}  // namespace cs
+
+#endif  // TIMERWHEEL_HPP
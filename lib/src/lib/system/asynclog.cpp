@@ -0,0 +1,507 @@
+#include <lib/system/asynclog.hpp>
+
+#include <boost/log/core/core.hpp>
+#include <boost/log/sources/record_ostream.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+
+namespace {
+thread_local bool isFlusherThread = false;
+thread_local bool isRecordOpen = false;
+
+// keeps thread buffer registered while the thread lives
+struct LocalBuffer {
+    std::shared_ptr<logger::detail::ThreadBuffer> buffer;
+    uint64_t generation = 0;
+
+    ~LocalBuffer() {
+        if (buffer) {
+            buffer->retire();
+        }
+    }
+};
+
+thread_local LocalBuffer localBuffer;
+
+size_t roundCapacity(size_t size) {
+    size_t capacity = 2;
+
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
+template <typename T>
+T readParameter(const boost::log::settings& settings, const char* name, T defaultValue) {
+    const boost::optional<std::string> value = settings["Async"][name].get();
+
+    if (!value || value->empty()) {
+        return defaultValue;
+    }
+
+    try {
+        if constexpr (std::is_same_v<T, bool>) {
+            std::string text = *value;
+            std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return text == "true" || text == "1" || text == "on" || text == "yes";
+        }
+        else {
+            return static_cast<T>(std::stoull(*value));
+        }
+    }
+    catch (const std::exception&) {
+        return defaultValue;
+    }
+}
+}  // namespace
+
+namespace logger {
+AsyncSettings AsyncSettings::read(const boost::log::settings& settings) {
+    AsyncSettings result;
+
+    if (!settings.has_section("Async")) {
+        return result;
+    }
+
+    result.enabled = readParameter(settings, "Enabled", result.enabled);
+    result.bufferSize = readParameter(settings, "BufferSize", result.bufferSize);
+    result.rateLimit = readParameter(settings, "RateLimit", result.rateLimit);
+    result.flushInterval = std::chrono::milliseconds(readParameter(settings, "FlushInterval", static_cast<size_t>(result.flushInterval.count())));
+
+    const boost::optional<std::string> overflow = settings["Async"]["Overflow"].get();
+
+    if (overflow) {
+        std::string text = *overflow;
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        if (text == "drop") {
+            result.overflow = OverflowPolicy::Drop;
+        }
+        else if (text == "block") {
+            result.overflow = OverflowPolicy::Block;
+        }
+    }
+
+    return result;
+}
+
+namespace detail {
+ThreadBuffer::ThreadBuffer(size_t capacity)
+: entries_(roundCapacity(capacity))
+, mask_(entries_.size() - 1) {
+}
+
+Entry* ThreadBuffer::reserve() {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+
+    if (tail - head_.load(std::memory_order_acquire) >= entries_.size()) {
+        return nullptr;
+    }
+
+    return &entries_[tail & mask_];
+}
+
+void ThreadBuffer::publish() {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+size_t ThreadBuffer::available() const {
+    return static_cast<size_t>(tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_relaxed));
+}
+
+Entry& ThreadBuffer::front(size_t offset) {
+    return entries_[(head_.load(std::memory_order_relaxed) + offset) & mask_];
+}
+
+void ThreadBuffer::release() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void ThreadBuffer::retire() {
+    retired_.store(true, std::memory_order_release);
+}
+
+bool ThreadBuffer::isRetired() const {
+    return retired_.load(std::memory_order_acquire);
+}
+}  // namespace detail
+
+AsyncLog& AsyncLog::instance() {
+    static AsyncLog log;
+    return log;
+}
+
+AsyncLog::~AsyncLog() {
+    stop();
+}
+
+void AsyncLog::start(const AsyncSettings& settings) {
+    stop();
+
+    bufferSize_.store(std::max<size_t>(settings.bufferSize, 2), std::memory_order_relaxed);
+    overflow_.store(settings.overflow, std::memory_order_relaxed);
+    rateLimit_.store(settings.rateLimit, std::memory_order_relaxed);
+    flushInterval_ = std::max(settings.flushInterval, std::chrono::milliseconds(1));
+
+    // stopped flusher has drained all buffers, threads create new ones of new size
+    {
+        std::lock_guard lock(buffersMutex_);
+        buffers_.clear();
+        generation_.fetch_add(1);
+    }
+
+    if (!settings.enabled) {
+        return;
+    }
+
+    running_.store(true);
+    flusher_ = std::thread(&AsyncLog::flusherRoutine, this);
+}
+
+void AsyncLog::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    // flusher writes records which have already got thread buffer entries
+    wake();
+
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+}
+
+void AsyncLog::flush() {
+    if (!running_.load() || isFlusherThread) {
+        return;
+    }
+
+    const uint64_t target = published_.load();
+    wake();
+
+    std::unique_lock lock(wakeMutex_);
+    flushedVariable_.wait(lock, [this, target] { return written_.load() >= target || !running_.load(); });
+}
+
+bool AsyncLog::isRunning() const {
+    return running_.load(std::memory_order_relaxed);
+}
+
+AsyncLog::Metrics AsyncLog::metrics() const {
+    Metrics result;
+    result.records = records_.load(std::memory_order_relaxed);
+    result.dropped = dropped_.load(std::memory_order_relaxed);
+    result.suppressed = suppressed_.load(std::memory_order_relaxed);
+    result.blocked = blocked_.load(std::memory_order_relaxed);
+
+    return result;
+}
+
+bool AsyncLog::admit(const char* file, int line, uint32_t& suppressed) {
+    const size_t limit = rateLimit_.load(std::memory_order_relaxed);
+
+    if (limit == 0) {
+        return true;
+    }
+
+    const size_t hash = std::hash<const void*>()(file) ^ (static_cast<size_t>(line) * 0x9E3779B97F4A7C15ull);
+    Site& site = sites_[hash & (SitesCount - 1)];
+
+    const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t window = site.window.load(std::memory_order_relaxed);
+
+    // the first record of new window reports suppressed ones
+    if (window != now && site.window.compare_exchange_strong(window, now)) {
+        site.count.store(0, std::memory_order_relaxed);
+        suppressed = site.suppressed.exchange(0);
+    }
+
+    if (site.count.fetch_add(1, std::memory_order_relaxed) < limit) {
+        return true;
+    }
+
+    site.suppressed.fetch_add(1, std::memory_order_relaxed);
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+
+    return false;
+}
+
+detail::Entry* AsyncLog::acquire(bool& dropped) {
+    records_.fetch_add(1, std::memory_order_relaxed);
+
+    if (isFlusherThread || !running_.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+
+    // flusher does not stop while there are active records
+    active_.fetch_add(1);
+
+    if (!running_.load()) {
+        active_.fetch_sub(1);
+        return nullptr;
+    }
+
+    auto& buffer = threadBuffer();
+    detail::Entry* entry = buffer.reserve();
+
+    while (entry == nullptr) {
+        if (overflow_.load(std::memory_order_relaxed) == OverflowPolicy::Drop) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            active_.fetch_sub(1);
+
+            dropped = true;
+            return nullptr;
+        }
+
+        blocked_.fetch_add(1, std::memory_order_relaxed);
+        wake();
+
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        entry = buffer.reserve();
+    }
+
+    entry->sequence = sequence_.fetch_add(1, std::memory_order_relaxed);
+    return entry;
+}
+
+void AsyncLog::publish() {
+    localBuffer.buffer->publish();
+    published_.fetch_add(1);
+    active_.fetch_sub(1);
+
+    if (sleeping_.load()) {
+        wake();
+    }
+}
+
+void AsyncLog::write(boost::log::record& record, const std::vector<detail::Argument>& arguments, uint32_t suppressed) {
+    if (!record) {
+        return;
+    }
+
+    {
+        boost::log::record_ostream stream(record);
+        std::ostream& os = stream.stream();
+
+        for (const auto& argument : arguments) {
+            argument.print(os);
+        }
+
+        if (suppressed != 0) {
+            os << " (" << suppressed << " similar messages suppressed)";
+        }
+    }
+
+    try {
+        boost::log::core::get()->push_record(std::move(record));
+    }
+    catch (...) {
+    }
+}
+
+void AsyncLog::flusherRoutine() {
+    isFlusherThread = true;
+
+    while (running_.load() || active_.load() != 0) {
+        if (drain() != 0) {
+            continue;
+        }
+
+        std::unique_lock lock(wakeMutex_);
+        sleeping_.store(true);
+
+        // publisher checks sleeping flag after publication
+        bool empty = true;
+
+        {
+            std::lock_guard buffersLock(buffersMutex_);
+
+            for (const auto& buffer : buffers_) {
+                empty = empty && buffer->available() == 0;
+            }
+        }
+
+        if (empty && running_.load()) {
+            wakeVariable_.wait_for(lock, flushInterval_);
+        }
+
+        sleeping_.store(false);
+    }
+
+    while (drain() != 0) {
+    }
+
+    flushedVariable_.notify_all();
+}
+
+size_t AsyncLog::drain() {
+    batch_.clear();
+
+    {
+        std::lock_guard lock(buffersMutex_);
+
+        for (size_t index = 0; index < buffers_.size();) {
+            auto& buffer = buffers_[index];
+
+            // thread of retired buffer does not publish anymore
+            const bool retired = buffer->isRetired();
+            const size_t count = buffer->available();
+
+            if (retired && count == 0) {
+                buffers_.erase(buffers_.begin() + static_cast<std::ptrdiff_t>(index));
+                continue;
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                detail::Entry& entry = buffer->front(i);
+                batch_.push_back(Item{entry.sequence, buffer.get(), &entry});
+            }
+
+            ++index;
+        }
+    }
+
+    // order of records of one thread is kept, records of different threads are written in order of their opening
+    std::sort(batch_.begin(), batch_.end(), [](const Item& lhs, const Item& rhs) { return lhs.sequence < rhs.sequence; });
+
+    for (auto& item : batch_) {
+        write(item.entry->record, item.entry->arguments, item.entry->suppressed);
+
+        item.entry->record.reset();
+        item.entry->arguments.clear();
+        item.entry->suppressed = 0;
+
+        item.buffer->release();
+    }
+
+    if (!batch_.empty()) {
+        written_.fetch_add(batch_.size());
+
+        std::lock_guard lock(wakeMutex_);
+        flushedVariable_.notify_all();
+    }
+
+    return batch_.size();
+}
+
+void AsyncLog::wake() {
+    std::lock_guard lock(wakeMutex_);
+    wakeVariable_.notify_one();
+}
+
+detail::ThreadBuffer& AsyncLog::threadBuffer() {
+    const uint64_t generation = generation_.load();
+
+    if (!localBuffer.buffer || localBuffer.generation != generation) {
+        localBuffer.buffer = std::make_shared<detail::ThreadBuffer>(bufferSize_.load(std::memory_order_relaxed));
+        localBuffer.generation = generation;
+
+        std::lock_guard lock(buffersMutex_);
+        buffers_.push_back(localBuffer.buffer);
+    }
+
+    return *localBuffer.buffer;
+}
+
+Record::~Record() {
+    // message arguments have thrown, nothing is written
+    if (arguments_ != nullptr) {
+        record_.reset();
+        commit();
+    }
+}
+
+void Record::open(const char* file, int line) {
+    AsyncLog& log = AsyncLog::instance();
+
+    if (level_ < boost::log::trivial::fatal && !log.admit(file, line, suppressed_)) {
+        record_.reset();
+        return;
+    }
+
+    // nested record, e.g. logged by operator<< of argument, is written at once
+    if (!isRecordOpen) {
+        bool dropped = false;
+        entry_ = log.acquire(dropped);
+
+        if (dropped) {
+            record_.reset();
+            return;
+        }
+    }
+
+    if (entry_ != nullptr) {
+        isRecordOpen = true;
+        entry_->suppressed = suppressed_;
+        arguments_ = &entry_->arguments;
+    }
+    else {
+        arguments_ = &local_;
+    }
+}
+
+void Record::commit() {
+    if (arguments_ == nullptr) {
+        return;
+    }
+
+    AsyncLog& log = AsyncLog::instance();
+
+    if (entry_ == nullptr) {
+        AsyncLog::write(record_, local_, suppressed_);
+    }
+    else {
+        isRecordOpen = false;
+
+        if (record_) {
+            // thread bound attributes (thread id, severity) should keep values of the calling thread
+            boost::log::attribute_value_set values;
+
+            for (const auto& value : record_.attribute_values()) {
+                boost::log::attribute_value detached = value.second;
+                detached.detach_from_thread();
+                values.insert(value.first, detached);
+            }
+
+            record_.attribute_values().swap(values);
+        }
+
+        entry_->record = std::move(record_);
+        log.publish();
+    }
+
+    arguments_ = nullptr;
+
+    if (level_ >= boost::log::trivial::fatal) {
+        log.flush();
+    }
+}
+
+Record& Record::operator<<(std::ostream& (*manipulator)(std::ostream&)) {
+    arguments_->push_back(detail::Argument::value(manipulator));
+    format() << manipulator;
+    return *this;
+}
+
+Record& Record::operator<<(std::ios_base& (*manipulator)(std::ios_base&)) {
+    arguments_->push_back(detail::Argument::value(manipulator));
+    format() << manipulator;
+    return *this;
+}
+
+std::ostringstream& Record::format() {
+    static thread_local std::ostringstream stream;
+
+    if (format_ == nullptr) {
+        static thread_local const std::ostringstream pristine;
+        stream.copyfmt(pristine);
+        format_ = &stream;
+    }
+
+    return *format_;
+}
+}  // namespace logger
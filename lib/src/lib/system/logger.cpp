@@ -16,9 +16,12 @@ void initialize(const logging::settings& settings) {
     logging::register_simple_filter_factory<severity_level>(logging::trivial::tag::severity::get_name());
 
     logging::init_from_settings(settings);
+
+    AsyncLog::instance().start(AsyncSettings::read(settings));
 }
 
 void cleanup() {
+    AsyncLog::instance().stop();
     logging::core::get()->remove_all_sinks();
 }
 }  // namespace logger
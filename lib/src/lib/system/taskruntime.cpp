@@ -0,0 +1,273 @@
+#include "lib/system/taskruntime.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include <lib/system/logger.hpp>
+
+namespace {
+constexpr size_t kMinWorkers = 2;
+constexpr std::chrono::seconds kMaxTimerWait{60};
+
+// worker of runtime on the current thread
+thread_local const cs::TaskRuntime* currentRuntime = nullptr;
+thread_local size_t currentWorker = 0;
+}  // namespace
+
+namespace cs {
+TaskRuntime::TaskRuntime(size_t workers) {
+    workers = std::max(workers, kMinWorkers);
+
+    queues_.reserve(workers);
+
+    for (size_t i = 0; i < workers; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    workers_.reserve(workers);
+
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back(&TaskRuntime::workerRoutine, this, i);
+    }
+
+    timer_ = std::thread(&TaskRuntime::timerRoutine, this);
+}
+
+TaskRuntime::~TaskRuntime() {
+    {
+        std::lock_guard lock(sleepMutex_);
+        std::lock_guard timerLock(timerMutex_);
+        stop_ = true;
+    }
+
+    sleepCondition_.notify_all();
+    timerCondition_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+
+    timer_.join();
+}
+
+TaskRuntime& TaskRuntime::instance() {
+    static TaskRuntime runtime;
+    return runtime;
+}
+
+void TaskRuntime::submit(Task task, TaskPriority priority) {
+    const auto index = static_cast<size_t>(priority);
+    Queue& queue = (currentRuntime == this) ? *queues_[currentWorker] : shared_;
+
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.tasks[index].push_back(std::move(task));
+        queue.size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    pending_.fetch_add(1);
+
+    // sleeping worker is counted under mutex before it checks pending tasks, so wake up is not lost
+    if (sleeping_.load() != 0) {
+        std::lock_guard lock(sleepMutex_);
+        sleepCondition_.notify_one();
+    }
+}
+
+void TaskRuntime::submitAt(std::chrono::steady_clock::time_point timePoint, Task task, TaskPriority priority) {
+    {
+        std::lock_guard lock(timerMutex_);
+        delayed_.insert(++delayedId_, timePoint, Delayed{std::move(task), priority});
+        delayedSize_.store(delayed_.size(), std::memory_order_relaxed);
+    }
+
+    timerCondition_.notify_one();
+}
+
+bool TaskRuntime::isWorkerThread() const {
+    return currentRuntime == this;
+}
+
+size_t TaskRuntime::workersCount() const {
+    return workers_.size();
+}
+
+TaskRuntime::Metrics TaskRuntime::metrics() const {
+    Metrics metrics;
+    metrics.workers = workers_.size();
+    metrics.queued = pending_.load(std::memory_order_relaxed);
+    metrics.delayed = delayedSize_.load(std::memory_order_relaxed);
+    metrics.executed = executed_.load(std::memory_order_relaxed);
+    metrics.steals = steals_.load(std::memory_order_relaxed);
+    return metrics;
+}
+
+void TaskRuntime::workerRoutine(size_t index) {
+    currentRuntime = this;
+    currentWorker = index;
+
+    while (!stop_) {
+        if (Task task = findTask(index); task) {
+            execute(task);
+            continue;
+        }
+
+        // task is pushed, but not visible yet
+        if (pending_.load() != 0) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex_);
+        sleeping_.fetch_add(1);
+
+        sleepCondition_.wait(lock, [this] {
+            return stop_ || pending_.load() != 0;
+        });
+
+        sleeping_.fetch_sub(1);
+    }
+}
+
+void TaskRuntime::timerRoutine() {
+    std::vector<TimerWheel<Delayed, uint64_t>::Expired> expired;
+    std::unique_lock lock(timerMutex_);
+
+    while (!stop_) {
+        const auto now = std::chrono::steady_clock::now();
+        const auto next = delayed_.nextExpiry().value_or(now + kMaxTimerWait);
+
+        if (next > now) {
+            timerCondition_.wait_until(lock, std::min(next, now + kMaxTimerWait));
+            continue;
+        }
+
+        delayed_.expire(now, expired);
+        delayedSize_.store(delayed_.size(), std::memory_order_relaxed);
+
+        lock.unlock();
+
+        for (auto& item : expired) {
+            submit(std::move(item.value.task), item.value.priority);
+        }
+
+        expired.clear();
+        lock.lock();
+    }
+}
+
+Task TaskRuntime::findTask(size_t index) {
+    // higher priority task of any queue goes first
+    for (size_t priority = 0; priority < kPriorities; ++priority) {
+        if (Task task = popLocal(index, priority); task) {
+            return task;
+        }
+
+        if (Task task = popShared(priority); task) {
+            return task;
+        }
+
+        if (Task task = steal(index, priority); task) {
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+
+    return Task();
+}
+
+Task TaskRuntime::popLocal(size_t index, size_t priority) {
+    Queue& queue = *queues_[index];
+
+    if (queue.size.load(std::memory_order_relaxed) == 0) {
+        return Task();
+    }
+
+    std::lock_guard lock(queue.mutex);
+    auto& tasks = queue.tasks[priority];
+
+    if (tasks.empty()) {
+        return Task();
+    }
+
+    // the latest task has the hottest data
+    Task task = std::move(tasks.back());
+    tasks.pop_back();
+
+    queue.size.fetch_sub(1, std::memory_order_relaxed);
+    pending_.fetch_sub(1);
+
+    return task;
+}
+
+Task TaskRuntime::popShared(size_t priority) {
+    if (shared_.size.load(std::memory_order_relaxed) == 0) {
+        return Task();
+    }
+
+    std::lock_guard lock(shared_.mutex);
+    auto& tasks = shared_.tasks[priority];
+
+    if (tasks.empty()) {
+        return Task();
+    }
+
+    Task task = std::move(tasks.front());
+    tasks.pop_front();
+
+    shared_.size.fetch_sub(1, std::memory_order_relaxed);
+    pending_.fetch_sub(1);
+
+    return task;
+}
+
+Task TaskRuntime::steal(size_t index, size_t priority) {
+    const size_t count = queues_.size();
+
+    for (size_t i = 1; i < count; ++i) {
+        Queue& queue = *queues_[(index + i) % count];
+
+        if (queue.size.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+
+        // busy owner is not waited for, other victims may be free
+        std::unique_lock lock(queue.mutex, std::try_to_lock);
+
+        if (!lock.owns_lock()) {
+            continue;
+        }
+
+        auto& tasks = queue.tasks[priority];
+
+        if (tasks.empty()) {
+            continue;
+        }
+
+        // the oldest task is the coldest one for owner
+        Task task = std::move(tasks.front());
+        tasks.pop_front();
+
+        queue.size.fetch_sub(1, std::memory_order_relaxed);
+        pending_.fetch_sub(1);
+
+        return task;
+    }
+
+    return Task();
+}
+
+void TaskRuntime::execute(Task& task) {
+    try {
+        task();
+    }
+    catch (const std::exception& exception) {
+        cserror() << "Task runtime, task failed: " << exception.what();
+    }
+    catch (...) {
+        cserror() << "Task runtime, task failed with unknown exception";
+    }
+
+    executed_.fetch_add(1, std::memory_order_relaxed);
+}
+}  // namespace cs
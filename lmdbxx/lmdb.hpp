@@ -2,6 +2,7 @@
 #define LMDBXX_HPP
 
 #include <cassert>
+#include <cstring>
 #include <numeric>
 #include <string>
 #include <string_view>
@@ -194,6 +195,27 @@ public:
                name, flags);
     }
 
+    // runs func(lmdb::txn& transaction) in one write transaction, so several tables are changed atomically,
+    // func opens tables by lmdb::dbi::open(transaction, name) and returns false to abort all its changes
+    template<typename Func>
+    void update(Func func) {
+        checkMapSize();
+
+        try {
+            auto transaction = lmdb::txn::begin(*env_);
+
+            if (func(transaction)) {
+                transaction.commit();
+            }
+            else {
+                transaction.abort();
+            }
+        }
+        catch(const lmdb::error& error) {
+            raise(error);
+        }
+    }
+
     // removes key/value pair by key argument as byte stream
     // name - table name at current path, nullptr if only one table exist
     bool remove(const char* data, size_t size, const char* name = nullptr,
@@ -308,6 +330,39 @@ public:
         return std::make_pair<Key, Value>(Key{}, Value{});
     }
 
+    // iterates key/value pairs in one read transaction, forward - from the first key not less than argument,
+    // backward - from the last key not greater than argument; func(const lmdb::val& key, const lmdb::val& value)
+    // returns false to stop iteration
+    template<typename Func>
+    void iterate(const char* data, size_t size, bool forward, Func func, const char* name = nullptr) const {
+        try {
+            auto transaction = lmdb::txn::begin(*env_, nullptr, MDB_RDONLY);
+            auto dbi = lmdb::dbi::open(transaction, name);
+            auto cursor = lmdb::cursor::open(transaction, dbi);
+
+            lmdb::val key(reinterpret_cast<const void*>(data), size);
+            lmdb::val value;
+
+            bool result = cursor.get(key, value, MDB_SET_RANGE);
+
+            if (!forward) {
+                if (!result) {
+                    result = cursor.get(key, value, MDB_LAST);
+                }
+                else if (key.size() != size || std::memcmp(key.data(), data, size) != 0) {
+                    result = cursor.get(key, value, MDB_PREV);
+                }
+            }
+
+            while (result && func(static_cast<const lmdb::val&>(key), static_cast<const lmdb::val&>(value))) {
+                result = cursor.get(key, value, forward ? MDB_NEXT : MDB_PREV);
+            }
+        }
+        catch(const lmdb::error& error) {
+            raise(error);
+        }
+    }
+
 protected:
     void flushImpl(bool force) {
         try {
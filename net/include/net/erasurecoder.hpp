@@ -0,0 +1,34 @@
+#ifndef ERASURECODER_HPP
+#define ERASURECODER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <lib/system/common.hpp>
+
+namespace cs {
+// Systematic Reed-Solomon code over GF(256) with Cauchy generator matrix,
+// any dataShards of dataShards + repairShards(dataShards) shards restore the data shards.
+// The amount of repair shards is a protocol constant: receiver restores data shards count from total shards count
+class ErasureCoder {
+public:
+    constexpr static uint32_t RepairPercents = 10;
+    constexpr static uint32_t MaxShards = 255;
+
+    static uint32_t repairShards(uint32_t dataShards);
+
+    // returns 0 if total shards count can not be produced by repairShards()
+    static uint32_t dataShards(uint32_t totalShards);
+
+    static bool isApplicable(uint32_t dataShards);
+
+    // every shard has size bytes
+    static void encode(const std::vector<const cs::Byte*>& data, const std::vector<cs::Byte*>& repair, size_t size);
+
+    // shards are data shards followed by repair ones, lost shards are nullptr,
+    // every lost data shard is restored to the buffer of recovered at the same index
+    static bool decode(const std::vector<const cs::Byte*>& shards, uint32_t dataShards, const std::vector<cs::Byte*>& recovered, size_t size);
+};
+}  // namespace cs
+
+#endif  // ERASURECODER_HPP
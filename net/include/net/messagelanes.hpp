@@ -0,0 +1,129 @@
+#ifndef MESSAGELANES_HPP
+#define MESSAGELANES_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <lib/system/structures.hpp>
+#include <lib/system/taskruntime.hpp>
+
+#include "packet.hpp"
+
+namespace cs {
+// histogram of latencies with power of two buckets of microseconds
+class LatencyHistogram {
+public:
+    enum : size_t {
+        BucketsCount = 32
+    };
+
+    using Duration = std::chrono::steady_clock::duration;
+
+    void add(Duration latency);
+
+    uint64_t count() const;
+
+    // upper bound in microseconds of bucket which contains the part of latencies, part is in [0, 1]
+    uint64_t percentile(double part) const;
+
+    std::string toString() const;
+
+private:
+    std::array<std::atomic<uint64_t>, BucketsCount> buckets_{};
+    std::atomic<uint64_t> count_ = {0};
+};
+
+enum class MessageLane : uint8_t {
+    // consensus and round messages, handled by processor thread at once
+    Consensus,
+
+    // bulk messages, decoded and verified by task runtime
+    Transactions,
+    Blocks,
+    States,
+
+    Count
+};
+
+const char* laneName(MessageLane lane);
+
+///
+/// Classified message dispatcher. Messages of bulk lanes are prepared by runtime workers, results of preparation
+/// are applied by the processor thread through calls queue, every lane applies them in order of messages arrival.
+///
+class MessageLanes {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // applies prepared message, called by processor thread
+    using Apply = std::function<void()>;
+
+    // decodes and verifies message, called by worker, should not touch state of processor thread
+    using Prepare = std::function<Apply()>;
+
+    explicit MessageLanes(CallsQueue& queue = CallsQueue::instance(), TaskRuntime& runtime = TaskRuntime::instance());
+    ~MessageLanes();
+
+    MessageLanes(const MessageLanes&) = delete;
+    MessageLanes& operator=(const MessageLanes&) = delete;
+
+    static MessageLane classify(MsgTypes type);
+
+    // call from processor thread
+    void process(MessageLane lane, Prepare prepare);
+
+    // latency of message handled by processor thread at once
+    void record(MessageLane lane, Clock::time_point received);
+
+    // drops not applied messages, waiting messages are not prepared and lanes do not call anything after it
+    void stop();
+
+    // messages waiting for preparation or application
+    size_t pending(MessageLane lane) const;
+
+    const LatencyHistogram& latency(MessageLane lane) const;
+
+    void report() const;
+
+private:
+    struct Slot {
+        Apply apply;
+        Clock::time_point received;
+        bool prepared = false;
+    };
+
+    struct Lane {
+        mutable std::mutex mutex;
+
+        // not applied messages, the front is the oldest one
+        std::deque<Slot> messages;
+        uint64_t nextTicket = 0;
+        uint64_t appliedTicket = 0;
+
+        LatencyHistogram latency;
+    };
+
+    // shared with running tasks, they may outlive dispatcher
+    struct State {
+        std::array<Lane, static_cast<size_t>(MessageLane::Count)> lanes;
+        std::atomic<bool> stopped = {false};
+
+        // returns false if lanes are stopped and message is dropped
+        bool prepared(MessageLane lane, uint64_t ticket, Apply apply);
+        void drain(MessageLane lane);
+    };
+
+    CallsQueue& queue_;
+    TaskRuntime& runtime_;
+    std::shared_ptr<State> state_;
+};
+}  // namespace cs
+
+#endif  // MESSAGELANES_HPP
@@ -47,6 +47,10 @@ public:
 
 private:
     void readerRoutine();
+#ifdef __linux__
+    // recvmmsg based reader, used if batched io is enabled by config
+    void readBatches(ip::udp::socket* sock);
+#endif
     void writerRoutine();
     void processorRoutine();
     inline void processTask(TaskPtr<IPacMan>&);
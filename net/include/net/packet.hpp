@@ -12,6 +12,7 @@
 
 #include <lz4.h>
 
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -36,6 +37,7 @@ enum BaseFlags : uint8_t {
     Encrypted = 1 << 4,
     Signed = 1 << 5,
     Direct = 1 << 6,  // send packet to Direct only, Node _cant_ resend it
+    ErasureCoded = 1 << 7,  // fragmented message is followed by repair fragments, see ErasureCoder
 };
 
 enum Offsets : uint32_t {
@@ -127,6 +129,10 @@ public:
         return checkFlag(BaseFlags::Direct);
     }
 
+    bool isErasureCoded() const {
+        return checkFlag(BaseFlags::ErasureCoded);
+    }
+
     const cs::Hash& getHash() const {
         if (!hashed_) {
             hash_ = generateHash(region_->data(), region_->size());
@@ -383,11 +389,17 @@ private:
 
     void composeFullData() const;
 
+    // restores lost data fragments of erasure coded message from repair ones
+    bool recoverFragments();
+
     cs::SpinLock pLock_{ATOMIC_FLAG_INIT};
 
     uint32_t packetsLeft_;
     uint32_t packetsTotal_ = 0;
 
+    // erasure coded message is complete when any of its data packets count fragments are received
+    uint32_t dataPacketsNum_ = 0;
+
     uint16_t maxFragment_ = 0;
     std::vector<Packet> packets_;
 
@@ -405,6 +417,10 @@ using MessagePtr = MemPtr<TypedSlot<Message>>;
 class PacketCollector {
 public:
     static const uint32_t MaxParallelCollections = 1024;
+    static const uint32_t MaxCompletedRemembered = 4096;
+
+    // late fragments of a processed message are discarded during this time
+    static constexpr std::chrono::seconds CompletedMessageTtl{10};
 
     PacketCollector()
     : msgAllocator_(MaxParallelCollections + 1) {
@@ -418,6 +434,7 @@ private:
 
     cs::SpinLock mLock_{ATOMIC_FLAG_INIT};
     FixedHashMap<cs::Hash, MessagePtr, uint16_t, MaxParallelCollections> map_;
+    FixedHashMap<cs::Hash, std::chrono::steady_clock::time_point, uint16_t, MaxCompletedRemembered> completed_;
 
     Message lastMessage_;
     friend class Network;
@@ -2,11 +2,11 @@
 #ifndef PACMANS_HPP
 #define PACMANS_HPP
 
+#include <array>
 #include <atomic>
 #include <boost/asio.hpp>
-#include <chrono>
-#include <list>
-#include <mutex>
+
+#include <lib/system/queues.hpp>
 
 #include "packet.hpp"
 
@@ -50,55 +50,98 @@ private:
     friend Pacman;
 };
 
+// received packets queue, one reader thread fills it and one processor thread takes packets;
+// slots are preallocated and keep their packet regions for reuse if nobody else holds them
 class IPacMan {
 public:
+    enum Options : size_t {
+        QueueCapacity = 8192,
+        MaxBatchSize = 64
+    };
+
     IPacMan() = default;
 
     struct Task {
         ip::udp::endpoint sender;
         size_t size;
         Packet pack;
-        std::chrono::time_point<std::chrono::high_resolution_clock> timestamp;
     };
 
+    // if queue is full returns overflow slot, packet received to it is dropped by enQueueLast()
     Task& allocNext();
-    void enQueueLast();
+
+    // returns false if packet is dropped because queue is full
+    bool enQueueLast();
+    void rejectLast();
+
+    // prepares up to count free slots to receive several packets at once, returns 0 if queue is full
+    size_t allocBatch(size_t count);
+
+    Task& batchTask(size_t index) {
+        return *batch_[index];
+    }
+
+    // accepted tasks of batch must be published in order of index, rejected ones are just skipped
+    void enQueueBatch(size_t index);
 
     TaskPtr<IPacMan> getNextTask(bool& is_empty);
 
-    using TaskIterator = std::list<Task>::iterator;
+    using TaskIterator = Task*;
     void releaseTask(TaskIterator&);
-    void rejectLast();
-    size_t getSize() {
-        return size_.load(std::memory_order_relaxed);
+
+    size_t getSize() const {
+        return queue_.size();
+    }
+
+    uint64_t getDropped() const {
+        return dropped_.load(std::memory_order_relaxed);
     }
 
 private:
-    std::list<Task> queue_;
-    std::mutex mutex_;
-    std::atomic<size_t> size_ = {0};
+    void prepare(Task& task);
+
+    SPSCRing<Task, QueueCapacity> queue_;
+    Task overflow_;
+    Task* last_ = nullptr;
+    std::array<Task*, MaxBatchSize> batch_{};
+
+    std::atomic<uint64_t> dropped_ = {0};
     RegionAllocator allocator_;
 };
 
+// packets to send queue, any thread may add packets and one writer thread sends them
 class OPacMan {
 public:
+    enum Options : size_t {
+        QueueCapacity = 8192,
+        // yields of sender while queue is full before packet is dropped
+        MaxPushAttempts = 1000
+    };
+
     struct Task {
         ip::udp::endpoint endpoint;
         Packet pack;
     };
 
-    Task* allocNext();
-    void enQueueLast();
+    // returns false if packet is dropped because queue stays full
+    bool enQueue(const ip::udp::endpoint& endpoint, const Packet& pack);
 
     TaskPtr<OPacMan> getNextTask(bool& is_empty);
 
-    using TaskIterator = std::list<Task>::iterator;
+    using TaskIterator = Task*;
     void releaseTask(TaskIterator&);
 
+    size_t getSize() const {
+        return queue_.size();
+    }
+
+    uint64_t getDropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
 private:
-    std::list<Task> queue_;
-    std::mutex mutex_;
-    std::atomic<size_t> size_ = {0};
+    MPSCRing<Task, QueueCapacity> queue_;
+    std::atomic<uint64_t> dropped_ = {0};
 };
 
 #endif  // PACMANS_HPP
@@ -16,6 +16,7 @@
 
 #include <net/network.hpp>
 
+#include "messagelanes.hpp"
 #include "neighbourhood.hpp"
 #include "packet.hpp"
 #include "pacmans.hpp"
@@ -193,6 +194,9 @@ private:
 
     void dispatchNodeMessage(const MsgTypes, const cs::RoundNumber, const Packet&, const uint8_t* data, size_t);
 
+    // decodes and verifies message by workers, applies it by processor thread in order of its lane
+    void dispatchBulkMessage(const MsgTypes, const cs::RoundNumber, const Packet&, const uint8_t* data, size_t);
+
     /* Network packages processing */
     bool gotRegistrationRequest(const TaskPtr<IPacMan>&, RemoteNodePtr&);
 
@@ -291,6 +295,9 @@ private:
     Network* net_;
     Node* node_;
 
+    static constexpr cs::RoundNumber lanesReportRounds_ = 100;
+    cs::MessageLanes lanes_;
+
     Neighbourhood neighbourhood_;
 
     static constexpr uint32_t fragmentsFixedMapSize_ = 10000;
@@ -0,0 +1,221 @@
+#include "erasurecoder.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace {
+class GaloisField {
+public:
+    GaloisField() {
+        // x^8 + x^4 + x^3 + x^2 + 1
+        constexpr unsigned polynomial = 0x11d;
+        unsigned value = 1;
+
+        for (size_t i = 0; i < 255; ++i) {
+            exp_[i] = exp_[i + 255] = static_cast<cs::Byte>(value);
+            log_[value] = static_cast<cs::Byte>(i);
+
+            value <<= 1;
+
+            if (value & 0x100) {
+                value ^= polynomial;
+            }
+        }
+
+        for (size_t a = 1; a < 256; ++a) {
+            for (size_t b = 1; b < 256; ++b) {
+                mul_[a][b] = exp_[log_[a] + log_[b]];
+            }
+        }
+    }
+
+    cs::Byte mul(cs::Byte a, cs::Byte b) const {
+        return mul_[a][b];
+    }
+
+    cs::Byte inv(cs::Byte a) const {
+        return exp_[255 - log_[a]];
+    }
+
+    // dest ^= coefficient * source
+    void mulAdd(cs::Byte* dest, const cs::Byte* source, cs::Byte coefficient, size_t size) const {
+        if (coefficient == 0) {
+            return;
+        }
+
+        const auto& row = mul_[coefficient];
+
+        for (size_t i = 0; i < size; ++i) {
+            dest[i] ^= row[source[i]];
+        }
+    }
+
+    // Cauchy matrix element, x = dataShards + repair index and y = data index never coincide
+    cs::Byte cauchy(uint32_t repair, uint32_t data, uint32_t dataShards) const {
+        return inv(static_cast<cs::Byte>((dataShards + repair) ^ data));
+    }
+
+    static const GaloisField& instance() {
+        static GaloisField field;
+        return field;
+    }
+
+private:
+    std::array<cs::Byte, 510> exp_{};
+    std::array<cs::Byte, 256> log_{};
+    std::array<std::array<cs::Byte, 256>, 256> mul_{};
+};
+
+// inverts matrix of size x size in place, Cauchy submatrices are never singular
+bool invert(std::vector<cs::Byte>& matrix, size_t size) {
+    const auto& field = GaloisField::instance();
+    std::vector<cs::Byte> result(size * size, 0);
+
+    for (size_t i = 0; i < size; ++i) {
+        result[i * size + i] = 1;
+    }
+
+    for (size_t col = 0; col < size; ++col) {
+        size_t pivot = col;
+
+        while (pivot < size && matrix[pivot * size + col] == 0) {
+            ++pivot;
+        }
+
+        if (pivot == size) {
+            return false;
+        }
+
+        if (pivot != col) {
+            std::swap_ranges(matrix.begin() + pivot * size, matrix.begin() + (pivot + 1) * size, matrix.begin() + col * size);
+            std::swap_ranges(result.begin() + pivot * size, result.begin() + (pivot + 1) * size, result.begin() + col * size);
+        }
+
+        const auto factor = field.inv(matrix[col * size + col]);
+
+        for (size_t j = 0; j < size; ++j) {
+            matrix[col * size + j] = field.mul(matrix[col * size + j], factor);
+            result[col * size + j] = field.mul(result[col * size + j], factor);
+        }
+
+        for (size_t row = 0; row < size; ++row) {
+            const auto coefficient = matrix[row * size + col];
+
+            if (row == col || coefficient == 0) {
+                continue;
+            }
+
+            field.mulAdd(&matrix[row * size], &matrix[col * size], coefficient, size);
+            field.mulAdd(&result[row * size], &result[col * size], coefficient, size);
+        }
+    }
+
+    matrix = std::move(result);
+    return true;
+}
+}  // namespace
+
+uint32_t cs::ErasureCoder::repairShards(uint32_t dataShards) {
+    return (dataShards * RepairPercents + 99) / 100;
+}
+
+uint32_t cs::ErasureCoder::dataShards(uint32_t totalShards) {
+    // total shards count grows strictly with data shards count
+    for (uint32_t data = 1; data < totalShards; ++data) {
+        const auto total = data + repairShards(data);
+
+        if (total == totalShards) {
+            return data;
+        }
+
+        if (total > totalShards) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+bool cs::ErasureCoder::isApplicable(uint32_t dataShards) {
+    return dataShards > 1 && dataShards + repairShards(dataShards) <= MaxShards;
+}
+
+void cs::ErasureCoder::encode(const std::vector<const cs::Byte*>& data, const std::vector<cs::Byte*>& repair, size_t size) {
+    const auto& field = GaloisField::instance();
+    const auto dataShards = static_cast<uint32_t>(data.size());
+
+    for (uint32_t i = 0; i < repair.size(); ++i) {
+        std::fill(repair[i], repair[i] + size, cs::Byte(0));
+
+        for (uint32_t j = 0; j < dataShards; ++j) {
+            field.mulAdd(repair[i], data[j], field.cauchy(i, j, dataShards), size);
+        }
+    }
+}
+
+bool cs::ErasureCoder::decode(const std::vector<const cs::Byte*>& shards, uint32_t dataShards, const std::vector<cs::Byte*>& recovered, size_t size) {
+    const auto& field = GaloisField::instance();
+
+    std::vector<uint32_t> lost;
+    std::vector<uint32_t> repairs;
+
+    for (uint32_t j = 0; j < dataShards; ++j) {
+        if (shards[j] == nullptr) {
+            lost.push_back(j);
+        }
+    }
+
+    for (uint32_t i = dataShards; i < shards.size() && repairs.size() < lost.size(); ++i) {
+        if (shards[i] != nullptr) {
+            repairs.push_back(i - dataShards);
+        }
+    }
+
+    if (repairs.size() < lost.size()) {
+        return false;
+    }
+
+    const size_t count = lost.size();
+
+    if (count == 0) {
+        return true;
+    }
+
+    // repair = sum(cauchy * data), move known data shards to the left side
+    std::vector<std::vector<cs::Byte>> syndromes(count);
+
+    for (size_t a = 0; a < count; ++a) {
+        const auto repair = repairs[a];
+        auto& syndrome = syndromes[a];
+        syndrome.assign(shards[dataShards + repair], shards[dataShards + repair] + size);
+
+        for (uint32_t j = 0; j < dataShards; ++j) {
+            if (shards[j] != nullptr) {
+                field.mulAdd(syndrome.data(), shards[j], field.cauchy(repair, j, dataShards), size);
+            }
+        }
+    }
+
+    std::vector<cs::Byte> matrix(count * count);
+
+    for (size_t a = 0; a < count; ++a) {
+        for (size_t b = 0; b < count; ++b) {
+            matrix[a * count + b] = field.cauchy(repairs[a], lost[b], dataShards);
+        }
+    }
+
+    if (!invert(matrix, count)) {
+        return false;
+    }
+
+    for (size_t b = 0; b < count; ++b) {
+        auto dest = recovered[lost[b]];
+        std::fill(dest, dest + size, cs::Byte(0));
+
+        for (size_t a = 0; a < count; ++a) {
+            field.mulAdd(dest, syndromes[a].data(), matrix[b * count + a], size);
+        }
+    }
+
+    return true;
+}
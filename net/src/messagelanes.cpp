@@ -0,0 +1,216 @@
+#include <messagelanes.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <sstream>
+
+#include <lib/system/logger.hpp>
+
+namespace {
+cs::MessageLane laneByIndex(size_t index) {
+    return static_cast<cs::MessageLane>(index);
+}
+}  // namespace
+
+namespace cs {
+void LatencyHistogram::add(Duration latency) {
+    const auto microseconds = static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count(), 0));
+
+    // bucket i keeps latencies below 2^i microseconds
+    size_t index = 0;
+
+    while (index + 1 < BucketsCount && (uint64_t(1) << index) <= microseconds) {
+        ++index;
+    }
+
+    buckets_[index].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const {
+    return count_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double part) const {
+    const uint64_t total = count();
+
+    if (total == 0) {
+        return 0;
+    }
+
+    const auto required = std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(total) * std::clamp(part, 0.0, 1.0) + 0.5));
+    uint64_t counted = 0;
+
+    for (size_t i = 0; i < BucketsCount; ++i) {
+        counted += buckets_[i].load(std::memory_order_relaxed);
+
+        if (counted >= required) {
+            return uint64_t(1) << i;
+        }
+    }
+
+    return uint64_t(1) << (BucketsCount - 1);
+}
+
+std::string LatencyHistogram::toString() const {
+    std::ostringstream os;
+    os << count() << " msg, p50 < " << percentile(0.5) << " us, p90 < " << percentile(0.9) << " us, p99 < " << percentile(0.99) << " us";
+    return os.str();
+}
+
+const char* laneName(MessageLane lane) {
+    switch (lane) {
+        case MessageLane::Consensus:
+            return "consensus";
+        case MessageLane::Transactions:
+            return "transactions";
+        case MessageLane::Blocks:
+            return "blocks";
+        case MessageLane::States:
+            return "states";
+        default:
+            return "unknown";
+    }
+}
+
+MessageLanes::MessageLanes(CallsQueue& queue, TaskRuntime& runtime)
+: queue_(queue)
+, runtime_(runtime)
+, state_(std::make_shared<State>()) {
+}
+
+MessageLanes::~MessageLanes() {
+    stop();
+}
+
+MessageLane MessageLanes::classify(MsgTypes type) {
+    switch (type) {
+        case MsgTypes::TransactionPacket:
+        case MsgTypes::TransactionsPacketReply:
+            return MessageLane::Transactions;
+        case MsgTypes::RequestedBlock:
+            return MessageLane::Blocks;
+        case MsgTypes::StateReply:
+            return MessageLane::States;
+        default:
+            return MessageLane::Consensus;
+    }
+}
+
+void MessageLanes::process(MessageLane lane, Prepare prepare) {
+    if (state_->stopped) {
+        return;
+    }
+
+    uint64_t ticket = 0;
+
+    {
+        Lane& data = state_->lanes[static_cast<size_t>(lane)];
+        std::lock_guard lock(data.mutex);
+
+        ticket = data.nextTicket++;
+        data.messages.push_back(Slot{Apply(), Clock::now(), false});
+    }
+
+    runtime_.submit([state = state_, queue = &queue_, lane, ticket, prepare = std::move(prepare)] {
+        // message is dropped by stop
+        if (state->stopped) {
+            return;
+        }
+
+        Apply apply;
+
+        try {
+            apply = prepare();
+        }
+        catch (const std::exception& exception) {
+            cserror() << "LANES> " << laneName(lane) << " message preparation failed, " << exception.what();
+        }
+        catch (...) {
+            cserror() << "LANES> " << laneName(lane) << " message preparation failed, unknown exception";
+        }
+
+        // failed message is skipped, but lane has to move on
+        if (!state->prepared(lane, ticket, std::move(apply))) {
+            return;
+        }
+
+        queue->insert([state, lane] {
+            state->drain(lane);
+        });
+    }, TaskPriority::Low);
+}
+
+void MessageLanes::record(MessageLane lane, Clock::time_point received) {
+    state_->lanes[static_cast<size_t>(lane)].latency.add(Clock::now() - received);
+}
+
+void MessageLanes::stop() {
+    state_->stopped = true;
+
+    // waiting tasks see the flag and skip preparation
+    for (Lane& data : state_->lanes) {
+        std::lock_guard lock(data.mutex);
+        data.messages.clear();
+        data.appliedTicket = data.nextTicket;
+    }
+}
+
+size_t MessageLanes::pending(MessageLane lane) const {
+    const Lane& data = state_->lanes[static_cast<size_t>(lane)];
+    std::lock_guard lock(data.mutex);
+    return data.messages.size();
+}
+
+const LatencyHistogram& MessageLanes::latency(MessageLane lane) const {
+    return state_->lanes[static_cast<size_t>(lane)].latency;
+}
+
+void MessageLanes::report() const {
+    for (size_t i = 0; i < state_->lanes.size(); ++i) {
+        const auto lane = laneByIndex(i);
+        csdebug() << "LANES> " << laneName(lane) << ": " << latency(lane).toString() << ", pending " << pending(lane);
+    }
+}
+
+bool MessageLanes::State::prepared(MessageLane lane, uint64_t ticket, Apply apply) {
+    Lane& data = lanes[static_cast<size_t>(lane)];
+    std::lock_guard lock(data.mutex);
+
+    if (stopped) {
+        return false;
+    }
+
+    Slot& slot = data.messages[static_cast<size_t>(ticket - data.appliedTicket)];
+    slot.apply = std::move(apply);
+    slot.prepared = true;
+
+    return true;
+}
+
+void MessageLanes::State::drain(MessageLane lane) {
+    Lane& data = lanes[static_cast<size_t>(lane)];
+
+    while (!stopped) {
+        Slot slot;
+
+        {
+            std::lock_guard lock(data.mutex);
+
+            if (data.messages.empty() || !data.messages.front().prepared) {
+                return;
+            }
+
+            slot = std::move(data.messages.front());
+            data.messages.pop_front();
+            ++data.appliedTicket;
+        }
+
+        if (slot.apply) {
+            slot.apply();
+        }
+
+        data.latency.add(Clock::now() - slot.received);
+    }
+}
+}  // namespace cs
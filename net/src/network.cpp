@@ -7,9 +7,11 @@
 #ifdef __linux__
 #include <sys/eventfd.h>
 #include <sys/poll.h>
+#include <netinet/udp.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <array>
+#include <cstring>
 #include <vector>
 #endif
 
@@ -34,9 +36,8 @@ using boost::asio::buffer;
 
 const ip::udp::socket::message_flags NO_FLAGS = 0;
 
-static std::atomic<std::chrono::time_point<std::chrono::high_resolution_clock>>
-    last_processed_time{std::chrono::high_resolution_clock::now()};
-const double lag_limit = 1000.;
+// every n-th dropped packet is reported to log
+constexpr uint64_t kDropsLogInterval = 1000;
 
 static ip::udp::socket bindSocket(io_context& context, Network* net, const EndpointData& data, bool ipv6 = true) {
     try {
@@ -100,6 +101,39 @@ ip::udp::socket* Network::getSocketInThread(const bool openOwn, const EndpointDa
     return result;
 }  // resolve
 
+// decodes received packet, returns false if packet must be dropped
+static bool decodeReceived(IPacMan::Task& task, size_t packetSize) {
+    if (!(task.pack.isHeaderValid())) {
+        static constexpr size_t limit = 100;
+        auto size = (task.pack.size() <= limit) ? task.pack.size() : limit;
+
+        cswarning() << "from socket Header is not valid: " << 
+            cs::Utils::byteStreamToHex(static_cast<const char*>(task.pack.data()), size);
+    }
+
+    task.size = task.pack.decode(packetSize);  // try to decode first
+
+    if (task.size == 0) {
+        cswarning() << "Ignore incorrect packet fragment, drop";
+        return false;
+    }
+
+    if (!task.pack.hasValidFragmentation()) {
+        cswarning() << "Incorrect fragment identity in message or too many fragments, drop (" <<
+            task.pack.getFragmentId() << " from " << task.pack.getFragmentsNum() <<
+                "), sender " << task.sender;
+        return false;
+    }
+
+    return true;
+}
+
+static void reportDrops(const char* queueName, uint64_t dropped) {
+    if (dropped % kDropsLogInterval == 1) {
+        cswarning() << "net: " << queueName << " queue is full, " << dropped << " packets dropped";
+    }
+}
+
 void Network::readerRoutine() {
     ip::udp::socket* sock = getSocketInThread(cs::ConfigHolder::instance().config()->hasTwoSockets(),
                                               cs::ConfigHolder::instance().config()->getInputEndpoint(), readerStatus_, cs::ConfigHolder::instance().config()->useIPv6());
@@ -113,6 +147,14 @@ void Network::readerRoutine() {
         std::this_thread::sleep_for(1s);
     }
 
+#ifdef __linux__
+    if (cs::ConfigHolder::instance().config()->useBatchedIO()) {
+        readBatches(sock);
+        cswarning() << "readerRoutine STOPPED!!!\n";
+        return;
+    }
+#endif
+
     boost::system::error_code lastError;
     size_t packetSize = 0;
 
@@ -130,63 +172,21 @@ void Network::readerRoutine() {
             continue;
         }
 
-        double currentLag = std::chrono::duration<double, std::milli>(
-            std::chrono::high_resolution_clock::now() -
-                last_processed_time.load(std::memory_order_relaxed)).count();
-
-        if (currentLag > lag_limit && iPacMan_.getSize() > 2) {
-            while (currentLag > lag_limit && iPacMan_.getSize() > 2) {
-                std::this_thread::yield();
-                packetSize = sock->receive_from(buffer(task.pack.data(), Packet::MaxSize),
-                    task.sender, NO_FLAGS, lastError);
-                currentLag = std::chrono::duration<double, std::milli>(
-                    std::chrono::high_resolution_clock::now() -
-                        last_processed_time.load(std::memory_order_relaxed)).count();
-                if (currentLag < lag_limit || iPacMan_.getSize() < 2) {
-                    task.timestamp = std::chrono::high_resolution_clock::now();
-                    break;
-                }
-                csdetails() << "Current lag = " << currentLag << "ms queue size = " <<
-                    iPacMan_.getSize() << " - spin";
-            }
-        } else {
-            packetSize = sock->receive_from(buffer(task.pack.data(), Packet::MaxSize),
-                task.sender, NO_FLAGS, lastError);
-            task.timestamp = std::chrono::high_resolution_clock::now();
-        }
+        packetSize = sock->receive_from(buffer(task.pack.data(), Packet::MaxSize),
+            task.sender, NO_FLAGS, lastError);
 
         while (!task.pack.region_.get()) {
             cswarning() << "net: invalid input packet";
         }
 
-        if (!(task.pack.isHeaderValid())) {
-            static constexpr size_t limit = 100;
-            auto size = (task.pack.size() <= limit) ? task.pack.size() : limit;
-
-            cswarning() << "from socket Header is not valid: " << 
-                cs::Utils::byteStreamToHex(static_cast<const char*>(task.pack.data()), size);
-        }
-
         if (!lastError) {
-            task.size = task.pack.decode(packetSize);  // try to decode first
-
-            bool reject = false;
-            if (task.size == 0) {
-                cswarning() << "Ignore incorrect packet fragment, drop";
-                reject = true;
-            }
-            else if (!task.pack.hasValidFragmentation()) {
-                cswarning() << "Incorrect fragment identity in message or too many fragments, drop (" <<
-                    task.pack.getFragmentId() << " from " << task.pack.getFragmentsNum() <<
-                        "), sender " << task.sender;
-                reject = true;
-            }
-
-            if (reject) {
+            if (!decodeReceived(task, packetSize)) {
                 iPacMan_.rejectLast();
             }
+            else if (!iPacMan_.enQueueLast()) {
+                reportDrops("input", iPacMan_.getDropped());
+            }
             else {
-                iPacMan_.enQueueLast();
 #ifdef LOG_NET
                 csdebug(logger::Net) << "<-- " << packetSize << " bytes from " << task.sender << " " << task.pack;
 #endif
@@ -216,6 +216,90 @@ void Network::readerRoutine() {
     cswarning() << "readerRoutine STOPPED!!!\n";
 }
 
+#ifdef __linux__
+void Network::readBatches(ip::udp::socket* sock) {
+    std::array<mmsghdr, IPacMan::MaxBatchSize> messages;
+    std::array<iovec, IPacMan::MaxBatchSize> iovecs;
+
+    while (stopReaderRoutine == false) {
+        const size_t count = iPacMan_.allocBatch(IPacMan::MaxBatchSize);
+
+        if (count == 0) {
+            // queue is full, single packet is received to the next free slot or to overflow one,
+            // queue may drain meanwhile, so the packet is decoded and published as in readerRoutine
+            auto& task = iPacMan_.allocNext();
+            boost::system::error_code lastError;
+            const size_t packetSize = sock->receive_from(buffer(task.pack.data(), Packet::MaxSize), task.sender, NO_FLAGS, lastError);
+
+            if (lastError) {
+                cserror() << "Cannot receive packet. Error " << lastError;
+                iPacMan_.rejectLast();
+            }
+            else if (!decodeReceived(task, packetSize)) {
+                iPacMan_.rejectLast();
+            }
+            else if (!iPacMan_.enQueueLast()) {
+                reportDrops("input", iPacMan_.getDropped());
+            }
+            else {
+#ifdef LOG_NET
+                csdebug(logger::Net) << "<-- " << packetSize << " bytes from " << task.sender << " " << task.pack;
+#endif
+                static const uint64_t one = 1;
+                [[maybe_unused]] auto res = write(readerEventfd_, &one, sizeof(uint64_t));
+            }
+
+            continue;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            auto& task = iPacMan_.batchTask(i);
+
+            iovecs[i].iov_base = task.pack.data();
+            iovecs[i].iov_len = Packet::MaxSize;
+
+            messages[i] = mmsghdr{};
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = task.sender.data();
+            messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(task.sender.capacity());
+        }
+
+        // blocks until at least one datagram and takes all the rest already received
+        const int received = recvmmsg(sock->native_handle(), messages.data(), static_cast<unsigned>(count), MSG_WAITFORONE, nullptr);
+
+        if (received < 0) {
+            if (errno != EINTR) {
+                cserror() << "Cannot receive packets, recvmmsg errno = " << errno;
+            }
+
+            continue;
+        }
+
+        uint64_t queued = 0;
+
+        for (int i = 0; i < received; ++i) {
+            auto& task = iPacMan_.batchTask(static_cast<size_t>(i));
+            task.sender.resize(messages[i].msg_hdr.msg_namelen);
+
+            if (!decodeReceived(task, messages[i].msg_len)) {
+                continue;
+            }
+
+#ifdef LOG_NET
+            csdebug(logger::Net) << "<-- " << messages[i].msg_len << " bytes from " << task.sender << " " << task.pack;
+#endif
+            iPacMan_.enQueueBatch(static_cast<size_t>(i));
+            ++queued;
+        }
+
+        if (queued != 0) {
+            [[maybe_unused]] auto res = write(readerEventfd_, &queued, sizeof(uint64_t));
+        }
+    }
+}
+#endif
+
 void Network::sendPackDirect(Packet& pack, const ip::udp::endpoint& ep) {
     boost::system::error_code lastError;
     size_t size = 0;
@@ -281,6 +365,67 @@ static inline void sendPack(ip::udp::socket& sock, TaskPtr<OPacMan>& task, const
 #endif
 }
 
+#ifdef __linux__
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+// UDP generic segmentation offload: kernel splits one message to datagrams of equal size,
+// payload of one message must fit to max udp datagram
+constexpr size_t kMaxGsoSegments = 63;
+using GsoControl = std::array<char, CMSG_SPACE(sizeof(uint16_t))>;
+
+static bool isGsoSupported(int socket) {
+    int value = 0;
+    return setsockopt(socket, SOL_UDP, UDP_SEGMENT, &value, sizeof(value)) == 0;
+}
+
+// joins consecutive packets to the same endpoint into one gso message if gso is on,
+// all segments of message have equal size except the last one, returns count of messages
+static size_t buildMessages(size_t packets, bool gso, std::vector<iovec>& iovecs, std::vector<ip::udp::endpoint>& endpoints,
+                            std::vector<mmsghdr>& messages, std::vector<GsoControl>& controls) {
+    size_t count = 0;
+
+    for (size_t i = 0; i < packets;) {
+        const size_t segmentSize = iovecs[i].iov_len;
+        size_t segments = 1;
+
+        if (gso && segmentSize != 0) {
+            while (i + segments < packets && segments < kMaxGsoSegments && endpoints[i + segments] == endpoints[i] &&
+                   iovecs[i + segments - 1].iov_len == segmentSize && iovecs[i + segments].iov_len <= segmentSize &&
+                   iovecs[i + segments].iov_len != 0) {
+                ++segments;
+            }
+        }
+
+        messages[count] = mmsghdr{};
+        auto& header = messages[count].msg_hdr;
+        header.msg_iov = &iovecs[i];
+        header.msg_iovlen = segments;
+        header.msg_name = endpoints[i].data();
+        header.msg_namelen = static_cast<socklen_t>(endpoints[i].size());
+
+        if (segments > 1) {
+            header.msg_control = controls[count].data();
+            header.msg_controllen = controls[count].size();
+
+            cmsghdr* control = CMSG_FIRSTHDR(&header);
+            control->cmsg_level = SOL_UDP;
+            control->cmsg_type = UDP_SEGMENT;
+            control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+
+            const auto size = static_cast<uint16_t>(segmentSize);
+            std::memcpy(CMSG_DATA(control), &size, sizeof(size));
+        }
+
+        ++count;
+        i += segments;
+    }
+
+    return count;
+}
+#endif
+
 void Network::writerRoutine() {
     ip::udp::socket* sock = getSocketInThread(cs::ConfigHolder::instance().config()->hasTwoSockets(),
                                               cs::ConfigHolder::instance().config()->getOutputEndpoint(), writerStatus_, cs::ConfigHolder::instance().config()->useIPv6());
@@ -295,6 +440,14 @@ void Network::writerRoutine() {
     std::vector<std::array<char, Packet::MaxSize>> packets_buffer;
     std::vector<boost::asio::mutable_buffer> encoded_packets;
     std::vector<ip::udp::endpoint> endpoints;
+    std::vector<GsoControl> controls;
+
+    bool gso = false;
+
+    if (cs::ConfigHolder::instance().config()->useBatchedIO()) {
+        gso = isGsoSupported(sock->native_handle());
+        csinfo() << "net: batched io is enabled, UDP GSO is " << (gso ? "supported" : "not supported");
+    }
 #endif
     while (stopWriterRoutine == false) {  // changed from true
 #ifdef __linux__
@@ -308,14 +461,13 @@ void Network::writerRoutine() {
             csdetails() << "(informational) current task quantity more then normal: " << tasks;
         }
 
-        uint64_t all_tasks = tasks;
-        while (all_tasks != 0) {
-            if (all_tasks >= 1000) {
-                tasks = 1000;
-                all_tasks -= 1000;
-            } else {
-                tasks = all_tasks;
-                all_tasks = 0;
+        // queue is drained until empty, notifications count only wakes writer up,
+        // packet of concurrent sender may be published after the next one
+        while (true) {
+            tasks = std::min<uint64_t>(oPacMan_.getSize(), 1000);
+
+            if (tasks == 0) {
+                break;
             }
 
             msg.resize(tasks);
@@ -324,16 +476,23 @@ void Network::writerRoutine() {
             std::fill(iovecs.begin(), iovecs.end(), iovec{});
             packets_buffer.resize(tasks);
             endpoints.resize(tasks);
+            controls.resize(tasks);
             encoded_packets.clear();
 
             int j = 0;
+            bool unpublished = false;
             for (uint64_t i = 0; i < tasks; i++) {
                 bool is_empty = false;
                 auto task = oPacMan_.getNextTask(is_empty);
-                if (is_empty) break;
+                if (is_empty) {
+                    // its sender notifies writer again after publishing
+                    unpublished = true;
+                    break;
+                }
                 std::atomic_thread_fence(std::memory_order_acquire);
                 if (!task->pack.region_.get()) {
                     cswarning() << "net: invalid packet for send!!!!!!!!! " << task->pack.region_.get();
+                    task.release();
                     continue;
                 }
 
@@ -341,6 +500,7 @@ void Network::writerRoutine() {
                     static constexpr size_t limit = 100;
                     auto size = (task->pack.size() <= limit) ? task->pack.size() : limit;
                     cswarning() << "socket Header is not valid: " << cs::Utils::byteStreamToHex(static_cast<const char*>(task->pack.data()), size);
+                    task.release();
                     continue;
                 }
 
@@ -352,32 +512,42 @@ void Network::writerRoutine() {
                 endpoints[j] = task->endpoint;
                 iovecs[j].iov_base = encoded_packets[j].data();
                 iovecs[j].iov_len = encoded_packets[j].size();
-                msg[j].msg_hdr.msg_iov = &iovecs[j];
-                msg[j].msg_hdr.msg_iovlen = 1;
-                msg[j].msg_hdr.msg_name = endpoints[j].data();
-                msg[j].msg_hdr.msg_namelen = endpoints[j].size();
                 task.release();
                 ++j;
             }
             if (j == 0) {
+                if (unpublished) {
+                    break;
+                }
+
                 continue;
             }
 
-            tasks = j;
+            tasks = buildMessages(static_cast<size_t>(j), gso, iovecs, endpoints, msg, controls);
 
             int sended = 0;
             struct mmsghdr* messages = msg.data();
             do {
-                sended = sendmmsg(sock->native_handle(), messages, tasks, 0);
+                sended = sendmmsg(sock->native_handle(), messages, static_cast<unsigned>(tasks), 0);
                 if (sended < 0) {
                     cswarning() << "sendmmsg errno = " << errno;
+                    if (errno == EIO && gso) {
+                        // device can not segment, the rest of batch is lost as any udp packets may be
+                        cswarning() << "net: UDP GSO is not supported by network device, disabled";
+                        gso = false;
+                    }
                     if (errno != EAGAIN)
                         break;
+                    continue;
                 }
                 messages += sended;
-                tasks -= sended;
+                tasks -= static_cast<uint64_t>(sended);
             } while (tasks);
-        };
+
+            if (unpublished) {
+                break;
+            }
+        }
 #endif
 #if defined(WIN32) || defined(__APPLE__)
 #ifdef WIN32
@@ -397,6 +567,7 @@ void Network::writerRoutine() {
             if (is_empty) break;
             if (!task->pack.region_.get()) {
                 cswarning() << "net: invalid packet!!!!!!!!!";
+                task.release();
                 continue;
             }
             sendPack(*sock, task, task->endpoint);
@@ -444,10 +615,10 @@ void Network::processorRoutine() {
             if (is_empty) break;
             if (!task->pack.region_.get()) {
                 cswarning() << "net: invalid packet processor!!!!!!!!!";
+                task.release();
                 continue;
             }
             processTask(task);
-            last_processed_time.store(task->timestamp, std::memory_order_relaxed);
             task.release();
         }
 #endif
@@ -480,7 +651,6 @@ void Network::processorRoutine() {
             auto task = iPacMan_.getNextTask(is_empty);
             if (is_empty) break;
             processTask(task);
-            last_processed_time.store(task->timestamp, std::memory_order_relaxed);
             task.release();
         }
 #endif
@@ -561,8 +731,6 @@ inline void Network::processTask(TaskPtr<IPacMan>& task) {
 }
 
 void Network::sendDirect(const Packet& p, const ip::udp::endpoint& ep) {
-    auto qePtr = oPacMan_.allocNext();
-
     if (ep.size() > 16) {
         cswarning() << "endpoint address too big " << ep.size();
         const uint8_t* ptr = reinterpret_cast<const uint8_t*>(ep.data());
@@ -573,10 +741,12 @@ void Network::sendDirect(const Packet& p, const ip::udp::endpoint& ep) {
     while (!p.region_.get()) {
         cswarning() << "net: invalid packet for sendDirect!!!!!!!!! ";
     }
-    qePtr->endpoint = ep;
-    qePtr->pack = p;
 
-    oPacMan_.enQueueLast();
+    if (!oPacMan_.enQueue(ep, p)) {
+        reportDrops("output", oPacMan_.getDropped());
+        return;
+    }
+
 #ifdef __linux__
     static uint64_t one = 1;
     [[maybe_unused]] auto res = write(writerEventfd_, &one, sizeof(uint64_t));
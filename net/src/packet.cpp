@@ -1,6 +1,9 @@
 #include <lz4.h>
 
+#include <algorithm>
+
 #include <lib/system/utils.hpp>
+#include "erasurecoder.hpp"
 #include "packet.hpp"
 #include "transport.hpp"  // for NetworkCommand
 
@@ -160,6 +163,17 @@ MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMs
         return MessagePtr();
     }
 
+    uint32_t dataPacketsNum = pack.getFragmentsNum();
+
+    if (pack.isErasureCoded()) {
+        dataPacketsNum = cs::ErasureCoder::dataShards(dataPacketsNum);
+
+        if (dataPacketsNum == 0) {
+            cswarning() << "COLLECT> erasure coded message has invalid fragments count " << pack.getFragmentsNum();
+            return MessagePtr();
+        }
+    }
+
     newFragmentedMsg = false;
 
     MessagePtr* msgPtr;
@@ -167,13 +181,21 @@ MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMs
 
     {
         cs::Lock l(mLock_);
+
+        // repair fragments may come after the message is processed, they must not start collecting it again
+        auto completed = completed_.find(pack.getHeaderHash());
+        if (completed && std::chrono::steady_clock::now() - *completed < CompletedMessageTtl) {
+            return MessagePtr();
+        }
+
         msgPtr = &map_.tryStore(pack.getHeaderHash());
     }
 
     if (!*msgPtr) {  // First time
         *msgPtr = msg = msgAllocator_.emplace();
-        msg->packetsLeft_ = pack.getFragmentsNum();
+        msg->packetsLeft_ = dataPacketsNum;
         msg->packetsTotal_ = pack.getFragmentsNum();
+        msg->dataPacketsNum_ = dataPacketsNum;
         msg->packets_.resize(msg->packetsTotal_);
         msg->headerHash_ = pack.getHeaderHash();
         newFragmentedMsg = true;
@@ -190,8 +212,17 @@ MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMs
         auto& goodPlace = msg->packets_[pack.getFragmentId()]; // valid fragmentation has already been tested
         if (!goodPlace) {
             msg->maxFragment_ = std::max(pack.getFragmentsNum(), msg->maxFragment_);
-            --msg->packetsLeft_;
             goodPlace = pack;
+
+            // repair fragments of erasure coded message may come after it is complete
+            if (msg->packetsLeft_ != 0 && --msg->packetsLeft_ == 0 && msg->dataPacketsNum_ < msg->packetsTotal_) {
+                if (!msg->recoverFragments()) {
+                    cswarning() << "COLLECT> can not recover erasure coded message, collect it again";
+
+                    msg->packets_.assign(msg->packetsTotal_, Packet());
+                    msg->packetsLeft_ = msg->dataPacketsNum_;
+                }
+            }
         }
 
         if (msg->packetsTotal_ >= 20) {
@@ -212,23 +243,123 @@ MessagePtr PacketCollector::getMessage(const Packet& pack, bool& newFragmentedMs
 }
 
 void PacketCollector::dropMessage(MessagePtr msg) {
-    (*msg)->packetsLeft_ = (*msg)->packetsTotal_;
+    {
+        cs::Lock l(mLock_);
+        completed_.tryStore((*msg)->headerHash_) = std::chrono::steady_clock::now();
+    }
+
+    (*msg)->packetsLeft_ = (*msg)->dataPacketsNum_;
     (*msg)->packets_.clear();
 }
 
+bool Message::recoverFragments() {
+    auto isPresent = [](const Packet& pack) { return static_cast<bool>(pack); };
+
+    const auto dataEnd = packets_.begin() + dataPacketsNum_;
+
+    if (std::all_of(packets_.begin(), dataEnd, isPresent)) {
+        return true;
+    }
+
+    // data fragments are of the same size except the last one, repair fragment has its size before the parity
+    const auto repairIter = std::find_if(dataEnd, packets_.end(), isPresent);
+
+    if (repairIter == packets_.end()) {
+        return false;
+    }
+
+    const Packet& repair = *repairIter;
+    const uint32_t headersLength = repair.getHeadersLength();
+
+    if (repair.size() <= headersLength + sizeof(uint16_t)) {
+        return false;
+    }
+
+    const size_t shardSize = repair.size() - headersLength - sizeof(uint16_t);
+    const size_t lastSize = *reinterpret_cast<const uint16_t*>(repair.getMsgData());
+
+    if (lastSize == 0 || lastSize > shardSize) {
+        return false;
+    }
+
+    std::vector<const cs::Byte*> shards(packetsTotal_, nullptr);
+    std::vector<cs::Byte*> recovered(dataPacketsNum_, nullptr);
+    cs::Bytes lastShard;
+
+    for (uint32_t i = 0; i < packetsTotal_; ++i) {
+        const Packet& pack = packets_[i];
+
+        if (!pack) {
+            continue;
+        }
+
+        const bool isData = i < dataPacketsNum_;
+        const size_t expectedSize = isData ? (i + 1 == dataPacketsNum_ ? lastSize : shardSize) : shardSize + sizeof(uint16_t);
+
+        if (pack.getHeadersLength() != headersLength || pack.getMsgSize() != expectedSize) {
+            return false;
+        }
+
+        shards[i] = isData ? pack.getMsgData() : pack.getMsgData() + sizeof(uint16_t);
+
+        // the last data shard is padded by zeros
+        if (i + 1 == dataPacketsNum_ && lastSize < shardSize) {
+            lastShard.assign(shards[i], shards[i] + lastSize);
+            lastShard.resize(shardSize, 0);
+            shards[i] = lastShard.data();
+        }
+    }
+
+    std::vector<Packet> restored(dataPacketsNum_);
+
+    for (uint32_t i = 0; i < dataPacketsNum_; ++i) {
+        if (packets_[i]) {
+            continue;
+        }
+
+        restored[i] = Packet(allocator_.allocateNext(static_cast<uint32_t>(headersLength + shardSize)));
+
+        auto data = static_cast<cs::Byte*>(restored[i].data());
+        std::copy(static_cast<const cs::Byte*>(repair.data()), static_cast<const cs::Byte*>(repair.data()) + headersLength, data);
+        *reinterpret_cast<uint16_t*>(data + Offsets::FragmentId) = static_cast<uint16_t>(i);
+
+        recovered[i] = data + headersLength;
+    }
+
+    if (!cs::ErasureCoder::decode(shards, dataPacketsNum_, recovered, shardSize)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < dataPacketsNum_; ++i) {
+        if (restored[i]) {
+            if (i + 1 == dataPacketsNum_) {
+                restored[i].setSize(static_cast<uint32_t>(headersLength + lastSize));
+            }
+
+            packets_[i] = restored[i];
+        }
+    }
+
+    csdetails() << "COLLECT> recovered " << std::count_if(restored.begin(), restored.end(), isPresent) << " of " << dataPacketsNum_ << " fragments";
+    return true;
+}
+
 /* WARN: All the cases except FRAG + COMPRESSED have bugs in them */
 void Message::composeFullData() const {
     if (getFirstPack().isFragmented()) {
         uint32_t headersLength = packets_[0].getHeadersLength();
         uint32_t totalSize = headersLength;
 
-        for (auto& pack: packets_) {
-            totalSize += static_cast<uint32_t>((pack.size() - headersLength));
+        // repair fragments of erasure coded message are not the part of data
+        const auto packetsEnd = getFirstPack().isErasureCoded() ? packets_.begin() + dataPacketsNum_ : packets_.end();
+
+        for (auto pack = packets_.begin(); pack != packetsEnd; ++pack) {
+            totalSize += static_cast<uint32_t>((pack->size() - headersLength));
         }
 
         fullData_ = allocator_.allocateNext(totalSize);
         uint8_t* data = static_cast<uint8_t*>(fullData_->data());
-        for (auto pack = packets_.begin(), end = packets_.end(); pack != end; ++pack) {
+        for (auto pack = packets_.begin(), end = packetsEnd; pack != end; ++pack) {
             uint32_t headerSize = static_cast<uint32_t>((pack == packets_.begin()) ? 0 : headersLength);
 
             uint32_t cSize = cs::numeric_cast<uint32_t>(pack->size()) - headerSize;
@@ -269,6 +400,11 @@ public:
             ++n;
         }
 
+        if (packet_.isErasureCoded()) {
+            os << (n ? ", " : "") << "erasure coded";
+            ++n;
+        }
+
         return os;
     }
 
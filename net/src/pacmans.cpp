@@ -1,71 +1,129 @@
 #include "pacmans.hpp"
 
+#include <algorithm>
+
 IPacMan::Task& IPacMan::allocNext() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.emplace_back();
-    auto end = queue_.end();
-    Task& task = *(--end);
-    task.pack.region_ = allocator_.allocateNext(Packet::MaxSize);
-    return task;
+    last_ = queue_.back();
+
+    if (last_ == nullptr) {
+        last_ = &overflow_;
+    }
+
+    prepare(*last_);
+    return *last_;
 }
 
-void IPacMan::enQueueLast() {
-    Task& task = queue_.back();
-    task.pack.setSize(static_cast<uint32_t>(task.size));
+bool IPacMan::enQueueLast() {
+    if (last_ == &overflow_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
 
-    size_.fetch_add(1, std::memory_order_acq_rel);
+    last_->pack.setSize(static_cast<uint32_t>(last_->size));
+    queue_.push();
+    return true;
 }
 
 void IPacMan::rejectLast() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.pop_back();
+    last_ = nullptr;
+}
+
+size_t IPacMan::allocBatch(size_t count) {
+    count = std::min<size_t>(count, MaxBatchSize);
+
+    for (size_t i = 0; i < count; ++i) {
+        batch_[i] = queue_.back(i);
+
+        if (batch_[i] == nullptr) {
+            return i;
+        }
+
+        prepare(*batch_[i]);
+    }
+
+    return count;
+}
+
+void IPacMan::enQueueBatch(size_t index) {
+    Task* task = queue_.back();
+
+    // previous tasks of batch are rejected, so accepted one takes the first unpublished slot
+    if (task != batch_[index]) {
+        std::swap(*task, *batch_[index]);
+    }
+
+    task->pack.setSize(static_cast<uint32_t>(task->size));
+    queue_.push();
+}
+
+void IPacMan::prepare(Task& task) {
+    // region is reused if packet of previous round is not held by anybody else
+    RegionPtr region = std::move(task.pack.region_);
+
+    if (region && region.use_count() == 1) {
+        region->setSize(Packet::MaxSize);
+    }
+    else {
+        region = allocator_.allocateNext(Packet::MaxSize);
+    }
+
+    task.pack = Packet(std::move(region));
 }
 
-TaskPtr<IPacMan> IPacMan::getNextTask(bool &is_empty) {
+TaskPtr<IPacMan> IPacMan::getNextTask(bool& is_empty) {
     TaskPtr<IPacMan> result;
-    if (!size_.load(std::memory_order_acquire)) {
+    Task* task = queue_.front();
+
+    if (task == nullptr) {
         is_empty = true;
         return result;
     }
-    std::lock_guard<std::mutex> lock(mutex_);
+
     result.owner_ = this;
-    result.it_ = queue_.begin();
+    result.it_ = task;
 
     return result;
 }
 
-void IPacMan::releaseTask(TaskIterator& it) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.erase(it);
-    size_.fetch_sub(1, std::memory_order_acq_rel);
+void IPacMan::releaseTask(TaskIterator&) {
+    queue_.pop();
 }
 
-OPacMan::Task* OPacMan::allocNext() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.emplace_back();
-    auto end = queue_.end();
-    Task& task = *(--end);
-    return &task;
-}
+bool OPacMan::enQueue(const ip::udp::endpoint& endpoint, const Packet& pack) {
+    auto fill = [&](Task& task) {
+        task.endpoint = endpoint;
+        task.pack = pack;
+    };
+
+    for (size_t attempt = 0; attempt < MaxPushAttempts; ++attempt) {
+        if (queue_.tryPush(fill)) {
+            return true;
+        }
+
+        std::this_thread::yield();
+    }
 
-void OPacMan::enQueueLast() {
-    size_.fetch_add(1, std::memory_order_acq_rel);
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
 }
 
-TaskPtr<OPacMan> OPacMan::getNextTask(bool &is_empty) {
+TaskPtr<OPacMan> OPacMan::getNextTask(bool& is_empty) {
     TaskPtr<OPacMan> result;
-    if (!size_.load(std::memory_order_acquire)) {
+    Task* task = queue_.front();
+
+    if (task == nullptr) {
         is_empty = true;
         return result;
     }
-    std::lock_guard<std::mutex> lock(mutex_);
+
     result.owner_ = this;
-    result.it_ = queue_.begin();
+    result.it_ = task;
+
     return result;
 }
 
 void OPacMan::releaseTask(TaskIterator& it) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.erase(it);
-    size_.fetch_sub(1, std::memory_order_acq_rel);
+    // sent packet region is not needed by queue any more
+    it->pack = Packet();
+    queue_.pop();
 }
@@ -8,6 +8,7 @@
 #include <csnode/configholder.hpp>
 
 #include <lib/system/allocators.hpp>
+#include <lib/system/scopeguard.hpp>
 #include <lib/system/utils.hpp>
 
 #include <thread>
@@ -153,6 +154,9 @@ void Transport::run() {
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
 
+    // node is going down, queued bulk messages must not reach it
+    lanes_.stop();
+
     cswarning() << "[Transport::run STOPED!]";
 }
 
@@ -698,6 +702,10 @@ void Transport::processPostponed(const cs::RoundNumber rNum) {
     postponed_[0] = &ppBuf;
 
     csdebug() << "TRANSPORT> POSTPHONED finished, round " << rNum;
+
+    if (rNum % lanesReportRounds_ == 0) {
+        lanes_.report();
+    }
 }
 
 void Transport::dispatchNodeMessage(const MsgTypes type, const cs::RoundNumber rNum, const Packet& firstPack, const uint8_t* data, size_t size) {
@@ -712,12 +720,19 @@ void Transport::dispatchNodeMessage(const MsgTypes type, const cs::RoundNumber r
         return;
     }
 
+    // bulk messages are measured by their lanes
+    const auto received = cs::MessageLanes::Clock::now();
+    auto latencyGuard = cs::scopeGuard([&] {
+        lanes_.record(cs::MessageLane::Consensus, received);
+    });
+
     // never cut packets
     switch (type) {
         case MsgTypes::BlockRequest:
             return node_->getBlockRequest(data, size, firstPack.getSender());
         case MsgTypes::RequestedBlock:
-            return node_->getBlockReply(data, size);
+            latencyGuard.dismiss();
+            return dispatchBulkMessage(type, rNum, firstPack, data, size);
         case MsgTypes::BigBang:  // any round (in theory) may be set
             return node_->getBigBang(data, size, rNum);
         case MsgTypes::Utility:  // managing info could be obtained  
@@ -753,11 +768,13 @@ void Transport::dispatchNodeMessage(const MsgTypes type, const cs::RoundNumber r
         case MsgTypes::HashReply:
             return node_->getHashReply(data, size, rNum, firstPack.getSender());
         case MsgTypes::TransactionPacket:
-            return node_->getTransactionsPacket(data, size, firstPack.getSender());
+            latencyGuard.dismiss();
+            return dispatchBulkMessage(type, rNum, firstPack, data, size);
         case MsgTypes::TransactionsPacketRequest:
             return node_->getPacketHashesRequest(data, size, rNum, firstPack.getSender());
         case MsgTypes::TransactionsPacketReply:
-            return node_->getPacketHashesReply(data, size, rNum, firstPack.getSender());
+            latencyGuard.dismiss();
+            return dispatchBulkMessage(type, rNum, firstPack, data, size);
         case MsgTypes::FirstStage:
             return node_->getStageOne(data, size, firstPack.getSender());
         case MsgTypes::SecondStage:
@@ -791,7 +808,8 @@ void Transport::dispatchNodeMessage(const MsgTypes type, const cs::RoundNumber r
         case MsgTypes::StateRequest:
             return node_->getStateRequest(data, size, rNum, firstPack.getSender());
         case MsgTypes::StateReply:
-            return node_->getStateReply(data, size, rNum, firstPack.getSender());
+            latencyGuard.dismiss();
+            return dispatchBulkMessage(type, rNum, firstPack, data, size);
         case MsgTypes::BlockAlarm:
             return node_->getBlockAlarm(data, size, rNum, firstPack.getSender());
         case MsgTypes::EventReport:
@@ -802,6 +820,27 @@ void Transport::dispatchNodeMessage(const MsgTypes type, const cs::RoundNumber r
     }
 }
 
+void Transport::dispatchBulkMessage(const MsgTypes type, const cs::RoundNumber rNum, const Packet& firstPack, const uint8_t* data, size_t size) {
+    // message memory is released after dispatch
+    auto prepare = [node = node_, type, rNum, sender = firstPack.getSender(), bytes = cs::Bytes(data, data + size)]() -> cs::MessageLanes::Apply {
+        switch (type) {
+            case MsgTypes::TransactionPacket:
+                return node->prepareTransactionsPacket(bytes.data(), bytes.size(), sender);
+            case MsgTypes::TransactionsPacketReply:
+                return node->preparePacketHashesReply(bytes.data(), bytes.size(), rNum, sender);
+            case MsgTypes::RequestedBlock:
+                return node->prepareBlockReply(bytes.data(), bytes.size());
+            case MsgTypes::StateReply:
+                return node->prepareStateReply(bytes.data(), bytes.size(), rNum, sender);
+            default:
+                cserror() << "TRANSPORT> Message type " << Packet::messageTypeToString(type) << " is not bulk one";
+                return cs::MessageLanes::Apply();
+        }
+    };
+
+    lanes_.process(cs::MessageLanes::classify(type), std::move(prepare));
+}
+
 void Transport::registerTask(Packet* pack, const uint32_t packNum, const bool incrementWhenResend) {
     auto end = pack + packNum;
 
@@ -1541,6 +1580,11 @@ void Transport::askForMissingPackages() {
         {
             cs::Lock messageLock(msg->pLock_);
 
+            // erasure coded message is complete without some of repair fragments
+            if (msg->isComplete()) {
+                continue;
+            }
+
             uint16_t start = 0;
             uint64_t mask = 0;
             uint64_t req = 0;
@@ -6,8 +6,10 @@
 #include <cstdint>
 #include <functional>
 #include <map>
-#include <set>
 #include <thread>
+#include <vector>
+
+#include <lib/system/timerwheel.hpp>
 
 // template<typename TResol = std::chrono::milliseconds>
 class CallsQueueScheduler {
@@ -37,9 +39,7 @@ public:
      * @date    17.09.2018
      */
 
-    CallsQueueScheduler()
-    : _queue(compare) {
-    }
+    CallsQueueScheduler() = default;
 
     CallsQueueScheduler(const CallsQueueScheduler&) = delete;
     CallsQueueScheduler& operator=(const CallsQueueScheduler&) = delete;
@@ -230,32 +230,23 @@ private:
      */
 
     struct Context {
-        /** @brief   The identifier: lets find item in queue (e.g. for remove) */
-        CallTag id;
-
-        /** @brief   The time point for scheduled execution */
-        ClockType::time_point tp;
-
         /** @brief   The delta - time period for periodic calls */
         long long dt;
 
         /** @brief   The procedure to call*/
         ProcType proc;
-
-        // support for std::find() by id
-        bool operator==(const CallTag rhs) const {
-            return id == rhs;
-        }
     };
 
-    // used for sort items in _queue by time to call
-    std::function<bool(const Context& lhs, const Context& rhs)> compare = [](const Context& lhs, const Context& rhs) { return lhs.tp < rhs.tp; };
+    using Queue = cs::TimerWheel<Context, CallTag>;
 
-    // container requirements: auto sort by tp, search by id
-    std::multiset<Context, decltype(compare)> _queue;
+    // scheduled calls by time to call, O(1) insert and remove by id
+    Queue _queue;
     // sync access to _queue
     std::mutex _mtx_queue;
 
+    // calls expired at once, reused to avoid allocation
+    std::vector<Queue::Expired> _expired;
+
     // process _queue and puts on time calls into CallsQueue::instance() object
     std::thread _worker;
 
@@ -15,6 +15,7 @@
 #include <list>
 #include <mutex>
 #include <optional>
+#include <set>
 #include <vector>
 
 //#define DEBUG_SMARTS
@@ -311,6 +312,22 @@ using SmartContractExecutedSignal = cs::Signal<void(cs::TransactionsPacket)>;
 // passes to every slot the "starter" transaction
 using SmartContractSignal = cs::Signal<void(const csdb::Transaction&)>;
 
+// order of committing results of concurrently executed queue items,
+// result waits only for older awaited items touching the same contracts, so hung contract holds back its dependants only
+class ExecutionCommitOrder {
+public:
+    using Contracts = std::set<csdb::Address>;
+
+    struct Item {
+        Contracts contracts;
+        // result is ready to commit
+        bool completed = false;
+    };
+
+    // items are awaited ones in queue order, returns indexes of items to commit now in queue order
+    static std::vector<size_t> ready(const std::vector<Item>& items);
+};
+
 class SmartContracts final {
 public:
     explicit SmartContracts(BlockChain&, CallsQueueScheduler&);
@@ -481,7 +498,8 @@ public slots:
     // called when execute_async() completed
     void on_execution_completed(const std::vector<SmartExecutionData>& data_list) {
         cs::Lock lock(public_access_lock);
-        on_execution_completed_impl(data_list);
+        completed_executions.push_back(data_list);
+        commit_completed_executions();
     }
 
     // called when next block is stored
@@ -607,6 +625,8 @@ private:
         bool is_executor;
         // is rejected by consensus
         bool is_rejected;
+        // execution is started by this node, its result is awaited
+        bool is_dispatched;
         // actual consensus
         std::unique_ptr<SmartConsensus> pconsensus;
 
@@ -620,6 +640,7 @@ private:
             abs_addr = src.abs_addr;
             is_executor = src.is_executor;
             is_rejected = src.is_rejected;
+            is_dispatched = src.is_dispatched;
             if (!src.executions.empty()) {
                 executions.assign(src.executions.cbegin(), src.executions.cend());
             }
@@ -633,7 +654,8 @@ private:
             , seq_finish(0)
             , abs_addr(absolute_address)
             , is_executor(false)
-            , is_rejected(false) {
+            , is_rejected(false)
+            , is_dispatched(false) {
 
             add(ref_contract, tr_start);
         }
@@ -649,6 +671,7 @@ private:
             tmp.abs_addr = abs_addr;
             tmp.is_executor = is_executor;
             tmp.is_rejected = is_rejected;
+            tmp.is_dispatched = is_dispatched;
             return tmp;
         }
 
@@ -661,6 +684,9 @@ private:
     // requirements: items are non-movable during the whole life cycle
     std::list<QueueItem> exe_queue;
 
+    // independent contracts are executed concurrently, their results wait here to be committed in queue order
+    std::list<std::vector<SmartExecutionData>> completed_executions;
+
     // is locked in all non-static public methods
     // is locked in const methods also
     //mutable cs::SpinLock public_access_lock = ATOMIC_FLAG_INIT;
@@ -833,6 +859,12 @@ private:
 
     void on_execution_completed_impl(const std::vector<SmartExecutionData>& data_list);
 
+    // passes completed executions to on_execution_completed_impl(), see ExecutionCommitOrder
+    void commit_completed_executions();
+
+    // contract of item and contracts used by its executions
+    ExecutionCommitOrder::Contracts touched_contracts(const QueueItem& item) const;
+
     // exe_queue item modifiers
 
     void update_status(QueueItem& item, cs::RoundNumber r, SmartContractStatus status, bool skip_log);
@@ -1,93 +1,66 @@
 #include "callsqueuescheduler.hpp"
-#include <algorithm>
 #include <lib/system/utils.hpp>  // CallsQueue
 
 void CallsQueueScheduler::SchedulerProc() {
-    bool signaled{false};
-    constexpr long long min_wait_for = 5;
     while (!_stop) {
         // get earliest action time
         auto earliest = ClockType::now() + std::chrono::seconds(60);
         {
             std::lock_guard<std::mutex> lque(_mtx_queue);
-            if (!_queue.empty()) {
-                earliest = _queue.cbegin()->tp;
+            if (auto next = _queue.nextExpiry(); next.has_value() && next.value() < earliest) {
+                earliest = next.value();
             }
         }
         // sleep until scheduled event and get ready to awake at any time
-        std::unique_lock<std::mutex> lsig(_mtx_signal);
-        signaled = _signal.wait_until(lsig, earliest, [this]() { return _flag; });  // std::system_error!
+        {
+            std::unique_lock<std::mutex> lsig(_mtx_signal);
+            _signal.wait_until(lsig, earliest, [this]() { return _flag; });  // std::system_error!
+            // reset _flag for the next signal, awake by direct notification re-schedules next timeout
+            _flag = false;
+        }
         // test stop condition before reaction
         if (_stop) {
             break;
         }
-        // event occurs
-        if (signaled) {
-            // reset _flag for the next signal
-            _flag = false;
-            // awake by direct notification: re-schedule next timeout
-            std::lock_guard<std::mutex> lque(_mtx_queue);
-            if (!_queue.empty()) {
-                // test whether to call immediately
-                if ((_queue.cbegin()->tp - ClockType::now()).count() >= min_wait_for) {
-                    // schedule next wait period
-                    continue;
-                }
-                // fall through to execute proc now (either timeout almost coincided with the signal, or proc is scheduled with
-                // tiny wait_for)
+        std::lock_guard<std::mutex> lque(_mtx_queue);
+        // all the calls expired by now are taken at once
+        _expired.clear();
+        _queue.expire(ClockType::now(), _expired);
+        for (auto& item : _expired) {
+            const CallTag id = item.key;
+            Context& run = item.value;
+            // push to CallsQueue only if there are no any previous calls
+            if (CanExe(id)) {
+                OnExeQueued(id);
+                CallsQueue::instance().insert([this, id, proc = run.proc]() {
+                    {
+                        std::lock_guard<std::mutex> lque(_mtx_queue);
+                        if (!ConfirmExe(id)) {
+                            // its highly likely the job was canceled
+                            return;
+                        }
+                    }
+                    // call out of lock to avoid recursive mutex locking if proc to insert another scheduled call
+                    proc();
+                    {
+                        std::lock_guard<std::mutex> lque(_mtx_queue);
+                        OnExeDone(id);
+                    }
+                });
+                _cnt_total += 1;
             }
             else {
-                // queue is empty, schedule next wait period
-                continue;
+                _cnt_block_exe += 1;
             }
-        }
-        // awake due timeout: the most probable its time to execute earliest proc
-        // test scheduled time (if it was at all)
-        Context run;
-        run.id = no_tag;
-        {
-            std::lock_guard<std::mutex> lque(_mtx_queue);
-            // execute calls until wait time >= min_wait_for
-            while (!_queue.empty()) {
-                if ((_queue.cbegin()->tp - ClockType::now()).count() >= min_wait_for) {
-                    break;
-                }
-                run = *_queue.cbegin();
-                _queue.erase(_queue.cbegin());
-                ProcType proc = run.proc;
-                // push to CallsQueue only if there are no any previous calls
-                if (CanExe(run.id)) {
-                    OnExeQueued(run.id);
-                    CallsQueue::instance().insert([this, run]() {
-                        {
-                            std::lock_guard<std::mutex> lque(_mtx_queue);
-                            if (!ConfirmExe(run.id)) {
-                                // its highly likely the job was canceled
-                                return;
-                            }
-                        }
-                        // call out of lock to avoid recursive mutex locking if proc to insert another scheduled call
-                        run.proc();
-                        {
-                            std::lock_guard<std::mutex> lque(_mtx_queue);
-                            OnExeDone(run.id);
-                        }
-                    });
-                    _cnt_total += 1;
-                }
-                else {
-                    _cnt_block_exe += 1;
-                }
-                // Launch::periodic -> schedule next item
-                if (run.dt > 0) {
-                    run.tp = ClockType::now() + std::chrono::milliseconds(run.dt);
-                    auto pos = _queue.insert(run);
-                    if (pos == _queue.end()) {
-                        // periodic calls aborted due to unexpected problem!
-                    }
+            // Launch::periodic -> schedule next item
+            if (run.dt > 0) {
+                const auto tp = ClockType::now() + std::chrono::milliseconds(run.dt);
+                if (!_queue.insert(id, tp, std::move(run))) {
+                    // periodic calls aborted due to unexpected problem!
                 }
             }
         }
+        _expired.clear();
     }
 }
 
@@ -152,8 +125,7 @@ CallsQueueScheduler::CallTag CallsQueueScheduler::Insert(ClockType::duration wai
     CallTag id = (tag == auto_tag ? proc.target_type().hash_code() : tag);
     {
         std::lock_guard<std::mutex> l(_mtx_queue);
-        auto it = std::find(_queue.cbegin(), _queue.cend(), id);
-        if (it != _queue.cend()) {
+        if (_queue.contains(id)) {
             if (!replace_existing) {
                 // reject schedule, the one already added before and still in queue
                 _cnt_block_que += 1;
@@ -161,16 +133,15 @@ CallsQueueScheduler::CallTag CallsQueueScheduler::Insert(ClockType::duration wai
             }
             else {
                 // remove from queue, below we will add a new schedule
-                csdebug() << "Erasing existing calls: " << it->id;
-                _queue.erase(it);
+                csdebug() << "Erasing existing calls: " << id;
+                _queue.remove(id);
             }
         }
         // add new item
-        auto result = _queue.insert(CallsQueueScheduler::Context{
-            id, ClockType::now() + wait_for, (scheme == Launch::once ? 0 : std::chrono::duration_cast<std::chrono::milliseconds>(wait_for).count()), std::move(proc)
-            //, std::move(comment)
+        auto result = _queue.insert(id, ClockType::now() + wait_for, CallsQueueScheduler::Context{
+            (scheme == Launch::once ? 0 : std::chrono::duration_cast<std::chrono::milliseconds>(wait_for).count()), proc
         });
-        if (result == _queue.end()) {
+        if (!result) {
             return no_tag;
         }
     }
@@ -188,11 +159,9 @@ bool CallsQueueScheduler::Remove(CallsQueueScheduler::CallTag id) {
         if (it_sync != _exe_sync.end()) {
             it_sync->second.queued = it_sync->second.done;
         }
-        auto it = std::find(_queue.cbegin(), _queue.cend(), id);
-        if (it == _queue.cend()) {
+        if (!_queue.remove(id)) {
             return false;
         }
-        _queue.erase(it);
     }
     // awake worker thread to re-schedule its waiting
     _flag = true;
@@ -682,6 +682,13 @@ void SmartContracts::enqueue(const csdb::Pool& block, size_t trx_idx, bool skip_
 }
 
 void SmartContracts::test_exe_queue(bool reading_db) {
+    // results of executions not awaited any more must not stay buffered
+    commit_completed_executions();
+
+    // contracts touched by blocked items, newer items must not overtake them
+    std::set<csdb::Address> claimed;
+    size_t dispatched = 0;
+
     // update queue items status
     auto it = exe_queue.begin();
     while (it != exe_queue.end()) {
@@ -735,7 +742,31 @@ void SmartContracts::test_exe_queue(bool reading_db) {
                 }
             }
         }
+        // is anyone of touched contracts required by older blocked item:
+        if (!wait_until_unlock && !claimed.empty()) {
+            if (claimed.count(it->abs_addr) > 0) {
+                wait_until_unlock = true;
+            }
+            for (const auto& execution : it->executions) {
+                for (const auto& u : execution.uses) {
+                    if (claimed.count(absolute_address(u)) > 0) {
+                        wait_until_unlock = true;
+                        break;
+                    }
+                }
+            }
+            if (wait_until_unlock && !reading_db) {
+                csdetails() << kLogPrefix << FormatRef(it->seq_enqueue) << " conflicts with older item in queue, wait until it is executed";
+            }
+        }
         if (wait_until_unlock) {
+            // keep block order of conflicting contracts
+            claimed.insert(it->abs_addr);
+            for (const auto& execution : it->executions) {
+                for (const auto& u : execution.uses) {
+                    claimed.insert(absolute_address(u));
+                }
+            }
             ++it;
             continue;
         }
@@ -784,7 +815,10 @@ void SmartContracts::test_exe_queue(bool reading_db) {
                     }
                     if (executor_ready) {
                         csdebug() << kLogPrefix << "execute " << FormatRef(it->seq_enqueue) << " now";
-                        execute_async(it->executions);
+                        if (execute_async(it->executions)) {
+                            it->is_dispatched = true;
+                            ++dispatched;
+                        }
                     }
                 }
             }
@@ -795,6 +829,97 @@ void SmartContracts::test_exe_queue(bool reading_db) {
 
         ++it;
     }
+
+    if (dispatched > 1) {
+        csdebug() << kLogPrefix << dispatched << " independent contracts are executing concurrently";
+    }
+}
+
+std::vector<size_t> ExecutionCommitOrder::ready(const std::vector<Item>& items) {
+    std::vector<size_t> result;
+    std::vector<bool> waiting(items.size(), false);
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        bool blocked = !items[i].completed;
+
+        // older ready items are committed before this one, so only waiting ones block it
+        for (size_t older = 0; older < i && !blocked; ++older) {
+            if (!waiting[older]) {
+                continue;
+            }
+            for (const auto& contract : items[i].contracts) {
+                if (items[older].contracts.count(contract) > 0) {
+                    blocked = true;
+                    break;
+                }
+            }
+        }
+
+        if (blocked) {
+            waiting[i] = true;
+        }
+        else {
+            result.push_back(i);
+        }
+    }
+
+    return result;
+}
+
+ExecutionCommitOrder::Contracts SmartContracts::touched_contracts(const QueueItem& item) const {
+    ExecutionCommitOrder::Contracts contracts;
+    contracts.insert(item.abs_addr);
+    for (const auto& execution : item.executions) {
+        for (const auto& u : execution.uses) {
+            contracts.insert(absolute_address(u));
+        }
+    }
+    return contracts;
+}
+
+void SmartContracts::commit_completed_executions() {
+    auto is_awaited = [this](const std::vector<SmartExecutionData>& data_list) {
+        if (data_list.empty()) {
+            return false;
+        }
+        auto it = find_in_queue(data_list.front().contract_ref);
+        return it != exe_queue.end() && it->status == SmartContractStatus::Running && it->is_dispatched;
+    };
+
+    // results of canceled, timed out or removed items are not awaited, on_execution_completed_impl() drops them
+    for (auto it_completed = completed_executions.begin(); it_completed != completed_executions.end();) {
+        if (is_awaited(*it_completed)) {
+            ++it_completed;
+            continue;
+        }
+        auto data_list = std::move(*it_completed);
+        it_completed = completed_executions.erase(it_completed);
+        on_execution_completed_impl(data_list);
+    }
+
+    if (completed_executions.empty()) {
+        return;
+    }
+
+    std::vector<std::list<std::vector<SmartExecutionData>>::iterator> results;
+    std::vector<ExecutionCommitOrder::Item> items;
+
+    for (auto it = exe_queue.begin(); it != exe_queue.end(); ++it) {
+        if (it->status != SmartContractStatus::Running || !it->is_dispatched) {
+            continue;
+        }
+        auto it_completed = std::find_if(completed_executions.begin(), completed_executions.end(), [&](const auto& data_list) {
+            return find_in_queue_item(it, data_list.front().contract_ref) != it->executions.end();
+        });
+        results.push_back(it_completed);
+        items.push_back(ExecutionCommitOrder::Item{touched_contracts(*it), it_completed != completed_executions.end()});
+    }
+
+    for (size_t index : ExecutionCommitOrder::ready(items)) {
+        auto data_list = std::move(*results[index]);
+        completed_executions.erase(results[index]);
+        on_execution_completed_impl(data_list);
+    }
 }
 
 SmartContractStatus SmartContracts::get_smart_contract_status(const csdb::Address& addr) const {
@@ -1580,6 +1705,11 @@ void SmartContracts::on_next_block_impl(const csdb::Pool& block, bool reading_db
 
     test_contracts_locks();
 
+    // finished results are committed before timeouts are tested, so they are not replaced by timeout errors
+    if (!reading_db) {
+        commit_completed_executions();
+    }
+
     const auto seq = block.sequence();
     for (auto& item : exe_queue) {
         if (item.status != SmartContractStatus::Running && item.status != SmartContractStatus::Finished) {
@@ -1983,8 +2113,8 @@ bool SmartContracts::execute_async(const std::vector<ExecutionItem>& executions)
         return data_list;
     };
 
-    // run async and watch result
-    auto watcher = cs::Concurrent::run(cs::RunPolicy::CallQueuePolicy, runnable);
+    // executor calls block until contracts are executed, so they do not occupy runtime workers
+    auto watcher = cs::Concurrent::runBlocking(cs::RunPolicy::CallQueuePolicy, runnable);
     cs::Connector::connect(&watcher->finished, this, &SmartContracts::on_execution_completed);
 
     return true;
@@ -2639,7 +2769,7 @@ bool SmartContracts::update_metadata(const api::SmartContractInvocation& contrac
     executor::GetContractMethodsResult result;
     std::string error;
     auto& executor_instance = exec_handler_ptr->getExecutor();
-    executor_instance.getContractMethods(result, contract.smartContractDeploy.byteCodeObjects);
+    executor_instance.getContractMethods(result, contract.smartContractDeploy.byteCodeObjects, cs::ExecutorPool::Lane::Consensus);
     if (result.status.code != 0) {
         executor_ready = executor_instance.isConnected();
         if (!skip_log) {
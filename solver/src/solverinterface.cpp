@@ -6,6 +6,7 @@
 #include <csnode/conveyer.hpp>
 #include <csnode/fee.hpp>
 #include <csnode/node.hpp>
+#include <csnode/roundtrace.hpp>
 
 #include <csdb/currency.hpp>
 #include <lib/system/logger.hpp>
@@ -211,6 +212,7 @@ void SolverCore::gotStageOne(const cs::StageOne& stage) {
 
 
     stageOneStorage.push_back(stage);
+    cs::RoundTrace::instance().record(cs::RoundTrace::Kind::StageOneReceived, stage.sender);
     csdebug() << kLogPrefix_ << __func__ << ": <-- stage-1 [" << static_cast<int>(stage.sender) << "] = " << stageOneStorage.size();
 
     if (!pstate) {
@@ -272,6 +274,7 @@ void SolverCore::gotStageTwo(const cs::StageTwo& stage) {
     }
 
     stageTwoStorage.push_back(stage);
+    cs::RoundTrace::instance().record(cs::RoundTrace::Kind::StageTwoReceived, stage.sender);
     csdebug() << kLogPrefix_ << __func__ << ": <-- stage-2 [" << static_cast<int>(stage.sender) << "] = " << stageTwoStorage.size();
 
     if (!pstate) {
@@ -380,6 +383,7 @@ void SolverCore::gotStageThree(const cs::StageThree& stage, const uint8_t flagg)
     }
 
     stageThreeStorage.push_back(stage);
+    cs::RoundTrace::instance().record(cs::RoundTrace::Kind::StageThreeReceived, stage.sender);
 
     csdebug() << kLogPrefix_ << __func__ << ": <-- stage-3 [" << static_cast<int>(stage.sender) << "] = " << stageThreeStorage.size() << " : " << trueStageThreeStorage.size();
 
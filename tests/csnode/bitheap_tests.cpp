@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include <csnode/bitheap.hpp>
+#include <csnode/datastream.hpp>
 
 TEST(BeatHeap, BasicOperations) {
 
@@ -41,3 +42,27 @@ TEST(BeatHeap, BasicOperations) {
     ASSERT_EQ(heap.count(), 1);
     ASSERT_FALSE(heap.empty());
 }
+
+TEST(BeatHeap, SerializationKeepsContent) {
+    using Heap = cs::BitHeap<int64_t, 1024>;
+    Heap heap;
+
+    heap.push(37);
+    heap.push(137);
+    heap.push(1037);
+
+    cs::Bytes bytes;
+    cs::DataStream output(bytes);
+    heap.serialize(output);
+
+    Heap restored;
+    cs::DataStream input(bytes.data(), bytes.size());
+    restored.deserialize(input);
+
+    ASSERT_TRUE(input.isValid());
+    ASSERT_EQ(restored.count(), heap.count());
+    ASSERT_FALSE(restored.contains(37));
+    ASSERT_TRUE(restored.contains(137));
+    ASSERT_TRUE(restored.contains(1037));
+    ASSERT_EQ(restored.minMaxRange(), heap.minMaxRange());
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <csnode/blockreplycache.hpp>
+
+namespace {
+CompressedRegion makeRegion(uint32_t size) {
+    RegionAllocator allocator;
+    return CompressedRegion(allocator.allocateNext(size), size);
+}
+}  // namespace
+
+TEST(BlockReplyCache, FindsInsertedReplies) {
+    cs::BlockReplyCache cache;
+
+    ASSERT_FALSE(cache.find({1, 2, 3}).has_value());
+
+    const auto region = makeRegion(100);
+    cache.insert({1, 2, 3}, region);
+
+    const auto found = cache.find({1, 2, 3});
+    ASSERT_TRUE(found.has_value());
+    ASSERT_EQ(found->data(), region.data());
+    ASSERT_FALSE(cache.find({1, 2}).has_value());
+
+    ASSERT_EQ(cache.hits(), 1);
+    ASSERT_EQ(cache.misses(), 2);
+}
+
+TEST(BlockReplyCache, EvictsLeastRecentlyUsed) {
+    cs::BlockReplyCache cache(2);
+
+    cache.insert({1}, makeRegion(10));
+    cache.insert({2}, makeRegion(10));
+
+    // 1 becomes the most recent
+    ASSERT_TRUE(cache.find({1}).has_value());
+
+    cache.insert({3}, makeRegion(10));
+
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_TRUE(cache.find({1}).has_value());
+    ASSERT_FALSE(cache.find({2}).has_value());
+    ASSERT_TRUE(cache.find({3}).has_value());
+}
+
+TEST(BlockReplyCache, KeepsBytesLimit) {
+    const auto region = makeRegion(1000);
+    cs::BlockReplyCache cache(100, region.size() * 2);
+
+    cache.insert({1}, region);
+    cache.insert({2}, region);
+    cache.insert({3}, region);
+
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.bytes(), region.size() * 2);
+    ASSERT_FALSE(cache.find({1}).has_value());
+}
+
+TEST(BlockReplyCache, InvalidatesRemovedBlocks) {
+    cs::BlockReplyCache cache;
+
+    cache.insert({1, 2}, makeRegion(10));
+    cache.insert({5, 6}, makeRegion(10));
+    cache.insert({3}, makeRegion(10));
+
+    cache.invalidate(3);
+
+    ASSERT_TRUE(cache.find({1, 2}).has_value());
+    ASSERT_FALSE(cache.find({5, 6}).has_value());
+    ASSERT_FALSE(cache.find({3}).has_value());
+    ASSERT_EQ(cache.size(), 1);
+}
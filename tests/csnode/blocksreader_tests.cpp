@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <csdb/address.hpp>
+#include <csdb/amount.hpp>
+#include <csdb/amount_commission.hpp>
+#include <csdb/blocksreader.hpp>
+#include <csdb/currency.hpp>
+#include <csdb/pool.hpp>
+#include <csdb/transaction.hpp>
+
+namespace {
+// iterates stored blocks kept in memory
+class MemoryIterator : public csdb::Database::Iterator {
+public:
+    explicit MemoryIterator(const std::vector<cs::Bytes>& blocks)
+    : blocks_(blocks) {
+    }
+
+    bool is_valid() const override {
+        return index_ < blocks_.size();
+    }
+
+    void seek_to_first() override {
+        index_ = 0;
+    }
+
+    void seek_to_last() override {
+        index_ = blocks_.empty() ? 0 : blocks_.size() - 1;
+    }
+
+    void seek(const cs::Bytes&) override {
+    }
+
+    void next() override {
+        ++index_;
+    }
+
+    void prev() override {
+        index_ = index_ == 0 ? blocks_.size() : index_ - 1;
+    }
+
+    uint32_t key() const override {
+        return static_cast<uint32_t>(index_);
+    }
+
+    cs::Bytes value() const override {
+        return blocks_[index_];
+    }
+
+private:
+    const std::vector<cs::Bytes>& blocks_;
+    size_t index_ = 0;
+};
+
+std::vector<cs::Bytes> makeChain(size_t count) {
+    std::vector<cs::Bytes> blocks;
+    csdb::PoolHash previous;
+
+    for (size_t sequence = 0; sequence < count; ++sequence) {
+        csdb::Pool pool(previous, sequence);
+
+        for (uint8_t i = 0; i < sequence % 5; ++i) {
+            pool.add_transaction(csdb::Transaction(i + 1, csdb::Address::from_wallet_id(i), csdb::Address::from_wallet_id(i + 1), csdb::Currency(1),
+                                                   csdb::Amount(static_cast<int32_t>(sequence)), csdb::AmountCommission(0.1),
+                                                   csdb::AmountCommission(0.01), cs::Signature{}));
+        }
+
+        pool.compose();
+        previous = pool.hash();
+        blocks.push_back(pool.to_binary());
+    }
+
+    return blocks;
+}
+}  // namespace
+
+TEST(BlocksReader, ParallelLoadMatchesSequential) {
+    auto blocks = makeChain(250);
+
+    // corrupted block must stay invalid at its place
+    blocks[123].resize(blocks[123].size() / 2);
+
+    std::vector<csdb::Pool> expected;
+
+    for (const auto& raw : blocks) {
+        expected.push_back(csdb::Pool::from_binary(cs::Bytes(raw)));
+    }
+
+    std::vector<csdb::Pool> loaded;
+
+    {
+        csdb::BlocksReader reader(std::make_shared<MemoryIterator>(blocks), 16);
+        csdb::BlocksReader::Batch batch;
+
+        while (reader.next(batch)) {
+            loaded.insert(loaded.end(), batch.begin(), batch.end());
+        }
+    }
+
+    ASSERT_EQ(loaded.size(), expected.size());
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(loaded[i].is_valid(), expected[i].is_valid()) << "block " << i;
+
+        if (expected[i].is_valid()) {
+            ASSERT_EQ(loaded[i].sequence(), expected[i].sequence());
+            ASSERT_EQ(loaded[i].hash(), expected[i].hash());
+            ASSERT_EQ(loaded[i].previous_hash(), expected[i].previous_hash());
+            ASSERT_EQ(loaded[i].transactions_count(), expected[i].transactions_count());
+        }
+    }
+}
+
+TEST(BlocksReader, ReaderStopsWhileBatchesAreQueued) {
+    const auto blocks = makeChain(100);
+
+    csdb::BlocksReader reader(std::make_shared<MemoryIterator>(blocks), 4);
+    csdb::BlocksReader::Batch batch;
+
+    ASSERT_TRUE(reader.next(batch));
+    ASSERT_EQ(batch.size(), 4u);
+    ASSERT_EQ(batch.front().sequence(), 0u);
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <contractstatecache.hpp>
+
+namespace {
+csdb::Address makeAddress(uint8_t index) {
+    cs::PublicKey key{};
+    key.fill(index);
+    return csdb::Address::from_public_key(key);
+}
+
+constexpr size_t kStateSize = 1000;
+}  // namespace
+
+TEST(ContractStateCache, LatestStateIsCached) {
+    cs::ContractStateCache cache(10 * kStateSize);
+    const auto address = makeAddress(1);
+
+    ASSERT_FALSE(cache.latest(address).has_value());
+
+    cache.setLatest(address, std::string(kStateSize, 'a'));
+    ASSERT_EQ(cache.latest(address), std::string(kStateSize, 'a'));
+
+    cache.invalidate(address);
+    ASSERT_FALSE(cache.latest(address).has_value());
+
+    const auto metrics = cache.metrics();
+    ASSERT_EQ(metrics.hits, 1u);
+    ASSERT_EQ(metrics.misses, 2u);
+    ASSERT_EQ(metrics.entries, 0u);
+    ASSERT_EQ(metrics.bytes, 0u);
+}
+
+TEST(ContractStateCache, StateReadBeforeUpdateIsNotCached) {
+    cs::ContractStateCache cache(10 * kStateSize);
+    const auto address = makeAddress(1);
+
+    const auto version = cache.version();
+    cache.invalidate(address);
+    cache.fillLatest(address, "outdated", version);
+
+    ASSERT_FALSE(cache.latest(address).has_value());
+
+    cache.fillLatest(address, "actual", cache.version());
+    ASSERT_EQ(cache.latest(address), std::string("actual"));
+}
+
+TEST(ContractStateCache, LeastRecentlyUsedStateIsEvicted) {
+    cs::ContractStateCache cache(3 * kStateSize + 500);
+
+    for (uint8_t i = 0; i < 3; ++i) {
+        cache.setLatest(makeAddress(i), std::string(kStateSize, static_cast<char>('a' + i)));
+    }
+
+    // the first one becomes the most recently used
+    ASSERT_TRUE(cache.latest(makeAddress(0)).has_value());
+
+    cache.setLatest(makeAddress(3), std::string(kStateSize, 'd'));
+
+    ASSERT_TRUE(cache.latest(makeAddress(0)).has_value());
+    ASSERT_FALSE(cache.latest(makeAddress(1)).has_value());
+    ASSERT_TRUE(cache.latest(makeAddress(3)).has_value());
+
+    const auto metrics = cache.metrics();
+    ASSERT_EQ(metrics.evictions, 1u);
+    ASSERT_LE(metrics.bytes, metrics.capacity);
+
+    // state larger than capacity is never cached
+    cache.setLatest(makeAddress(4), std::string(4 * kStateSize, 'e'));
+    ASSERT_FALSE(cache.latest(makeAddress(4)).has_value());
+}
+
+TEST(ContractStateCache, EqualStatesAreStoredOnce) {
+    // twenty copies would not fit
+    cs::ContractStateCache cache(4 * kStateSize);
+    const std::string state(kStateSize, 's');
+
+    for (uint8_t i = 0; i < 10; ++i) {
+        cache.setLatest(makeAddress(i), state);
+        cache.addHistory(makeAddress(i), 100, state);
+    }
+
+    auto metrics = cache.metrics();
+    ASSERT_EQ(metrics.entries, 20u);
+    ASSERT_EQ(metrics.states, 1u);
+    ASSERT_EQ(metrics.evictions, 0u);
+
+    for (uint8_t i = 0; i < 10; ++i) {
+        ASSERT_EQ(cache.latest(makeAddress(i)), state);
+    }
+
+    cache.clearHistory();
+    metrics = cache.metrics();
+    ASSERT_EQ(metrics.entries, 10u);
+    ASSERT_EQ(metrics.states, 1u);
+}
+
+TEST(ContractStateCache, HistoryReturnsStateOfSequence) {
+    cs::ContractStateCache cache(100 * kStateSize);
+    const auto address = makeAddress(1);
+    std::string state;
+
+    ASSERT_EQ(cache.history(address, 10, state), cs::ContractStateCache::HistoryResult::Latest);
+
+    cache.addHistory(address, 10, "ten");
+    cache.addHistory(address, 20, "twenty");
+    cache.setLatest(address, "twenty");
+
+    ASSERT_EQ(cache.history(address, 5, state), cs::ContractStateCache::HistoryResult::Unknown);
+    ASSERT_EQ(cache.history(address, 15, state), cs::ContractStateCache::HistoryResult::Found);
+    ASSERT_EQ(state, "ten");
+    ASSERT_EQ(cache.history(address, 25, state), cs::ContractStateCache::HistoryResult::Found);
+    ASSERT_EQ(state, "twenty");
+
+    cache.clearHistory();
+    ASSERT_EQ(cache.history(address, 15, state), cs::ContractStateCache::HistoryResult::Latest);
+    ASSERT_EQ(cache.latest(address), std::string("twenty"));
+}
+
+TEST(ContractStateCache, EvictedHistoryIsNotReplacedByLatest) {
+    cs::ContractStateCache cache(2 * kStateSize + 500);
+    const auto address = makeAddress(1);
+    std::string state;
+
+    cache.addHistory(address, 10, std::string(kStateSize, 'a'));
+    cache.addHistory(address, 20, std::string(kStateSize, 'b'));
+    cache.addHistory(makeAddress(2), 20, std::string(kStateSize, 'c'));
+
+    // the whole history of address is evicted
+    ASSERT_EQ(cache.metrics().evictions, 2u);
+    ASSERT_EQ(cache.history(address, 15, state), cs::ContractStateCache::HistoryResult::Unknown);
+    ASSERT_EQ(cache.history(address, 25, state), cs::ContractStateCache::HistoryResult::Latest);
+}
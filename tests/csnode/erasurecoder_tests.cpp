@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include <csnode/packstream.hpp>
+
+#include <net/erasurecoder.hpp>
+#include <net/packet.hpp>
+
+namespace {
+const cs::PublicKey kPublicKey = cs::PublicKey{};
+
+std::vector<cs::Bytes> makeShards(size_t count, size_t size, std::mt19937& generator) {
+    std::uniform_int_distribution<int> distribution(0, 255);
+    std::vector<cs::Bytes> shards(count, cs::Bytes(size));
+
+    for (auto& shard : shards) {
+        std::generate(shard.begin(), shard.end(), [&] { return static_cast<cs::Byte>(distribution(generator)); });
+    }
+
+    return shards;
+}
+
+// collector keeps received packets, do not share regions with the stream
+std::vector<Packet> copyPackets(RegionAllocator& allocator, Packet* packets, uint32_t count) {
+    std::vector<Packet> result;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        Packet packet(allocator.allocateNext(static_cast<uint32_t>(packets[i].size())));
+        std::copy(static_cast<const cs::Byte*>(packets[i].data()), static_cast<const cs::Byte*>(packets[i].data()) + packets[i].size(),
+                  static_cast<cs::Byte*>(packet.data()));
+        result.push_back(packet);
+    }
+
+    return result;
+}
+}  // namespace
+
+TEST(ErasureCoder, DataShardsCountIsRestoredFromTotal) {
+    for (uint32_t data = 1; data < 1000; ++data) {
+        ASSERT_EQ(cs::ErasureCoder::dataShards(data + cs::ErasureCoder::repairShards(data)), data);
+    }
+
+    ASSERT_EQ(cs::ErasureCoder::dataShards(12), 0u);
+    ASSERT_FALSE(cs::ErasureCoder::isApplicable(1));
+    ASSERT_FALSE(cs::ErasureCoder::isApplicable(240));
+}
+
+TEST(ErasureCoder, RestoresLostDataShards) {
+    std::mt19937 generator(42);
+    constexpr size_t size = 100;
+
+    for (uint32_t dataCount : {2u, 10u, 11u, 57u, 200u}) {
+        const auto repairCount = cs::ErasureCoder::repairShards(dataCount);
+
+        auto data = makeShards(dataCount, size, generator);
+        std::vector<cs::Bytes> repair(repairCount, cs::Bytes(size));
+
+        std::vector<const cs::Byte*> dataPtrs;
+        std::vector<cs::Byte*> repairPtrs;
+
+        std::transform(data.begin(), data.end(), std::back_inserter(dataPtrs), [](const auto& shard) { return shard.data(); });
+        std::transform(repair.begin(), repair.end(), std::back_inserter(repairPtrs), [](auto& shard) { return shard.data(); });
+
+        cs::ErasureCoder::encode(dataPtrs, repairPtrs, size);
+
+        std::vector<const cs::Byte*> shards(dataPtrs);
+        shards.insert(shards.end(), repairPtrs.begin(), repairPtrs.end());
+
+        // lose repair shards count of random shards
+        std::vector<uint32_t> indexes(dataCount + repairCount);
+        std::iota(indexes.begin(), indexes.end(), 0);
+        std::shuffle(indexes.begin(), indexes.end(), generator);
+
+        for (uint32_t i = 0; i < repairCount; ++i) {
+            shards[indexes[i]] = nullptr;
+        }
+
+        std::vector<cs::Bytes> restored(dataCount, cs::Bytes(size));
+        std::vector<cs::Byte*> recovered;
+        std::transform(restored.begin(), restored.end(), std::back_inserter(recovered), [](auto& shard) { return shard.data(); });
+
+        ASSERT_TRUE(cs::ErasureCoder::decode(shards, dataCount, recovered, size));
+
+        for (uint32_t j = 0; j < dataCount; ++j) {
+            if (shards[j] == nullptr) {
+                ASSERT_EQ(restored[j], data[j]);
+            }
+        }
+
+        // lost data shard can not be restored without repair ones
+        std::fill(shards.begin() + dataCount, shards.end(), nullptr);
+        shards.front() = nullptr;
+        ASSERT_FALSE(cs::ErasureCoder::decode(shards, dataCount, recovered, size));
+    }
+}
+
+TEST(ErasureCoder, MessageIsCollectedWithoutLostFragments) {
+    RegionAllocator allocator;
+    cs::OPackStream stream(&allocator, kPublicKey);
+    stream.setErasureCoding(true);
+
+    std::mt19937 generator(7);
+    const auto payload = makeShards(1, 20 * Packet::MaxSize + 123, generator).front();
+
+    stream.init(BaseFlags::Broadcast | BaseFlags::Fragmented);
+    stream << MsgTypes::RoundTable << cs::RoundNumber(1) << payload;
+
+    auto packetsPtr = stream.getPackets();
+    const auto count = stream.getPacketsCount();
+
+    const auto dataCount = cs::ErasureCoder::dataShards(count);
+    ASSERT_GT(dataCount, 20u);
+    ASSERT_EQ(count, dataCount + cs::ErasureCoder::repairShards(dataCount));
+
+    auto packets = copyPackets(allocator, packetsPtr, count);
+
+    for (const auto& packet : packets) {
+        ASSERT_TRUE(packet.isErasureCoded());
+        ASSERT_TRUE(packet.isHeaderValid());
+        ASSERT_LE(packet.size(), static_cast<size_t>(Packet::MaxSize));
+    }
+
+    // the first and the last data fragments are lost
+    PacketCollector collector;
+    MessagePtr msg;
+
+    for (uint32_t i = 1; i + 1 < count; ++i) {
+        if (i + 1 == dataCount) {
+            continue;
+        }
+
+        bool isNew = false;
+        msg = collector.getMessage(packets[i], isNew);
+        ASSERT_TRUE(msg);
+    }
+
+    ASSERT_TRUE(msg->isComplete());
+    ASSERT_EQ(msg->getFirstPack().getType(), MsgTypes::RoundTable);
+
+    cs::IPackStream istream;
+    istream.init(msg->getFullData(), msg->getFullSize());
+
+    MsgTypes type;
+    cs::RoundNumber round = 0;
+    cs::Bytes received;
+    istream >> type >> round >> received;
+
+    ASSERT_TRUE(istream.good());
+    ASSERT_TRUE(istream.end());
+    ASSERT_EQ(type, MsgTypes::RoundTable);
+    ASSERT_EQ(round, 1u);
+    ASSERT_EQ(received, payload);
+}
+
+TEST(ErasureCoder, LateRepairFragmentsDoNotRecreateMessage) {
+    RegionAllocator allocator;
+    cs::OPackStream stream(&allocator, kPublicKey);
+    stream.setErasureCoding(true);
+
+    std::mt19937 generator(11);
+    const auto payload = makeShards(1, 30 * Packet::MaxSize, generator).front();
+
+    stream.init(BaseFlags::Broadcast | BaseFlags::Fragmented);
+    stream << MsgTypes::RoundTable << cs::RoundNumber(2) << payload;
+
+    auto packetsPtr = stream.getPackets();
+    const auto count = stream.getPacketsCount();
+    const auto dataCount = cs::ErasureCoder::dataShards(count);
+    ASSERT_LT(dataCount, count);
+
+    auto packets = copyPackets(allocator, packetsPtr, count);
+
+    // all k + r fragments come, the message is processed as soon as it is complete like Network does
+    PacketCollector collector;
+    uint32_t created = 0;
+    uint32_t collected = 0;
+    uint32_t late = 0;
+    bool processed = false;
+
+    for (const auto& packet : packets) {
+        bool isNew = false;
+        MessagePtr msg = collector.getMessage(packet, isNew);
+
+        if (isNew) {
+            ++created;
+        }
+
+        if (processed) {
+            // late repair fragment must not make the message incomplete again
+            ASSERT_FALSE(msg);
+            ++late;
+            continue;
+        }
+
+        ASSERT_TRUE(msg);
+        ++collected;
+
+        if (msg->isComplete()) {
+            processed = true;
+            collector.dropMessage(msg);
+        }
+    }
+
+    ASSERT_TRUE(processed);
+    ASSERT_EQ(created, 1u);
+    ASSERT_EQ(collected, dataCount);
+    ASSERT_EQ(late, count - dataCount);
+}
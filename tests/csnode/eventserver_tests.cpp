@@ -0,0 +1,381 @@
+#include "gtest/gtest.h"
+
+#include <csconnector/eventserver.hpp>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+// requests are lines, "wait" lines are parked until release, "flow" lines block processing until unblock,
+// "blob <size>" line is followed by size bytes
+class LineCodec : public csconnector::Codec {
+public:
+    Status extract(std::string_view input, Request& request, size_t& consumed) override {
+        ++extracts_;
+
+        const auto end = input.find('\n');
+
+        if (end == std::string_view::npos) {
+            return Status::Incomplete;
+        }
+
+        if (input.substr(0, end) == "bad") {
+            return Status::Malformed;
+        }
+
+        if (input.substr(0, 5) == "blob ") {
+            const size_t size = std::stoull(std::string(input.substr(5, end - 5)));
+
+            if (input.size() < end + 1 + size) {
+                consumed = end + 1 + size;
+                return Status::Incomplete;
+            }
+
+            request.method = "blob";
+            request.data = "blob " + std::to_string(size);
+            consumed = end + 1 + size;
+
+            return Status::Ready;
+        }
+
+        request.data = std::string(input.substr(0, end));
+        request.method = request.data.substr(0, request.data.find(' '));
+        consumed = end + 1;
+
+        if (request.method == "ping") {
+            request.reply = "pong\n";
+        }
+
+        return Status::Ready;
+    }
+
+    std::string process(const Request& request) override {
+        if (request.method == "flow") {
+            std::unique_lock lock(mutex_);
+            ++blocked_;
+            condition_.wait(lock, [this] { return !blocking_; });
+            --blocked_;
+        }
+
+        return "echo " + request.data + "\n";
+    }
+
+    bool blocking(const Request& request) const override {
+        return request.method == "flow";
+    }
+
+    bool park(const Request& request, const std::weak_ptr<void>& owner, Reply reply) override {
+        if (request.method != "wait") {
+            return false;
+        }
+
+        std::lock_guard lock(mutex_);
+        parked_.push_back(Parked{owner, std::move(reply)});
+        return true;
+    }
+
+    size_t release(const std::string& reply) {
+        std::vector<Parked> parked;
+
+        {
+            std::lock_guard lock(mutex_);
+            parked.swap(parked_);
+        }
+
+        size_t released = 0;
+
+        for (auto& item : parked) {
+            if (!item.owner.expired()) {
+                item.reply(reply);
+                ++released;
+            }
+        }
+
+        return released;
+    }
+
+    size_t parked() {
+        std::lock_guard lock(mutex_);
+        return parked_.size();
+    }
+
+    size_t extracts() const {
+        return extracts_;
+    }
+
+    size_t blocked() {
+        std::lock_guard lock(mutex_);
+        return blocked_;
+    }
+
+    void unblock() {
+        {
+            std::lock_guard lock(mutex_);
+            blocking_ = false;
+        }
+
+        condition_.notify_all();
+    }
+
+private:
+    struct Parked {
+        std::weak_ptr<void> owner;
+        Reply reply;
+    };
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::vector<Parked> parked_;
+    size_t blocked_ = 0;
+    bool blocking_ = true;
+    std::atomic<size_t> extracts_ = {0};
+};
+
+class Client {
+public:
+    explicit Client(uint16_t port) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+
+        timeval timeout{5, 0};
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        connected_ = ::connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    ~Client() {
+        ::close(fd_);
+    }
+
+    bool connected() const {
+        return connected_;
+    }
+
+    void send(const std::string& data) {
+        ::send(fd_, data.data(), data.size(), MSG_NOSIGNAL);
+    }
+
+    // reads lines count, returns empty string if connection is closed
+    std::string receive(size_t lines) {
+        std::string result;
+        char symbol = 0;
+
+        while (lines != 0 && ::recv(fd_, &symbol, 1, 0) == 1) {
+            result.push_back(symbol);
+
+            if (symbol == '\n') {
+                --lines;
+            }
+        }
+
+        return result;
+    }
+
+private:
+    int fd_ = -1;
+    bool connected_ = false;
+};
+
+class EventServerTest : public ::testing::Test {
+protected:
+    void start(csconnector::EventServer::Settings settings = csconnector::EventServer::Settings()) {
+        codec_ = std::make_shared<LineCodec>();
+        settings.workers = 2;
+        server_ = std::make_unique<csconnector::EventServer>(codec_, settings);
+        server_->listen();
+        thread_ = std::thread([this] { server_->serve(); });
+    }
+
+    void TearDown() override {
+        if (thread_.joinable()) {
+            server_->stop();
+            thread_.join();
+        }
+    }
+
+    template <typename Predicate>
+    static bool waitFor(Predicate predicate) {
+        for (size_t i = 0; i < 500 && !predicate(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        return predicate();
+    }
+
+    std::shared_ptr<LineCodec> codec_;
+    std::unique_ptr<csconnector::EventServer> server_;
+    std::thread thread_;
+};
+}  // namespace
+
+TEST_F(EventServerTest, PipelinedRequestsAreAnsweredInOrder) {
+    start();
+
+    Client client(server_->port());
+    ASSERT_TRUE(client.connected());
+
+    client.send("first 1\nping\nsecond 2\n");
+    ASSERT_EQ(client.receive(3), "echo first 1\npong\necho second 2\n");
+
+    // request split between packets
+    client.send("thi");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    client.send("rd 3\n");
+    ASSERT_EQ(client.receive(1), "echo third 3\n");
+
+    const auto stats = server_->stats();
+    ASSERT_EQ(stats.at("first").calls, 1u);
+    ASSERT_EQ(stats.at("third").calls, 1u);
+}
+
+TEST_F(EventServerTest, ParkedRequestsDoNotBlockOthers) {
+    start();
+
+    const size_t kWaiters = 50;
+    std::vector<std::unique_ptr<Client>> waiters;
+
+    for (size_t i = 0; i < kWaiters; ++i) {
+        waiters.push_back(std::make_unique<Client>(server_->port()));
+        waiters.back()->send("wait block\n");
+    }
+
+    ASSERT_TRUE(waitFor([this, kWaiters] { return codec_->parked() == kWaiters; }));
+
+    // workers are free while long-polls are parked
+    Client client(server_->port());
+    client.send("call 1\n");
+    ASSERT_EQ(client.receive(1), "echo call 1\n");
+
+    // closed connection drops its parked request
+    waiters.pop_back();
+    ASSERT_TRUE(waitFor([this, kWaiters] { return server_->connections() == kWaiters; }));
+
+    ASSERT_EQ(codec_->release("block 42\n"), kWaiters - 1);
+
+    for (auto& waiter : waiters) {
+        ASSERT_EQ(waiter->receive(1), "block 42\n");
+    }
+
+    ASSERT_EQ(server_->stats().at("wait").calls, kWaiters - 1);
+}
+
+TEST_F(EventServerTest, BlockedRequestsDoNotStarveOthers) {
+    start();
+
+    // more blocked requests than workers, like smart contract transactions waiting for execution
+    const size_t kBlocked = 8;
+    std::vector<std::unique_ptr<Client>> flows;
+
+    for (size_t i = 0; i < kBlocked; ++i) {
+        flows.push_back(std::make_unique<Client>(server_->port()));
+        flows.back()->send("flow " + std::to_string(i) + "\n");
+    }
+
+    ASSERT_TRUE(waitFor([this, kBlocked] { return codec_->blocked() == kBlocked; }));
+
+    Client client(server_->port());
+    client.send("call 1\n");
+    ASSERT_EQ(client.receive(1), "echo call 1\n");
+
+    codec_->unblock();
+
+    for (size_t i = 0; i < kBlocked; ++i) {
+        ASSERT_EQ(flows[i]->receive(1), "echo flow " + std::to_string(i) + "\n");
+    }
+}
+
+TEST_F(EventServerTest, ConnectionsAreLimited) {
+    csconnector::EventServer::Settings settings;
+    settings.maxConnections = 2;
+    start(settings);
+
+    Client first(server_->port());
+    Client second(server_->port());
+    first.send("call 1\n");
+    second.send("call 2\n");
+
+    ASSERT_EQ(first.receive(1), "echo call 1\n");
+    ASSERT_EQ(second.receive(1), "echo call 2\n");
+
+    Client third(server_->port());
+    third.send("call 3\n");
+
+    ASSERT_EQ(third.receive(1), "");
+    ASSERT_TRUE(waitFor([this] { return server_->rejected() == 1; }));
+}
+
+TEST_F(EventServerTest, MalformedRequestClosesConnection) {
+    start();
+
+    Client client(server_->port());
+    client.send("bad\n");
+
+    ASSERT_EQ(client.receive(1), "");
+    ASSERT_TRUE(waitFor([this] { return server_->connections() == 0; }));
+}
+
+TEST_F(EventServerTest, LargeRequestIsNotParsedOnEveryRead) {
+    start();
+
+    Client client(server_->port());
+    client.send("blob 65536\n");
+    ASSERT_TRUE(waitFor([this] { return codec_->extracts() == 1; }));
+
+    const std::string part(1024, 'x');
+
+    for (size_t i = 0; i < 64; ++i) {
+        client.send(part);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    client.send("ping\n");
+    ASSERT_EQ(client.receive(2), "echo blob 65536\npong\n");
+
+    // declared size is checked, then request and ping are extracted once
+    ASSERT_EQ(codec_->extracts(), 3u);
+}
+
+TEST_F(EventServerTest, RequestAboveLimitIsRejectedByDeclaredSize) {
+    csconnector::EventServer::Settings settings;
+    settings.maxRequestSize = 1024;
+    start(settings);
+
+    Client client(server_->port());
+    client.send("blob 4096\n");
+
+    ASSERT_EQ(client.receive(1), "");
+    ASSERT_TRUE(waitFor([this] { return server_->connections() == 0; }));
+}
+
+TEST_F(EventServerTest, StopClosesConnectedClients) {
+    start();
+
+    Client first(server_->port());
+    Client second(server_->port());
+    first.send("call 1\n");
+    second.send("wait block\n");
+
+    ASSERT_EQ(first.receive(1), "echo call 1\n");
+    ASSERT_TRUE(waitFor([this] { return codec_->parked() == 1; }));
+
+    server_->stop();
+    thread_.join();
+
+    ASSERT_EQ(server_->connections(), 0u);
+    ASSERT_EQ(first.receive(1), "");
+    ASSERT_EQ(second.receive(1), "");
+}
+#endif  // __linux__
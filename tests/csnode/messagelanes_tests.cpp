@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <net/messagelanes.hpp>
+
+namespace {
+void runQueueUntil(CallsQueue& queue, const std::function<bool()>& predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (!predicate() && std::chrono::steady_clock::now() < deadline) {
+        queue.callAll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+}  // namespace
+
+TEST(MessageLanes, BulkMessagesAreClassified) {
+    ASSERT_EQ(cs::MessageLanes::classify(MsgTypes::TransactionPacket), cs::MessageLane::Transactions);
+    ASSERT_EQ(cs::MessageLanes::classify(MsgTypes::TransactionsPacketReply), cs::MessageLane::Transactions);
+    ASSERT_EQ(cs::MessageLanes::classify(MsgTypes::RequestedBlock), cs::MessageLane::Blocks);
+    ASSERT_EQ(cs::MessageLanes::classify(MsgTypes::StateReply), cs::MessageLane::States);
+    ASSERT_EQ(cs::MessageLanes::classify(MsgTypes::FirstStage), cs::MessageLane::Consensus);
+    ASSERT_EQ(cs::MessageLanes::classify(MsgTypes::RoundTable), cs::MessageLane::Consensus);
+}
+
+TEST(MessageLanes, MessagesAreAppliedInArrivalOrder) {
+    CallsQueue queue;
+    cs::TaskRuntime runtime(4);
+    cs::MessageLanes lanes(queue, runtime);
+
+    const size_t count = 100;
+    std::vector<size_t> applied;
+
+    for (size_t i = 0; i < count; ++i) {
+        lanes.process(cs::MessageLane::Transactions, [i, &applied]() -> cs::MessageLanes::Apply {
+            // earlier messages are prepared longer
+            std::this_thread::sleep_for(std::chrono::microseconds((count - i) * 20));
+
+            if (i % 10 == 5) {
+                return cs::MessageLanes::Apply();
+            }
+
+            return [i, &applied] {
+                applied.push_back(i);
+            };
+        });
+    }
+
+    runQueueUntil(queue, [&] { return lanes.pending(cs::MessageLane::Transactions) == 0; });
+
+    ASSERT_EQ(applied.size(), count - count / 10);
+
+    for (size_t i = 1; i < applied.size(); ++i) {
+        ASSERT_LT(applied[i - 1], applied[i]);
+    }
+
+    ASSERT_EQ(lanes.latency(cs::MessageLane::Transactions).count(), count);
+    ASSERT_EQ(lanes.latency(cs::MessageLane::Blocks).count(), 0u);
+}
+
+TEST(MessageLanes, FailedPreparationDoesNotStopLane) {
+    CallsQueue queue;
+    cs::TaskRuntime runtime(2);
+    cs::MessageLanes lanes(queue, runtime);
+
+    std::atomic<size_t> applied = 0;
+
+    lanes.process(cs::MessageLane::States, []() -> cs::MessageLanes::Apply {
+        throw std::runtime_error("bad message");
+    });
+
+    lanes.process(cs::MessageLane::States, []() -> cs::MessageLanes::Apply {
+        throw 42;
+    });
+
+    lanes.process(cs::MessageLane::States, [&applied]() -> cs::MessageLanes::Apply {
+        return [&applied] { ++applied; };
+    });
+
+    runQueueUntil(queue, [&] { return applied == 1; });
+
+    ASSERT_EQ(applied.load(), 1u);
+    ASSERT_EQ(lanes.pending(cs::MessageLane::States), 0u);
+}
+
+TEST(MessageLanes, StopDropsWaitingMessages) {
+    CallsQueue queue;
+    cs::TaskRuntime runtime(1);
+    cs::MessageLanes lanes(queue, runtime);
+
+    const size_t count = 10;
+    std::atomic<bool> started = false;
+    std::atomic<bool> release = false;
+    std::atomic<size_t> prepared = 0;
+    std::atomic<size_t> applied = 0;
+
+    // the only worker is busy with the first message, others wait
+    for (size_t i = 0; i < count; ++i) {
+        lanes.process(cs::MessageLane::Blocks, [&]() -> cs::MessageLanes::Apply {
+            ++prepared;
+            started = true;
+
+            while (!release) {
+                std::this_thread::yield();
+            }
+
+            return [&applied] { ++applied; };
+        });
+    }
+
+    while (!started) {
+        std::this_thread::yield();
+    }
+
+    lanes.stop();
+    ASSERT_EQ(lanes.pending(cs::MessageLane::Blocks), 0u);
+
+    release = true;
+    runQueueUntil(queue, [&] { return runtime.metrics().executed == count; });
+    queue.callAll();
+
+    ASSERT_EQ(runtime.metrics().executed, count);
+    ASSERT_EQ(prepared.load(), 1u);
+    ASSERT_EQ(applied.load(), 0u);
+    ASSERT_EQ(lanes.pending(cs::MessageLane::Blocks), 0u);
+}
+
+TEST(MessageLanes, HistogramPercentiles) {
+    cs::LatencyHistogram histogram;
+    ASSERT_EQ(histogram.percentile(0.5), 0u);
+
+    for (int i = 0; i < 90; ++i) {
+        histogram.add(std::chrono::microseconds(100));
+    }
+
+    for (int i = 0; i < 10; ++i) {
+        histogram.add(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(histogram.count(), 100u);
+
+    // buckets have power of two upper bounds
+    ASSERT_EQ(histogram.percentile(0.5), 128u);
+    ASSERT_EQ(histogram.percentile(0.9), 128u);
+    ASSERT_EQ(histogram.percentile(0.99), 16384u);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <csnode/multiwallets.hpp>
+
+namespace {
+cs::PublicKey makeKey(uint8_t value) {
+    cs::PublicKey key{};
+    key.fill(value);
+    return key;
+}
+
+class TestMultiWallets : public cs::MultiWallets {
+public:
+    void update(uint8_t key, int32_t balance, uint64_t transactions) {
+        cs::WalletsCache::WalletData data;
+        data.balance_ = csdb::Amount(balance);
+        data.transNum_ = transactions;
+
+        onWalletCacheUpdated(makeKey(key), data);
+    }
+};
+
+std::vector<uint8_t> keys(const std::vector<cs::MultiWallets::InternalData>& data) {
+    std::vector<uint8_t> result;
+
+    for (const auto& item : data) {
+        result.push_back(item.key[0]);
+    }
+
+    return result;
+}
+}  // namespace
+
+TEST(MultiWallets, PagesByBalance) {
+    TestMultiWallets wallets;
+
+    for (uint8_t i = 1; i <= 10; ++i) {
+        wallets.update(i, i * 10, 10 - i);
+    }
+
+    ASSERT_EQ(wallets.size(), 10);
+
+    using Tag = cs::MultiWallets::Tags;
+    using Order = cs::MultiWallets::Order;
+
+    ASSERT_EQ(keys(wallets.iterate<Tag::ByBalance>(0, 3, Order::Greater)), (std::vector<uint8_t>{10, 9, 8}));
+    ASSERT_EQ(keys(wallets.iterate<Tag::ByBalance>(8, 5, Order::Greater)), (std::vector<uint8_t>{2, 1}));
+    ASSERT_EQ(keys(wallets.iterate<Tag::ByBalance>(0, 3, Order::Less)), (std::vector<uint8_t>{1, 2, 3}));
+    ASSERT_EQ(keys(wallets.iterate<Tag::ByBalance>(7, 5, Order::Less)), (std::vector<uint8_t>{8, 9, 10}));
+    ASSERT_EQ(keys(wallets.iterate<Tag::ByTransactionsCount>(2, 2, Order::Greater)), (std::vector<uint8_t>{3, 4}));
+
+    ASSERT_TRUE(wallets.iterate<Tag::ByBalance>(10, 5, Order::Greater).empty());
+    ASSERT_TRUE(wallets.iterate<Tag::ByBalance>(0, 0, Order::Greater).empty());
+}
+
+TEST(MultiWallets, UpdateMovesWalletRank) {
+    TestMultiWallets wallets;
+
+    for (uint8_t i = 1; i <= 5; ++i) {
+        wallets.update(i, i, 0);
+    }
+
+    wallets.update(1, 100, 0);
+
+    using Tag = cs::MultiWallets::Tags;
+    using Order = cs::MultiWallets::Order;
+
+    ASSERT_EQ(wallets.size(), 5);
+    ASSERT_EQ(keys(wallets.iterate<Tag::ByBalance>(0, 2, Order::Greater)), (std::vector<uint8_t>{1, 5}));
+    ASSERT_EQ(keys(wallets.iterate<Tag::ByBalance>(0, 1, Order::Less)), (std::vector<uint8_t>{2}));
+}
+
+TEST(MultiWallets, NegativeBalancesAreNotListed) {
+    TestMultiWallets wallets;
+
+    wallets.update(1, 10, 0);
+    wallets.update(2, -5, 0);
+    wallets.update(3, 0, 0);
+
+    using Tag = cs::MultiWallets::Tags;
+    using Order = cs::MultiWallets::Order;
+
+    ASSERT_EQ(wallets.size(), 2);
+    ASSERT_FALSE(wallets.contains(makeKey(2)));
+    ASSERT_EQ(keys(wallets.iterate<Tag::ByBalance>(0, 5, Order::Greater)), (std::vector<uint8_t>{1, 3}));
+
+    // wallet leaves the list when its balance becomes negative and returns with positive one
+    wallets.update(1, -1, 1);
+    ASSERT_EQ(keys(wallets.iterate<Tag::ByBalance>(0, 5, Order::Greater)), (std::vector<uint8_t>{3}));
+
+    wallets.update(2, 20, 1);
+    ASSERT_EQ(keys(wallets.iterate<Tag::ByBalance>(0, 5, Order::Greater)), (std::vector<uint8_t>{2, 3}));
+    ASSERT_EQ(wallets.size(), 2);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <csdb/address.hpp>
+#include <csdb/amount.hpp>
+#include <csdb/currency.hpp>
+#include <csdb/pool.hpp>
+#include <csdb/poolview.hpp>
+#include <csdb/transaction.hpp>
+
+namespace {
+cs::PublicKey makeKey(uint8_t value) {
+    cs::PublicKey key{};
+    key.fill(value);
+    return key;
+}
+
+csdb::Pool makePool() {
+    csdb::Pool pool(csdb::PoolHash::calc_from_data(cs::Bytes{1, 2, 3}), 42);
+    pool.add_user_field(0, std::string("1580000000000"));
+
+    for (uint8_t i = 0; i < 10; ++i) {
+        const auto source = (i % 2) ? csdb::Address::from_wallet_id(i) : csdb::Address::from_public_key(makeKey(i));
+        csdb::Transaction transaction(i + 1, source, csdb::Address::from_public_key(makeKey(100 + i)), csdb::Currency(1), csdb::Amount(i, 5),
+                                      csdb::AmountCommission(0.1), csdb::AmountCommission(0.01), cs::Signature{});
+
+        if (i % 3 == 0) {
+            transaction.add_user_field(1, std::string("payload"));
+            transaction.add_user_field(5, uint64_t(i));
+        }
+
+        pool.add_transaction(transaction);
+    }
+
+    pool.compose();
+    return pool;
+}
+}  // namespace
+
+TEST(PoolView, MatchesDecodedPool) {
+    const auto pool = makePool();
+    ASSERT_TRUE(pool.is_valid());
+
+    csdb::PoolView view(pool.to_binary());
+    ASSERT_TRUE(view.is_valid());
+
+    ASSERT_EQ(view.sequence(), pool.sequence());
+    ASSERT_EQ(view.previous_hash(), pool.previous_hash());
+    ASSERT_EQ(view.hash(), pool.hash());
+    ASSERT_EQ(view.get_time(), pool.get_time());
+    ASSERT_EQ(view.transactions_count(), pool.transactions_count());
+
+    for (size_t i = 0; i < pool.transactions_count(); ++i) {
+        const auto expected = pool.transaction(i);
+        const auto actual = view.transaction(i);
+
+        ASSERT_TRUE(actual.is_valid());
+        ASSERT_EQ(actual.id(), expected.id());
+        ASSERT_EQ(actual.innerID(), expected.innerID());
+        ASSERT_EQ(actual.source(), expected.source());
+        ASSERT_EQ(actual.target(), expected.target());
+        ASSERT_EQ(actual.amount(), expected.amount());
+        ASSERT_EQ(actual.max_fee().get_raw(), expected.max_fee().get_raw());
+        ASSERT_EQ(actual.counted_fee().get_raw(), expected.counted_fee().get_raw());
+        ASSERT_EQ(actual.currency(), expected.currency());
+        ASSERT_EQ(actual.signature(), expected.signature());
+        ASSERT_EQ(actual.user_field(1), expected.user_field(1));
+        ASSERT_EQ(actual.user_field(5), expected.user_field(5));
+        ASSERT_FALSE(actual.user_field(7).is_valid());
+
+        ASSERT_EQ(actual.to_transaction().to_byte_stream(), expected.to_byte_stream());
+        ASSERT_EQ(actual.to_transaction().id(), expected.id());
+    }
+
+    ASSERT_FALSE(view.transaction(pool.transactions_count()).is_valid());
+    ASSERT_EQ(view.to_pool().hash(), pool.hash());
+}
+
+TEST(PoolView, RejectsDamagedData) {
+    ASSERT_FALSE(csdb::PoolView(cs::Bytes{}).is_valid());
+    ASSERT_FALSE(csdb::PoolView(cs::Bytes{1, 2, 3}).is_valid());
+
+    auto bytes = makePool().to_binary();
+    bytes.resize(bytes.size() / 2);
+    ASSERT_FALSE(csdb::PoolView(std::move(bytes)).is_valid());
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+
+#include <csnode/roundtrace.hpp>
+
+TEST(RoundTrace, EventsAreRecordedForCurrentRound) {
+    cs::RoundTrace trace;
+
+    trace.startRound(10);
+    trace.record(cs::RoundTrace::Kind::StageOneReceived, 3);
+
+    {
+        cs::RoundTrace::Span span(trace, cs::RoundTrace::Kind::Validation);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    trace.startRound(11);
+
+    const auto events = trace.events();
+    ASSERT_EQ(events.size(), 4u);
+
+    ASSERT_EQ(events[0].kind, cs::RoundTrace::Kind::RoundStart);
+    ASSERT_EQ(events[0].round, 10u);
+
+    ASSERT_EQ(events[1].kind, cs::RoundTrace::Kind::StageOneReceived);
+    ASSERT_EQ(events[1].sender, 3);
+    ASSERT_EQ(events[1].round, 10u);
+
+    ASSERT_EQ(events[2].kind, cs::RoundTrace::Kind::Validation);
+    ASSERT_EQ(events[2].sender, cs::RoundTrace::kNoSender);
+    ASSERT_GE(events[2].duration, 2000u);
+    ASSERT_LE(events[2].time, events[3].time);
+
+    ASSERT_EQ(events[3].round, 11u);
+}
+
+TEST(RoundTrace, OldestEventsAreOverwritten) {
+    cs::RoundTrace trace;
+    trace.startRound(1);
+
+    for (size_t i = 0; i < cs::RoundTrace::kCapacity + 10; ++i) {
+        trace.record(cs::RoundTrace::Kind::StageTwoReceived, static_cast<uint8_t>(i % 100));
+    }
+
+    const auto events = trace.events();
+    ASSERT_EQ(events.size(), cs::RoundTrace::kCapacity);
+
+    // round start and the first 10 stages are gone
+    ASSERT_EQ(events.front().sender, 10);
+    ASSERT_EQ(events.back().sender, (cs::RoundTrace::kCapacity + 9) % 100);
+}
+
+TEST(RoundTrace, DumpIsLoadedAndRendered) {
+    cs::RoundTrace trace;
+    trace.startRound(42);
+    trace.record(cs::RoundTrace::Kind::StageOneReceived, 1);
+    trace.record(cs::RoundTrace::Kind::StageOneReceived, 5);
+    trace.record(cs::RoundTrace::Kind::BlockStore, cs::RoundTrace::kNoSender, 1500);
+
+    const auto path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("roundtrace_%%%%-%%%%")).string();
+    ASSERT_TRUE(trace.dump(path));
+
+    const auto events = cs::RoundTrace::load(path);
+    boost::filesystem::remove(path);
+
+    ASSERT_TRUE(events.has_value());
+
+    const auto expected = trace.events();
+    ASSERT_EQ(events->size(), expected.size());
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ((*events)[i].time, expected[i].time);
+        ASSERT_EQ((*events)[i].round, expected[i].round);
+        ASSERT_EQ((*events)[i].kind, expected[i].kind);
+        ASSERT_EQ((*events)[i].sender, expected[i].sender);
+        ASSERT_EQ((*events)[i].duration, expected[i].duration);
+    }
+
+    std::ostringstream os;
+    cs::RoundTrace::render(events.value(), os);
+
+    const auto text = os.str();
+    ASSERT_NE(text.find("Round 42"), std::string::npos);
+    ASSERT_NE(text.find("latest stage-1 received: [5]"), std::string::npos);
+    ASSERT_NE(text.find("longest block store: 1.500 ms"), std::string::npos);
+
+    ASSERT_FALSE(cs::RoundTrace::load(path).has_value());
+}
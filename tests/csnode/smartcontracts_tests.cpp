@@ -66,3 +66,27 @@ TEST(SmartContract, basic_checks) {
     ASSERT_TRUE(SmartContracts::is_new_state(t_state));
 
 }
+
+TEST(SmartContract, HungContractHoldsBackOnlyDependants) {
+    auto address = [](uint8_t value) {
+        cs::PublicKey key{};
+        key.fill(value);
+        return csdb::Address::from_public_key(key);
+    };
+
+    using Item = cs::ExecutionCommitOrder::Item;
+
+    // the oldest contract hangs, the second is independent, the third calls the hung one, the fourth uses the third
+    std::vector<Item> items = {
+        Item{{address(1)}, false},
+        Item{{address(2)}, true},
+        Item{{address(3), address(1)}, true},
+        Item{{address(4), address(3)}, true}
+    };
+
+    ASSERT_EQ(cs::ExecutionCommitOrder::ready(items), (std::vector<size_t>{1}));
+
+    // timed out or finished hung contract releases its dependants in queue order
+    items[0].completed = true;
+    ASSERT_EQ(cs::ExecutionCommitOrder::ready(items), (std::vector<size_t>{0, 1, 2, 3}));
+}
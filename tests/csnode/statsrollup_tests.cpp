@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <statsrollup.hpp>
+
+namespace {
+constexpr csstats::period_t kNow = 1'600'000'000;
+constexpr csstats::period_t kHour = csstats::Rollup::BucketSec;
+constexpr int64_t kMaxFraction = 1'000'000'000'000'000'000;
+
+csstats::BlockStats makeBlock(csstats::period_t time, csstats::Count transactions, int64_t integral = 0, int64_t fraction = 0) {
+    csstats::BlockStats block;
+    block.time = time;
+    block.transactionsCount = transactions;
+    csstats::addAmount(block.balancePerCurrency[1], integral, fraction);
+    return block;
+}
+}  // namespace
+
+TEST(StatsRollup, PeriodsAreSummedFromBuckets) {
+    csstats::Rollup rollup;
+
+    rollup.add(makeBlock(kNow - 10, 1), kNow);
+    rollup.add(makeBlock(kNow - 2 * csstats::secondsPerDay, 2), kNow);
+    rollup.add(makeBlock(kNow - 10 * csstats::secondsPerDay, 4), kNow);
+    rollup.add(makeBlock(kNow - 100 * csstats::secondsPerDay, 8), kNow);
+
+    // only the month is kept in buckets
+    ASSERT_EQ(rollup.bucketsCount(), 3u);
+
+    const auto stats = rollup.get(csstats::collectionPeriods, kNow);
+    ASSERT_EQ(stats.size(), csstats::collectionPeriods.size());
+
+    ASSERT_EQ(stats[csstats::Day].poolsCount, 1u);
+    ASSERT_EQ(stats[csstats::Day].transactionsCount, 1u);
+    ASSERT_EQ(stats[csstats::Week].transactionsCount, 3u);
+    ASSERT_EQ(stats[csstats::Month].transactionsCount, 7u);
+    ASSERT_EQ(stats[csstats::Total].poolsCount, 4u);
+    ASSERT_EQ(stats[csstats::Total].transactionsCount, 15u);
+    ASSERT_EQ(stats[csstats::Total].periodSec, csstats::collectionPeriods[csstats::Total]);
+
+    // the block leaves the day an hour bucket later at most
+    const auto later = rollup.get(csstats::collectionPeriods, kNow + csstats::secondsPerDay + kHour);
+    ASSERT_EQ(later[csstats::Day].transactionsCount, 0u);
+    ASSERT_EQ(later[csstats::Week].transactionsCount, 3u);
+}
+
+TEST(StatsRollup, RemovedBlockIsSubtracted) {
+    csstats::Rollup rollup;
+    const auto first = makeBlock(kNow - 20, 3, 1, kMaxFraction / 2);
+    const auto second = makeBlock(kNow - 10, 5, 2, kMaxFraction / 2);
+
+    rollup.add(first, kNow);
+    rollup.add(second, kNow);
+
+    auto stats = rollup.get(csstats::collectionPeriods, kNow);
+    ASSERT_EQ(stats[csstats::Day].balancePerCurrency[1].integral, 4);
+    ASSERT_EQ(stats[csstats::Day].balancePerCurrency[1].fraction, 0);
+
+    rollup.remove(second);
+    stats = rollup.get(csstats::collectionPeriods, kNow);
+
+    ASSERT_EQ(stats[csstats::Day].poolsCount, 1u);
+    ASSERT_EQ(stats[csstats::Day].transactionsCount, 3u);
+    ASSERT_EQ(stats[csstats::Total].balancePerCurrency[1].integral, 1);
+    ASSERT_EQ(stats[csstats::Total].balancePerCurrency[1].fraction, kMaxFraction / 2);
+
+    rollup.remove(first);
+    ASSERT_EQ(rollup.bucketsCount(), 0u);
+    ASSERT_EQ(rollup.get(csstats::collectionPeriods, kNow)[csstats::Total].poolsCount, 0u);
+}
+
+TEST(StatsRollup, SerializedRollupIsRestored) {
+    csstats::Rollup rollup;
+    rollup.add(makeBlock(kNow - 10, 1, 5, 7), kNow);
+    rollup.add(makeBlock(kNow - 3 * kHour, 2, 1, 1), kNow);
+
+    std::stringstream stream;
+    rollup.serialize(stream);
+
+    csstats::Rollup restored;
+    ASSERT_TRUE(restored.deserialize(stream));
+    ASSERT_EQ(restored.bucketsCount(), rollup.bucketsCount());
+
+    const auto expected = rollup.get(csstats::collectionPeriods, kNow);
+    const auto stats = restored.get(csstats::collectionPeriods, kNow);
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(stats[i].poolsCount, expected[i].poolsCount);
+        ASSERT_EQ(stats[i].transactionsCount, expected[i].transactionsCount);
+        ASSERT_EQ(stats[i].balancePerCurrency.at(1).integral, expected[i].balancePerCurrency.at(1).integral);
+        ASSERT_EQ(stats[i].balancePerCurrency.at(1).fraction, expected[i].balancePerCurrency.at(1).fraction);
+    }
+
+    std::stringstream truncated(stream.str().substr(0, 10));
+    ASSERT_FALSE(restored.deserialize(truncated));
+    ASSERT_EQ(restored.bucketsCount(), 0u);
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+
+#include <csdb/address.hpp>
+#include <csdb/amount.hpp>
+#include <csdb/amount_commission.hpp>
+#include <csdb/currency.hpp>
+#include <csdb/transaction.hpp>
+
+#include <csnode/datastream.hpp>
+#include <csnode/walletscache.hpp>
+#include <csnode/walletsids.hpp>
+
+namespace {
+cs::PublicKey makeKey(uint8_t value) {
+    cs::PublicKey key{};
+    key.fill(value);
+    return key;
+}
+
+csdb::Transaction makeTransaction(uint8_t source, double countedFee) {
+    return csdb::Transaction(source + 1, csdb::Address::from_public_key(makeKey(source)), csdb::Address::from_public_key(makeKey(255)), csdb::Currency(1),
+                             csdb::Amount(1), csdb::AmountCommission(1.0), csdb::AmountCommission(countedFee), cs::Signature{});
+}
+
+// creates wallets 0..count-1 and 100..100+count-1, every pair exchanges fee
+void fill(cs::WalletsCache::Updater& updater, uint8_t count) {
+    for (uint8_t i = 0; i < count; ++i) {
+        updater.smartSourceTransactionReleased(makeTransaction(i, 0.5 + i), makeTransaction(100 + i, 0.0));
+        updater.updateLastTransactions({{makeKey(i), csdb::TransactionID(i, 1)}});
+    }
+}
+
+template <typename T>
+cs::Bytes serialize(const T& object) {
+    cs::Bytes data;
+
+    {
+        cs::DataStream stream(data);
+        object.serialize(stream);
+    }
+
+    return data;
+}
+
+template <typename T>
+bool deserialize(T& object, const cs::Bytes& data) {
+    cs::DataStream stream(data.data(), data.size());
+    return object.deserialize(stream);
+}
+
+void expectSameWallets(const cs::WalletsCache::Updater& expected, const cs::WalletsCache::Updater& actual, uint8_t count) {
+    for (uint8_t i = 0; i < count; ++i) {
+        for (auto key : {makeKey(i), makeKey(100 + i)}) {
+            const auto* lhs = expected.findWallet(key);
+            const auto* rhs = actual.findWallet(key);
+
+            ASSERT_NE(lhs, nullptr);
+            ASSERT_NE(rhs, nullptr);
+            ASSERT_EQ(lhs->balance_, rhs->balance_);
+            ASSERT_EQ(lhs->transNum_, rhs->transNum_);
+            ASSERT_EQ(lhs->lastTransaction_, rhs->lastTransaction_);
+        }
+    }
+}
+}  // namespace
+
+TEST(WalletsIds, SerializationRoundTrip) {
+    cs::WalletsIds ids;
+
+    for (uint8_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(ids.normal().insert(csdb::Address::from_public_key(makeKey(i)), i));
+    }
+
+    cs::WalletsIds::WalletId special = 0;
+    ASSERT_TRUE(ids.special().findAnyOrInsertSpecial(csdb::Address::from_public_key(makeKey(200)), special));
+
+    cs::WalletsIds restored;
+    ASSERT_TRUE(deserialize(restored, serialize(ids)));
+
+    for (uint8_t i = 0; i < 100; ++i) {
+        cs::WalletsIds::WalletId id = 0;
+        ASSERT_TRUE(restored.normal().find(csdb::Address::from_public_key(makeKey(i)), id));
+        ASSERT_EQ(id, i);
+    }
+
+    auto expected = ids.content();
+    auto actual = restored.content();
+
+    ASSERT_EQ(actual.nextId, expected.nextId);
+    ASSERT_EQ(actual.nextIdSpecial, expected.nextIdSpecial);
+
+    std::sort(expected.wallets.begin(), expected.wallets.end());
+    std::sort(actual.wallets.begin(), actual.wallets.end());
+    ASSERT_EQ(actual.wallets, expected.wallets);
+
+    // content is serialized as ids are
+    ASSERT_EQ(serialize(ids), serialize(ids.content()));
+}
+
+TEST(WalletsIds, DamagedDataKeepsContent) {
+    cs::WalletsIds ids;
+    ASSERT_TRUE(ids.normal().insert(csdb::Address::from_public_key(makeKey(1)), 1));
+
+    auto data = serialize(ids);
+    data.resize(data.size() - 1);
+
+    cs::WalletsIds restored;
+    ASSERT_TRUE(restored.normal().insert(csdb::Address::from_public_key(makeKey(2)), 2));
+    ASSERT_FALSE(deserialize(restored, data));
+
+    cs::WalletsIds::WalletId id = 0;
+    ASSERT_TRUE(restored.normal().find(csdb::Address::from_public_key(makeKey(2)), id));
+}
+
+TEST(WalletsCache, SerializationRoundTrip) {
+    const uint8_t kCount = 50;
+
+    cs::WalletsIds ids;
+    cs::WalletsCache cache(ids);
+    auto updater = cache.createUpdater();
+    fill(*updater, kCount);
+
+    cs::WalletsIds restoredIds;
+    cs::WalletsCache restored(restoredIds);
+    auto restoredUpdater = restored.createUpdater();
+
+    ASSERT_TRUE(deserialize(restored, serialize(cache)));
+    ASSERT_EQ(restored.getCount(), cache.getCount());
+    expectSameWallets(*updater, *restoredUpdater, kCount);
+
+    auto data = serialize(cache);
+    data.resize(data.size() / 2);
+
+    ASSERT_FALSE(deserialize(restored, data));
+    ASSERT_EQ(restored.getCount(), cache.getCount());
+}
+
+TEST(WalletsCache, FrozenStateIsNotChanged) {
+    const uint8_t kCount = 50;
+
+    cs::WalletsIds ids;
+    cs::WalletsCache cache(ids);
+    auto updater = cache.createUpdater();
+    fill(*updater, kCount);
+
+    const auto before = serialize(cache);
+    const auto count = cache.getCount();
+
+    auto frozen = cache.freeze();
+    ASSERT_NE(frozen, nullptr);
+    ASSERT_EQ(serialize(*frozen), before);
+
+    // changes after freeze are seen by cache only
+    updater->updateLastTransactions({{makeKey(1), csdb::TransactionID(1000, 1)}});
+    fill(*updater, kCount + 1);
+
+    ASSERT_EQ(serialize(*frozen), before);
+    ASSERT_EQ(cache.getCount(), count + 2);
+    ASSERT_EQ(updater->findWallet(makeKey(1))->lastTransaction_, csdb::TransactionID(1, 1));
+
+    // frozen state is in use
+    ASSERT_EQ(cache.freeze(), nullptr);
+
+    cs::WalletsIds frozenIds;
+    cs::WalletsCache fromFrozen(frozenIds);
+    ASSERT_TRUE(deserialize(fromFrozen, serialize(*frozen)));
+    ASSERT_EQ(fromFrozen.getCount(), count);
+
+    const auto after = serialize(cache);
+    frozen.reset();
+    cache.compact();
+
+    cs::WalletsIds compactedIds;
+    cs::WalletsCache compacted(compactedIds);
+    ASSERT_TRUE(deserialize(compacted, after));
+    ASSERT_EQ(cache.getCount(), count + 2);
+    expectSameWallets(*compacted.createUpdater(), *updater, kCount + 1);
+
+    ASSERT_NE(cache.freeze(), nullptr);
+}
+
+TEST(WalletsCache, FrozenStateIsReleasedByOtherThread) {
+    const uint8_t kCount = 50;
+
+    cs::WalletsIds ids;
+    cs::WalletsCache cache(ids);
+    auto updater = cache.createUpdater();
+    fill(*updater, kCount);
+
+    const auto before = serialize(cache);
+    cs::Bytes written;
+
+    std::thread writer([frozen = cache.freeze(), &written]() mutable {
+        written = serialize(*frozen);
+        frozen.reset();
+    });
+
+    fill(*updater, kCount + 1);
+
+    // cache joins wallets only after the writer has released them
+    std::shared_ptr<const cs::WalletsCache::Frozen> next;
+
+    while (!(next = cache.freeze())) {
+        std::this_thread::yield();
+    }
+
+    writer.join();
+
+    ASSERT_EQ(written, before);
+    ASSERT_EQ(cache.getCount(), static_cast<size_t>(2 * (kCount + 1)));
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include <csnode/walletsshards.hpp>
+
+namespace {
+cs::PublicKey makeKey(uint8_t value) {
+    cs::PublicKey key{};
+    key.fill(value);
+    return key;
+}
+
+cs::WalletsShards::WalletData makeWallet(int32_t balance, uint64_t transactions) {
+    cs::WalletsShards::WalletData data;
+    data.balance_ = csdb::Amount(balance);
+    data.transNum_ = transactions;
+    return data;
+}
+}  // namespace
+
+TEST(WalletsShards, PublishReplacesWallets) {
+    cs::WalletsShards shards;
+
+    cs::WalletsShards::Wallets wallets;
+    for (uint8_t i = 0; i < 200; ++i) {
+        wallets.emplace_back(makeKey(i), makeWallet(i, 1));
+    }
+
+    shards.publish(std::move(wallets));
+    ASSERT_EQ(shards.size(), 200);
+
+    cs::WalletsShards::Wallets update;
+    update.emplace_back(makeKey(7), makeWallet(700, 2));
+    shards.publish(std::move(update));
+
+    cs::WalletsShards::WalletData data;
+    ASSERT_TRUE(shards.find(makeKey(7), data));
+    ASSERT_EQ(data.balance_, csdb::Amount(700));
+    ASSERT_EQ(data.transNum_, 2);
+    ASSERT_EQ(shards.size(), 200);
+
+    ASSERT_FALSE(shards.find(makeKey(250), data));
+    ASSERT_FALSE(shards.apply(makeKey(250), [](const auto&) { FAIL(); }));
+
+    size_t visited = 0;
+    shards.iterate([&visited](const cs::PublicKey&, const cs::WalletsShards::WalletData&) {
+        return ++visited < 10;
+    });
+    ASSERT_EQ(visited, 10);
+}
+
+TEST(WalletsShards, ReadersSeePublishedState) {
+    cs::WalletsShards shards;
+    const cs::PublicKey key = makeKey(1);
+
+    shards.publish({{key, makeWallet(0, 0)}});
+
+    std::atomic<bool> stop = false;
+    std::atomic<bool> consistent = true;
+
+    // every published state has balance equal to transactions count
+    std::thread reader([&] {
+        while (!stop) {
+            shards.apply(key, [&](const cs::WalletsShards::WalletData& wallet) {
+                if (wallet.balance_ != csdb::Amount(static_cast<int32_t>(wallet.transNum_))) {
+                    consistent = false;
+                }
+            });
+        }
+    });
+
+    for (int32_t i = 1; i <= 10000; ++i) {
+        shards.publish({{key, makeWallet(i, static_cast<uint64_t>(i))}});
+    }
+
+    stop = true;
+    reader.join();
+
+    ASSERT_TRUE(consistent);
+}
+
+TEST(WalletsShards, PublishIsAtomicAcrossShards) {
+    cs::WalletsShards shards;
+
+    // keys are in different shards
+    const cs::PublicKey first = makeKey(1);
+    const cs::PublicKey second = makeKey(2);
+
+    shards.publish({{first, makeWallet(0, 0)}, {second, makeWallet(0, 0)}});
+
+    std::atomic<bool> stop = false;
+    std::atomic<bool> consistent = true;
+
+    // both wallets are changed by every publish, so readers see equal balances
+    std::thread reader([&] {
+        while (!stop) {
+            csdb::Amount balances[2];
+
+            shards.iterate([&](const cs::PublicKey& key, const cs::WalletsShards::WalletData& wallet) {
+                balances[key == first ? 0 : 1] = wallet.balance_;
+                return true;
+            });
+
+            if (balances[0] != balances[1]) {
+                consistent = false;
+            }
+        }
+    });
+
+    for (int32_t i = 1; i <= 10000; ++i) {
+        shards.publish({{first, makeWallet(i, 1)}, {second, makeWallet(i, 1)}});
+    }
+
+    stop = true;
+    reader.join();
+
+    ASSERT_TRUE(consistent);
+    ASSERT_EQ(shards.size(), 2);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+#include <csnode/walletssnapshot.hpp>
+
+namespace {
+const char* kPath = "./test_snapshots";
+
+csdb::PoolHash makeHash(uint8_t value) {
+    return csdb::PoolHash::from_binary(cs::Bytes(32, value));
+}
+
+class WalletsSnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        boost::filesystem::remove_all(kPath);
+    }
+
+    void TearDown() override {
+        boost::filesystem::remove_all(kPath);
+    }
+};
+}  // namespace
+
+TEST_F(WalletsSnapshotTest, LoadsNewestAccepted) {
+    cs::WalletsSnapshot snapshot(kPath);
+
+    ASSERT_TRUE(snapshot.save(10, makeHash(1), cs::Bytes{1, 2, 3}));
+    ASSERT_TRUE(snapshot.save(20, makeHash(2), cs::Bytes{4, 5, 6}));
+
+    cs::Sequence sequence = 0;
+    cs::Bytes data;
+
+    ASSERT_TRUE(snapshot.load([](cs::Sequence, const csdb::PoolHash&) { return true; }, sequence, data));
+    ASSERT_EQ(sequence, 20);
+    ASSERT_EQ(data, (cs::Bytes{4, 5, 6}));
+
+    // newest one does not fit to chain
+    ASSERT_TRUE(snapshot.load([](cs::Sequence seq, const csdb::PoolHash& hash) { return seq <= 15 && hash == makeHash(1); }, sequence, data));
+    ASSERT_EQ(sequence, 10);
+    ASSERT_EQ(data, (cs::Bytes{1, 2, 3}));
+}
+
+TEST_F(WalletsSnapshotTest, KeepsLimitedCount) {
+    cs::WalletsSnapshot snapshot(kPath);
+
+    for (cs::Sequence seq = 1; seq <= cs::WalletsSnapshot::KeepCount + 2; ++seq) {
+        ASSERT_TRUE(snapshot.save(seq, makeHash(uint8_t(seq)), cs::Bytes{uint8_t(seq)}));
+    }
+
+    cs::Sequence sequence = 0;
+    cs::Bytes data;
+
+    ASSERT_FALSE(snapshot.load([](cs::Sequence seq, const csdb::PoolHash&) { return seq <= 2; }, sequence, data));
+}
+
+TEST_F(WalletsSnapshotTest, RemoveAfterDropsNewer) {
+    cs::WalletsSnapshot snapshot(kPath);
+
+    ASSERT_TRUE(snapshot.save(10, makeHash(1), cs::Bytes{1}));
+    ASSERT_TRUE(snapshot.save(20, makeHash(2), cs::Bytes{2}));
+
+    snapshot.removeAfter(15);
+
+    cs::Sequence sequence = 0;
+    cs::Bytes data;
+
+    ASSERT_TRUE(snapshot.load([](cs::Sequence, const csdb::PoolHash&) { return true; }, sequence, data));
+    ASSERT_EQ(sequence, 10);
+}
+
+TEST_F(WalletsSnapshotTest, DamagedSnapshotIsSkipped) {
+    {
+        cs::WalletsSnapshot snapshot(kPath);
+        ASSERT_TRUE(snapshot.save(10, makeHash(1), cs::Bytes{1, 2, 3}));
+        ASSERT_TRUE(snapshot.save(20, makeHash(2), cs::Bytes{4, 5, 6}));
+    }
+
+    // corrupt the last byte of payload of the newest snapshot
+    const auto path = boost::filesystem::path(kPath) / "wallets_20.snapshot";
+    const auto size = boost::filesystem::file_size(path);
+    boost::filesystem::resize_file(path, size - 1);
+
+    cs::WalletsSnapshot snapshot(kPath);
+    cs::Sequence sequence = 0;
+    cs::Bytes data;
+
+    ASSERT_TRUE(snapshot.load([](cs::Sequence, const csdb::PoolHash&) { return true; }, sequence, data));
+    ASSERT_EQ(sequence, 10);
+}
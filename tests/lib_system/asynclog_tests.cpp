@@ -0,0 +1,206 @@
+#include "gtest/gtest.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/log/core/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+
+#include <lib/system/logger.hpp>
+
+namespace {
+// keeps messages, may hold the flusher
+class MemoryBackend : public boost::log::sinks::basic_formatted_sink_backend<char, boost::log::sinks::synchronized_feeding> {
+public:
+    void consume(const boost::log::record_view&, const std::string& message) {
+        std::unique_lock lock(mutex_);
+        variable_.wait(lock, [this] { return !held_; });
+        messages_.push_back(message);
+    }
+
+    void hold(bool held) {
+        {
+            std::lock_guard lock(mutex_);
+            held_ = held;
+        }
+
+        variable_.notify_all();
+    }
+
+    std::vector<std::string> messages() {
+        std::lock_guard lock(mutex_);
+        return messages_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable variable_;
+    std::vector<std::string> messages_;
+    bool held_ = false;
+};
+
+using MemorySink = boost::log::sinks::synchronous_sink<MemoryBackend>;
+
+class AsyncLogTest : public ::testing::Test {
+protected:
+    void start(const logger::AsyncSettings& settings) {
+        namespace expr = boost::log::expressions;
+
+        backend_ = boost::make_shared<MemoryBackend>();
+        sink_ = boost::make_shared<MemorySink>(backend_);
+        sink_->set_formatter(expr::stream << boost::log::trivial::severity << " " << expr::smessage);
+
+        boost::log::core::get()->add_sink(sink_);
+        logger::AsyncLog::instance().start(settings);
+    }
+
+    void TearDown() override {
+        backend_->hold(false);
+        logger::AsyncLog::instance().stop();
+        boost::log::core::get()->remove_sink(sink_);
+    }
+
+    boost::shared_ptr<MemoryBackend> backend_;
+    boost::shared_ptr<MemorySink> sink_;
+};
+}  // namespace
+
+TEST_F(AsyncLogTest, ArgumentsAreCapturedAtCall) {
+    start(logger::AsyncSettings());
+    backend_->hold(true);
+
+    int value = 10;
+    std::string text = "text";
+    csinfo() << "value " << value << ", " << text << ", hex " << std::hex << 255 << std::dec << ", " << WithDelimiters<int>(1000000);
+
+    value = 20;
+    text = "changed";
+
+    backend_->hold(false);
+    logger::AsyncLog::instance().flush();
+
+    const auto messages = backend_->messages();
+    ASSERT_EQ(messages.size(), 1u);
+    ASSERT_EQ(messages.front(), "info value 10, text, hex ff, 1'000'000");
+}
+
+TEST_F(AsyncLogTest, RecordsOfThreadKeepOrder) {
+    start(logger::AsyncSettings());
+
+    constexpr size_t kThreads = 4;
+    constexpr size_t kRecords = 2000;
+
+    std::vector<std::thread> threads;
+
+    for (size_t thread = 0; thread < kThreads; ++thread) {
+        threads.emplace_back([thread] {
+            for (size_t i = 0; i < kRecords; ++i) {
+                cswarning() << thread << " " << i;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    logger::AsyncLog::instance().flush();
+
+    const auto messages = backend_->messages();
+    ASSERT_EQ(messages.size(), kThreads * kRecords);
+
+    std::vector<size_t> next(kThreads, 0);
+
+    for (const auto& message : messages) {
+        size_t thread = 0;
+        size_t index = 0;
+        ASSERT_EQ(std::sscanf(message.c_str(), "warning %zu %zu", &thread, &index), 2);
+        ASSERT_LT(thread, kThreads);
+        ASSERT_EQ(index, next[thread]++);
+    }
+}
+
+TEST_F(AsyncLogTest, OverflowedRecordsAreDropped) {
+    logger::AsyncSettings settings;
+    settings.bufferSize = 8;
+    settings.overflow = logger::OverflowPolicy::Drop;
+
+    start(settings);
+    backend_->hold(true);
+
+    const auto before = logger::AsyncLog::instance().metrics();
+    size_t evaluated = 0;
+
+    for (size_t i = 0; i < 100; ++i) {
+        csinfo() << "record " << ++evaluated;
+    }
+
+    const auto after = logger::AsyncLog::instance().metrics();
+
+    backend_->hold(false);
+    logger::AsyncLog::instance().flush();
+
+    const size_t written = backend_->messages().size();
+    const size_t dropped = after.dropped - before.dropped;
+
+    ASSERT_GT(dropped, 0u);
+    ASSERT_EQ(written + dropped, 100u);
+
+    // arguments of dropped record are not evaluated
+    ASSERT_EQ(evaluated, written);
+}
+
+TEST_F(AsyncLogTest, RepeatedRecordsAreLimited) {
+    logger::AsyncSettings settings;
+    settings.rateLimit = 5;
+
+    start(settings);
+
+    auto log = [] {
+        for (size_t i = 0; i < 100; ++i) {
+            csdebug() << "repeated";
+        }
+    };
+
+    // all records should get the same second
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    std::this_thread::sleep_for(std::chrono::seconds(1) - (now - std::chrono::duration_cast<std::chrono::seconds>(now)));
+
+    log();
+    logger::AsyncLog::instance().flush();
+    ASSERT_LE(backend_->messages().size(), 5u);
+
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    log();
+    logger::AsyncLog::instance().flush();
+
+    const auto messages = backend_->messages();
+    ASSERT_LE(messages.size(), 10u);
+
+    // the first message of the next second reports suppressed ones
+    bool reported = false;
+
+    for (const auto& message : messages) {
+        reported = reported || message.find("similar messages suppressed") != std::string::npos;
+    }
+
+    ASSERT_TRUE(reported);
+}
+
+TEST_F(AsyncLogTest, DisabledBackendWritesAtOnce) {
+    logger::AsyncSettings settings;
+    settings.enabled = false;
+
+    start(settings);
+
+    csinfo() << "sync " << 1;
+
+    ASSERT_FALSE(logger::AsyncLog::instance().isRunning());
+    ASSERT_EQ(backend_->messages(), std::vector<std::string>{"info sync 1"});
+}
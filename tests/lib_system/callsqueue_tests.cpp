@@ -0,0 +1,162 @@
+#include "gtest/gtest.h"
+
+#include <array>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <lib/system/structures.hpp>
+
+TEST(CallsQueue, CallsAreRunInInsertionOrder) {
+    CallsQueue queue;
+    std::vector<int> order;
+
+    for (int i = 0; i < 10; ++i) {
+        queue.insert([&order, i] { order.push_back(i); });
+    }
+
+    ASSERT_EQ(queue.size(), 10u);
+    queue.callAll();
+
+    ASSERT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    ASSERT_EQ(queue.size(), 0u);
+}
+
+TEST(CallsQueue, CallInsertedByCallRunsNextTime) {
+    CallsQueue queue;
+    int calls = 0;
+
+    queue.insert([&] {
+        ++calls;
+        queue.insert([&] { ++calls; });
+    });
+
+    queue.callAll();
+    ASSERT_EQ(calls, 1);
+
+    queue.callAll();
+    ASSERT_EQ(calls, 2);
+}
+
+TEST(CallsQueue, LargeCallableIsAccepted) {
+    CallsQueue queue;
+
+    std::array<uint64_t, 64> values{};
+    values.back() = 42;
+
+    uint64_t result = 0;
+    queue.insert([&result, values] { result = values.back(); });
+
+    queue.callAll();
+    ASSERT_EQ(result, 42u);
+}
+
+TEST(CallsQueue, OverflowKeepsOrderOfProducers) {
+    constexpr size_t kProducers = 3;
+    constexpr int kCalls = 20000;
+
+    // small ring makes producers overflow it
+    CallsQueue queue(16);
+
+    std::array<std::vector<int>, kProducers> received;
+    std::atomic<size_t> finished = 0;
+    std::vector<std::thread> producers;
+
+    for (size_t producer = 0; producer < kProducers; ++producer) {
+        producers.emplace_back([&, producer] {
+            for (int i = 0; i < kCalls; ++i) {
+                queue.insert([&received, producer, i] { received[producer].push_back(i); });
+            }
+
+            ++finished;
+        });
+    }
+
+    while (finished != kProducers) {
+        queue.callAll();
+    }
+
+    queue.callAll();
+    queue.callAll();
+
+    for (auto& thread : producers) {
+        thread.join();
+    }
+
+    for (const auto& values : received) {
+        ASSERT_EQ(values.size(), static_cast<size_t>(kCalls));
+
+        for (int i = 0; i < kCalls; ++i) {
+            ASSERT_EQ(values[static_cast<size_t>(i)], i);
+        }
+    }
+
+    const auto stats = queue.producers();
+    ASSERT_EQ(stats.size(), kProducers);
+
+    uint64_t overflows = 0;
+
+    for (const auto& item : stats) {
+        ASSERT_EQ(item.calls, static_cast<uint64_t>(kCalls));
+        overflows += item.overflows;
+    }
+
+    ASSERT_GT(overflows, 0u);
+}
+
+TEST(CallsQueue, RecordsOfExitedProducersAreReused) {
+    constexpr size_t kExited = 2 * CallsQueue::MaxProducers;
+    constexpr size_t kLiving = CallsQueue::MaxProducers - 1;
+
+    CallsQueue queue;
+
+    for (size_t i = 0; i < kExited; ++i) {
+        std::thread([&queue] { queue.insert([] {}); }).join();
+    }
+
+    std::atomic<size_t> inserted = 0;
+    std::atomic<bool> done = false;
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < kLiving; ++i) {
+        threads.emplace_back([&] {
+            queue.insert([] {});
+            ++inserted;
+
+            while (!done) {
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    while (inserted != kLiving) {
+        std::this_thread::yield();
+    }
+
+    const auto stats = queue.producers();
+    std::set<std::thread::id> ids;
+
+    for (auto& thread : threads) {
+        ids.insert(thread.get_id());
+    }
+
+    done = true;
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    queue.callAll();
+
+    uint64_t calls = 0;
+
+    // every living thread has own record
+    for (const auto& item : stats) {
+        ids.erase(item.thread);
+        calls += item.calls;
+    }
+
+    ASSERT_TRUE(ids.empty());
+    ASSERT_EQ(calls, static_cast<uint64_t>(kExited + kLiving));
+}
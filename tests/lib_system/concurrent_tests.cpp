@@ -411,3 +411,44 @@ TEST(Concurrent, FutureWatcherHighMultithreading) {
 
     ASSERT_EQ(currentThreadPoolSum, expectedSum);
 }
+
+TEST(Concurrent, BlockingRunDoesNotOccupyRuntime) {
+    const size_t count = cs::TaskRuntime::instance().workersCount() + 1;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool released = false;
+    std::atomic<size_t> finished = 0;
+
+    std::vector<cs::FutureWatcherPtr<int>> watchers;
+
+    // every runtime worker would be blocked here if blocking functions were run by runtime
+    for (size_t i = 0; i < count; ++i) {
+        watchers.push_back(cs::Concurrent::runBlocking(cs::RunPolicy::ThreadPolicy, [&] {
+            std::unique_lock lock(mutex);
+            condition.wait_for(lock, std::chrono::milliseconds(sleepTimeMs), [&] { return released; });
+            return released ? 1 : 0;
+        }));
+
+        cs::Connector::connect(&watchers.back()->finished, [&finished](const int& result) {
+            finished += static_cast<size_t>(result);
+        });
+    }
+
+    cs::Concurrent::run([&] {
+        {
+            std::lock_guard lock(mutex);
+            released = true;
+        }
+
+        condition.notify_all();
+    });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(sleepTimeMs * 2);
+
+    while (finished != count && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(finished, count);
+}
@@ -7,6 +7,7 @@
 #include <mutex>
 #include <thread>
 #include <type_traits>
+#include <vector>
 #include <condition_variable>
 
 #include <lib/system/random.hpp>
@@ -255,6 +256,141 @@ TEST(fuqueue, DISABLED_multithreaded_stress) {
     r3.join();
 }
 
+TEST(SPSCRing, FullAndEmpty) {
+    SPSCRing<uint32_t, 8> ring;
+
+    ASSERT_EQ(ring.front(), nullptr);
+
+    for (uint32_t i = 0; i < ring.capacity(); ++i) {
+        auto element = ring.back();
+        ASSERT_NE(element, nullptr);
+        *element = i;
+        ring.push();
+    }
+
+    ASSERT_EQ(ring.back(), nullptr);
+    ASSERT_EQ(ring.size(), ring.capacity());
+
+    for (uint32_t i = 0; i < ring.capacity(); ++i) {
+        auto element = ring.front();
+        ASSERT_NE(element, nullptr);
+        ASSERT_EQ(*element, i);
+        ring.pop();
+    }
+
+    ASSERT_EQ(ring.front(), nullptr);
+    ASSERT_EQ(ring.size(), 0);
+}
+
+TEST(SPSCRing, ElementsAreKeptForReuse) {
+    SPSCRing<std::vector<int>, 2> ring;
+
+    ring.back()->assign(100, 1);
+    ring.push();
+    ring.pop();
+
+    ring.back();
+    ring.push();
+    ring.pop();
+
+    ASSERT_EQ(ring.back()->size(), 100);
+}
+
+TEST(SPSCRing, multithreaded_order) {
+    SPSCRing<uint32_t, 64> ring;
+    constexpr uint32_t count = 100000;
+
+    std::thread writer([&] {
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t* element = nullptr;
+
+            while ((element = ring.back()) == nullptr) {
+                std::this_thread::yield();
+            }
+
+            *element = i;
+            ring.push();
+        }
+    });
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t* element = nullptr;
+
+        while ((element = ring.front()) == nullptr) {
+            std::this_thread::yield();
+        }
+
+        ASSERT_EQ(*element, i);
+        ring.pop();
+    }
+
+    writer.join();
+}
+
+TEST(MPSCRing, FullAndEmpty) {
+    MPSCRing<uint32_t, 8> ring;
+
+    ASSERT_EQ(ring.front(), nullptr);
+
+    for (uint32_t i = 0; i < ring.capacity(); ++i) {
+        ASSERT_TRUE(ring.tryPush([i](uint32_t& element) { element = i; }));
+    }
+
+    ASSERT_FALSE(ring.tryPush([](uint32_t&) {}));
+    ASSERT_EQ(ring.size(), ring.capacity());
+
+    for (uint32_t i = 0; i < ring.capacity(); ++i) {
+        auto element = ring.front();
+        ASSERT_NE(element, nullptr);
+        ASSERT_EQ(*element, i);
+        ring.pop();
+    }
+
+    ASSERT_EQ(ring.front(), nullptr);
+    ASSERT_EQ(ring.size(), 0);
+}
+
+TEST(MPSCRing, multithreaded_sum) {
+    MPSCRing<uint32_t, 128> ring;
+
+    constexpr uint32_t writers = 4;
+    constexpr uint32_t count = 50000;
+
+    auto writerFunc = [&] {
+        for (uint32_t i = 1; i <= count; ++i) {
+            while (!ring.tryPush([i](uint32_t& element) { element = i; })) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (uint32_t i = 0; i < writers; ++i) {
+        threads.emplace_back(writerFunc);
+    }
+
+    uint64_t sum = 0;
+
+    for (uint32_t i = 0; i < writers * count; ++i) {
+        uint32_t* element = nullptr;
+
+        while ((element = ring.front()) == nullptr) {
+            std::this_thread::yield();
+        }
+
+        sum += *element;
+        ring.pop();
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(sum, uint64_t(writers) * count * (count + 1) / 2);
+    ASSERT_EQ(ring.front(), nullptr);
+}
+
 TEST(boost_spsc_queue, DISABLED_multithreaded_stress) {
     boost::lockfree::spsc_queue<uint32_t, boost::lockfree::capacity<10000>> queue;
 
@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <lib/system/taskruntime.hpp>
+
+namespace {
+void waitFor(const std::atomic<size_t>& value, size_t expected) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (value.load() < expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+}  // namespace
+
+TEST(TaskRuntime, AllTasksAreExecuted) {
+    cs::TaskRuntime runtime(4);
+    std::atomic<size_t> done = 0;
+
+    const size_t count = 10000;
+
+    for (size_t i = 0; i < count; ++i) {
+        runtime.submit([&done] { ++done; });
+    }
+
+    waitFor(done, count);
+    ASSERT_EQ(done.load(), count);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    const auto metrics = runtime.metrics();
+    ASSERT_EQ(metrics.workers, 4u);
+    ASSERT_EQ(metrics.queued, 0u);
+    ASSERT_EQ(metrics.executed, count);
+}
+
+TEST(TaskRuntime, HighPriorityTaskGoesFirst) {
+    cs::TaskRuntime runtime(2);
+    std::atomic<size_t> released = 0;
+    std::atomic<size_t> blocked = 0;
+    std::atomic<size_t> done = 0;
+
+    std::mutex mutex;
+    std::vector<cs::TaskPriority> order;
+
+    // occupy both workers
+    for (size_t i = 0; i < 2; ++i) {
+        runtime.submit([&, i] {
+            ++blocked;
+
+            while (released.load() <= i) {
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    waitFor(blocked, 2);
+
+    for (auto priority : {cs::TaskPriority::Low, cs::TaskPriority::Normal, cs::TaskPriority::High}) {
+        runtime.submit([&, priority] {
+            {
+                std::lock_guard lock(mutex);
+                order.push_back(priority);
+            }
+
+            ++done;
+        }, priority);
+    }
+
+    // the only released worker executes tasks one by one
+    released = 1;
+    waitFor(done, 3);
+    released = 2;
+
+    std::lock_guard lock(mutex);
+    ASSERT_EQ(order, (std::vector<cs::TaskPriority>{cs::TaskPriority::High, cs::TaskPriority::Normal, cs::TaskPriority::Low}));
+}
+
+TEST(TaskRuntime, IdleWorkersStealSpawnedTasks) {
+    cs::TaskRuntime runtime(4);
+    std::atomic<size_t> done = 0;
+
+    const size_t count = 64;
+
+    // spawned tasks are pushed to deque of the spawning worker
+    runtime.submit([&] {
+        for (size_t i = 0; i < count; ++i) {
+            runtime.submit([&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ++done;
+            });
+        }
+    });
+
+    waitFor(done, count);
+
+    ASSERT_EQ(done.load(), count);
+    ASSERT_GT(runtime.metrics().steals, 0u);
+}
+
+TEST(TaskRuntime, DelayedTasksAreExecutedInTimeOrder) {
+    cs::TaskRuntime runtime(2);
+    std::atomic<size_t> done = 0;
+
+    std::mutex mutex;
+    std::vector<int> order;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    for (int delay : {60, 20, 40}) {
+        runtime.submitAt(now + std::chrono::milliseconds(delay), [&, delay] {
+            {
+                std::lock_guard lock(mutex);
+                order.push_back(delay);
+            }
+
+            ++done;
+        });
+    }
+
+    ASSERT_EQ(runtime.metrics().delayed, 3u);
+
+    waitFor(done, 3);
+
+    ASSERT_GE(std::chrono::steady_clock::now() - now, std::chrono::milliseconds(60));
+
+    std::lock_guard lock(mutex);
+    ASSERT_EQ(order, (std::vector<int>{20, 40, 60}));
+}
+
+TEST(TaskRuntime, MoveOnlyTaskIsAccepted) {
+    cs::TaskRuntime runtime(2);
+    std::atomic<size_t> done = 0;
+
+    auto value = std::make_unique<size_t>(42);
+
+    runtime.submit([&done, value = std::move(value)] {
+        done = *value;
+    });
+
+    waitFor(done, 42);
+    ASSERT_EQ(done.load(), 42u);
+}
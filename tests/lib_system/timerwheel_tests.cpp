@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include <lib/system/timerwheel.hpp>
+
+namespace {
+using Wheel = cs::TimerWheel<int>;
+using Clock = Wheel::Clock;
+
+const Clock::time_point kStart = Clock::now();
+
+Clock::time_point at(int64_t ms) {
+    return kStart + std::chrono::milliseconds(ms);
+}
+
+std::vector<Wheel::Expired> expire(Wheel& wheel, int64_t ms) {
+    std::vector<Wheel::Expired> result;
+    wheel.expire(at(ms), result);
+    return result;
+}
+}  // namespace
+
+TEST(TimerWheel, EntriesExpireInTimeOrder) {
+    Wheel wheel(kStart);
+
+    ASSERT_TRUE(wheel.insert(3, at(300), 30));
+    ASSERT_TRUE(wheel.insert(1, at(10), 10));
+    ASSERT_TRUE(wheel.insert(2, at(20), 20));
+    ASSERT_FALSE(wheel.insert(2, at(50), 50));
+
+    ASSERT_EQ(wheel.size(), 3u);
+    ASSERT_EQ(wheel.nextExpiry(), at(10));
+
+    ASSERT_TRUE(expire(wheel, 9).empty());
+
+    auto expired = expire(wheel, 25);
+    ASSERT_EQ(expired.size(), 2u);
+    ASSERT_EQ(expired[0].key, 1u);
+    ASSERT_EQ(expired[0].value, 10);
+    ASSERT_EQ(expired[1].key, 2u);
+
+    ASSERT_FALSE(wheel.contains(1));
+    ASSERT_TRUE(wheel.contains(3));
+
+    // the entry is in the second level, so the wheel wakes up to move it down first
+    ASSERT_EQ(wheel.nextExpiry(), at(256));
+    ASSERT_TRUE(expire(wheel, 256).empty());
+    ASSERT_EQ(wheel.nextExpiry(), at(300));
+
+    expired = expire(wheel, 300);
+    ASSERT_EQ(expired.size(), 1u);
+    ASSERT_EQ(expired[0].value, 30);
+
+    ASSERT_TRUE(wheel.empty());
+    ASSERT_FALSE(wheel.nextExpiry().has_value());
+}
+
+TEST(TimerWheel, RemovedEntryDoesNotExpire) {
+    Wheel wheel(kStart);
+
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(wheel.insert(static_cast<uintptr_t>(i), at(1000 + i * 1000), i));
+    }
+
+    for (int i = 0; i < 100; i += 2) {
+        ASSERT_TRUE(wheel.remove(static_cast<uintptr_t>(i)));
+    }
+
+    ASSERT_FALSE(wheel.remove(0));
+    ASSERT_EQ(wheel.size(), 50u);
+
+    const auto expired = expire(wheel, 200'000);
+    ASSERT_EQ(expired.size(), 50u);
+
+    for (size_t i = 0; i < expired.size(); ++i) {
+        ASSERT_EQ(expired[i].value, static_cast<int>(i * 2 + 1));
+    }
+
+    // removed keys may be scheduled again
+    ASSERT_TRUE(wheel.insert(0, at(200'010), 0));
+    ASSERT_EQ(expire(wheel, 200'010).size(), 1u);
+}
+
+TEST(TimerWheel, PassedTimeExpiresAtOnce) {
+    Wheel wheel(kStart);
+
+    ASSERT_TRUE(expire(wheel, 1000).empty());
+    ASSERT_TRUE(wheel.insert(1, at(500), 1));
+    ASSERT_LE(wheel.nextExpiry().value(), at(1000));
+
+    const auto expired = expire(wheel, 1000);
+    ASSERT_EQ(expired.size(), 1u);
+}
+
+TEST(TimerWheel, FarEntryIsMovedDownAgain) {
+    Wheel wheel(kStart);
+
+    // longer than the whole wheel
+    const int64_t delay = int64_t(1) << 33;
+
+    ASSERT_TRUE(wheel.insert(1, at(delay), 1));
+    ASSERT_TRUE(expire(wheel, delay / 2).empty());
+    ASSERT_TRUE(expire(wheel, delay - 1).empty());
+    ASSERT_EQ(expire(wheel, delay).size(), 1u);
+}
+
+TEST(TimerWheel, RandomScheduleMatchesOrderedMap) {
+    Wheel wheel(kStart);
+    std::multimap<int64_t, uintptr_t> expected;
+    std::mt19937_64 random(42);
+
+    int64_t now = 0;
+    uintptr_t key = 1;
+
+    for (int round = 0; round < 200; ++round) {
+        for (int i = 0; i < 50; ++i, ++key) {
+            // delays cover every level of the wheel
+            const int64_t delay = static_cast<int64_t>(random() % (uint64_t(1) << (4 + (random() % 26))));
+            ASSERT_TRUE(wheel.insert(key, at(now + delay), static_cast<int>(key)));
+            expected.emplace(now + delay, key);
+        }
+
+        for (int i = 0; i < 10 && !expected.empty(); ++i) {
+            auto iter = std::next(expected.begin(), static_cast<long>(random() % expected.size()));
+            ASSERT_TRUE(wheel.remove(iter->second));
+            expected.erase(iter);
+        }
+
+        const auto next = wheel.nextExpiry();
+        ASSERT_TRUE(next.has_value());
+        ASSERT_LE(next.value(), at(expected.begin()->first));
+
+        now += static_cast<int64_t>(random() % 100'000);
+
+        const auto expired = expire(wheel, now);
+        const auto end = expected.upper_bound(now);
+
+        ASSERT_EQ(expired.size(), static_cast<size_t>(std::distance(expected.begin(), end)));
+
+        int64_t previous = 0;
+
+        for (const auto& item : expired) {
+            auto iter = std::find_if(expected.begin(), end, [&](const auto& value) { return value.second == item.key; });
+            ASSERT_NE(iter, end);
+            ASSERT_GE(iter->first, previous);
+            previous = iter->first;
+        }
+
+        expected.erase(expected.begin(), end);
+        ASSERT_EQ(wheel.size(), expected.size());
+    }
+}
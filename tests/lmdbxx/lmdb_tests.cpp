@@ -149,6 +149,84 @@ TEST(Lmdbxx, LastPair) {
     }
 }
 
+TEST(Lmdbxx, InsertAndIterate) {
+    auto db = createDb();
+    db->open();
+
+    std::vector<std::pair<std::string, std::string>> pairs = {
+        {"Key1", "Value1"},
+        {"Key3", "Value3"},
+        {"Key5", "Value5"}
+    };
+
+    for (const auto& [key, value] : pairs) {
+        db->insert(key, value);
+    }
+
+    ASSERT_EQ(db->size(), pairs.size());
+
+    std::vector<std::string> keys;
+    auto collect = [&keys](const lmdb::val& key, const lmdb::val&) {
+        keys.emplace_back(key.data(), key.size());
+        return true;
+    };
+
+    db->iterate("Key2", 4, true, collect);
+    ASSERT_EQ(keys, std::vector<std::string>({"Key3", "Key5"}));
+
+    keys.clear();
+    db->iterate("Key4", 4, false, collect);
+    ASSERT_EQ(keys, std::vector<std::string>({"Key3", "Key1"}));
+
+    keys.clear();
+    db->iterate("Key3", 4, false, collect);
+    ASSERT_EQ(keys, std::vector<std::string>({"Key3", "Key1"}));
+
+    keys.clear();
+    db->iterate("Key9", 4, false, [&keys](const lmdb::val& key, const lmdb::val&) {
+        keys.emplace_back(key.data(), key.size());
+        return false;
+    });
+    ASSERT_EQ(keys, std::vector<std::string>({"Key5"}));
+}
+
+TEST(Lmdbxx, UpdateTablesInOneTransaction) {
+    auto db = createDb();
+    db->setMaxDbs(2);
+    db->open();
+
+    const char* table1 = "Table1";
+    const char* table2 = "Table2";
+
+    auto put = [](lmdb::txn& transaction, const char* table, std::string key, std::string value) {
+        auto dbi = lmdb::dbi::open(transaction, table, MDB_CREATE);
+        lmdb::val k(key.data(), key.size());
+        lmdb::val v(value.data(), value.size());
+        dbi.put(transaction, k, v);
+    };
+
+    db->update([&put, table1, table2](lmdb::txn& transaction) {
+        put(transaction, table1, "Key1", "Value1");
+        put(transaction, table2, "Key2", "Value2");
+        return true;
+    });
+
+    ASSERT_EQ(db->size(table1), 1);
+    ASSERT_EQ(db->size(table2), 1);
+
+    // aborted transaction changes nothing
+    db->update([&put, table1, table2](lmdb::txn& transaction) {
+        put(transaction, table1, "Key3", "Value3");
+        put(transaction, table2, "Key4", "Value4");
+        return false;
+    });
+
+    ASSERT_EQ(db->size(table1), 1);
+    ASSERT_EQ(db->size(table2), 1);
+    ASSERT_TRUE(db->isKeyExists(std::string("Key2"), table2));
+    ASSERT_FALSE(db->isKeyExists(std::string("Key4"), table2));
+}
+
 TEST(Lmdbxx, TestMappedSize) {
     auto db = createDb();
     db->setMapSize(9000);